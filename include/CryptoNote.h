@@ -92,9 +92,11 @@ namespace CryptoNote
         uint64_t unlockTime;
 
         //RTcoin
-        //TODO: need to specify the unit of deadline
-        uint64_t deadline;
-        uint64_t size;
+        /* Absolute deadline, as a unix timestamp in milliseconds. 0 means
+           the transaction has no deadline. Only serialized for
+           HACK_TRANSACTION_VERSION transactions. */
+        uint64_t deadline = 0;
+        uint64_t size = 0;
 
         std::vector<TransactionInput> inputs;
 
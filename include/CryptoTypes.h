@@ -14,6 +14,7 @@
 #include <common/StringTools.h>
 #include <cstdint>
 #include <iterator>
+#include <string_view>
 
 namespace Crypto
 {
@@ -56,7 +57,7 @@ namespace Crypto
         {
             if (j.IsString())
             {
-                fromString(j.GetString());
+                fromString(std::string_view(j.GetString(), j.GetStringLength()));
             }
         }
 
@@ -73,7 +74,7 @@ namespace Crypto
         }
 
         /* Initializes the class from a json string */
-        void fromString(const std::string &s)
+        void fromString(std::string_view s)
         {
             if (!Common::podFromHex(s, data))
             {
@@ -123,7 +124,7 @@ namespace Crypto
         {
             if (j.IsString())
             {
-                fromString(j.GetString());
+                fromString(std::string_view(j.GetString(), j.GetStringLength()));
             }
         }
 
@@ -140,7 +141,7 @@ namespace Crypto
         }
 
         /* Initializes the class from a json string */
-        void fromString(const std::string &s)
+        void fromString(std::string_view s)
         {
             if (!Common::podFromHex(s, data))
             {
@@ -177,7 +178,7 @@ namespace Crypto
         {
             if (j.IsString())
             {
-                fromString(j.GetString());
+                fromString(std::string_view(j.GetString(), j.GetStringLength()));
             }
         }
 
@@ -194,7 +195,7 @@ namespace Crypto
         }
 
         /* Initializes the class from a json string */
-        void fromString(const std::string &s)
+        void fromString(std::string_view s)
         {
             if (!Common::podFromHex(s, data))
             {
@@ -242,7 +243,7 @@ namespace Crypto
         {
             if (j.IsString())
             {
-                fromString(j.GetString());
+                fromString(std::string_view(j.GetString(), j.GetStringLength()));
             }
         }
 
@@ -259,7 +260,7 @@ namespace Crypto
         }
 
         /* Initializes the class from a json string */
-        void fromString(const std::string &s)
+        void fromString(std::string_view s)
         {
             if (!Common::podFromHex(s, data))
             {
@@ -309,7 +310,7 @@ namespace Crypto
         {
             if (j.IsString())
             {
-                fromString(j.GetString());
+                fromString(std::string_view(j.GetString(), j.GetStringLength()));
             }
         }
 
@@ -326,7 +327,7 @@ namespace Crypto
         }
 
         /* Initializes the class from a json string */
-        void fromString(const std::string &s)
+        void fromString(std::string_view s)
         {
             if (!Common::podFromHex(s, data))
             {
@@ -376,7 +377,7 @@ namespace Crypto
         {
             if (j.IsString())
             {
-                fromString(j.GetString());
+                fromString(std::string_view(j.GetString(), j.GetStringLength()));
             }
         }
 
@@ -393,7 +394,7 @@ namespace Crypto
         }
 
         /* Initializes the class from a json string */
-        void fromString(const std::string &s)
+        void fromString(std::string_view s)
         {
             if (!Common::podFromHex(s, data))
             {
@@ -443,7 +444,7 @@ namespace Crypto
         {
             if (j.IsString())
             {
-                fromString(j.GetString());
+                fromString(std::string_view(j.GetString(), j.GetStringLength()));
             }
         }
 
@@ -460,7 +461,7 @@ namespace Crypto
         }
 
         /* Initializes the class from a json string */
-        void fromString(const std::string &s)
+        void fromString(std::string_view s)
         {
             if (!Common::podFromHex(s, data))
             {
@@ -510,7 +511,7 @@ namespace Crypto
         {
             if (j.IsString())
             {
-                fromString(j.GetString());
+                fromString(std::string_view(j.GetString(), j.GetStringLength()));
             }
         }
 
@@ -527,7 +528,7 @@ namespace Crypto
         }
 
         /* Initializes the class from a json string */
-        void fromString(const std::string &s)
+        void fromString(std::string_view s)
         {
             if (!Common::podFromHex(s, data))
             {
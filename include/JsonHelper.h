@@ -6,6 +6,8 @@
 
 #include "rapidjson/document.h"
 
+#include <string_view>
+
 /* Yikes! */
 typedef rapidjson::GenericObject<
     true,
@@ -140,6 +142,27 @@ template<typename T> std::string getStringFromJSON(const T &j, const std::string
     return getStringFromJSON(val);
 }
 
+/**
+ * Gets a string from the JSON without copying it, with or without a given
+ * keyname. Only valid for as long as the document is
+ */
+template<typename T> std::string_view getStringViewFromJSON(const T &j)
+{
+    if (!j.IsString())
+    {
+        throw std::invalid_argument("JSON parameter is wrong type. Expected String, got " + kTypeNames[j.GetType()]);
+    }
+
+    return std::string_view(j.GetString(), j.GetStringLength());
+}
+
+template<typename T> std::string_view getStringViewFromJSON(const T &j, const std::string &key)
+{
+    auto &val = getJsonValue(j, key);
+
+    return getStringViewFromJSON(val);
+}
+
 /**
  * Gets an Array from JSON, with or without a given keyname
  */
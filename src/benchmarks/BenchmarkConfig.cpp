@@ -0,0 +1,126 @@
+// Copyright (c) 2018-2020, The TurtleCoin Developers
+//
+// Please see the included LICENSE file for more information.
+
+////////////////////////////////
+#include "BenchmarkConfig.h"
+////////////////////////////////
+
+#include <config/CliHeader.h>
+#include <cxxopts.hpp>
+#include <iostream>
+#include <utilities/ColouredMsg.h>
+
+namespace Benchmarks
+{
+    BenchmarkConfig::BenchmarkConfig(): list(false), help(false), version(false) {}
+
+    void BenchmarkConfig::parse(int argc, char **argv)
+    {
+        cxxopts::Options options(argv[0], CryptoNote::getProjectCLIHeader());
+
+        options.add_options("Core")(
+            "help", "Display this help message", cxxopts::value<bool>(help)->implicit_value("true"))(
+            "version",
+            "Output software version information",
+            cxxopts::value<bool>(version)->default_value("false")->implicit_value("true"));
+
+        options.add_options("Run")(
+            "filter",
+            "Only run the benchmarks whose name matches this regular expression",
+            cxxopts::value<std::string>(filter)->default_value(".*"),
+            "<regex>")(
+            "list",
+            "List the benchmarks and exit",
+            cxxopts::value<bool>(list)->default_value("false")->implicit_value("true"))(
+            "warmup",
+            "Untimed samples to run before measuring each benchmark",
+            cxxopts::value<uint64_t>(warmup)->default_value("2"),
+            "#")(
+            "samples",
+            "Timed samples to take of each benchmark",
+            cxxopts::value<uint64_t>(samples)->default_value("10"),
+            "#");
+
+        options.add_options("Results")(
+            "output",
+            "Write the results to this file as JSON",
+            cxxopts::value<std::string>(outputFile),
+            "<file>")(
+            "baseline",
+            "Compare the results against a JSON file written by an earlier --output run, and exit with an error if "
+            "any benchmark regressed",
+            cxxopts::value<std::string>(baselineFile),
+            "<file>")(
+            "threshold",
+            "How much slower than the baseline median, in percent, counts as a regression",
+            cxxopts::value<double>(threshold)->default_value("10"),
+            "#");
+
+        options.add_options("Fixtures")(
+            "seed",
+            "Seed for the fixture generators, so runs are comparable",
+            cxxopts::value<uint64_t>(seed)->default_value("1"),
+            "#")(
+            "chain-height",
+            "Blocks in the synthetic chain",
+            cxxopts::value<uint64_t>(chainHeight)->default_value("200"),
+            "#")(
+            "outputs-per-block",
+            "Coinbase outputs in each synthetic block",
+            cxxopts::value<uint64_t>(outputsPerBlock)->default_value("16"),
+            "#")(
+            "pool-size",
+            "Transactions in the synthetic transaction pool",
+            cxxopts::value<uint64_t>(poolSize)->default_value("1000"),
+            "#")(
+            "ring-size",
+            "Ring size of the synthetic transaction inputs",
+            cxxopts::value<uint64_t>(ringSize)->default_value("4"),
+            "#");
+
+        try
+        {
+            auto result = options.parse(argc, argv);
+        }
+        catch (const cxxopts::OptionException &e)
+        {
+            std::cout << WarningMsg("Error: Unable to parse command line argument options: ") << WarningMsg(e.what())
+                      << "\n\n";
+            std::cout << options.help({}) << std::endl;
+            exit(1);
+        }
+
+        if (help) // Do we want to display the help message?
+        {
+            std::cout << options.help({}) << std::endl;
+            exit(0);
+        }
+        else if (version) // Do we want to display the software version?
+        {
+            std::cout << InformationMsg(CryptoNote::getProjectCLIHeader()) << std::endl;
+            exit(0);
+        }
+
+        if (samples == 0)
+        {
+            throw std::runtime_error("--samples must not be zero");
+        }
+
+        if (threshold < 0)
+        {
+            throw std::runtime_error("--threshold must not be negative");
+        }
+
+        if (ringSize == 0)
+        {
+            throw std::runtime_error("--ring-size must not be zero");
+        }
+
+        if (chainHeight * outputsPerBlock < ringSize * 2)
+        {
+            throw std::runtime_error("--chain-height and --outputs-per-block are too small to build rings from");
+        }
+    }
+
+} // namespace Benchmarks
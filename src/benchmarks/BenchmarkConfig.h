@@ -0,0 +1,61 @@
+// Copyright (c) 2018-2020, The TurtleCoin Developers
+//
+// Please see the included LICENSE file for more information.
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace Benchmarks
+{
+    struct BenchmarkConfig
+    {
+        BenchmarkConfig();
+
+        void parse(int argc, char **argv);
+
+        /* Only run benchmarks whose name matches this regex */
+        std::string filter;
+
+        /* Print the benchmark names and exit */
+        bool list;
+
+        /* Untimed samples run before measuring, to warm caches and allocators */
+        uint64_t warmup;
+
+        /* Timed samples per benchmark */
+        uint64_t samples;
+
+        /* Where to write the results as JSON. Empty to not write them */
+        std::string outputFile;
+
+        /* Results from an earlier run to compare against. Empty to not compare */
+        std::string baselineFile;
+
+        /* How much slower than the baseline median, in percent, counts as a
+           regression */
+        double threshold;
+
+        /* Seed for the fixture generators, so runs use the same data */
+        uint64_t seed;
+
+        /* Blocks in the synthetic chain the cache and validation benchmarks
+           run against */
+        uint64_t chainHeight;
+
+        /* Coinbase outputs per synthetic block */
+        uint64_t outputsPerBlock;
+
+        /* Transactions in the synthetic pool */
+        uint64_t poolSize;
+
+        /* Ring size of synthetic transaction inputs */
+        uint64_t ringSize;
+
+        bool help;
+
+        bool version;
+    };
+
+} // namespace Benchmarks
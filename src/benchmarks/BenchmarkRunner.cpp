@@ -0,0 +1,349 @@
+// Copyright (c) 2018-2020, The TurtleCoin Developers
+//
+// Please see the included LICENSE file for more information.
+
+////////////////////////////////
+#include "BenchmarkRunner.h"
+////////////////////////////////
+
+#include "rapidjson/document.h"
+#include "rapidjson/istreamwrapper.h"
+#include "rapidjson/ostreamwrapper.h"
+#include "rapidjson/prettywriter.h"
+
+#include <JsonHelper.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <regex>
+#include <sstream>
+#include <unordered_map>
+#include <utilities/ColouredMsg.h>
+#include <version.h>
+
+namespace Benchmarks
+{
+    namespace
+    {
+        /* Nearest rank percentile of sorted values */
+        double percentile(const std::vector<double> &sorted, const double p)
+        {
+            const size_t rank = static_cast<size_t>(std::ceil(p / 100 * sorted.size()));
+
+            return sorted[std::min(sorted.size() - 1, rank == 0 ? 0 : rank - 1)];
+        }
+
+        std::string formatTime(const double nanoseconds)
+        {
+            std::stringstream stream;
+
+            stream << std::fixed << std::setprecision(2);
+
+            if (nanoseconds >= 1e9)
+            {
+                stream << nanoseconds / 1e9 << " s";
+            }
+            else if (nanoseconds >= 1e6)
+            {
+                stream << nanoseconds / 1e6 << " ms";
+            }
+            else if (nanoseconds >= 1e3)
+            {
+                stream << nanoseconds / 1e3 << " us";
+            }
+            else
+            {
+                stream << nanoseconds << " ns";
+            }
+
+            return stream.str();
+        }
+    } // namespace
+
+    BenchmarkRunner::BenchmarkRunner(const BenchmarkConfig &config): m_config(config) {}
+
+    void BenchmarkRunner::add(Benchmark benchmark)
+    {
+        m_benchmarks.push_back(std::move(benchmark));
+    }
+
+    bool BenchmarkRunner::isSelected(const Benchmark &benchmark) const
+    {
+        return std::regex_search(benchmark.name, std::regex(m_config.filter));
+    }
+
+    std::vector<std::string> BenchmarkRunner::selected() const
+    {
+        std::vector<std::string> names;
+
+        for (const auto &benchmark : m_benchmarks)
+        {
+            if (isSelected(benchmark))
+            {
+                names.push_back(benchmark.name);
+            }
+        }
+
+        return names;
+    }
+
+    std::vector<BenchmarkResult> BenchmarkRunner::run() const
+    {
+        std::vector<BenchmarkResult> results;
+
+        for (const auto &benchmark : m_benchmarks)
+        {
+            if (!isSelected(benchmark))
+            {
+                continue;
+            }
+
+            const auto result = runOne(benchmark);
+
+            std::cout << std::left << std::setw(48) << result.name << std::right << std::setw(12)
+                      << formatTime(result.median) << "  (mean " << formatTime(result.mean) << " +- "
+                      << formatTime(result.stddev) << ", p95 " << formatTime(result.p95) << ")  "
+                      << static_cast<uint64_t>(result.opsPerSecond) << " op/s" << std::endl;
+
+            results.push_back(result);
+        }
+
+        return results;
+    }
+
+    BenchmarkResult BenchmarkRunner::runOne(const Benchmark &benchmark) const
+    {
+        if (benchmark.prepare)
+        {
+            benchmark.prepare();
+        }
+
+        for (uint64_t i = 0; i < m_config.warmup; i++)
+        {
+            if (benchmark.setup)
+            {
+                benchmark.setup();
+            }
+
+            benchmark.run();
+        }
+
+        /* Nanoseconds per operation of each sample */
+        std::vector<double> timings;
+
+        uint64_t operations = 0;
+
+        for (uint64_t i = 0; i < m_config.samples; i++)
+        {
+            if (benchmark.setup)
+            {
+                benchmark.setup();
+            }
+
+            const auto startTime = std::chrono::steady_clock::now();
+
+            operations = std::max<uint64_t>(1, benchmark.run());
+
+            const auto elapsed = std::chrono::steady_clock::now() - startTime;
+
+            timings.push_back(
+                std::chrono::duration_cast<std::chrono::duration<double, std::nano>>(elapsed).count() / operations);
+        }
+
+        std::sort(timings.begin(), timings.end());
+
+        BenchmarkResult result;
+
+        result.name = benchmark.name;
+        result.samples = timings.size();
+        result.operations = operations;
+        result.mean = std::accumulate(timings.begin(), timings.end(), 0.0) / timings.size();
+        result.median = timings.size() % 2 == 0
+                            ? (timings[timings.size() / 2 - 1] + timings[timings.size() / 2]) / 2
+                            : timings[timings.size() / 2];
+        result.min = timings.front();
+        result.max = timings.back();
+        result.p95 = percentile(timings, 95);
+
+        double variance = 0;
+
+        for (const auto timing : timings)
+        {
+            variance += (timing - result.mean) * (timing - result.mean);
+        }
+
+        result.stddev = timings.size() > 1 ? std::sqrt(variance / (timings.size() - 1)) : 0;
+        result.opsPerSecond = result.median > 0 ? 1e9 / result.median : 0;
+
+        return result;
+    }
+
+    void writeResults(const std::vector<BenchmarkResult> &results, const std::string &filename)
+    {
+        std::ofstream output(filename);
+
+        if (!output)
+        {
+            throw std::runtime_error("Failed to open " + filename + " for writing");
+        }
+
+        rapidjson::OStreamWrapper osw(output);
+        rapidjson::PrettyWriter<rapidjson::OStreamWrapper> writer(osw);
+
+        writer.StartObject();
+        {
+            writer.Key("benchmarks");
+            writer.StartArray();
+            {
+                for (const auto &result : results)
+                {
+                    writer.StartObject();
+                    {
+                        writer.Key("max");
+                        writer.Double(result.max);
+
+                        writer.Key("mean");
+                        writer.Double(result.mean);
+
+                        writer.Key("median");
+                        writer.Double(result.median);
+
+                        writer.Key("min");
+                        writer.Double(result.min);
+
+                        writer.Key("name");
+                        writer.String(result.name);
+
+                        writer.Key("operations");
+                        writer.Uint64(result.operations);
+
+                        writer.Key("opsPerSecond");
+                        writer.Double(result.opsPerSecond);
+
+                        writer.Key("p95");
+                        writer.Double(result.p95);
+
+                        writer.Key("samples");
+                        writer.Uint64(result.samples);
+
+                        writer.Key("stddev");
+                        writer.Double(result.stddev);
+                    }
+                    writer.EndObject();
+                }
+            }
+            writer.EndArray();
+
+            writer.Key("unit");
+            writer.String("ns/op");
+
+            writer.Key("version");
+            writer.String(PROJECT_VERSION_LONG);
+        }
+        writer.EndObject();
+
+        writer.Flush();
+    }
+
+    std::vector<BenchmarkResult> readResults(const std::string &filename)
+    {
+        std::ifstream input(filename);
+
+        if (!input)
+        {
+            throw std::runtime_error("Failed to open " + filename);
+        }
+
+        rapidjson::IStreamWrapper isw(input);
+        rapidjson::Document j;
+
+        if (j.ParseStream(isw).HasParseError())
+        {
+            throw std::runtime_error(filename + " is not valid JSON");
+        }
+
+        std::vector<BenchmarkResult> results;
+
+        for (const auto &item : getArrayFromJSON(j, "benchmarks"))
+        {
+            BenchmarkResult result;
+
+            result.name = getStringFromJSON(item, "name");
+            result.samples = getUint64FromJSON(item, "samples");
+            result.operations = getUint64FromJSON(item, "operations");
+            result.mean = getDoubleFromJSON(item, "mean");
+            result.median = getDoubleFromJSON(item, "median");
+            result.stddev = getDoubleFromJSON(item, "stddev");
+            result.min = getDoubleFromJSON(item, "min");
+            result.max = getDoubleFromJSON(item, "max");
+            result.p95 = getDoubleFromJSON(item, "p95");
+            result.opsPerSecond = getDoubleFromJSON(item, "opsPerSecond");
+
+            results.push_back(result);
+        }
+
+        return results;
+    }
+
+    size_t compareToBaseline(
+        const std::vector<BenchmarkResult> &results,
+        const std::vector<BenchmarkResult> &baseline,
+        const double threshold)
+    {
+        std::unordered_map<std::string, BenchmarkResult> baselineByName;
+
+        for (const auto &result : baseline)
+        {
+            baselineByName[result.name] = result;
+        }
+
+        size_t regressions = 0;
+
+        std::cout << "\nCompared to baseline (regression threshold " << threshold << "%):\n\n";
+
+        for (const auto &result : results)
+        {
+            const auto it = baselineByName.find(result.name);
+
+            std::cout << std::left << std::setw(48) << result.name << std::right;
+
+            if (it == baselineByName.end() || it->second.median <= 0)
+            {
+                std::cout << std::setw(12) << "new" << std::endl;
+                continue;
+            }
+
+            const double change = (result.median - it->second.median) / it->second.median * 100;
+
+            std::stringstream stream;
+
+            stream << std::showpos << std::fixed << std::setprecision(1) << change << "%";
+
+            const std::string changeStr = stream.str();
+
+            /* Right align it with the rest of the table */
+            std::cout << std::string(changeStr.size() < 12 ? 12 - changeStr.size() : 0, ' ');
+
+            if (change > threshold)
+            {
+                std::cout << WarningMsg(changeStr) << "  " << WarningMsg("REGRESSION") << std::endl;
+                regressions++;
+            }
+            else if (change < -threshold)
+            {
+                std::cout << SuccessMsg(changeStr) << "  " << SuccessMsg("improved") << std::endl;
+            }
+            else
+            {
+                std::cout << changeStr << std::endl;
+            }
+        }
+
+        return regressions;
+    }
+
+} // namespace Benchmarks
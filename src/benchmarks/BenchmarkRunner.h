@@ -0,0 +1,93 @@
+// Copyright (c) 2018-2020, The TurtleCoin Developers
+//
+// Please see the included LICENSE file for more information.
+
+#pragma once
+
+#include "BenchmarkConfig.h"
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace Benchmarks
+{
+    struct Benchmark
+    {
+        /* Grouped by prefix, e.g. cache/database/getBlockIndex */
+        std::string name;
+
+        /* Runs once, before the warmup, if the benchmark is selected. Builds
+           the fixtures it needs. Optional */
+        std::function<void()> prepare;
+
+        /* Runs before every sample, untimed. Optional */
+        std::function<void()> setup;
+
+        /* Runs one timed sample, returning how many operations it did */
+        std::function<uint64_t()> run;
+    };
+
+    /* Per operation timings of a benchmark, in nanoseconds */
+    struct BenchmarkResult
+    {
+        std::string name;
+
+        uint64_t samples = 0;
+
+        /* Operations in each sample */
+        uint64_t operations = 0;
+
+        double mean = 0;
+
+        double median = 0;
+
+        double stddev = 0;
+
+        double min = 0;
+
+        double max = 0;
+
+        double p95 = 0;
+
+        /* Worked out from the median */
+        double opsPerSecond = 0;
+    };
+
+    class BenchmarkRunner
+    {
+      public:
+        BenchmarkRunner(const BenchmarkConfig &config);
+
+        void add(Benchmark benchmark);
+
+        /* Names of the benchmarks that match the filter */
+        std::vector<std::string> selected() const;
+
+        /* Runs every selected benchmark, printing each result as it
+           finishes */
+        std::vector<BenchmarkResult> run() const;
+
+      private:
+        BenchmarkResult runOne(const Benchmark &benchmark) const;
+
+        bool isSelected(const Benchmark &benchmark) const;
+
+        const BenchmarkConfig m_config;
+
+        std::vector<Benchmark> m_benchmarks;
+    };
+
+    void writeResults(const std::vector<BenchmarkResult> &results, const std::string &filename);
+
+    std::vector<BenchmarkResult> readResults(const std::string &filename);
+
+    /* Prints how each result compares to the baseline, returning how many
+       are more than threshold percent slower */
+    size_t compareToBaseline(
+        const std::vector<BenchmarkResult> &results,
+        const std::vector<BenchmarkResult> &baseline,
+        const double threshold);
+
+} // namespace Benchmarks
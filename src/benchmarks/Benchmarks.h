@@ -0,0 +1,23 @@
+// Copyright (c) 2018-2020, The TurtleCoin Developers
+//
+// Please see the included LICENSE file for more information.
+
+#pragma once
+
+#include "BenchmarkConfig.h"
+#include "BenchmarkRunner.h"
+
+namespace Benchmarks
+{
+    /* Transaction pool, transaction validation, and the memory and database
+       blockchain caches */
+    void registerCoreBenchmarks(BenchmarkRunner &runner, const BenchmarkConfig &config);
+
+    /* Binary serialization of transactions and blocks, the JSON encoding of
+       the wallet sync data, and parsing of bulk API request bodies */
+    void registerSerializationBenchmarks(BenchmarkRunner &runner, const BenchmarkConfig &config);
+
+    /* Wallet synchronizer block processing */
+    void registerWalletBenchmarks(BenchmarkRunner &runner, const BenchmarkConfig &config);
+
+} // namespace Benchmarks
@@ -0,0 +1,424 @@
+// Copyright (c) 2018-2020, The TurtleCoin Developers
+//
+// Please see the included LICENSE file for more information.
+
+////////////////////////////////
+#include "Benchmarks.h"
+////////////////////////////////
+
+#include "Fixtures.h"
+
+#include <common/ArrayView.h>
+#include <config/CryptoNoteConfig.h>
+#include <cryptonotecore/BlockchainCache.h>
+#include <cryptonotecore/CachedTransaction.h>
+#include <cryptonotecore/Checkpoints.h>
+#include <cryptonotecore/CryptoNoteFormatUtils.h>
+#include <cryptonotecore/DatabaseBlockchainCache.h>
+#include <cryptonotecore/DatabaseBlockchainCacheFactory.h>
+#include <cryptonotecore/RocksDBWrapper.h>
+#include <cryptonotecore/TransactionPool.h>
+#include <cryptonotecore/TransactionValidatiorState.h>
+#include <cryptonotecore/ValidateTransaction.h>
+#include <filesystem>
+#include <logging/DummyLogger.h>
+#include <random>
+#include <stdexcept>
+#include <utilities/ThreadPool.h>
+
+namespace Benchmarks
+{
+    namespace
+    {
+        /* Most of the transactions on the network have 1-3 inputs and a
+           handful of outputs */
+        const size_t TRANSACTION_INPUTS = 2;
+
+        const size_t TRANSACTION_OUTPUTS = 4;
+
+        /* Signing is slow, and validating a few dozen transactions is enough
+           to get a stable timing */
+        const size_t MAX_SIGNED_TRANSACTIONS = 32;
+
+        /* Rings and key images to look up in each cache sample */
+        const size_t CACHE_LOOKUPS = 256;
+
+        /* A populated cache, and what to look up in it */
+        struct CacheFixture
+        {
+            std::unique_ptr<FixtureGenerator> generator;
+
+            std::unique_ptr<CryptoNote::IBlockchainCache> cache;
+
+            std::vector<Crypto::Hash> blockHashes;
+
+            std::vector<Crypto::Hash> transactionHashes;
+
+            /* Absolute global indexes */
+            std::vector<std::vector<uint32_t>> rings;
+
+            /* None of these are spent */
+            std::vector<Crypto::KeyImage> keyImages;
+        };
+
+        /* Fixtures shared between the benchmarks, built by the first selected
+           benchmark that needs them */
+        struct CoreState
+        {
+            CoreState(const BenchmarkConfig &config):
+                config(config),
+                logger(std::make_shared<Logging::DummyLogger>()),
+                currency(CryptoNote::CurrencyBuilder(logger).currency()),
+                checkpoints(logger)
+            {
+            }
+
+            ~CoreState()
+            {
+                /* The cache has to go before the database it's stored in */
+                database.cache.reset();
+
+                if (db)
+                {
+                    db->shutdown();
+                    db->destroy(*dbConfig);
+
+                    std::error_code ec;
+                    std::filesystem::remove_all(dbConfig->dataDir, ec);
+                }
+            }
+
+            const BenchmarkConfig config;
+
+            std::shared_ptr<Logging::ILogger> logger;
+
+            const CryptoNote::Currency currency;
+
+            const CryptoNote::Checkpoints checkpoints;
+
+            Utilities::ThreadPool<bool> threadPool;
+
+            CacheFixture memory;
+
+            CacheFixture database;
+
+            std::unique_ptr<CryptoNote::RocksDBWrapper> db;
+
+            std::unique_ptr<CryptoNote::DataBaseConfig> dbConfig;
+
+            std::unique_ptr<CryptoNote::DatabaseBlockchainCacheFactory> databaseFactory;
+
+            /* Correctly signed, spending outputs of the memory cache */
+            std::vector<CryptoNote::CachedTransaction> signedTransactions;
+
+            std::vector<CryptoNote::CachedTransaction> poolTransactions;
+
+            /* Copies of poolTransactions, ready to be moved into the pool */
+            std::vector<CryptoNote::CachedTransaction> pendingTransactions;
+
+            std::unique_ptr<CryptoNote::TransactionPool> pool;
+        };
+
+        CryptoNote::TransactionValidatorState getValidatorState(const CryptoNote::CachedTransaction &transaction)
+        {
+            CryptoNote::TransactionValidatorState validatorState;
+
+            for (const auto &input : transaction.getTransaction().inputs)
+            {
+                validatorState.spentKeyImages.insert(boost::get<CryptoNote::KeyInput>(input).keyImage);
+            }
+
+            return validatorState;
+        }
+
+        void populateCache(const CoreState &state, CacheFixture &fixture)
+        {
+            fixture.generator = std::make_unique<FixtureGenerator>(state.currency, state.config.seed);
+
+            fixture.transactionHashes = fixture.generator->buildChain(
+                *fixture.cache, static_cast<uint32_t>(state.config.chainHeight), state.config.outputsPerBlock);
+
+            fixture.blockHashes = fixture.cache->getBlockHashes(0, fixture.cache->getTopBlockIndex() + 1);
+
+            /* Unsigned transactions pick random rings and key images without
+               using up the outputs makeSpendingTransaction() spends */
+            for (size_t i = 0; i < CACHE_LOOKUPS; i++)
+            {
+                const auto transaction = fixture.generator->makeUnsignedTransaction(1, state.config.ringSize, 1, 0);
+
+                const auto &input = boost::get<CryptoNote::KeyInput>(transaction.inputs[0]);
+
+                fixture.rings.push_back(CryptoNote::relativeOutputOffsetsToAbsolute(input.outputIndexes));
+                fixture.keyImages.push_back(input.keyImage);
+            }
+        }
+
+        void prepareMemoryCache(CoreState &state)
+        {
+            if (state.memory.cache)
+            {
+                return;
+            }
+
+            state.memory.cache =
+                std::make_unique<CryptoNote::BlockchainCache>("", state.currency, state.logger, nullptr);
+
+            populateCache(state, state.memory);
+        }
+
+        void prepareDatabaseCache(CoreState &state)
+        {
+            if (state.database.cache)
+            {
+                return;
+            }
+
+            const auto dataDir = std::filesystem::temp_directory_path()
+                                 / ("benchmarks-" + std::to_string(std::random_device()()));
+
+            /* RocksDB only creates the last directory of the path */
+            std::filesystem::create_directories(dataDir);
+
+            state.dbConfig = std::make_unique<CryptoNote::DataBaseConfig>(dataDir.string(), 2, 100, 64, 64, 64, false);
+
+            auto db = std::make_unique<CryptoNote::RocksDBWrapper>(state.logger);
+            db->init(*state.dbConfig);
+
+            /* Only set once it's open, so the destructor knows to close it */
+            state.db = std::move(db);
+
+            state.databaseFactory =
+                std::make_unique<CryptoNote::DatabaseBlockchainCacheFactory>(*state.db, state.logger);
+
+            state.database.cache = std::make_unique<CryptoNote::DatabaseBlockchainCache>(
+                state.currency, *state.db, *state.databaseFactory, state.logger);
+
+            populateCache(state, state.database);
+        }
+
+        void prepareSignedTransactions(CoreState &state)
+        {
+            if (!state.signedTransactions.empty())
+            {
+                return;
+            }
+
+            prepareMemoryCache(state);
+
+            const size_t count =
+                std::min(MAX_SIGNED_TRANSACTIONS, state.memory.generator->ownedOutputs().size() / TRANSACTION_INPUTS);
+
+            for (size_t i = 0; i < count; i++)
+            {
+                state.signedTransactions.emplace_back(state.memory.generator->makeSpendingTransaction(
+                    TRANSACTION_INPUTS,
+                    state.config.ringSize,
+                    TRANSACTION_OUTPUTS,
+                    CryptoNote::parameters::MINIMUM_FEE));
+            }
+        }
+
+        void preparePoolTransactions(CoreState &state)
+        {
+            if (!state.poolTransactions.empty())
+            {
+                return;
+            }
+
+            /* The pool doesn't look at the chain, but the generator needs
+               one to pick ring members from */
+            prepareMemoryCache(state);
+
+            for (size_t i = 0; i < state.config.poolSize; i++)
+            {
+                /* Vary the fee so the pool has something to sort by */
+                state.poolTransactions.emplace_back(state.memory.generator->makeUnsignedTransaction(
+                    TRANSACTION_INPUTS,
+                    state.config.ringSize,
+                    TRANSACTION_OUTPUTS,
+                    CryptoNote::parameters::MINIMUM_FEE * (1 + i % 100)));
+            }
+        }
+
+        void addCacheBenchmarks(
+            BenchmarkRunner &runner,
+            const std::shared_ptr<CoreState> &state,
+            const std::string &prefix,
+            CacheFixture CoreState::*fixture,
+            void (*prepare)(CoreState &))
+        {
+            const auto prepareFixture = [state, prepare]() { prepare(*state); };
+
+            runner.add({prefix + "getBlockIndex", prepareFixture, nullptr, [state, fixture]() {
+                            const auto &f = (*state).*fixture;
+
+                            for (uint32_t i = 0; i < f.blockHashes.size(); i++)
+                            {
+                                if (f.cache->getBlockIndex(f.blockHashes[i]) != i)
+                                {
+                                    throw std::runtime_error("Block index lookup failed");
+                                }
+                            }
+
+                            return f.blockHashes.size();
+                        }});
+
+            runner.add({prefix + "getBlockHash", prepareFixture, nullptr, [state, fixture]() {
+                            const auto &f = (*state).*fixture;
+
+                            for (uint32_t i = 0; i < f.blockHashes.size(); i++)
+                            {
+                                if (f.cache->getBlockHash(i) != f.blockHashes[i])
+                                {
+                                    throw std::runtime_error("Block hash lookup failed");
+                                }
+                            }
+
+                            return f.blockHashes.size();
+                        }});
+
+            runner.add({prefix + "hasTransaction", prepareFixture, nullptr, [state, fixture]() {
+                            const auto &f = (*state).*fixture;
+
+                            for (const auto &hash : f.transactionHashes)
+                            {
+                                if (!f.cache->hasTransaction(hash))
+                                {
+                                    throw std::runtime_error("Transaction lookup failed");
+                                }
+                            }
+
+                            return f.transactionHashes.size();
+                        }});
+
+            runner.add({prefix + "extractKeyOutputKeys", prepareFixture, nullptr, [state, fixture]() {
+                            auto &f = (*state).*fixture;
+
+                            const uint32_t blockIndex = f.cache->getTopBlockIndex();
+
+                            std::vector<Crypto::PublicKey> keys;
+
+                            for (auto &ring : f.rings)
+                            {
+                                keys.clear();
+
+                                const auto result = f.cache->extractKeyOutputKeys(
+                                    FIXTURE_OUTPUT_AMOUNT,
+                                    blockIndex,
+                                    Common::ArrayView<uint32_t>(ring.data(), ring.size()),
+                                    keys);
+
+                                if (result != CryptoNote::ExtractOutputKeysResult::SUCCESS)
+                                {
+                                    throw std::runtime_error("Output key lookup failed");
+                                }
+                            }
+
+                            return f.rings.size();
+                        }});
+
+            runner.add({prefix + "checkIfSpent", prepareFixture, nullptr, [state, fixture]() {
+                            const auto &f = (*state).*fixture;
+
+                            for (const auto &keyImage : f.keyImages)
+                            {
+                                if (f.cache->checkIfSpent(keyImage))
+                                {
+                                    throw std::runtime_error("Unspent key image reported as spent");
+                                }
+                            }
+
+                            return f.keyImages.size();
+                        }});
+        }
+    } // namespace
+
+    void registerCoreBenchmarks(BenchmarkRunner &runner, const BenchmarkConfig &config)
+    {
+        const auto state = std::make_shared<CoreState>(config);
+
+        runner.add(
+            {"pool/pushTransaction",
+             [state]() { preparePoolTransactions(*state); },
+             [state]() {
+                 state->pool = std::make_unique<CryptoNote::TransactionPool>(state->logger);
+                 state->pendingTransactions = state->poolTransactions;
+             },
+             [state]() {
+                 for (auto &transaction : state->pendingTransactions)
+                 {
+                     auto validatorState = getValidatorState(transaction);
+
+                     if (!state->pool->pushTransaction(std::move(transaction), std::move(validatorState)))
+                     {
+                         throw std::runtime_error("Pool rejected a synthetic transaction");
+                     }
+                 }
+
+                 return state->pendingTransactions.size();
+             }});
+
+        runner.add(
+            {"pool/getPoolTransactionsForBlockTemplate",
+             [state]() {
+                 preparePoolTransactions(*state);
+
+                 state->pool = std::make_unique<CryptoNote::TransactionPool>(state->logger);
+
+                 for (const auto &transaction : state->poolTransactions)
+                 {
+                     state->pool->pushTransaction(
+                         CryptoNote::CachedTransaction(transaction), getValidatorState(transaction));
+                 }
+             },
+             nullptr,
+             [state]() {
+                 const auto [regular, fusion] = state->pool->getPoolTransactionsForBlockTemplate();
+
+                 if (regular.size() + fusion.size() != state->poolTransactions.size())
+                 {
+                     throw std::runtime_error("Pool lost transactions");
+                 }
+
+                 return 1;
+             }});
+
+        runner.add(
+            {"validate/transaction", [state]() { prepareSignedTransactions(*state); }, nullptr, [state]() {
+                 const uint64_t blockHeight = state->memory.cache->getTopBlockIndex() + 1;
+
+                 const uint64_t blockSizeMedian =
+                     state->currency.blockGrantedFullRewardZoneByBlockVersion(CryptoNote::BLOCK_MAJOR_VERSION_1);
+
+                 for (const auto &transaction : state->signedTransactions)
+                 {
+                     CryptoNote::TransactionValidatorState validatorState;
+
+                     ValidateTransaction validator(
+                         transaction,
+                         validatorState,
+                         state->memory.cache.get(),
+                         state->currency,
+                         state->checkpoints,
+                         state->threadPool,
+                         blockHeight,
+                         blockSizeMedian,
+                         true);
+
+                     const auto result = validator.validate();
+
+                     if (!result.valid)
+                     {
+                         throw std::runtime_error("Synthetic transaction failed validation: " + result.errorMessage);
+                     }
+                 }
+
+                 return state->signedTransactions.size();
+             }});
+
+        addCacheBenchmarks(runner, state, "cache/memory/", &CoreState::memory, &prepareMemoryCache);
+
+        addCacheBenchmarks(runner, state, "cache/database/", &CoreState::database, &prepareDatabaseCache);
+    }
+
+} // namespace Benchmarks
@@ -0,0 +1,387 @@
+// Copyright (c) 2018-2020, The TurtleCoin Developers
+//
+// Please see the included LICENSE file for more information.
+
+////////////////////////////////
+#include "Fixtures.h"
+////////////////////////////////
+
+#include <algorithm>
+#include <common/CryptoNoteTools.h>
+#include <common/TransactionExtra.h>
+#include <config/CryptoNoteConfig.h>
+#include <cryptonotecore/CachedBlock.h>
+#include <cryptonotecore/TransactionValidatiorState.h>
+#include <stdexcept>
+
+namespace Benchmarks
+{
+    FixtureGenerator::FixtureGenerator(const CryptoNote::Currency &currency, const uint64_t seed):
+        m_currency(currency), m_seed(seed), m_random(seed)
+    {
+    }
+
+    std::tuple<Crypto::PublicKey, Crypto::SecretKey> FixtureGenerator::nextKeys()
+    {
+        const uint64_t data[2] = {m_seed, m_counter++};
+
+        Crypto::EllipticCurveScalar scalar;
+
+        Crypto::hashToScalar(data, sizeof(data), scalar);
+
+        const Crypto::SecretKey secretKey = reinterpret_cast<const Crypto::SecretKey &>(scalar);
+
+        Crypto::PublicKey publicKey;
+
+        Crypto::secret_key_to_public_key(secretKey, publicKey);
+
+        return {publicKey, secretKey};
+    }
+
+    Crypto::Hash FixtureGenerator::nextHash()
+    {
+        const uint64_t data[2] = {m_seed, m_counter++};
+
+        return Crypto::cn_fast_hash(data, sizeof(data));
+    }
+
+    std::vector<Crypto::Hash> FixtureGenerator::buildChain(
+        CryptoNote::IBlockchainCache &cache,
+        const uint32_t blockCount,
+        const size_t outputsPerBlock)
+    {
+        const uint64_t genesisTimestamp = m_currency.genesisBlock().timestamp;
+
+        uint32_t globalIndex =
+            static_cast<uint32_t>(cache.getKeyOutputsCountForAmount(FIXTURE_OUTPUT_AMOUNT, cache.getTopBlockIndex()));
+
+        std::vector<Crypto::Hash> transactionHashes;
+
+        for (uint32_t i = 0; i < blockCount; i++)
+        {
+            const uint32_t blockIndex = cache.getTopBlockIndex() + 1;
+
+            CryptoNote::BlockTemplate block;
+
+            block.majorVersion = CryptoNote::BLOCK_MAJOR_VERSION_1;
+            block.minorVersion = CryptoNote::BLOCK_MINOR_VERSION_0;
+            block.nonce = 0;
+            block.timestamp = genesisTimestamp + blockIndex * CryptoNote::parameters::DIFFICULTY_TARGET;
+            block.previousBlockHash = cache.getTopBlockHash();
+
+            auto &coinbase = block.baseTransaction;
+
+            coinbase.version = CryptoNote::CURRENT_TRANSACTION_VERSION;
+            coinbase.unlockTime = 0;
+            coinbase.inputs.push_back(CryptoNote::BaseInput {blockIndex});
+
+            const auto [transactionPublicKey, transactionSecretKey] = nextKeys();
+
+            CryptoNote::addTransactionPublicKeyToExtra(coinbase.extra, transactionPublicKey);
+
+            for (size_t j = 0; j < outputsPerBlock; j++)
+            {
+                const auto [publicKey, secretKey] = nextKeys();
+
+                coinbase.outputs.push_back({FIXTURE_OUTPUT_AMOUNT, CryptoNote::KeyOutput {publicKey}});
+
+                m_ownedOutputs.push_back({globalIndex++, publicKey, secretKey});
+            }
+
+            const CryptoNote::CachedBlock cachedBlock(block);
+
+            transactionHashes.push_back(CryptoNote::getObjectHash(coinbase));
+
+            CryptoNote::RawBlock rawBlock;
+
+            rawBlock.block = CryptoNote::toBinaryArray(block);
+
+            cache.pushBlock(
+                cachedBlock,
+                {},
+                CryptoNote::TransactionValidatorState(),
+                CryptoNote::getObjectBinarySize(coinbase),
+                FIXTURE_OUTPUT_AMOUNT * outputsPerBlock,
+                1,
+                std::move(rawBlock));
+        }
+
+        return transactionHashes;
+    }
+
+    const std::vector<OwnedOutput> &FixtureGenerator::ownedOutputs() const
+    {
+        return m_ownedOutputs;
+    }
+
+    std::vector<uint32_t> FixtureGenerator::pickRing(const uint32_t realIndex, const size_t ringSize)
+    {
+        if (ringSize > m_ownedOutputs.size())
+        {
+            throw std::runtime_error("Not enough outputs on the synthetic chain to build a ring");
+        }
+
+        std::vector<uint32_t> ring = {m_ownedOutputs[realIndex].globalIndex};
+
+        std::uniform_int_distribution<size_t> distribution(0, m_ownedOutputs.size() - 1);
+
+        while (ring.size() < ringSize)
+        {
+            const uint32_t decoy = m_ownedOutputs[distribution(m_random)].globalIndex;
+
+            if (std::find(ring.begin(), ring.end(), decoy) == ring.end())
+            {
+                ring.push_back(decoy);
+            }
+        }
+
+        std::sort(ring.begin(), ring.end());
+
+        return ring;
+    }
+
+    CryptoNote::Transaction FixtureGenerator::makeTransactionPrefix(
+        const std::vector<size_t> &realOutputs,
+        const size_t ringSize,
+        const size_t outputCount,
+        const uint64_t fee,
+        std::vector<std::vector<uint32_t>> &rings)
+    {
+        CryptoNote::Transaction transaction;
+
+        transaction.version = CryptoNote::CURRENT_TRANSACTION_VERSION;
+        transaction.unlockTime = 0;
+
+        const auto [transactionPublicKey, transactionSecretKey] = nextKeys();
+
+        CryptoNote::addTransactionPublicKeyToExtra(transaction.extra, transactionPublicKey);
+
+        for (const auto realOutput : realOutputs)
+        {
+            const auto ring = pickRing(realOutput, ringSize);
+
+            CryptoNote::KeyInput input;
+
+            input.amount = FIXTURE_OUTPUT_AMOUNT;
+
+            /* Stored relative to the previous index */
+            for (size_t i = 0; i < ring.size(); i++)
+            {
+                input.outputIndexes.push_back(i == 0 ? ring[i] : ring[i] - ring[i - 1]);
+            }
+
+            transaction.inputs.push_back(input);
+
+            rings.push_back(ring);
+        }
+
+        const uint64_t totalOut = FIXTURE_OUTPUT_AMOUNT * realOutputs.size() - fee;
+
+        for (size_t i = 0; i < outputCount; i++)
+        {
+            const auto [publicKey, secretKey] = nextKeys();
+
+            /* Any remainder goes in the first output */
+            const uint64_t amount = totalOut / outputCount + (i == 0 ? totalOut % outputCount : 0);
+
+            transaction.outputs.push_back({amount, CryptoNote::KeyOutput {publicKey}});
+        }
+
+        return transaction;
+    }
+
+    CryptoNote::Transaction FixtureGenerator::makeSpendingTransaction(
+        const size_t inputCount,
+        const size_t ringSize,
+        const size_t outputCount,
+        const uint64_t fee)
+    {
+        if (m_nextUnspent + inputCount > m_ownedOutputs.size())
+        {
+            throw std::runtime_error("Ran out of synthetic outputs to spend, use a larger --chain-height");
+        }
+
+        std::vector<size_t> realOutputs;
+
+        for (size_t i = 0; i < inputCount; i++)
+        {
+            realOutputs.push_back(m_nextUnspent++);
+        }
+
+        std::vector<std::vector<uint32_t>> rings;
+
+        auto transaction = makeTransactionPrefix(realOutputs, ringSize, outputCount, fee, rings);
+
+        for (size_t i = 0; i < inputCount; i++)
+        {
+            const auto &owned = m_ownedOutputs[realOutputs[i]];
+
+            Crypto::generate_key_image(
+                owned.key, owned.secretKey, boost::get<CryptoNote::KeyInput>(transaction.inputs[i]).keyImage);
+        }
+
+        const Crypto::Hash prefixHash =
+            CryptoNote::getObjectHash(static_cast<const CryptoNote::TransactionPrefix &>(transaction));
+
+        for (size_t i = 0; i < inputCount; i++)
+        {
+            const auto &owned = m_ownedOutputs[realOutputs[i]];
+
+            const auto &ring = rings[i];
+
+            std::vector<Crypto::PublicKey> publicKeys;
+
+            /* Our ring members are our own outputs, so we know their keys -
+               and global index n is our n'th output on top of whatever the
+               genesis block paid out */
+            const uint32_t firstIndex = m_ownedOutputs.front().globalIndex;
+
+            for (const auto globalIndex : ring)
+            {
+                publicKeys.push_back(m_ownedOutputs[globalIndex - firstIndex].key);
+            }
+
+            const uint64_t realPosition = std::find(ring.begin(), ring.end(), owned.globalIndex) - ring.begin();
+
+            const auto [success, signatures] = Crypto::crypto_ops::generateRingSignatures(
+                prefixHash,
+                boost::get<CryptoNote::KeyInput>(transaction.inputs[i]).keyImage,
+                publicKeys,
+                owned.secretKey,
+                realPosition);
+
+            if (!success)
+            {
+                throw std::runtime_error("Failed to sign synthetic transaction");
+            }
+
+            transaction.signatures.push_back(signatures);
+        }
+
+        return transaction;
+    }
+
+    CryptoNote::Transaction FixtureGenerator::makeUnsignedTransaction(
+        const size_t inputCount,
+        const size_t ringSize,
+        const size_t outputCount,
+        const uint64_t fee)
+    {
+        if (m_ownedOutputs.empty())
+        {
+            throw std::runtime_error("Build a chain before making transactions");
+        }
+
+        std::uniform_int_distribution<size_t> distribution(0, m_ownedOutputs.size() - 1);
+
+        std::vector<size_t> realOutputs;
+
+        for (size_t i = 0; i < inputCount; i++)
+        {
+            realOutputs.push_back(distribution(m_random));
+        }
+
+        std::vector<std::vector<uint32_t>> rings;
+
+        auto transaction = makeTransactionPrefix(realOutputs, ringSize, outputCount, fee, rings);
+
+        for (auto &input : transaction.inputs)
+        {
+            const Crypto::Hash keyImage = nextHash();
+
+            boost::get<CryptoNote::KeyInput>(input).keyImage = reinterpret_cast<const Crypto::KeyImage &>(keyImage);
+
+            std::vector<Crypto::Signature> signatures(ringSize);
+
+            for (auto &signature : signatures)
+            {
+                const Crypto::Hash first = nextHash();
+                const Crypto::Hash second = nextHash();
+
+                std::copy(std::begin(first.data), std::end(first.data), std::begin(signature.data));
+                std::copy(std::begin(second.data), std::end(second.data), std::begin(signature.data) + 32);
+            }
+
+            transaction.signatures.push_back(signatures);
+        }
+
+        return transaction;
+    }
+
+    std::vector<WalletTypes::WalletBlockInfo> FixtureGenerator::makeWalletBlocks(
+        const size_t blockCount,
+        const size_t transactionsPerBlock,
+        const size_t outputsPerTransaction,
+        const size_t ownedEvery,
+        const Crypto::PublicKey &publicSpendKey,
+        const Crypto::PublicKey &publicViewKey)
+    {
+        std::vector<WalletTypes::WalletBlockInfo> blocks;
+
+        uint64_t globalIndex = 0;
+
+        uint64_t outputCount = 0;
+
+        for (size_t height = 0; height < blockCount; height++)
+        {
+            WalletTypes::WalletBlockInfo block;
+
+            block.blockHeight = height;
+            block.blockHash = nextHash();
+            block.blockTimestamp =
+                m_currency.genesisBlock().timestamp + height * CryptoNote::parameters::DIFFICULTY_TARGET;
+
+            WalletTypes::RawCoinbaseTransaction coinbase;
+
+            coinbase.hash = nextHash();
+            coinbase.transactionPublicKey = std::get<0>(nextKeys());
+            coinbase.unlockTime = height + CryptoNote::parameters::CRYPTONOTE_MINED_MONEY_UNLOCK_WINDOW;
+            coinbase.keyOutputs.push_back({std::get<0>(nextKeys()), FIXTURE_OUTPUT_AMOUNT, globalIndex++});
+
+            block.coinbaseTransaction = coinbase;
+
+            for (size_t i = 0; i < transactionsPerBlock; i++)
+            {
+                WalletTypes::RawTransaction transaction;
+
+                const auto [transactionPublicKey, transactionSecretKey] = nextKeys();
+
+                Crypto::KeyDerivation derivation;
+
+                Crypto::generate_key_derivation(publicViewKey, transactionSecretKey, derivation);
+
+                transaction.hash = nextHash();
+                transaction.transactionPublicKey = transactionPublicKey;
+                transaction.unlockTime = 0;
+
+                for (size_t j = 0; j < outputsPerTransaction; j++)
+                {
+                    Crypto::PublicKey key;
+
+                    if (ownedEvery != 0 && outputCount++ % ownedEvery == 0)
+                    {
+                        Crypto::derive_public_key(derivation, j, publicSpendKey, key);
+                    }
+                    else
+                    {
+                        key = std::get<0>(nextKeys());
+                    }
+
+                    transaction.keyOutputs.push_back({key, FIXTURE_OUTPUT_AMOUNT, globalIndex++});
+                }
+
+                const Crypto::Hash keyImage = nextHash();
+
+                transaction.keyInputs.push_back(
+                    {FIXTURE_OUTPUT_AMOUNT, {0, 1, 1, 1}, reinterpret_cast<const Crypto::KeyImage &>(keyImage)});
+
+                block.transactions.push_back(transaction);
+            }
+
+            blocks.push_back(block);
+        }
+
+        return blocks;
+    }
+
+} // namespace Benchmarks
@@ -0,0 +1,117 @@
+// Copyright (c) 2018-2020, The TurtleCoin Developers
+//
+// Please see the included LICENSE file for more information.
+
+#pragma once
+
+#include <CryptoNote.h>
+#include <WalletTypes.h>
+#include <cryptonotecore/Currency.h>
+#include <cryptonotecore/IBlockchainCache.h>
+#include <random>
+#include <tuple>
+#include <vector>
+
+namespace Benchmarks
+{
+    /* Every output on the synthetic chain is for this amount, so any of them
+       can be used in a ring with any other. Picked to not clash with the
+       genesis block outputs. */
+    const uint64_t FIXTURE_OUTPUT_AMOUNT = 7'777'777;
+
+    /* A synthetic output we know the secret key for */
+    struct OwnedOutput
+    {
+        uint32_t globalIndex;
+
+        Crypto::PublicKey key;
+
+        Crypto::SecretKey secretKey;
+    };
+
+    /* Generates chains, transactions and wallet sync data to benchmark
+       against. Keys are derived from the seed rather than the system random
+       number generator, so the same seed always gives the same fixtures. */
+    class FixtureGenerator
+    {
+      public:
+        FixtureGenerator(const CryptoNote::Currency &currency, const uint64_t seed);
+
+        /* Pushes blockCount blocks on top of cache, each with only a
+           coinbase transaction paying outputsPerBlock outputs of
+           FIXTURE_OUTPUT_AMOUNT to keys we hold. Outputs are remembered
+           across calls, so only build one chain per generator. Returns the
+           hashes of the coinbase transactions. */
+        std::vector<Crypto::Hash> buildChain(
+            CryptoNote::IBlockchainCache &cache,
+            const uint32_t blockCount,
+            const size_t outputsPerBlock);
+
+        /* The outputs buildChain() has paid, in global index order */
+        const std::vector<OwnedOutput> &ownedOutputs() const;
+
+        /* A correctly signed transaction spending inputCount chain outputs,
+           each hidden among ringSize - 1 decoys, into outputCount outputs,
+           leaving fee over. Successive calls spend different outputs, until
+           they run out. */
+        CryptoNote::Transaction makeSpendingTransaction(
+            const size_t inputCount,
+            const size_t ringSize,
+            const size_t outputCount,
+            const uint64_t fee);
+
+        /* A transaction of the same shape, with random key images and
+           signatures, for when only the shape matters - the pool and
+           serialization don't check signatures. */
+        CryptoNote::Transaction makeUnsignedTransaction(
+            const size_t inputCount,
+            const size_t ringSize,
+            const size_t outputCount,
+            const uint64_t fee);
+
+        /* Blocks as a wallet gets them from /getwalletsyncdata. Every
+           ownedEvery'th output is sent to the given address. */
+        std::vector<WalletTypes::WalletBlockInfo> makeWalletBlocks(
+            const size_t blockCount,
+            const size_t transactionsPerBlock,
+            const size_t outputsPerTransaction,
+            const size_t ownedEvery,
+            const Crypto::PublicKey &publicSpendKey,
+            const Crypto::PublicKey &publicViewKey);
+
+        /* The next key pair from the seeded sequence */
+        std::tuple<Crypto::PublicKey, Crypto::SecretKey> nextKeys();
+
+        Crypto::Hash nextHash();
+
+      private:
+        /* Inputs spending the given indexes into m_ownedOutputs, with the
+           ring of global indexes used for each stored in rings */
+        CryptoNote::Transaction makeTransactionPrefix(
+            const std::vector<size_t> &realOutputs,
+            const size_t ringSize,
+            const size_t outputCount,
+            const uint64_t fee,
+            std::vector<std::vector<uint32_t>> &rings);
+
+        /* ringSize distinct global indexes including that of
+           m_ownedOutputs[realIndex], sorted */
+        std::vector<uint32_t> pickRing(const uint32_t realIndex, const size_t ringSize);
+
+        const CryptoNote::Currency &m_currency;
+
+        uint64_t m_seed;
+
+        /* Incremented for every key or hash handed out */
+        uint64_t m_counter = 0;
+
+        /* Picks decoys and unsigned inputs */
+        std::mt19937_64 m_random;
+
+        std::vector<OwnedOutput> m_ownedOutputs;
+
+        /* Index into m_ownedOutputs of the next output to spend */
+        size_t m_nextUnspent = 0;
+    };
+
+} // namespace Benchmarks
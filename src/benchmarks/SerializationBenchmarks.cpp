@@ -0,0 +1,558 @@
+// Copyright (c) 2018-2020, The TurtleCoin Developers
+//
+// Please see the included LICENSE file for more information.
+
+////////////////////////////////
+#include "Benchmarks.h"
+////////////////////////////////
+
+#include "Fixtures.h"
+#include "rapidjson/document.h"
+#include "rapidjson/stringbuffer.h"
+#include "rapidjson/writer.h"
+
+#include <JsonHelper.h>
+#include <common/CryptoNoteTools.h>
+#include <common/JsonRequestBody.h>
+#include <common/StringTools.h>
+#include <cryptonotecore/BlockchainCache.h>
+#include <cryptonotecore/CachedTransaction.h>
+#include <cryptonotecore/TransactionView.h>
+#include <logging/DummyLogger.h>
+#include <serialization/BinaryCodec.h>
+#include <stdexcept>
+
+namespace Benchmarks
+{
+    namespace
+    {
+        /* Transactions to (de)serialize in each sample */
+        const size_t TRANSACTION_COUNT = 256;
+
+        /* Transactions in the synthetic block - a busy block on the network */
+        const size_t BLOCK_TRANSACTIONS = 100;
+
+        /* Wallet sync data is requested 100 blocks at a time */
+        const size_t WALLET_BLOCKS = 100;
+
+        /* Entries in the bulk API request bodies - a large payout, or a
+           status check on everything a service has sent */
+        const size_t REQUEST_ENTRIES = 2000;
+
+        struct SerializationState
+        {
+            SerializationState(const BenchmarkConfig &config):
+                config(config),
+                logger(std::make_shared<Logging::DummyLogger>()),
+                currency(CryptoNote::CurrencyBuilder(logger).currency())
+            {
+            }
+
+            const BenchmarkConfig config;
+
+            std::shared_ptr<Logging::ILogger> logger;
+
+            const CryptoNote::Currency currency;
+
+            std::vector<CryptoNote::Transaction> transactions;
+
+            std::vector<CryptoNote::BinaryArray> transactionBlobs;
+
+            CryptoNote::BlockTemplate block;
+
+            CryptoNote::BinaryArray blockBlob;
+
+            std::vector<WalletTypes::WalletBlockInfo> walletBlocks;
+
+            std::string walletBlocksJSON;
+
+            /* Body of a /transactions/send/advanced request */
+            std::string sendRequestJSON;
+
+            /* Body of a /transaction/status request */
+            std::string statusRequestJSON;
+        };
+
+        void prepareTransactions(SerializationState &state)
+        {
+            if (!state.transactions.empty())
+            {
+                return;
+            }
+
+            CryptoNote::BlockchainCache cache("", state.currency, state.logger, nullptr);
+
+            FixtureGenerator generator(state.currency, state.config.seed);
+
+            generator.buildChain(cache, static_cast<uint32_t>(state.config.chainHeight), state.config.outputsPerBlock);
+
+            for (size_t i = 0; i < TRANSACTION_COUNT; i++)
+            {
+                state.transactions.push_back(generator.makeUnsignedTransaction(
+                    2, state.config.ringSize, 4, CryptoNote::parameters::MINIMUM_FEE));
+
+                state.transactionBlobs.push_back(CryptoNote::toBinaryArray(state.transactions.back()));
+            }
+
+            /* Any coinbase will do, take it from the chain we just built */
+            const auto topBlock = cache.getBlockByIndex(cache.getTopBlockIndex());
+
+            state.block = CryptoNote::fromBinaryArray<CryptoNote::BlockTemplate>(topBlock.block);
+
+            for (size_t i = 0; i < BLOCK_TRANSACTIONS; i++)
+            {
+                state.block.transactionHashes.push_back(generator.nextHash());
+            }
+
+            state.blockBlob = CryptoNote::toBinaryArray(state.block);
+        }
+
+        /* The ISerializer path toBinaryArray() took before BinaryCodec, kept
+           here so the two can be compared */
+        template<typename T> CryptoNote::BinaryArray legacyToBinaryArray(const T &object)
+        {
+            CryptoNote::BinaryArray ba;
+            Common::VectorOutputStream stream(ba);
+            CryptoNote::BinaryOutputStreamSerializer serializer(stream);
+            serialize(const_cast<T &>(object), serializer);
+            return ba;
+        }
+
+        template<typename T> T legacyFromBinaryArray(const CryptoNote::BinaryArray &ba)
+        {
+            T object;
+            Common::MemoryInputStream stream(ba.data(), ba.size());
+            CryptoNote::BinaryInputStreamSerializer serializer(stream);
+            serialize(object, serializer);
+
+            if (!stream.endOfStream())
+            {
+                throw std::runtime_error("failed to unpack type");
+            }
+
+            return object;
+        }
+
+        void prepareWalletBlocks(SerializationState &state)
+        {
+            if (!state.walletBlocks.empty())
+            {
+                return;
+            }
+
+            FixtureGenerator generator(state.currency, state.config.seed);
+
+            /* Nothing is sent to this wallet, only the encoding matters here */
+            const auto publicSpendKey = std::get<0>(generator.nextKeys());
+            const auto publicViewKey = std::get<0>(generator.nextKeys());
+
+            state.walletBlocks = generator.makeWalletBlocks(WALLET_BLOCKS, 10, 4, 0, publicSpendKey, publicViewKey);
+
+            rapidjson::StringBuffer sb;
+            rapidjson::Writer<rapidjson::StringBuffer> writer(sb);
+
+            writer.StartArray();
+            {
+                for (const auto &block : state.walletBlocks)
+                {
+                    block.toJSON(writer);
+                }
+            }
+            writer.EndArray();
+
+            state.walletBlocksJSON = sb.GetString();
+        }
+
+        void prepareRequests(SerializationState &state)
+        {
+            if (!state.sendRequestJSON.empty())
+            {
+                return;
+            }
+
+            FixtureGenerator generator(state.currency, state.config.seed);
+
+            rapidjson::StringBuffer sendBuffer;
+            rapidjson::Writer<rapidjson::StringBuffer> sendWriter(sendBuffer);
+
+            rapidjson::StringBuffer statusBuffer;
+            rapidjson::Writer<rapidjson::StringBuffer> statusWriter(statusBuffer);
+
+            sendWriter.StartObject();
+            sendWriter.Key("deadline");
+            sendWriter.Uint64(0);
+            sendWriter.Key("destinations");
+            sendWriter.StartArray();
+
+            statusWriter.StartArray();
+
+            for (size_t i = 0; i < REQUEST_ENTRIES; i++)
+            {
+                /* Only the length of the address matters here */
+                const std::string hash = Common::podToHex(generator.nextHash());
+
+                sendWriter.StartObject();
+                sendWriter.Key("address");
+                sendWriter.String("TRTL" + hash + hash.substr(0, 31));
+                sendWriter.Key("amount");
+                sendWriter.Uint64(1000 + i);
+                sendWriter.EndObject();
+
+                statusWriter.String(hash);
+            }
+
+            sendWriter.EndArray();
+            sendWriter.EndObject();
+
+            statusWriter.EndArray();
+
+            state.sendRequestJSON = sendBuffer.GetString();
+            state.statusRequestJSON = statusBuffer.GetString();
+        }
+
+        /* Reads the body as ApiDispatcher::makeAdvancedTransaction() does */
+        size_t readSendRequest(const rapidjson::Document &body)
+        {
+            std::vector<std::pair<std::string, uint64_t>> destinations;
+
+            for (const auto &destination : getArrayFromJSON(body, "destinations"))
+            {
+                destinations.emplace_back(
+                    getStringFromJSON(destination, "address"), getUint64FromJSON(destination, "amount"));
+            }
+
+            return destinations.size();
+        }
+    } // namespace
+
+    void registerSerializationBenchmarks(BenchmarkRunner &runner, const BenchmarkConfig &config)
+    {
+        const auto state = std::make_shared<SerializationState>(config);
+
+        runner.add(
+            {"serialization/transaction/toBinaryArray", [state]() { prepareTransactions(*state); }, nullptr, [state]() {
+                 size_t size = 0;
+
+                 for (const auto &transaction : state->transactions)
+                 {
+                     size += CryptoNote::toBinaryArray(transaction).size();
+                 }
+
+                 if (size == 0)
+                 {
+                     throw std::runtime_error("Transaction serialized to nothing");
+                 }
+
+                 return state->transactions.size();
+             }});
+
+        runner.add(
+            {"serialization/transaction/fromBinaryArray",
+             [state]() { prepareTransactions(*state); },
+             nullptr,
+             [state]() {
+                 for (const auto &blob : state->transactionBlobs)
+                 {
+                     const auto transaction = CryptoNote::fromBinaryArray<CryptoNote::Transaction>(blob);
+
+                     if (transaction.inputs.empty())
+                     {
+                         throw std::runtime_error("Transaction deserialized without inputs");
+                     }
+                 }
+
+                 return state->transactionBlobs.size();
+             }});
+
+        runner.add(
+            {"serialization/block/toBinaryArray", [state]() { prepareTransactions(*state); }, nullptr, [state]() {
+                 if (CryptoNote::toBinaryArray(state->block).size() != state->blockBlob.size())
+                 {
+                     throw std::runtime_error("Block serialized to a different size");
+                 }
+
+                 return 1;
+             }});
+
+        runner.add(
+            {"serialization/block/fromBinaryArray", [state]() { prepareTransactions(*state); }, nullptr, [state]() {
+                 const auto block = CryptoNote::fromBinaryArray<CryptoNote::BlockTemplate>(state->blockBlob);
+
+                 if (block.transactionHashes.size() != BLOCK_TRANSACTIONS)
+                 {
+                     throw std::runtime_error("Block deserialized with the wrong transactions");
+                 }
+
+                 return 1;
+             }});
+
+        runner.add(
+            {"serialization/transaction/legacyToBinaryArray",
+             [state]() { prepareTransactions(*state); },
+             nullptr,
+             [state]() {
+                 size_t size = 0;
+
+                 for (const auto &transaction : state->transactions)
+                 {
+                     size += legacyToBinaryArray(transaction).size();
+                 }
+
+                 if (size == 0)
+                 {
+                     throw std::runtime_error("Transaction serialized to nothing");
+                 }
+
+                 return state->transactions.size();
+             }});
+
+        runner.add(
+            {"serialization/transaction/legacyFromBinaryArray",
+             [state]() { prepareTransactions(*state); },
+             nullptr,
+             [state]() {
+                 for (const auto &blob : state->transactionBlobs)
+                 {
+                     const auto transaction = legacyFromBinaryArray<CryptoNote::Transaction>(blob);
+
+                     if (transaction.inputs.empty())
+                     {
+                         throw std::runtime_error("Transaction deserialized without inputs");
+                     }
+                 }
+
+                 return state->transactionBlobs.size();
+             }});
+
+        /* Decoding into the same object each time, as a sync loop would, so
+           its storage is reused */
+        runner.add(
+            {"serialization/transaction/decodeInPlace",
+             [state]() { prepareTransactions(*state); },
+             nullptr,
+             [state]() {
+                 CryptoNote::Transaction transaction;
+
+                 for (const auto &blob : state->transactionBlobs)
+                 {
+                     using Codec = CryptoNote::BinaryCodec<CryptoNote::Transaction>;
+
+                     if (Codec::decode(transaction, blob.data(), blob.size()) != blob.size())
+                     {
+                         throw std::runtime_error("Transaction deserialized with trailing data");
+                     }
+                 }
+
+                 return state->transactionBlobs.size();
+             }});
+
+        runner.add(
+            {"serialization/transaction/getObjectBinarySize",
+             [state]() { prepareTransactions(*state); },
+             nullptr,
+             [state]() {
+                 for (size_t i = 0; i < state->transactions.size(); i++)
+                 {
+                     if (CryptoNote::getObjectBinarySize(state->transactions[i]) != state->transactionBlobs[i].size())
+                     {
+                         throw std::runtime_error("Transaction size doesn't match its serialization");
+                     }
+                 }
+
+                 return state->transactions.size();
+             }});
+
+        runner.add(
+            {"serialization/block/legacyToBinaryArray", [state]() { prepareTransactions(*state); }, nullptr, [state]() {
+                 if (legacyToBinaryArray(state->block) != state->blockBlob)
+                 {
+                     throw std::runtime_error("Block serialized differently");
+                 }
+
+                 return 1;
+             }});
+
+        runner.add(
+            {"serialization/block/legacyFromBinaryArray",
+             [state]() { prepareTransactions(*state); },
+             nullptr,
+             [state]() {
+                 const auto block = legacyFromBinaryArray<CryptoNote::BlockTemplate>(state->blockBlob);
+
+                 if (block.transactionHashes.size() != BLOCK_TRANSACTIONS)
+                 {
+                     throw std::runtime_error("Block deserialized with the wrong transactions");
+                 }
+
+                 return 1;
+             }});
+
+        /* Getting at the fields of a transaction off the wire, read in place
+           and by deserializing it. Hashing costs the same either way, so it's
+           left out */
+        runner.add(
+            {"serialization/transaction/view", [state]() { prepareTransactions(*state); }, nullptr, [state]() {
+                 uint64_t fees = 0;
+
+                 for (const auto &blob : state->transactionBlobs)
+                 {
+                     const CryptoNote::TransactionView view(blob);
+
+                     fees += view.getTransactionFee();
+                 }
+
+                 if (fees == 0)
+                 {
+                     throw std::runtime_error("Transactions viewed without fees");
+                 }
+
+                 return state->transactionBlobs.size();
+             }});
+
+        runner.add(
+            {"serialization/transaction/cachedTransaction",
+             [state]() { prepareTransactions(*state); },
+             nullptr,
+             [state]() {
+                 uint64_t fees = 0;
+
+                 for (const auto &blob : state->transactionBlobs)
+                 {
+                     const CryptoNote::CachedTransaction transaction(blob);
+
+                     fees += transaction.getTransactionFee();
+                 }
+
+                 if (fees == 0)
+                 {
+                     throw std::runtime_error("Transactions deserialized without fees");
+                 }
+
+                 return state->transactionBlobs.size();
+             }});
+
+        /* The body of a /getwalletsyncdata response, which is the bulk of what
+           the daemon encodes and wallets decode */
+        runner.add(
+            {"json/walletSyncData/encode", [state]() { prepareWalletBlocks(*state); }, nullptr, [state]() {
+                 rapidjson::StringBuffer sb;
+                 rapidjson::Writer<rapidjson::StringBuffer> writer(sb);
+
+                 writer.StartArray();
+                 {
+                     for (const auto &block : state->walletBlocks)
+                     {
+                         block.toJSON(writer);
+                     }
+                 }
+                 writer.EndArray();
+
+                 if (sb.GetSize() != state->walletBlocksJSON.size())
+                 {
+                     throw std::runtime_error("Wallet sync data encoded to a different size");
+                 }
+
+                 return state->walletBlocks.size();
+             }});
+
+        runner.add(
+            {"json/walletSyncData/decode", [state]() { prepareWalletBlocks(*state); }, nullptr, [state]() {
+                 rapidjson::Document j;
+
+                 if (j.Parse(state->walletBlocksJSON).HasParseError())
+                 {
+                     throw std::runtime_error("Failed to parse wallet sync data");
+                 }
+
+                 std::vector<WalletTypes::WalletBlockInfo> blocks;
+
+                 for (const auto &item : j.GetArray())
+                 {
+                     WalletTypes::WalletBlockInfo block;
+                     block.fromJSON(item);
+                     blocks.push_back(block);
+                 }
+
+                 return blocks.size();
+             }});
+
+        /* API request bodies, parsed as they were before JsonRequestBody, and
+           with it */
+        runner.add(
+            {"json/sendRequest/parse", [state]() { prepareRequests(*state); }, nullptr, [state]() {
+                 rapidjson::Document body;
+
+                 if (body.Parse(state->sendRequestJSON.c_str()).HasParseError())
+                 {
+                     throw std::runtime_error("Failed to parse send request");
+                 }
+
+                 return readSendRequest(body);
+             }});
+
+        runner.add(
+            {"json/sendRequest/parseInSitu", [state]() { prepareRequests(*state); }, nullptr, [state]() {
+                 Common::JsonRequestBody body;
+
+                 if (!body.parse(state->sendRequestJSON))
+                 {
+                     throw std::runtime_error("Failed to parse send request");
+                 }
+
+                 return readSendRequest(body.document());
+             }});
+
+        runner.add(
+            {"json/statusRequest/parse", [state]() { prepareRequests(*state); }, nullptr, [state]() {
+                 rapidjson::Document body;
+
+                 if (body.Parse(state->statusRequestJSON.c_str()).HasParseError())
+                 {
+                     throw std::runtime_error("Failed to parse status request");
+                 }
+
+                 std::vector<Crypto::Hash> hashes;
+
+                 for (const auto &hashStr : getArrayFromJSON(body))
+                 {
+                     Crypto::Hash hash;
+
+                     if (!Common::podFromHex(getStringFromJSON(hashStr), hash))
+                     {
+                         throw std::runtime_error("Failed to decode hash");
+                     }
+
+                     hashes.push_back(hash);
+                 }
+
+                 return hashes.size();
+             }});
+
+        runner.add(
+            {"json/statusRequest/parseInSitu", [state]() { prepareRequests(*state); }, nullptr, [state]() {
+                 Common::JsonRequestBody body;
+
+                 if (!body.parse(state->statusRequestJSON))
+                 {
+                     throw std::runtime_error("Failed to parse status request");
+                 }
+
+                 std::vector<Crypto::Hash> hashes;
+
+                 for (const auto &hashStr : getArrayFromJSON(body.document()))
+                 {
+                     Crypto::Hash hash;
+
+                     if (!Common::podFromHex(getStringViewFromJSON(hashStr), hash))
+                     {
+                         throw std::runtime_error("Failed to decode hash");
+                     }
+
+                     hashes.push_back(hash);
+                 }
+
+                 return hashes.size();
+             }});
+    }
+
+} // namespace Benchmarks
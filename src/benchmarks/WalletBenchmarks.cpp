@@ -0,0 +1,147 @@
+// Copyright (c) 2018-2020, The TurtleCoin Developers
+//
+// Please see the included LICENSE file for more information.
+
+////////////////////////////////
+#include "Benchmarks.h"
+////////////////////////////////
+
+#include "Fixtures.h"
+
+#include <logging/DummyLogger.h>
+#include <stdexcept>
+#include <utilities/Addresses.h>
+#include <walletbackend/WalletSynchronizer.h>
+
+namespace Benchmarks
+{
+    namespace
+    {
+        /* One /getwalletsyncdata response worth */
+        const size_t WALLET_BLOCKS = 100;
+
+        const size_t TRANSACTIONS_PER_BLOCK = 10;
+
+        const size_t OUTPUTS_PER_TRANSACTION = 4;
+
+        /* A fairly busy wallet - one in every 16 outputs is ours */
+        const size_t OWNED_EVERY = 16;
+    } // namespace
+
+    /* Friend of WalletSynchronizer, so it can time the block processing the
+       sync thread does without needing a daemon */
+    class WalletSynchronizerBenchmark
+    {
+      public:
+        WalletSynchronizerBenchmark(const BenchmarkConfig &config):
+            m_config(config),
+            m_currency(CryptoNote::CurrencyBuilder(std::make_shared<Logging::DummyLogger>()).currency())
+        {
+        }
+
+        void prepare()
+        {
+            if (m_synchronizer)
+            {
+                return;
+            }
+
+            FixtureGenerator generator(m_currency, m_config.seed);
+
+            const auto [publicSpendKey, privateSpendKey] = generator.nextKeys();
+            const auto [publicViewKey, privateViewKey] = generator.nextKeys();
+
+            m_blocks = generator.makeWalletBlocks(
+                WALLET_BLOCKS,
+                TRANSACTIONS_PER_BLOCK,
+                OUTPUTS_PER_TRANSACTION,
+                OWNED_EVERY,
+                publicSpendKey,
+                publicViewKey);
+
+            /* Never connects, we don't start the sync thread */
+            const auto daemon = std::make_shared<Nigel>("127.0.0.1", 0, false);
+
+            m_synchronizer = std::make_unique<WalletSynchronizer>(daemon, 0, 0, privateViewKey, nullptr, 1);
+
+            const std::string address = Utilities::privateKeysToAddress(privateSpendKey, privateViewKey);
+
+            m_synchronizer->setSubWallets(
+                std::make_shared<SubWallets>(privateSpendKey, privateViewKey, address, 0, true));
+
+            for (const auto &block : m_blocks)
+            {
+                m_blockInputs.push_back(m_synchronizer->processBlockOutputs(block));
+            }
+        }
+
+        /* Finding our outputs - a key derivation per transaction, and an
+           underive per output */
+        uint64_t processBlockOutputs() const
+        {
+            size_t found = 0;
+
+            for (const auto &block : m_blocks)
+            {
+                found += m_synchronizer->processBlockOutputs(block).size();
+            }
+
+            if (found == 0)
+            {
+                throw std::runtime_error("Wallet didn't find its outputs");
+            }
+
+            return m_blocks.size();
+        }
+
+        /* Turning the outputs we found into transactions */
+        uint64_t processBlockTransactions() const
+        {
+            size_t found = 0;
+
+            for (size_t i = 0; i < m_blocks.size(); i++)
+            {
+                const auto scanInfo = m_synchronizer->processBlockTransactions(m_blocks[i], m_blockInputs[i]);
+
+                found += scanInfo.transactionsToAdd.size();
+            }
+
+            if (found == 0)
+            {
+                throw std::runtime_error("Wallet didn't find its transactions");
+            }
+
+            return m_blocks.size();
+        }
+
+      private:
+        const BenchmarkConfig m_config;
+
+        const CryptoNote::Currency m_currency;
+
+        std::unique_ptr<WalletSynchronizer> m_synchronizer;
+
+        std::vector<WalletTypes::WalletBlockInfo> m_blocks;
+
+        /* processBlockOutputs() of each block */
+        std::vector<BlockInputsAndOwners> m_blockInputs;
+    };
+
+    void registerWalletBenchmarks(BenchmarkRunner &runner, const BenchmarkConfig &config)
+    {
+        const auto benchmark = std::make_shared<WalletSynchronizerBenchmark>(config);
+
+        runner.add(
+            {"wallet/processBlockOutputs",
+             [benchmark]() { benchmark->prepare(); },
+             nullptr,
+             [benchmark]() { return benchmark->processBlockOutputs(); }});
+
+        runner.add(
+            {"wallet/processBlockTransactions",
+             [benchmark]() { benchmark->prepare(); },
+             nullptr,
+             [benchmark]() { return benchmark->processBlockTransactions(); }});
+    }
+
+} // namespace Benchmarks
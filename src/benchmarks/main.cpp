@@ -0,0 +1,62 @@
+// Copyright (c) 2018-2020, The TurtleCoin Developers
+//
+// Please see the included LICENSE file for more information.
+
+#include "Benchmarks.h"
+
+#include <iostream>
+#include <utilities/ColouredMsg.h>
+
+int main(int argc, char **argv)
+{
+    Benchmarks::BenchmarkConfig config;
+
+    try
+    {
+        config.parse(argc, argv);
+
+        Benchmarks::BenchmarkRunner runner(config);
+
+        Benchmarks::registerCoreBenchmarks(runner, config);
+        Benchmarks::registerSerializationBenchmarks(runner, config);
+        Benchmarks::registerWalletBenchmarks(runner, config);
+
+        if (config.list)
+        {
+            for (const auto &name : runner.selected())
+            {
+                std::cout << name << std::endl;
+            }
+
+            return 0;
+        }
+
+        const auto results = runner.run();
+
+        if (!config.outputFile.empty())
+        {
+            Benchmarks::writeResults(results, config.outputFile);
+
+            std::cout << SuccessMsg("\nWrote results to " + config.outputFile) << std::endl;
+        }
+
+        if (!config.baselineFile.empty())
+        {
+            const auto regressions =
+                Benchmarks::compareToBaseline(results, Benchmarks::readResults(config.baselineFile), config.threshold);
+
+            if (regressions != 0)
+            {
+                std::cout << WarningMsg("\n" + std::to_string(regressions) + " benchmark(s) regressed") << std::endl;
+                return 1;
+            }
+        }
+    }
+    catch (const std::exception &e)
+    {
+        std::cout << WarningMsg("Unhandled exception caught: ") << WarningMsg(e.what()) << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,387 @@
+// Copyright (c) 2018-2020, The TurtleCoin Developers
+//
+// Please see the included LICENSE file for more information.
+
+////////////////////////////////
+#include "ChainReplay.h"
+////////////////////////////////
+
+#include <common/CryptoNoteTools.h>
+#include <common/StringTools.h>
+#include <cryptonotecore/BlockchainCache.h>
+#include <cryptonotecore/CachedBlock.h>
+#include <cryptonotecore/CoreErrors.h>
+#include <cryptonotecore/DatabaseBlockchainCache.h>
+#include <cryptonotecore/DatabaseBlockchainCacheFactory.h>
+#include <cryptonotecore/LevelDBWrapper.h>
+#include <cryptonotecore/MainChainStorage.h>
+#include <cryptonotecore/MemoryBlockchainCacheFactory.h>
+#include <cryptonotecore/RocksDBWrapper.h>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <logging/DummyLogger.h>
+#include <random>
+#include <sstream>
+#include <system/Dispatcher.h>
+#include <utilities/ColouredMsg.h>
+#include <utilities/Tracing.h>
+
+namespace fs = std::filesystem;
+
+namespace ChainReplay
+{
+    namespace
+    {
+        double toSeconds(const std::chrono::nanoseconds duration)
+        {
+            return std::chrono::duration<double>(duration).count();
+        }
+
+        Crypto::Hash getBlockHash(const CryptoNote::RawBlock &rawBlock)
+        {
+            const auto block = CryptoNote::fromBinaryArray<CryptoNote::BlockTemplate>(rawBlock.block);
+
+            return CryptoNote::CachedBlock(block).getBlockHash();
+        }
+
+        template<typename Function> std::chrono::nanoseconds timed(Function function)
+        {
+            const auto startTime = std::chrono::steady_clock::now();
+
+            function();
+
+            return std::chrono::steady_clock::now() - startTime;
+        }
+    } // namespace
+
+    ChainReplay::ChainReplay(const ChainReplayConfig &config):
+        m_config(config),
+        /* Core logs every 100 blocks, which would drown out our progress */
+        m_logger(std::make_shared<Logging::DummyLogger>()),
+        m_currency(CryptoNote::CurrencyBuilder(m_logger).currency())
+    {
+    }
+
+    ChainReplay::~ChainReplay()
+    {
+        closeDatabase();
+
+        if (m_temporaryDataDirectory)
+        {
+            std::error_code ec;
+            fs::remove_all(m_dataDirectory, ec);
+        }
+    }
+
+    void ChainReplay::openDatabase()
+    {
+        m_dbConfig = std::make_unique<CryptoNote::DataBaseConfig>(
+            m_dataDirectory,
+            m_config.dbThreads,
+            m_config.dbMaxOpenFiles,
+            m_config.dbWriteBufferSizeMB,
+            m_config.dbReadCacheSizeMB,
+            m_config.dbMaxFileSizeMB,
+            m_config.enableDbCompression);
+
+        std::shared_ptr<CryptoNote::IDataBase> database;
+
+        if (m_config.storage == StorageType::LevelDB)
+        {
+            database = std::make_shared<CryptoNote::LevelDBWrapper>(m_logger);
+        }
+        else
+        {
+            database = std::make_shared<CryptoNote::RocksDBWrapper>(m_logger);
+        }
+
+        database->init(*m_dbConfig);
+
+        /* Only set once it's open, so closeDatabase() knows to shut it down */
+        m_database = database;
+
+        if (!CryptoNote::DatabaseBlockchainCache::checkDBSchemeVersion(*m_database, m_logger))
+        {
+            m_database->shutdown();
+            m_database->destroy(*m_dbConfig);
+            m_database->init(*m_dbConfig);
+        }
+    }
+
+    void ChainReplay::closeDatabase()
+    {
+        if (m_database)
+        {
+            m_database->shutdown();
+            m_database.reset();
+        }
+    }
+
+    std::unique_ptr<CryptoNote::IBlockchainCacheFactory> ChainReplay::makeCacheFactory()
+    {
+        if (m_config.storage == StorageType::Memory)
+        {
+            const auto filename = (fs::path(m_dataDirectory) / "blockchaincache.bin").string();
+
+            /* The root cache is loaded from this file when Core starts, so
+               seed it with a cache holding just the genesis block */
+            CryptoNote::BlockchainCache(filename, m_currency, m_logger, nullptr, 0).save();
+
+            return std::make_unique<CryptoNote::MemoryBlockchainCacheFactory>(filename, m_logger);
+        }
+
+        openDatabase();
+
+        return std::make_unique<CryptoNote::DatabaseBlockchainCacheFactory>(*m_database, m_logger);
+    }
+
+    CryptoNote::Checkpoints ChainReplay::makeCheckpoints(const CryptoNote::IMainChainStorage &source) const
+    {
+        CryptoNote::Checkpoints checkpoints(m_logger);
+
+        if (!m_config.checkpointsFile.empty() && !checkpoints.loadCheckpointsFromFile(m_config.checkpointsFile))
+        {
+            throw std::runtime_error("Failed to load checkpoints from " + m_config.checkpointsFile);
+        }
+
+        if (m_config.checkpointHeight != 0)
+        {
+            if (m_config.checkpointHeight >= source.getBlockCount())
+            {
+                throw std::runtime_error("--checkpoint-height is above the top of the source chain");
+            }
+
+            const auto height = static_cast<uint32_t>(m_config.checkpointHeight);
+
+            const auto hash = getBlockHash(source.getBlockByIndex(height));
+
+            /* Everything at or below the highest checkpoint is in the
+               checkpoint zone */
+            if (!checkpoints.addCheckpoint(height, Common::podToHex(hash)))
+            {
+                throw std::runtime_error("--checkpoint-height clashes with a checkpoint from --load-checkpoints");
+            }
+        }
+
+        return checkpoints;
+    }
+
+    void ChainReplay::run()
+    {
+        const fs::path sourceDirectory(m_config.sourceDirectory);
+
+        const auto blocksFile = sourceDirectory / m_currency.blocksFileName();
+        const auto indexesFile = sourceDirectory / m_currency.blockIndexesFileName();
+
+        /* MainChainStorage would happily create empty ones */
+        if (!fs::exists(blocksFile) || !fs::exists(indexesFile))
+        {
+            throw std::runtime_error(
+                "Couldn't find " + blocksFile.string() + " and " + indexesFile.string()
+                + ". Is --source a daemon data directory?");
+        }
+
+        const CryptoNote::MainChainStorage source(blocksFile.string(), indexesFile.string());
+
+        Tracing::tracer().setEnabled(!m_config.traceFile.empty());
+
+        if (source.getBlockCount() == 0 || getBlockHash(source.getBlockByIndex(0)) != m_currency.genesisBlockHash())
+        {
+            throw std::runtime_error("The source chain has a different genesis block to this build");
+        }
+
+        if (m_config.dataDirectory.empty())
+        {
+            m_dataDirectory = (fs::temp_directory_path() / ("chainreplay-" + std::to_string(std::random_device()())))
+                                  .string();
+
+            m_temporaryDataDirectory = true;
+        }
+        else
+        {
+            m_dataDirectory = m_config.dataDirectory;
+
+            /* Core would import the existing chain rather than replay it */
+            if (fs::exists(fs::path(m_dataDirectory) / m_currency.blocksFileName()))
+            {
+                throw std::runtime_error(
+                    "--data-dir already contains a chain. Point it at an empty directory, or leave it out.");
+            }
+        }
+
+        fs::create_directories(m_dataDirectory);
+
+        /* The genesis block is added when the chain is created */
+        const uint64_t available = source.getBlockCount() - 1;
+
+        const uint64_t blockCount =
+            m_config.blockCount == 0 ? available : std::min<uint64_t>(m_config.blockCount, available);
+
+        std::cout << InformationMsg("Replaying ") << SuccessMsg(blockCount) << InformationMsg(" blocks from ")
+                  << SuccessMsg(sourceDirectory.string()) << InformationMsg(" into ")
+                  << SuccessMsg(m_dataDirectory) << "\n\n";
+
+        System::Dispatcher dispatcher;
+
+        auto core = std::make_unique<CryptoNote::Core>(
+            m_currency,
+            m_logger,
+            makeCheckpoints(source),
+            dispatcher,
+            makeCacheFactory(),
+            CryptoNote::createSwappedMainChainStorage(m_dataDirectory, m_currency),
+            m_config.transactionValidationThreads);
+
+        core->load();
+
+        ReplayStats stats;
+
+        ReplayStats lastReport;
+
+        for (uint32_t height = 1; height <= blockCount; height++)
+        {
+            const auto blockStart = std::chrono::steady_clock::now();
+
+            CryptoNote::RawBlock rawBlock;
+
+            stats.read += timed([&]() { rawBlock = source.getBlockByIndex(height); });
+
+            CryptoNote::BlockTemplate blockTemplate;
+
+            /* Holds a reference to blockTemplate */
+            std::unique_ptr<CryptoNote::CachedBlock> cachedBlock;
+
+            stats.deserialize += timed([&]() {
+                blockTemplate = CryptoNote::fromBinaryArray<CryptoNote::BlockTemplate>(rawBlock.block);
+
+                cachedBlock = std::make_unique<CryptoNote::CachedBlock>(blockTemplate);
+
+                /* Hashed lazily otherwise, and we want it in this stage */
+                cachedBlock->getBlockHash();
+            });
+
+            if (m_config.verifyPoW)
+            {
+                const uint64_t difficulty = core->getDifficultyForNextBlock();
+
+                stats.pow += timed([&]() {
+                    if (!m_currency.checkProofOfWork(*cachedBlock, difficulty))
+                    {
+                        stats.weakPoW++;
+                    }
+                });
+            }
+
+            stats.transactions += rawBlock.transactions.size() + 1;
+            stats.bytes += rawBlock.block.size();
+
+            for (const auto &transaction : rawBlock.transactions)
+            {
+                stats.bytes += transaction.size();
+            }
+
+            const auto result = core->addBlock(*cachedBlock, std::move(rawBlock));
+
+            if (result != CryptoNote::error::AddBlockErrorCode::ADDED_TO_MAIN)
+            {
+                throw std::runtime_error(
+                    "Block " + std::to_string(height) + " (" + Common::podToHex(cachedBlock->getBlockHash())
+                    + ") was not added to the main chain: " + result.message());
+            }
+
+            stats.total += std::chrono::steady_clock::now() - blockStart;
+            stats.blocks++;
+
+            if (height % m_config.reportInterval == 0)
+            {
+                printProgress(stats, lastReport, height);
+
+                lastReport = stats;
+            }
+        }
+
+        const auto coreTimings = core->getBlockProcessingTimings();
+
+        /* Flush everything to disk before the database is closed */
+        core.reset();
+
+        printSummary(stats, coreTimings);
+
+        if (!m_config.traceFile.empty())
+        {
+            std::ofstream(m_config.traceFile) << Tracing::tracer().dump(std::numeric_limits<uint64_t>::max());
+
+            std::cout << InformationMsg("Wrote tracing spans to ") << m_config.traceFile << std::endl;
+        }
+    }
+
+    void ChainReplay::printProgress(const ReplayStats &stats, const ReplayStats &lastReport, const uint64_t height)
+        const
+    {
+        const double intervalSeconds = toSeconds(stats.total - lastReport.total);
+
+        const double blocksPerSecond = intervalSeconds > 0 ? (stats.blocks - lastReport.blocks) / intervalSeconds : 0;
+
+        std::cout << InformationMsg("Height ") << std::setw(10) << height << InformationMsg("  ") << std::fixed
+                  << std::setprecision(1) << std::setw(10) << blocksPerSecond << InformationMsg(" blocks/s  ")
+                  << std::setw(10) << toSeconds(stats.total) << InformationMsg(" s elapsed") << std::endl;
+    }
+
+    void ChainReplay::printSummary(
+        const ReplayStats &stats,
+        const CryptoNote::BlockProcessingTimings &coreTimings) const
+    {
+        const double totalSeconds = toSeconds(stats.total);
+
+        /* Transactions are deserialized in Core, the header by us */
+        const auto deserialize = stats.deserialize + coreTimings.deserialize;
+
+        const auto accounted = stats.read + deserialize + stats.pow + coreTimings.blockValidation
+                               + coreTimings.transactionValidation + coreTimings.storage;
+
+        const std::vector<std::tuple<std::string, std::chrono::nanoseconds>> stages = {
+            {"Read", stats.read},
+            {"Deserialize", deserialize},
+            {"Proof of work", stats.pow},
+            {"Block validation", coreTimings.blockValidation},
+            {"Transaction validation", coreTimings.transactionValidation},
+            {"DB write", coreTimings.storage},
+            {"Other", stats.total > accounted ? stats.total - accounted : std::chrono::nanoseconds(0)},
+        };
+
+        std::cout << "\n"
+                  << InformationMsg("Replayed ") << SuccessMsg(stats.blocks) << InformationMsg(" blocks and ")
+                  << SuccessMsg(stats.transactions) << InformationMsg(" transactions (")
+                  << SuccessMsg(stats.bytes / 1024 / 1024) << InformationMsg(" MiB) in ") << std::fixed
+                  << std::setprecision(2) << SuccessMsg(totalSeconds) << InformationMsg(" seconds") << "\n\n";
+
+        std::cout << std::left << std::setw(26) << "Stage" << std::right << std::setw(14) << "Total (s)"
+                  << std::setw(16) << "Per block (us)" << std::setw(10) << "Share" << "\n";
+
+        for (const auto &[name, duration] : stages)
+        {
+            const double seconds = toSeconds(duration);
+
+            std::cout << std::left << std::setw(26) << name << std::right << std::fixed << std::setprecision(3)
+                      << std::setw(14) << seconds << std::setprecision(1) << std::setw(16)
+                      << (stats.blocks > 0 ? seconds * 1e6 / stats.blocks : 0) << std::setw(9)
+                      << (totalSeconds > 0 ? seconds / totalSeconds * 100 : 0) << "%\n";
+        }
+
+        std::cout << "\n"
+                  << InformationMsg("Blocks per second:       ") << std::setprecision(1)
+                  << SuccessMsg(totalSeconds > 0 ? stats.blocks / totalSeconds : 0) << "\n"
+                  << InformationMsg("Transactions per second: ")
+                  << SuccessMsg(totalSeconds > 0 ? stats.transactions / totalSeconds : 0) << std::endl;
+
+        if (m_config.verifyPoW && stats.weakPoW != 0)
+        {
+            std::cout << WarningMsg("\n" + std::to_string(stats.weakPoW) + " blocks had too weak a proof of work")
+                      << std::endl;
+        }
+    }
+
+} // namespace ChainReplay
@@ -0,0 +1,85 @@
+// Copyright (c) 2018-2020, The TurtleCoin Developers
+//
+// Please see the included LICENSE file for more information.
+
+#pragma once
+
+#include "ChainReplayConfig.h"
+
+#include <IDataBase.h>
+#include <chrono>
+#include <cryptonotecore/Core.h>
+#include <cryptonotecore/Currency.h>
+#include <logging/ILogger.h>
+#include <memory>
+
+namespace ChainReplay
+{
+    /* What the replay has done so far. Stages timed by the replay itself
+       rather than Core */
+    struct ReplayStats
+    {
+        uint64_t blocks = 0;
+
+        uint64_t transactions = 0;
+
+        /* Raw block and transaction bytes */
+        uint64_t bytes = 0;
+
+        /* Reading the block from the source blocks.bin */
+        std::chrono::nanoseconds read {0};
+
+        /* Deserializing and hashing the block header */
+        std::chrono::nanoseconds deserialize {0};
+
+        std::chrono::nanoseconds pow {0};
+
+        /* Blocks whose proof of work was too weak, when verifying it */
+        uint64_t weakPoW = 0;
+
+        /* Everything, including the stages above and Core::addBlock() */
+        std::chrono::nanoseconds total {0};
+    };
+
+    /* Replays an existing chain into a fresh Core, with no network, timing
+       each stage of block processing */
+    class ChainReplay
+    {
+      public:
+        ChainReplay(const ChainReplayConfig &config);
+
+        ~ChainReplay();
+
+        void run();
+
+      private:
+        void openDatabase();
+
+        void closeDatabase();
+
+        std::unique_ptr<CryptoNote::IBlockchainCacheFactory> makeCacheFactory();
+
+        CryptoNote::Checkpoints makeCheckpoints(const CryptoNote::IMainChainStorage &source) const;
+
+        void printProgress(const ReplayStats &stats, const ReplayStats &lastReport, const uint64_t height) const;
+
+        void printSummary(const ReplayStats &stats, const CryptoNote::BlockProcessingTimings &coreTimings) const;
+
+        const ChainReplayConfig m_config;
+
+        std::shared_ptr<Logging::ILogger> m_logger;
+
+        const CryptoNote::Currency m_currency;
+
+        /* Where the new chain is built */
+        std::string m_dataDirectory;
+
+        /* Whether we made m_dataDirectory, and so should remove it */
+        bool m_temporaryDataDirectory = false;
+
+        std::shared_ptr<CryptoNote::IDataBase> m_database;
+
+        std::unique_ptr<CryptoNote::DataBaseConfig> m_dbConfig;
+    };
+
+} // namespace ChainReplay
@@ -0,0 +1,192 @@
+// Copyright (c) 2018-2020, The TurtleCoin Developers
+//
+// Please see the included LICENSE file for more information.
+
+////////////////////////////////
+#include "ChainReplayConfig.h"
+////////////////////////////////
+
+#include <config/CliHeader.h>
+#include <config/CryptoNoteConfig.h>
+#include <cxxopts.hpp>
+#include <iostream>
+#include <thread>
+#include <utilities/ColouredMsg.h>
+
+namespace ChainReplay
+{
+    namespace
+    {
+        StorageType parseStorageType(const std::string &str)
+        {
+            if (str == "rocksdb")
+            {
+                return StorageType::RocksDB;
+            }
+            else if (str == "leveldb")
+            {
+                return StorageType::LevelDB;
+            }
+            else if (str == "memory")
+            {
+                return StorageType::Memory;
+            }
+
+            throw std::runtime_error("--storage must be one of rocksdb, leveldb, memory");
+        }
+    } // namespace
+
+    ChainReplayConfig::ChainReplayConfig():
+        enableDbCompression(false),
+        verifyPoW(false),
+        help(false),
+        version(false)
+    {
+    }
+
+    void ChainReplayConfig::parse(int argc, char **argv)
+    {
+        cxxopts::Options options(argv[0], CryptoNote::getProjectCLIHeader());
+
+        std::string storageStr;
+
+        options.add_options("Core")(
+            "help", "Display this help message", cxxopts::value<bool>(help)->implicit_value("true"))(
+            "version",
+            "Output software version information",
+            cxxopts::value<bool>(version)->default_value("false")->implicit_value("true"));
+
+        options.add_options("Source")(
+            "source",
+            "Data directory containing the " + std::string(CryptoNote::parameters::CRYPTONOTE_BLOCKS_FILENAME) + " and "
+                + CryptoNote::parameters::CRYPTONOTE_BLOCKINDEXES_FILENAME + " to replay",
+            cxxopts::value<std::string>(sourceDirectory),
+            "<path>")(
+            "blocks",
+            "Stop after replaying this many blocks. 0 replays the whole chain",
+            cxxopts::value<uint64_t>(blockCount)->default_value("0"),
+            "#");
+
+        options.add_options("Storage")(
+            "storage",
+            "Blockchain cache to replay into: rocksdb, leveldb or memory",
+            cxxopts::value<std::string>(storageStr)->default_value("rocksdb"),
+            "<type>")(
+            "data-dir",
+            "Directory to build the new chain in. Defaults to a temporary directory, which is removed afterwards",
+            cxxopts::value<std::string>(dataDirectory),
+            "<path>")(
+            "db-enable-compression",
+            "Enable database compression",
+            cxxopts::value<bool>(enableDbCompression)->default_value("false")->implicit_value("true"))(
+            "db-max-open-files",
+            "Number of files that can be used by the database at one time",
+            cxxopts::value<uint64_t>(dbMaxOpenFiles),
+            "#")(
+            "db-read-buffer-size",
+            "Size of the database read cache in megabytes (MB)",
+            cxxopts::value<uint64_t>(dbReadCacheSizeMB),
+            "#")(
+            "db-threads",
+            "Number of background threads used for compaction and flush operations (RocksDB only)",
+            cxxopts::value<uint64_t>(dbThreads)->default_value(std::to_string(CryptoNote::ROCKSDB_BACKGROUND_THREADS)),
+            "#")(
+            "db-write-buffer-size",
+            "Size of the database write buffer in megabytes (MB)",
+            cxxopts::value<uint64_t>(dbWriteBufferSizeMB),
+            "#")(
+            "db-max-file-size",
+            "Max file size of database files in megabytes (MB) (LevelDB only)",
+            cxxopts::value<uint64_t>(dbMaxFileSizeMB)
+                ->default_value(std::to_string(CryptoNote::LEVELDB_MAX_FILE_SIZE_MB)),
+            "#");
+
+        options.add_options("Validation")(
+            "transaction-validation-threads",
+            "Number of threads to use to validate a transaction's inputs in parallel",
+            cxxopts::value<uint32_t>(transactionValidationThreads)
+                ->default_value(std::to_string(std::max(1u, std::thread::hardware_concurrency()))),
+            "#")(
+            "load-checkpoints",
+            "Specify a file <path> containing a CSV of Blockchain checkpoints",
+            cxxopts::value<std::string>(checkpointsFile),
+            "<path>")(
+            "checkpoint-height",
+            "Treat the source chain up to this height as checkpointed, so those blocks skip the expensive checks",
+            cxxopts::value<uint64_t>(checkpointHeight)->default_value("0"),
+            "#")(
+            "verify-pow",
+            "Check the proof of work of every block, and time it",
+            cxxopts::value<bool>(verifyPoW)->default_value("false")->implicit_value("true"));
+
+        options.add_options("Output")(
+            "report-interval",
+            "Print progress every this many blocks",
+            cxxopts::value<uint64_t>(reportInterval)->default_value("10000"),
+            "#")(
+            "trace-file",
+            "Record tracing spans, and write the most recent to <path> for chrome://tracing or Perfetto",
+            cxxopts::value<std::string>(traceFile),
+            "<path>");
+
+        try
+        {
+            const auto result = options.parse(argc, argv);
+
+            const bool levelDB = storageStr == "leveldb";
+
+            /* Same defaults as the daemon */
+            if (result.count("db-max-open-files") == 0)
+            {
+                dbMaxOpenFiles = levelDB ? CryptoNote::LEVELDB_MAX_OPEN_FILES : CryptoNote::ROCKSDB_MAX_OPEN_FILES;
+            }
+
+            if (result.count("db-read-buffer-size") == 0)
+            {
+                dbReadCacheSizeMB = levelDB ? CryptoNote::LEVELDB_READ_BUFFER_MB : CryptoNote::ROCKSDB_READ_BUFFER_MB;
+            }
+
+            if (result.count("db-write-buffer-size") == 0)
+            {
+                dbWriteBufferSizeMB =
+                    levelDB ? CryptoNote::LEVELDB_WRITE_BUFFER_MB : CryptoNote::ROCKSDB_WRITE_BUFFER_MB;
+            }
+        }
+        catch (const cxxopts::OptionException &e)
+        {
+            std::cout << WarningMsg("Error: Unable to parse command line argument options: ") << WarningMsg(e.what())
+                      << "\n\n";
+            std::cout << options.help({}) << std::endl;
+            exit(1);
+        }
+
+        if (help) // Do we want to display the help message?
+        {
+            std::cout << options.help({}) << std::endl;
+            exit(0);
+        }
+        else if (version) // Do we want to display the software version?
+        {
+            std::cout << InformationMsg(CryptoNote::getProjectCLIHeader()) << std::endl;
+            exit(0);
+        }
+
+        if (sourceDirectory.empty())
+        {
+            throw std::runtime_error("--source must be given");
+        }
+
+        storage = parseStorageType(storageStr);
+
+        if (transactionValidationThreads == 0)
+        {
+            throw std::runtime_error("--transaction-validation-threads must not be zero");
+        }
+
+        if (reportInterval == 0)
+        {
+            throw std::runtime_error("--report-interval must not be zero");
+        }
+    }
+
+} // namespace ChainReplay
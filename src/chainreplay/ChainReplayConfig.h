@@ -0,0 +1,77 @@
+// Copyright (c) 2018-2020, The TurtleCoin Developers
+//
+// Please see the included LICENSE file for more information.
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace ChainReplay
+{
+    enum class StorageType
+    {
+        RocksDB,
+
+        LevelDB,
+
+        /* No database, everything is held in BlockchainCache */
+        Memory
+    };
+
+    struct ChainReplayConfig
+    {
+        ChainReplayConfig();
+
+        void parse(int argc, char **argv);
+
+        /* Data directory holding the blocks.bin and blockindexes.bin to replay */
+        std::string sourceDirectory;
+
+        /* Stop after replaying this many blocks. 0 for the whole chain */
+        uint64_t blockCount;
+
+        StorageType storage;
+
+        /* Where to build the new chain. Empty for a temporary directory, which
+           is removed afterwards */
+        std::string dataDirectory;
+
+        uint64_t dbThreads;
+
+        uint64_t dbMaxOpenFiles;
+
+        uint64_t dbWriteBufferSizeMB;
+
+        uint64_t dbReadCacheSizeMB;
+
+        uint64_t dbMaxFileSizeMB;
+
+        bool enableDbCompression;
+
+        uint32_t transactionValidationThreads;
+
+        /* Checkpoint file to load, as used by the daemon's --load-checkpoints */
+        std::string checkpointsFile;
+
+        /* Treat the source chain up to this height as checkpointed, skipping
+           the expensive checks for those blocks. 0 to not */
+        uint64_t checkpointHeight;
+
+        /* Check the proof of work of every block. The daemon doesn't, but
+           it's the cost we'd pay if it did */
+        bool verifyPoW;
+
+        /* Print progress every this many blocks */
+        uint64_t reportInterval;
+
+        /* Record tracing spans, and write the most recent of them here at the
+           end. Empty to not trace */
+        std::string traceFile;
+
+        bool help;
+
+        bool version;
+    };
+
+} // namespace ChainReplay
@@ -0,0 +1,29 @@
+// Copyright (c) 2018-2020, The TurtleCoin Developers
+//
+// Please see the included LICENSE file for more information.
+
+#include "ChainReplay.h"
+
+#include <iostream>
+#include <utilities/ColouredMsg.h>
+
+int main(int argc, char **argv)
+{
+    ChainReplay::ChainReplayConfig config;
+
+    try
+    {
+        config.parse(argc, argv);
+
+        ChainReplay::ChainReplay replay(config);
+
+        replay.run();
+    }
+    catch (const std::exception &e)
+    {
+        std::cout << WarningMsg("Unhandled exception caught: ") << WarningMsg(e.what()) << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -24,6 +24,21 @@ namespace CryptoNote
 
     template<class T> bool getObjectBinarySize(const T &object, size_t &size)
     {
+        /* Count the bytes, rather than building the buffer */
+        if constexpr (BinaryCodec<T>::specialised)
+        {
+            try
+            {
+                size = BinaryCodec<T>::size(object);
+                return true;
+            }
+            catch (const std::exception &)
+            {
+                size = (std::numeric_limits<size_t>::max)();
+                return false;
+            }
+        }
+
         BinaryArray ba;
         if (!toBinaryArray(object, ba))
         {
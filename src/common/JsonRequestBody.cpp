@@ -0,0 +1,37 @@
+// Copyright (c) 2018-2020, The TurtleCoin Developers
+//
+// Please see the included LICENSE file for more information.
+
+///////////////////////////////////
+#include <common/JsonRequestBody.h>
+///////////////////////////////////
+
+namespace Common
+{
+    JsonRequestBody::JsonRequestBody(): m_allocator(m_pool, sizeof(m_pool)), m_document(&m_allocator) {}
+
+    bool JsonRequestBody::parse(const std::string &body)
+    {
+        m_text = body;
+
+        if (!m_document.ParseInsitu(&m_text[0]).HasParseError())
+        {
+            return true;
+        }
+
+        /* Parsing in place has overwritten the text, so start again from the
+           body, this time in quotes */
+        m_text.clear();
+        m_text.reserve(body.size() + 2);
+        m_text += '"';
+        m_text += body;
+        m_text += '"';
+
+        return !m_document.ParseInsitu(&m_text[0]).HasParseError();
+    }
+
+    const rapidjson::Document &JsonRequestBody::document() const
+    {
+        return m_document;
+    }
+} // namespace Common
@@ -0,0 +1,52 @@
+// Copyright (c) 2018-2020, The TurtleCoin Developers
+//
+// Please see the included LICENSE file for more information.
+
+#pragma once
+
+#include "rapidjson/document.h"
+
+#include <string>
+
+namespace Common
+{
+    /* The parsed JSON body of an API request.
+
+       The body is parsed in place, so strings in the document point into our
+       own copy of the body rather than each being copied out of it, and the
+       document allocates out of a buffer held here, only going to the heap
+       once that's used up. Only large requests allocate more than a couple of
+       times.
+
+       The document points into this object, so it can't be copied or moved.
+       Make one per request, and keep it around while the document is used. */
+    class JsonRequestBody
+    {
+      public:
+        JsonRequestBody();
+
+        JsonRequestBody(const JsonRequestBody &) = delete;
+
+        JsonRequestBody &operator=(const JsonRequestBody &) = delete;
+
+        /* Returns false if the body isn't JSON. A body that's a bare string,
+           such as a hex blob, without quotes around it, is taken as a JSON
+           string */
+        bool parse(const std::string &body);
+
+        const rapidjson::Document &document() const;
+
+      private:
+        /* Enough for the values of any ordinary request */
+        static constexpr size_t POOL_SIZE = 16 * 1024;
+
+        char m_pool[POOL_SIZE];
+
+        /* The parsed text, which the document's strings point into */
+        std::string m_text;
+
+        rapidjson::MemoryPoolAllocator<> m_allocator;
+
+        rapidjson::Document m_document;
+    };
+} // namespace Common
@@ -8,6 +8,10 @@
 #include <fstream>
 #include <iomanip>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 namespace Common
 {
     namespace
@@ -29,6 +33,43 @@ namespace Common
             0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
             0xff, 0xff, 0xff, 0xff};
 
+#if defined(__SSE2__)
+        /* Decodes 16 hex characters into 8 bytes, returning false if any of
+           them isn't hex. Bytes are compared as signed, which is fine, since
+           anything over 0x7f comes out negative and so out of every range */
+        bool fromHex16(const char *text, uint8_t *data)
+        {
+            const __m128i characters = _mm_loadu_si128(reinterpret_cast<const __m128i *>(text));
+
+            const __m128i isDigit = _mm_and_si128(
+                _mm_cmpgt_epi8(characters, _mm_set1_epi8('0' - 1)),
+                _mm_cmplt_epi8(characters, _mm_set1_epi8('9' + 1)));
+
+            /* Folds 'A' to 'F' onto 'a' to 'f', and nothing else onto them */
+            const __m128i lower = _mm_or_si128(characters, _mm_set1_epi8(0x20));
+
+            const __m128i isLetter = _mm_and_si128(
+                _mm_cmpgt_epi8(lower, _mm_set1_epi8('a' - 1)), _mm_cmplt_epi8(lower, _mm_set1_epi8('f' + 1)));
+
+            if (_mm_movemask_epi8(_mm_or_si128(isDigit, isLetter)) != 0xffff)
+            {
+                return false;
+            }
+
+            const __m128i nibbles = _mm_or_si128(
+                _mm_and_si128(isDigit, _mm_sub_epi8(characters, _mm_set1_epi8('0'))),
+                _mm_and_si128(isLetter, _mm_sub_epi8(lower, _mm_set1_epi8('a' - 10))));
+
+            /* Each 16 bit lane holds a pair of characters, the high nibble in
+               the low byte - combine them into the low byte, then pack */
+            const __m128i bytes = _mm_or_si128(
+                _mm_and_si128(_mm_slli_epi16(nibbles, 4), _mm_set1_epi16(0x00f0)), _mm_srli_epi16(nibbles, 8));
+
+            _mm_storel_epi64(reinterpret_cast<__m128i *>(data), _mm_packus_epi16(bytes, bytes));
+
+            return true;
+        }
+#endif
     }
 
     std::string asString(const void *data, uint64_t size)
@@ -89,7 +130,7 @@ namespace Common
         return text.size() >> 1;
     }
 
-    bool fromHex(const std::string &text, void *data, uint64_t bufferSize, uint64_t &size)
+    bool fromHex(std::string_view text, void *data, uint64_t bufferSize, uint64_t &size)
     {
         if ((text.size() & 1) != 0)
         {
@@ -101,7 +142,20 @@ namespace Common
             return false;
         }
 
-        for (uint64_t i = 0; i < (text.size() >> 1); ++i)
+        uint64_t i = 0;
+
+#if defined(__SSE2__)
+        //RTcoin
+        for (; i + 8 <= (text.size() >> 1); i += 8)
+        {
+            if (!fromHex16(text.data() + (i << 1), static_cast<uint8_t *>(data) + i))
+            {
+                return false;
+            }
+        }
+#endif
+
+        for (; i < (text.size() >> 1); ++i)
         {
             uint8_t value1;
             if (!fromHex(text[i << 1], value1))
@@ -8,6 +8,7 @@
 #include <cstdint>
 #include <sstream>
 #include <stdexcept>
+#include <string_view>
 #include <vector>
 
 namespace Common
@@ -27,7 +28,7 @@ namespace Common
         uint64_t bufferSize); // Assigns values of hex 'text' to buffer 'data' up to 'bufferSize', returns actual data
                               // size, throws on error
     bool fromHex(
-        const std::string &text,
+        std::string_view text,
         void *data,
         uint64_t bufferSize,
         uint64_t &size); // Assigns values of hex 'text' to buffer 'data' up to 'bufferSize', assigns actual data size
@@ -37,7 +38,10 @@ namespace Common
         const std::string &text,
         std::vector<uint8_t> &data); // Appends values of hex 'text' to 'data', returns false on error, does not throw
 
-    template<typename T> bool podFromHex(const std::string &text, T &val)
+    //RTcoin
+    /* Takes a string_view so hex can be decoded straight out of a parsed
+       JSON document, without copying it into a std::string first */
+    template<typename T> bool podFromHex(std::string_view text, T &val)
     {
         uint64_t outSize;
         return fromHex(text, &val, sizeof(val), outSize) && outSize == sizeof(val);
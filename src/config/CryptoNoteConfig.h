@@ -7,6 +7,7 @@
 #pragma once
 
 #include <boost/uuid/uuid.hpp>
+#include <crypto/chukwa-batch.h>
 #include <crypto/hash.h>
 #include <cstddef>
 #include <cstdint>
@@ -225,6 +226,15 @@ namespace CryptoNote
             7; // CRYPTONOTE_NUMBER_OF_PERIODS_TO_FORGET_TX_DELETED_FROM_POOL * CRYPTONOTE_MEMPOOL_TX_LIVETIME = time to
                // forget tx
 
+        //RTcoin
+        // Shortest gap the adaptive block policy leaves between blocks
+        const uint64_t BLOCK_CADENCE_MIN_INTERVAL = 250; // milliseconds
+
+        // Largest block the adaptive block policy builds, as a percentage of the median block size. Consensus allows
+        // up to 200%, but the reward penalty grows with the square of the excess: 25% of the reward at 150%, all of
+        // it at 200%
+        const uint64_t BLOCK_CADENCE_MAX_SIZE_PERCENT = 150;
+
         const size_t FUSION_TX_MAX_SIZE = CRYPTONOTE_BLOCK_GRANTED_FULL_REWARD_ZONE_CURRENT * 30 / 100;
 
         const size_t FUSION_TX_MIN_INPUT_COUNT = 12;
@@ -326,8 +336,29 @@ namespace CryptoNote
             {BLOCK_MAJOR_VERSION_7, Crypto::chukwa_slow_hash_v2} /* UPGRADE_HEIGHT_V7 */
     };
 
+    //RTcoin
+    /* Hashing algorithms that can hash several blocks in one call. Versions
+       without an entry here are hashed one at a time with the algorithm
+       above. */
+    const std::unordered_map<
+        uint8_t,
+        std::function<void(const uint8_t *const *data, const size_t *lengths, Crypto::Hash *hashes, size_t count)>>
+        BATCH_HASHING_ALGORITHMS_BY_BLOCK_VERSION = {
+            {BLOCK_MAJOR_VERSION_6, Crypto::chukwa_slow_hash_v1_batch}, /* UPGRADE_HEIGHT_V6 */
+            {BLOCK_MAJOR_VERSION_7, Crypto::chukwa_slow_hash_v2_batch} /* UPGRADE_HEIGHT_V7 */
+    };
+
+    /* How many blocks to hand the algorithms above at once to get the most
+       hashes per second out of this machine */
+    const std::unordered_map<uint8_t, std::function<size_t()>> BATCH_HASHING_SIZES_BY_BLOCK_VERSION = {
+        {BLOCK_MAJOR_VERSION_6, Crypto::chukwa_preferred_lanes_v1}, /* UPGRADE_HEIGHT_V6 */
+        {BLOCK_MAJOR_VERSION_7, Crypto::chukwa_preferred_lanes_v2} /* UPGRADE_HEIGHT_V7 */
+    };
+
     const size_t BLOCKS_IDS_SYNCHRONIZING_DEFAULT_COUNT = 10'000; // by default, blocks ids count in synchronizing
     const uint64_t BLOCKS_SYNCHRONIZING_DEFAULT_COUNT = 100; // by default, blocks count in blocks downloading
+    //RTcoin
+    const uint64_t BLOCKS_SYNCHRONIZING_LOW_MEMORY_COUNT = 10; // blocks count in downloading when memory is short
     const size_t COMMAND_RPC_GET_BLOCKS_FAST_MAX_COUNT = 1'000;
 
     const int P2P_DEFAULT_PORT = 10101;
@@ -354,7 +385,13 @@ namespace CryptoNote
     const uint8_t P2P_UPGRADE_WINDOW = 2;
 
     const size_t P2P_CONNECTION_MAX_WRITE_BUFFER_SIZE = 32 * 1024 * 1024; // 32 MB
+    //RTcoin
+    // When the write queues together are over their memory allowance, connections are dropped past this instead
+    const size_t P2P_CONNECTION_LOW_MEMORY_WRITE_BUFFER_SIZE = 1024 * 1024; // 1 MB
     const uint32_t P2P_DEFAULT_CONNECTIONS_COUNT = 8;
+    //RTcoin
+    // Time we expect a relayed transaction to take to reach the next peer and get through its pool
+    const uint32_t P2P_TRANSACTION_HOP_TIME = 100; // milliseconds
 
     const size_t P2P_DEFAULT_WHITELIST_CONNECTIONS_PERCENT = 70;
 
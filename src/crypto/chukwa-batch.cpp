@@ -0,0 +1,744 @@
+// Copyright (c) 2018-2020, The TurtleCoin Developers
+//
+// Please see the included LICENSE file for more information.
+
+#include "chukwa-batch.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <vector>
+
+extern "C"
+{
+#include <argon2/lib/blake2/blake2.h>
+}
+
+/* The interleaved kernel relies on GCC / Clang vector extensions, and is
+   only built for lane widths that fit in the vector registers we target */
+#if defined(__GNUC__) && (defined(__SSE2__) || defined(__ARM_NEON))
+#define CHUKWA_INTERLEAVED
+#endif
+
+#if defined(CHUKWA_INTERLEAVED) && defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace Crypto
+{
+    namespace
+    {
+        const uint32_t ARGON2_BLOCK_SIZE = 1024;
+
+        const uint32_t ARGON2_WORDS_IN_BLOCK = ARGON2_BLOCK_SIZE / sizeof(uint64_t);
+
+        const uint32_t ARGON2_ADDRESSES_PER_BLOCK = 128;
+
+        const uint32_t ARGON2_PREHASH_LENGTH = 64;
+
+        const uint64_t MASK_32 = UINT64_C(0xFFFFFFFF);
+
+        void selectArgon2Implementation()
+        {
+            /* See chukwa_slow_hash_base() */
+            if (!argon2_optimization_selected)
+            {
+                argon2_select_impl(NULL, NULL);
+
+                argon2_optimization_selected = true;
+            }
+        }
+
+        /* Hashes the inputs one at a time with the Argon2 library, reusing
+           the same memory for each of them */
+        void hashSequentially(
+            const uint8_t *const *data,
+            const size_t *lengths,
+            Hash *hashes,
+            const size_t count,
+            const size_t iterations,
+            const size_t memory,
+            const size_t threads)
+        {
+            selectArgon2Implementation();
+
+            thread_local std::vector<uint64_t> scratchpad;
+
+            const size_t memorySize = argon2_memory_size(memory, threads);
+
+            if (scratchpad.size() * sizeof(uint64_t) < memorySize)
+            {
+                scratchpad.resize(memorySize / sizeof(uint64_t));
+            }
+
+            for (size_t i = 0; i < count; i++)
+            {
+                uint8_t salt[CHUKWA_SALTLEN];
+                memcpy(salt, data[i], sizeof(salt));
+
+                argon2_context context = {};
+
+                context.out = hashes[i].data;
+                context.outlen = CHUKWA_HASHLEN;
+                context.pwd = const_cast<uint8_t *>(data[i]);
+                context.pwdlen = static_cast<uint32_t>(lengths[i]);
+                context.salt = salt;
+                context.saltlen = CHUKWA_SALTLEN;
+                context.t_cost = static_cast<uint32_t>(iterations);
+                context.m_cost = static_cast<uint32_t>(memory);
+                context.lanes = static_cast<uint32_t>(threads);
+                context.threads = static_cast<uint32_t>(threads);
+                context.version = ARGON2_VERSION_NUMBER;
+                context.flags = ARGON2_DEFAULT_FLAGS;
+
+                argon2_ctx_mem(&context, Argon2_id, scratchpad.data(), scratchpad.size() * sizeof(uint64_t));
+            }
+        }
+
+#if defined(CHUKWA_INTERLEAVED)
+
+        /* One 64 bit word from each lane */
+        template<size_t Lanes> struct LaneVector
+        {
+            typedef uint64_t Type __attribute__((vector_size(Lanes * sizeof(uint64_t))));
+        };
+
+        /* lo(x) * lo(y). Left to itself, the compiler does a full 64 bit
+           multiply here, which is far slower than the 32 x 32 -> 64 bit
+           multiply every x86 vector extension has. */
+        inline uint64_t multiplyLow(const uint64_t x, const uint64_t y)
+        {
+            return (x & MASK_32) * (y & MASK_32);
+        }
+
+        template<typename Word> inline Word multiplyLow(const Word &x, const Word &y)
+        {
+            return (x & MASK_32) * (y & MASK_32);
+        }
+
+#if defined(__SSE2__)
+        inline LaneVector<2>::Type multiplyLow(const LaneVector<2>::Type &x, const LaneVector<2>::Type &y)
+        {
+            return (LaneVector<2>::Type)_mm_mul_epu32((__m128i)x, (__m128i)y);
+        }
+#endif
+
+#if defined(__AVX2__)
+        inline LaneVector<4>::Type multiplyLow(const LaneVector<4>::Type &x, const LaneVector<4>::Type &y)
+        {
+            return (LaneVector<4>::Type)_mm256_mul_epu32((__m256i)x, (__m256i)y);
+        }
+#endif
+
+#if defined(__AVX512F__)
+        inline LaneVector<8>::Type multiplyLow(const LaneVector<8>::Type &x, const LaneVector<8>::Type &y)
+        {
+            return (LaneVector<8>::Type)_mm512_maskz_mul_epu32(0xFF, (__m512i)x, (__m512i)y);
+        }
+#endif
+
+#define CHUKWA_ROTR64(x, n) (((x) >> (n)) | ((x) << (64 - (n))))
+
+/* The Argon2 multiply-add, x + y + 2 * lo(x) * lo(y) */
+#define CHUKWA_BLAMKA(x, y) ((x) + (y) + 2 * multiplyLow(x, y))
+
+#define CHUKWA_G(a, b, c, d)              \
+    do                                    \
+    {                                     \
+        a = CHUKWA_BLAMKA(a, b);          \
+        d = CHUKWA_ROTR64(d ^ a, 32);     \
+        c = CHUKWA_BLAMKA(c, d);          \
+        b = CHUKWA_ROTR64(b ^ c, 24);     \
+        a = CHUKWA_BLAMKA(a, b);          \
+        d = CHUKWA_ROTR64(d ^ a, 16);     \
+        c = CHUKWA_BLAMKA(c, d);          \
+        b = CHUKWA_ROTR64(b ^ c, 63);     \
+    } while (0)
+
+#define CHUKWA_ROUND(v, i0, i1, i2, i3, i4, i5, i6, i7, i8, i9, i10, i11, i12, i13, i14, i15) \
+    do                                                                                      \
+    {                                                                                       \
+        CHUKWA_G(v[i0], v[i4], v[i8], v[i12]);                                              \
+        CHUKWA_G(v[i1], v[i5], v[i9], v[i13]);                                              \
+        CHUKWA_G(v[i2], v[i6], v[i10], v[i14]);                                             \
+        CHUKWA_G(v[i3], v[i7], v[i11], v[i15]);                                             \
+        CHUKWA_G(v[i0], v[i5], v[i10], v[i15]);                                             \
+        CHUKWA_G(v[i1], v[i6], v[i11], v[i12]);                                             \
+        CHUKWA_G(v[i2], v[i7], v[i8], v[i13]);                                              \
+        CHUKWA_G(v[i3], v[i4], v[i9], v[i14]);                                              \
+    } while (0)
+
+        /* The Argon2 block permutation, on a block of plain 64 bit words or
+           of lane vectors alike */
+        template<typename Word> inline void permute(Word *v)
+        {
+            /* Rows of 16 words */
+            for (uint32_t i = 0; i < 8; i++)
+            {
+                Word *row = v + i * 16;
+                CHUKWA_ROUND(row, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+            }
+
+            /* Columns of pairs of words */
+            for (uint32_t i = 0; i < 8; i++)
+            {
+                Word *column = v + i * 2;
+                CHUKWA_ROUND(column, 0, 1, 16, 17, 32, 33, 48, 49, 64, 65, 80, 81, 96, 97, 112, 113);
+            }
+        }
+
+#undef CHUKWA_ROUND
+#undef CHUKWA_G
+#undef CHUKWA_BLAMKA
+#undef CHUKWA_ROTR64
+
+        struct AddressBlock
+        {
+            uint64_t v[ARGON2_WORDS_IN_BLOCK];
+        };
+
+        /* Generates the next block of data independent reference indexes -
+           these only depend on the position and the Argon2 parameters, so
+           are the same for every lane */
+        void nextAddresses(AddressBlock &addresses, AddressBlock &input)
+        {
+            input.v[6]++;
+
+            /* G(zero, G(zero, input)) */
+            for (int round = 0; round < 2; round++)
+            {
+                const AddressBlock &source = round == 0 ? input : addresses;
+
+                AddressBlock r = source;
+
+                permute(r.v);
+
+                for (uint32_t w = 0; w < ARGON2_WORDS_IN_BLOCK; w++)
+                {
+                    addresses.v[w] = source.v[w] ^ r.v[w];
+                }
+            }
+        }
+
+        template<size_t Lanes> class InterleavedArgon2id
+        {
+          public:
+            typedef typename LaneVector<Lanes>::Type Word;
+
+            /* Word w of lane l of the block is v[w][l] */
+            struct Block
+            {
+                Word v[ARGON2_WORDS_IN_BLOCK];
+            };
+
+            InterleavedArgon2id(const uint32_t iterations, const uint32_t memory):
+                m_iterations(iterations),
+                m_memory(memory),
+                m_segmentLength(std::max<uint32_t>(memory, 2 * ARGON2_SYNC_POINTS) / ARGON2_SYNC_POINTS),
+                m_memoryBlocks(m_segmentLength * ARGON2_SYNC_POINTS)
+            {
+            }
+
+            /* Hashes up to Lanes inputs. Unused lanes are still computed,
+               from a copy of the first input, and thrown away. */
+            void hash(const uint8_t *const *data, const size_t *lengths, Hash *hashes, const size_t count)
+            {
+                /* Each lane's memory is kept in one piece, as it would be if
+                   we were hashing it on its own - interleaving the whole of
+                   it would spread every reference block we read over Lanes
+                   times as many cache lines. Only the blocks being worked on
+                   are interleaved. */
+                thread_local std::vector<uint64_t> scratchpad;
+
+                const size_t laneWords = static_cast<size_t>(m_memoryBlocks) * ARGON2_WORDS_IN_BLOCK;
+
+                if (scratchpad.size() < laneWords * Lanes)
+                {
+                    scratchpad.resize(laneWords * Lanes);
+                }
+
+                for (size_t lane = 0; lane < Lanes; lane++)
+                {
+                    m_lanes[lane] = scratchpad.data() + lane * laneWords;
+
+                    const size_t input = lane < count ? lane : 0;
+
+                    fillFirstBlocks(lane, data[input], lengths[input]);
+                }
+
+                /* The block we filled in last, which the next block is
+                   always built from */
+                Block previous;
+
+                const uint64_t *secondBlocks[Lanes];
+
+                for (size_t lane = 0; lane < Lanes; lane++)
+                {
+                    secondBlocks[lane] = block(lane, 1);
+                }
+
+                for (uint32_t w = 0; w < ARGON2_WORDS_IN_BLOCK; w++)
+                {
+                    Word word;
+                    loadWord(word, secondBlocks, w);
+                    previous.v[w] = word;
+                }
+
+                for (uint32_t pass = 0; pass < m_iterations; pass++)
+                {
+                    for (uint32_t slice = 0; slice < ARGON2_SYNC_POINTS; slice++)
+                    {
+                        fillSegment(previous, pass, slice);
+                    }
+                }
+
+                for (size_t lane = 0; lane < count; lane++)
+                {
+                    uint8_t finalBlock[ARGON2_BLOCK_SIZE];
+
+                    const uint64_t *lastBlock = block(lane, m_memoryBlocks - 1);
+
+                    for (uint32_t w = 0; w < ARGON2_WORDS_IN_BLOCK; w++)
+                    {
+                        storeLittleEndian(finalBlock + w * 8, lastBlock[w]);
+                    }
+
+                    blake2b_long(hashes[lane].data, CHUKWA_HASHLEN, finalBlock, sizeof(finalBlock));
+                }
+            }
+
+          private:
+            /* H0, then the first two blocks of the lane, from H' of H0 */
+            void fillFirstBlocks(const size_t lane, const uint8_t *data, const size_t length)
+            {
+                uint8_t seed[ARGON2_PREHASH_LENGTH + 8];
+
+                blake2b_state state;
+
+                blake2b_init(&state, ARGON2_PREHASH_LENGTH);
+
+                const uint32_t parameters[] = {1, /* Argon2 lanes */
+                                               CHUKWA_HASHLEN,
+                                               m_memory,
+                                               m_iterations,
+                                               ARGON2_VERSION_NUMBER,
+                                               Argon2_id,
+                                               static_cast<uint32_t>(length)};
+
+                updateLittleEndian(state, parameters, sizeof(parameters) / sizeof(parameters[0]));
+
+                blake2b_update(&state, data, length);
+
+                const uint32_t saltLength = CHUKWA_SALTLEN;
+                updateLittleEndian(state, &saltLength, 1);
+
+                /* Chukwa salts with the start of the input */
+                blake2b_update(&state, data, CHUKWA_SALTLEN);
+
+                /* No secret, and no associated data */
+                const uint32_t empty[] = {0, 0};
+                updateLittleEndian(state, empty, 2);
+
+                blake2b_final(&state, seed, ARGON2_PREHASH_LENGTH);
+
+                for (uint32_t index = 0; index < 2; index++)
+                {
+                    uint8_t bytes[ARGON2_BLOCK_SIZE];
+
+                    storeLittleEndian(seed + ARGON2_PREHASH_LENGTH, index, 4);
+                    storeLittleEndian(seed + ARGON2_PREHASH_LENGTH + 4, 0, 4);
+
+                    blake2b_long(bytes, sizeof(bytes), seed, sizeof(seed));
+
+                    uint64_t *words = block(lane, index);
+
+                    for (uint32_t w = 0; w < ARGON2_WORDS_IN_BLOCK; w++)
+                    {
+                        words[w] = loadLittleEndian(bytes + w * 8);
+                    }
+                }
+            }
+
+            void fillSegment(Block &previous, const uint32_t pass, const uint32_t slice)
+            {
+                const bool dataIndependent = pass == 0 && slice < ARGON2_SYNC_POINTS / 2;
+
+                AddressBlock addresses;
+                AddressBlock input = {};
+
+                if (dataIndependent)
+                {
+                    input.v[0] = pass;
+                    input.v[1] = 0;
+                    input.v[2] = slice;
+                    input.v[3] = m_memoryBlocks;
+                    input.v[4] = m_iterations;
+                    input.v[5] = Argon2_id;
+                }
+
+                uint32_t start = 0;
+
+                if (pass == 0 && slice == 0)
+                {
+                    /* The first two blocks are already filled in */
+                    start = 2;
+
+                    if (dataIndependent)
+                    {
+                        nextAddresses(addresses, input);
+                    }
+                }
+
+                uint32_t current = slice * m_segmentLength + start;
+
+                for (uint32_t i = start; i < m_segmentLength; i++, current++)
+                {
+                    uint32_t references[Lanes];
+
+                    if (dataIndependent)
+                    {
+                        if (i % ARGON2_ADDRESSES_PER_BLOCK == 0)
+                        {
+                            nextAddresses(addresses, input);
+                        }
+
+                        const uint32_t reference =
+                            referenceIndex(pass, slice, i, addresses.v[i % ARGON2_ADDRESSES_PER_BLOCK]);
+
+                        std::fill(references, references + Lanes, reference);
+                    }
+                    else
+                    {
+                        /* Each lane picks its own reference block */
+                        for (size_t lane = 0; lane < Lanes; lane++)
+                        {
+                            references[lane] = referenceIndex(pass, slice, i, previous.v[0][lane]);
+                        }
+                    }
+
+                    /* XOR over the old block on later passes, as of Argon2 v1.3 */
+                    fillBlock(previous, references, current, pass != 0);
+                }
+            }
+
+            /* Builds block current of every lane from the previous block and
+               the lane's reference block, and leaves it in previous.
+
+               The lanes' blocks are interleaved into vectors, and the result
+               split back out, word by word in registers - writing single
+               words to memory and reading them back as a vector, or the
+               other way around, stalls on every read. */
+            void fillBlock(Block &previous, const uint32_t *references, const uint32_t current, const bool withXor)
+            {
+                const uint64_t *referenceBlocks[Lanes];
+                uint64_t *currentBlocks[Lanes];
+
+                for (size_t lane = 0; lane < Lanes; lane++)
+                {
+                    referenceBlocks[lane] = block(lane, references[lane]);
+                    currentBlocks[lane] = block(lane, current);
+                }
+
+                Block r;
+                Block t;
+
+                for (uint32_t w = 0; w < ARGON2_WORDS_IN_BLOCK; w++)
+                {
+                    Word x;
+                    loadWord(x, referenceBlocks, w);
+                    x ^= previous.v[w];
+
+                    r.v[w] = x;
+                    if (withXor)
+                    {
+                        Word old;
+                        loadWord(old, currentBlocks, w);
+                        t.v[w] = x ^ old;
+                    }
+                    else
+                    {
+                        t.v[w] = x;
+                    }
+                }
+
+                permute(r.v);
+
+                for (uint32_t w = 0; w < ARGON2_WORDS_IN_BLOCK; w++)
+                {
+                    const Word x = t.v[w] ^ r.v[w];
+
+                    previous.v[w] = x;
+
+                    for (size_t lane = 0; lane < Lanes; lane++)
+                    {
+                        currentBlocks[lane][w] = x[lane];
+                    }
+                }
+            }
+
+            /* Word w of each lane's block */
+            static void loadWord(Word &word, const uint64_t *const *blocks, const uint32_t w)
+            {
+                word = Word {};
+
+                for (size_t lane = 0; lane < Lanes; lane++)
+                {
+                    word[lane] = blocks[lane][w];
+                }
+            }
+
+            uint64_t *block(const size_t lane, const uint32_t index) const
+            {
+                return m_lanes[lane] + static_cast<size_t>(index) * ARGON2_WORDS_IN_BLOCK;
+            }
+
+            /* Maps a pseudo random value onto a block we have already filled
+               in, biased towards recent blocks. With a single Argon2 lane we
+               always reference our own lane. */
+            uint32_t referenceIndex(
+                const uint32_t pass,
+                const uint32_t slice,
+                const uint32_t index,
+                const uint64_t pseudoRandom) const
+            {
+                uint32_t referenceAreaSize;
+
+                if (pass == 0)
+                {
+                    referenceAreaSize = slice * m_segmentLength + index - 1;
+                }
+                else
+                {
+                    referenceAreaSize = m_memoryBlocks - m_segmentLength + index - 1;
+                }
+
+                uint64_t relativePosition = pseudoRandom & MASK_32;
+                relativePosition = relativePosition * relativePosition >> 32;
+                relativePosition = referenceAreaSize - 1 - (referenceAreaSize * relativePosition >> 32);
+
+                uint32_t startPosition = 0;
+
+                if (pass != 0 && slice != ARGON2_SYNC_POINTS - 1)
+                {
+                    startPosition = (slice + 1) * m_segmentLength;
+                }
+
+                return static_cast<uint32_t>((startPosition + relativePosition) % m_memoryBlocks);
+            }
+
+            static uint64_t loadLittleEndian(const uint8_t *bytes)
+            {
+                uint64_t word = 0;
+
+                for (int b = 7; b >= 0; b--)
+                {
+                    word = (word << 8) | bytes[b];
+                }
+
+                return word;
+            }
+
+            static void storeLittleEndian(uint8_t *bytes, const uint64_t value, const int length = 8)
+            {
+                for (int b = 0; b < length; b++)
+                {
+                    bytes[b] = static_cast<uint8_t>(value >> (8 * b));
+                }
+            }
+
+            static void updateLittleEndian(blake2b_state &state, const uint32_t *values, const size_t count)
+            {
+                for (size_t i = 0; i < count; i++)
+                {
+                    uint8_t bytes[4];
+                    storeLittleEndian(bytes, values[i], 4);
+                    blake2b_update(&state, bytes, sizeof(bytes));
+                }
+            }
+
+            const uint32_t m_iterations;
+
+            const uint32_t m_memory;
+
+            const uint32_t m_segmentLength;
+
+            const uint32_t m_memoryBlocks;
+
+            /* Where each lane's memory starts */
+            uint64_t *m_lanes[Lanes];
+        };
+
+        template<size_t Lanes>
+        void hashInterleaved(
+            const uint8_t *const *data,
+            const size_t *lengths,
+            Hash *hashes,
+            const size_t count,
+            const size_t iterations,
+            const size_t memory)
+        {
+            InterleavedArgon2id<Lanes> argon2(static_cast<uint32_t>(iterations), static_cast<uint32_t>(memory));
+
+            for (size_t i = 0; i < count; i += Lanes)
+            {
+                argon2.hash(data + i, lengths + i, hashes + i, std::min(Lanes, count - i));
+            }
+        }
+
+#endif
+
+        bool haveInterleavedKernel(const size_t lanes)
+        {
+            switch (lanes)
+            {
+#if defined(CHUKWA_INTERLEAVED)
+                case 2:
+#endif
+#if defined(CHUKWA_INTERLEAVED) && defined(__AVX2__)
+                case 4:
+#endif
+#if defined(CHUKWA_INTERLEAVED) && defined(__AVX512F__)
+                case 8:
+#endif
+                    return true;
+                default:
+                    return false;
+            }
+        }
+
+        /* Returns false if we don't have a kernel of this width */
+        bool hashInterleaved(
+            const size_t lanes,
+            const uint8_t *const *data,
+            const size_t *lengths,
+            Hash *hashes,
+            const size_t count,
+            const size_t iterations,
+            const size_t memory)
+        {
+            switch (lanes)
+            {
+#if defined(CHUKWA_INTERLEAVED)
+                case 2:
+                {
+                    hashInterleaved<2>(data, lengths, hashes, count, iterations, memory);
+                    return true;
+                }
+#endif
+#if defined(CHUKWA_INTERLEAVED) && defined(__AVX2__)
+                case 4:
+                {
+                    hashInterleaved<4>(data, lengths, hashes, count, iterations, memory);
+                    return true;
+                }
+#endif
+#if defined(CHUKWA_INTERLEAVED) && defined(__AVX512F__)
+                case 8:
+                {
+                    hashInterleaved<8>(data, lengths, hashes, count, iterations, memory);
+                    return true;
+                }
+#endif
+                default:
+                {
+                    return false;
+                }
+            }
+        }
+    } // namespace
+
+    size_t chukwa_preferred_lanes(const size_t iterations, const size_t memory, const size_t threads)
+    {
+#if defined(CHUKWA_INTERLEAVED)
+        if (threads != 1)
+        {
+            return 1;
+        }
+
+        static std::mutex mutex;
+
+        static std::map<std::pair<size_t, size_t>, size_t> preferredLanes;
+
+        std::scoped_lock lock(mutex);
+
+        const auto parameters = std::make_pair(iterations, memory);
+
+        const auto it = preferredLanes.find(parameters);
+
+        if (it != preferredLanes.end())
+        {
+            return it->second;
+        }
+
+        /* Much like argon2_select_impl(), time a batch at each lane width
+           and go with the quickest. Whether running lanes side by side
+           wins depends on whether the Argon2 library has a vectorized
+           implementation of its own for this CPU, and on whether that many
+           lanes' memory still fits in the cache, so this is simpler and more
+           reliable than guessing. */
+        const uint8_t input[76] = {};
+
+        const uint8_t *data[CHUKWA_MAX_LANES];
+        size_t lengths[CHUKWA_MAX_LANES];
+        Hash hashes[CHUKWA_MAX_LANES];
+
+        std::fill(data, data + CHUKWA_MAX_LANES, input);
+        std::fill(lengths, lengths + CHUKWA_MAX_LANES, sizeof(input));
+
+        size_t best = 1;
+
+        auto bestTime = std::chrono::steady_clock::duration::max();
+
+        for (const size_t lanes : {1, 2, 4, 8})
+        {
+            if (lanes != 1 && !haveInterleavedKernel(lanes))
+            {
+                continue;
+            }
+
+            /* The first run allocates the memory for this width */
+            chukwa_slow_hash_batch(data, lengths, hashes, CHUKWA_MAX_LANES, iterations, memory, threads, lanes);
+
+            const auto start = std::chrono::steady_clock::now();
+
+            chukwa_slow_hash_batch(data, lengths, hashes, CHUKWA_MAX_LANES, iterations, memory, threads, lanes);
+
+            const auto elapsed = std::chrono::steady_clock::now() - start;
+
+            if (elapsed < bestTime)
+            {
+                best = lanes;
+                bestTime = elapsed;
+            }
+        }
+
+        preferredLanes[parameters] = best;
+
+        return best;
+#else
+        return 1;
+#endif
+    }
+
+    void chukwa_slow_hash_batch(
+        const uint8_t *const *data,
+        const size_t *lengths,
+        Hash *hashes,
+        const size_t count,
+        const size_t iterations,
+        const size_t memory,
+        const size_t threads,
+        const size_t lanes)
+    {
+        const size_t width = lanes == 0 ? chukwa_preferred_lanes(iterations, memory, threads) : lanes;
+
+        if (threads == 1 && hashInterleaved(width, data, lengths, hashes, count, iterations, memory))
+        {
+            return;
+        }
+
+        hashSequentially(data, lengths, hashes, count, iterations, memory, threads);
+    }
+} // namespace Crypto
@@ -0,0 +1,72 @@
+// Copyright (c) 2018-2020, The TurtleCoin Developers
+//
+// Please see the included LICENSE file for more information.
+
+#pragma once
+
+#include "hash.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Crypto
+{
+    //RTcoin
+    /* The most inputs the interleaved Chukwa kernel will hash side by side */
+    const size_t CHUKWA_MAX_LANES = 8;
+
+    /* The lane width (1, 2, 4 or 8) that hashes quickest with these
+       parameters on this machine. Found by timing each of them the first
+       time it is asked for, and remembered from then on. */
+    size_t chukwa_preferred_lanes(const size_t iterations, const size_t memory, const size_t threads);
+
+    /* Hashes count inputs with Chukwa, lanes of them at a time. Gives
+       exactly the same results as calling chukwa_slow_hash_base() on each
+       input in turn.
+
+       With 2, 4 or 8 lanes, the inputs are run through Argon2id together,
+       with each 64 bit word of the blocks being worked on stored next to
+       the same word of the other lanes, so one vector instruction (SSE2,
+       AVX2 or AVX-512, whichever we are built for) advances every lane at
+       once. With 1 lane, each input is handed to the Argon2 library in turn.
+
+       Either way the Argon2 memory is allocated the first time a thread
+       uses a given lane width, and reused from then on, rather than
+       allocated and freed for every hash.
+
+       lanes of 0 uses chukwa_preferred_lanes(). Only single threaded
+       Argon2 (which both Chukwa versions are) is interleaved, and only at
+       widths that fit in the vector registers we are built for - anything
+       else is hashed one input at a time. */
+    void chukwa_slow_hash_batch(
+        const uint8_t *const *data,
+        const size_t *lengths,
+        Hash *hashes,
+        const size_t count,
+        const size_t iterations,
+        const size_t memory,
+        const size_t threads,
+        const size_t lanes = 0);
+
+    inline void
+        chukwa_slow_hash_v1_batch(const uint8_t *const *data, const size_t *lengths, Hash *hashes, const size_t count)
+    {
+        chukwa_slow_hash_batch(data, lengths, hashes, count, CHUKWA_ITERS_V1, CHUKWA_MEMORY_V1, CHUKWA_THREADS_V1);
+    }
+
+    inline void
+        chukwa_slow_hash_v2_batch(const uint8_t *const *data, const size_t *lengths, Hash *hashes, const size_t count)
+    {
+        chukwa_slow_hash_batch(data, lengths, hashes, count, CHUKWA_ITERS_V2, CHUKWA_MEMORY_V2, CHUKWA_THREADS_V2);
+    }
+
+    inline size_t chukwa_preferred_lanes_v1()
+    {
+        return chukwa_preferred_lanes(CHUKWA_ITERS_V1, CHUKWA_MEMORY_V1, CHUKWA_THREADS_V1);
+    }
+
+    inline size_t chukwa_preferred_lanes_v2()
+    {
+        return chukwa_preferred_lanes(CHUKWA_ITERS_V2, CHUKWA_MEMORY_V2, CHUKWA_THREADS_V2);
+    }
+} // namespace Crypto
@@ -1321,17 +1321,28 @@ B is the Ed25519 base point (x,4/5) with x positive.
 */
 
 void ge_double_scalarmult_base_vartime(ge_p2 *r, const unsigned char *a, const ge_p3 *A, const unsigned char *b)
+{
+    ge_dsmp Ai; /* A, 3A, 5A, 7A, 9A, 11A, 13A, 15A */
+
+    ge_dsm_precomp(Ai, A);
+
+    ge_double_scalarmult_base_precomp_vartime(r, a, Ai, b);
+}
+
+/*
+As above, with A already run through ge_dsm_precomp
+*/
+
+void ge_double_scalarmult_base_precomp_vartime(ge_p2 *r, const unsigned char *a, const ge_dsmp Ai, const unsigned char *b)
 {
     signed char aslide[256];
     signed char bslide[256];
-    ge_dsmp Ai; /* A, 3A, 5A, 7A, 9A, 11A, 13A, 15A */
     ge_p1p1 t;
     ge_p3 u;
     int i;
 
     slide(aslide, a);
     slide(bslide, b);
-    ge_dsm_precomp(Ai, A);
 
     ge_p2_0(r);
 
@@ -2306,17 +2317,33 @@ void ge_double_scalarmult_precomp_vartime(
     const ge_p3 *A,
     const unsigned char *b,
     const ge_dsmp Bi)
+{
+    ge_dsmp Ai; /* A, 3A, 5A, 7A, 9A, 11A, 13A, 15A */
+
+    ge_dsm_precomp(Ai, A);
+
+    ge_double_scalarmult_precomp2_vartime(r, a, Ai, b, Bi);
+}
+
+/*
+r = a * A + b * B, with both A and B already run through ge_dsm_precomp
+*/
+
+void ge_double_scalarmult_precomp2_vartime(
+    ge_p2 *r,
+    const unsigned char *a,
+    const ge_dsmp Ai,
+    const unsigned char *b,
+    const ge_dsmp Bi)
 {
     signed char aslide[256];
     signed char bslide[256];
-    ge_dsmp Ai; /* A, 3A, 5A, 7A, 9A, 11A, 13A, 15A */
     ge_p1p1 t;
     ge_p3 u;
     int i;
 
     slide(aslide, a);
     slide(bslide, b);
-    ge_dsm_precomp(Ai, A);
 
     ge_p2_0(r);
 
@@ -2358,6 +2385,134 @@ void ge_double_scalarmult_precomp_vartime(
     }
 }
 
+static void ge_cached_select(ge_cached *t, const ge_cached table[8], signed char b)
+{
+    ge_cached minust;
+    unsigned char bnegative = negative(b);
+    unsigned char babs = b - (((-bnegative) & b) << 1);
+
+    ge_cached_0(t);
+    ge_cached_cmov(t, &table[0], equal(babs, 1));
+    ge_cached_cmov(t, &table[1], equal(babs, 2));
+    ge_cached_cmov(t, &table[2], equal(babs, 3));
+    ge_cached_cmov(t, &table[3], equal(babs, 4));
+    ge_cached_cmov(t, &table[4], equal(babs, 5));
+    ge_cached_cmov(t, &table[5], equal(babs, 6));
+    ge_cached_cmov(t, &table[6], equal(babs, 7));
+    ge_cached_cmov(t, &table[7], equal(babs, 8));
+    fe_copy(minust.YplusX, t->YminusX);
+    fe_copy(minust.YminusX, t->YplusX);
+    fe_copy(minust.Z, t->Z);
+    fe_neg(minust.T2d, t->T2d);
+    ge_cached_cmov(t, &minust, bnegative);
+}
+
+/*
+r[i][j] = (j + 1) * 256^i * A
+
+The same layout as ge_base, so a * A can then be found the same way
+ge_scalarmult_base finds a * B - without any of the 252 doublings
+ge_scalarmult needs. Costs about two ge_scalarmult calls to build.
+*/
+
+void ge_fixed_base_precomp(ge_fixed_base_table r, const ge_p3 *A)
+{
+    ge_p1p1 t;
+    ge_p2 s;
+    ge_p3 base = *A;
+    ge_p3 u;
+    int i, j;
+
+    for (i = 0; i < 32; i++)
+    {
+        ge_p3_to_cached(&r[i][0], &base);
+
+        u = base;
+
+        for (j = 1; j < 8; j++)
+        {
+            ge_add(&t, &u, &r[i][0]);
+            ge_p1p1_to_p3(&u, &t);
+            ge_p3_to_cached(&r[i][j], &u);
+        }
+
+        /* base = 256 * base, via 8 * base which we already have */
+        ge_p3_to_p2(&s, &u);
+
+        for (j = 0; j < 4; j++)
+        {
+            ge_p2_dbl(&t, &s);
+            ge_p1p1_to_p2(&s, &t);
+        }
+
+        ge_p2_dbl(&t, &s);
+        ge_p1p1_to_p3(&base, &t);
+    }
+}
+
+/*
+h = a * A, where A was run through ge_fixed_base_precomp
+where a = a[0]+256*a[1]+...+256^31 a[31]
+
+Constant time, like ge_scalarmult_base.
+
+Preconditions:
+  a[31] <= 127
+*/
+
+void ge_scalarmult_fixed_base(ge_p3 *h, const unsigned char *a, const ge_fixed_base_table A)
+{
+    signed char e[64];
+    signed char carry;
+    ge_p1p1 r;
+    ge_p2 s;
+    ge_cached t;
+    int i;
+
+    for (i = 0; i < 32; ++i)
+    {
+        e[2 * i + 0] = (a[i] >> 0) & 15;
+        e[2 * i + 1] = (a[i] >> 4) & 15;
+    }
+    /* each e[i] is between 0 and 15 */
+    /* e[63] is between 0 and 7 */
+
+    carry = 0;
+    for (i = 0; i < 63; ++i)
+    {
+        e[i] += carry;
+        carry = e[i] + 8;
+        carry >>= 4;
+        e[i] -= carry << 4;
+    }
+    e[63] += carry;
+    /* each e[i] is between -8 and 8 */
+
+    ge_p3_0(h);
+    for (i = 1; i < 64; i += 2)
+    {
+        ge_cached_select(&t, A[i / 2], e[i]);
+        ge_add(&r, h, &t);
+        ge_p1p1_to_p3(h, &r);
+    }
+
+    ge_p3_dbl(&r, h);
+    ge_p1p1_to_p2(&s, &r);
+    ge_p2_dbl(&r, &s);
+    ge_p1p1_to_p2(&s, &r);
+    ge_p2_dbl(&r, &s);
+    ge_p1p1_to_p2(&s, &r);
+    ge_p2_dbl(&r, &s);
+    ge_p1p1_to_p3(h, &r);
+
+    for (i = 0; i < 64; i += 2)
+    {
+        ge_cached_select(&t, A[i / 2], e[i]);
+        ge_add(&r, h, &t);
+        ge_p1p1_to_p3(h, &r);
+    }
+}
+
 int ge_check_subgroup_precomp_vartime(const ge_dsmp p)
 {
     ge_p3 s;
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <stddef.h>
 #include <stdint.h>
 
 /* From fe.h */
@@ -60,6 +61,8 @@ void ge_dsm_precomp(ge_dsmp r, const ge_p3 *s);
 
 void ge_double_scalarmult_base_vartime(ge_p2 *, const unsigned char *, const ge_p3 *, const unsigned char *);
 
+void ge_double_scalarmult_base_precomp_vartime(ge_p2 *, const unsigned char *, const ge_dsmp, const unsigned char *);
+
 /* From ge_frombytes.c, modified */
 
 extern const fe fe_sqrtm1;
@@ -123,8 +126,22 @@ void ge_double_scalarmult_precomp_vartime(
     const unsigned char *,
     const ge_dsmp);
 
+void ge_double_scalarmult_precomp2_vartime(
+    ge_p2 *,
+    const unsigned char *,
+    const ge_dsmp,
+    const unsigned char *,
+    const ge_dsmp);
+
 int ge_check_subgroup_precomp_vartime(const ge_dsmp);
 
+/* Per point window tables, for points we multiply by again and again */
+typedef ge_cached ge_fixed_base_table[32][8];
+
+void ge_fixed_base_precomp(ge_fixed_base_table, const ge_p3 *);
+
+void ge_scalarmult_fixed_base(ge_p3 *, const unsigned char *, const ge_fixed_base_table);
+
 void ge_mul8(ge_p1p1 *, const ge_p2 *);
 
 extern const fe fe_ma2;
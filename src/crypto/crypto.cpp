@@ -17,7 +17,9 @@
 #include <cstdint>
 #include <cstdlib>
 #include <cstring>
+#include <list>
 #include <memory>
+#include <unordered_map>
 #include <vector>
 
 namespace Crypto
@@ -28,6 +30,127 @@ namespace Crypto
 #include "keccak.h"
     }
 
+    namespace
+    {
+        //RTcoin
+        /* Precomputed tables for points we keep multiplying, such as ring
+           members that turn up in signature after signature. Holds the
+           capacity most recently used points. */
+        template<typename Table> class PointTableCache
+        {
+          public:
+            explicit PointTableCache(const size_t capacity): m_capacity(capacity) {}
+
+            /* Returns the table for point, building it with build() if we
+               don't have it yet. Returns nullptr if build() fails, i.e.
+               point isn't a valid point. */
+            template<typename BuildFunc> std::shared_ptr<const Table> get(const PublicKey &point, BuildFunc build)
+            {
+                {
+                    std::scoped_lock lock(m_mutex);
+
+                    const auto it = m_index.find(point);
+
+                    if (it != m_index.end())
+                    {
+                        m_entries.splice(m_entries.begin(), m_entries, it->second);
+                        return it->second->second;
+                    }
+                }
+
+                /* Build outside the lock - if two threads race to build the
+                   same table, one is just thrown away */
+                auto table = std::make_shared<Table>();
+
+                if (!build(*table))
+                {
+                    return nullptr;
+                }
+
+                std::scoped_lock lock(m_mutex);
+
+                if (m_index.find(point) == m_index.end())
+                {
+                    m_entries.emplace_front(point, table);
+                    m_index[point] = m_entries.begin();
+
+                    if (m_entries.size() > m_capacity)
+                    {
+                        m_index.erase(m_entries.back().first);
+                        m_entries.pop_back();
+                    }
+                }
+
+                return table;
+            }
+
+            void clear()
+            {
+                std::scoped_lock lock(m_mutex);
+
+                m_index.clear();
+                m_entries.clear();
+            }
+
+          private:
+            typedef std::list<std::pair<PublicKey, std::shared_ptr<const Table>>> Entries;
+
+            const size_t m_capacity;
+
+            std::mutex m_mutex;
+
+            Entries m_entries;
+
+            std::unordered_map<PublicKey, typename Entries::iterator> m_index;
+        };
+
+        struct FixedBaseTable
+        {
+            ge_fixed_base_table table;
+        };
+
+        struct PointPrecomp
+        {
+            ge_dsmp precomp;
+        };
+
+        /* 40KB each - these are for the handful of keys we derive against
+           over and over, such as our own view key */
+        PointTableCache<FixedBaseTable> &fixedBaseTables()
+        {
+            static PointTableCache<FixedBaseTable> cache(16);
+            return cache;
+        }
+
+        /* 1.25KB each. Keyed by the point itself */
+        PointTableCache<PointPrecomp> &pointPrecomps()
+        {
+            static PointTableCache<PointPrecomp> cache(2048);
+            return cache;
+        }
+
+        /* Keyed by the point, but holds the table for hash_to_ec(point) */
+        PointTableCache<PointPrecomp> &hashedPointPrecomps()
+        {
+            static PointTableCache<PointPrecomp> cache(2048);
+            return cache;
+        }
+
+        bool buildPointPrecomp(const PublicKey &key, PointPrecomp &table)
+        {
+            ge_p3 point;
+
+            if (ge_frombytes_vartime(&point, reinterpret_cast<const unsigned char *>(&key)) != 0)
+            {
+                return false;
+            }
+
+            ge_dsm_precomp(table.precomp, &point);
+
+            return true;
+        }
+    } // namespace
+
     static inline void random_scalar(EllipticCurveScalar &res)
     {
         unsigned char tmp[64];
@@ -124,6 +247,42 @@ namespace Crypto
         return true;
     }
 
+    bool crypto_ops::generateKeyDerivationPrecomputed(
+        const PublicKey &key1,
+        const SecretKey &key2,
+        KeyDerivation &derivation)
+    {
+        assert(sc_check(reinterpret_cast<const unsigned char *>(&key2)) == 0);
+
+        const auto table = fixedBaseTables().get(key1, [&key1](FixedBaseTable &result) {
+            ge_p3 point;
+
+            if (ge_frombytes_vartime(&point, reinterpret_cast<const unsigned char *>(&key1)) != 0)
+            {
+                return false;
+            }
+
+            ge_fixed_base_precomp(result.table, &point);
+
+            return true;
+        });
+
+        if (!table)
+        {
+            return false;
+        }
+
+        ge_p3 point;
+        ge_p2 point2;
+        ge_p1p1 point3;
+        ge_scalarmult_fixed_base(&point, reinterpret_cast<const unsigned char *>(&key2), table->table);
+        ge_p3_to_p2(&point2, &point);
+        ge_mul8(&point3, &point2);
+        ge_p1p1_to_p2(&point2, &point3);
+        ge_tobytes(reinterpret_cast<unsigned char *>(&derivation), &point2);
+        return true;
+    }
+
     void
         crypto_ops::derivation_to_scalar(const KeyDerivation &derivation, size_t output_index, EllipticCurveScalar &res)
     {
@@ -455,6 +614,13 @@ namespace Crypto
         ge_tobytes(reinterpret_cast<unsigned char *>(&image), &point2);
     }
 
+    void crypto_ops::clearPrecomputedPoints()
+    {
+        fixedBaseTables().clear();
+        pointPrecomps().clear();
+        hashedPointPrecomps().clear();
+    }
+
 #ifdef _MSC_VER
 #pragma warning(disable : 4200)
 #endif
@@ -656,7 +822,6 @@ namespace Crypto
         for (size_t i = 0; i < pubs.size(); i++)
         {
             ge_p2 tmp2;
-            ge_p3 tmp3;
 
             if (sc_check(reinterpret_cast<const unsigned char *>(&signatures[i])) != 0
                 || sc_check(reinterpret_cast<const unsigned char *>(&signatures[i]) + 32) != 0)
@@ -664,25 +829,37 @@ namespace Crypto
                 return false;
             }
 
-            if (ge_frombytes_vartime(&tmp3, reinterpret_cast<const unsigned char *>(&pubs[i])) != 0)
+            const auto &pub = pubs[i];
+
+            /* Ring members tend to turn up in many signatures, so keep their
+               decompressed points and tables around */
+            const auto point =
+                pointPrecomps().get(pub, [&pub](PointPrecomp &precomp) { return buildPointPrecomp(pub, precomp); });
+
+            if (!point)
             {
                 return false;
             }
 
-            ge_double_scalarmult_base_vartime(
+            ge_double_scalarmult_base_precomp_vartime(
                 &tmp2,
                 reinterpret_cast<const unsigned char *>(&signatures[i]),
-                &tmp3,
+                point->precomp,
                 reinterpret_cast<const unsigned char *>(&signatures[i]) + 32);
 
             ge_tobytes(reinterpret_cast<unsigned char *>(&buf->ab[i].a), &tmp2);
 
-            hash_to_ec(pubs[i], tmp3);
+            const auto hashedPoint = hashedPointPrecomps().get(pub, [&pub](PointPrecomp &precomp) {
+                ge_p3 hashed;
+                hash_to_ec(pub, hashed);
+                ge_dsm_precomp(precomp.precomp, &hashed);
+                return true;
+            });
 
-            ge_double_scalarmult_precomp_vartime(
+            ge_double_scalarmult_precomp2_vartime(
                 &tmp2,
                 reinterpret_cast<const unsigned char *>(&signatures[i]) + 32,
-                &tmp3,
+                hashedPoint->precomp,
                 reinterpret_cast<const unsigned char *>(&signatures[i]),
                 image_pre);
 
@@ -189,6 +189,26 @@ namespace Crypto
             const std::vector<PublicKey> pubs,
             const std::vector<Signature> signatures);
 
+        //RTcoin
+        /* Gives the same result as generate_key_derivation(), but keeps a
+           window table for key1 in a small cache of recently used keys, so
+           deriving against the same public key again (our own view key for
+           change, a pool's address for every block template) skips all the
+           doublings. Still constant time in key2. */
+        static bool generateKeyDerivationPrecomputed(
+            const PublicKey &key1,
+            const SecretKey &key2,
+            KeyDerivation &derivation);
+
+        /* Drops every cached point table */
+        static void clearPrecomputedPoints();
+
+        /* There's deliberately no multi-scalar multiplication. Every ring
+           member's two points go into the signature hash one by one, so
+           checkRingSignature() can't sum them, and each already uses the
+           cached tables. Scanning outputs needs each transaction's
+           derivation on its own, so there's nothing to sum there either. */
+
         static void generateViewFromSpend(const Crypto::SecretKey &spend, Crypto::SecretKey &viewSecret);
 
         static void generateViewFromSpend(
@@ -61,6 +61,12 @@ enum
 
 void cn_fast_hash(const void *data, size_t length, char *hash);
 
+/* cn_fast_hash of count independent inputs, several at a time on machines
+   with wide enough vector registers (see keccak_batch) */
+void cn_fast_hash_batch(const void *const *data, const size_t *lengths, char (*hashes)[HASH_SIZE], size_t count);
+
+size_t cn_fast_hash_batch_lanes(void);
+
 void cn_slow_hash(
     const void *data,
     size_t length,
@@ -72,6 +78,22 @@ void cn_slow_hash(
     uint32_t scratchpad,
     uint32_t iterations);
 
+/* Thread local scratchpad arena shared by the slow hashes. acquire returns a
+   16 byte aligned buffer of at least size bytes, backed by 2MB huge pages
+   where the OS will give us them. release frees it again, unless the thread
+   is holding the arena, in which case it is kept warm for the next hash until
+   the matching unhold. */
+uint8_t *slow_hash_arena_acquire(size_t size);
+
+void slow_hash_arena_release(void);
+
+void slow_hash_arena_hold(void);
+
+void slow_hash_arena_unhold(void);
+
+/* Non zero if the arena is currently backed by huge pages */
+int slow_hash_arena_huge_pages(void);
+
 void hash_extra_blake(const void *data, size_t length, char *hash);
 
 void hash_extra_groestl(const void *data, size_t length, char *hash);
@@ -26,3 +26,13 @@ void cn_fast_hash(const void *data, size_t length, char *hash)
     hash_process(&state, data, length);
     memcpy(hash, &state, HASH_SIZE);
 }
+
+void cn_fast_hash_batch(const void *const *data, const size_t *lengths, char (*hashes)[HASH_SIZE], size_t count)
+{
+    keccak_batch((const uint8_t *const *)data, lengths, (uint8_t *)hashes, HASH_SIZE, count);
+}
+
+size_t cn_fast_hash_batch_lanes(void)
+{
+    return keccak_batch_lanes();
+}
@@ -68,6 +68,28 @@ namespace Crypto
 
     static bool argon2_optimization_selected = false;
 
+    //RTcoin
+    /* Keeps this thread's slow hash scratchpad arena allocated for as long as
+       it is in scope, so a run of hashes - mining, or validating a batch of
+       blocks - only pays for allocating and faulting in the scratchpad once */
+    class SlowHashArena
+    {
+      public:
+        SlowHashArena()
+        {
+            slow_hash_arena_hold();
+        }
+
+        ~SlowHashArena()
+        {
+            slow_hash_arena_unhold();
+        }
+
+        SlowHashArena(const SlowHashArena &) = delete;
+
+        SlowHashArena &operator=(const SlowHashArena &) = delete;
+    };
+
     /*
       Cryptonight hash functions
     */
@@ -84,6 +106,15 @@ namespace Crypto
         return h;
     }
 
+    //RTcoin
+    /* Hashes count independent inputs with cn_fast_hash, several side by
+       side where the CPU allows. Used for tree hashes and for hashing a
+       block's worth of transactions at once. */
+    inline void cn_fast_hash_batch(const void *const *data, const size_t *lengths, Hash *hashes, size_t count)
+    {
+        cn_fast_hash_batch(data, lengths, reinterpret_cast<char(*)[HASH_SIZE]>(hashes), count);
+    }
+
     // Standard CryptoNight
     inline void cn_slow_hash_v0(const void *data, size_t length, Hash &hash)
     {
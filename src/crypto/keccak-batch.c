@@ -0,0 +1,293 @@
+// Copyright (c) 2018-2020, The TurtleCoin Developers
+//
+// Please see the included LICENSE file for more information.
+
+/* Multi buffer Keccak. Several independent inputs are absorbed side by side,
+   with word i of every input's state stored next to each other, so one
+   vector instruction advances the permutation of all of them at once. */
+
+#include "keccak.h"
+
+#if defined(__AVX512F__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#if defined(_MSC_VER)
+#define KECCAK_ALIGN(x) __declspec(align(x))
+#else
+#define KECCAK_ALIGN(x) __attribute__((aligned(x)))
+#endif
+
+/* From keccak.c */
+extern const uint64_t keccakf_rndc[24];
+
+#if defined(__AVX512F__)
+
+#define KECCAK_BATCH_LANES 8
+
+typedef __m512i keccak_lanes_t;
+
+#define LANES_LOAD(p) _mm512_load_si512((const void *)(p))
+#define LANES_STORE(p, v) _mm512_store_si512((void *)(p), v)
+#define LANES_SET1(x) _mm512_set1_epi64((long long)(x))
+#define LANES_XOR(a, b) _mm512_xor_si512(a, b)
+#define LANES_XOR5(a, b, c, d, e) \
+    _mm512_ternarylogic_epi64(_mm512_ternarylogic_epi64(a, b, c, 0x96), d, e, 0x96)
+/* a ^ (~b & c) */
+#define LANES_CHI(a, b, c) _mm512_ternarylogic_epi64(a, b, c, 0xD2)
+#define LANES_ROL(a, n) _mm512_rol_epi64(a, n)
+
+#elif defined(__AVX2__)
+
+#define KECCAK_BATCH_LANES 4
+
+typedef __m256i keccak_lanes_t;
+
+#define LANES_LOAD(p) _mm256_load_si256((const __m256i *)(p))
+#define LANES_STORE(p, v) _mm256_store_si256((__m256i *)(p), v)
+#define LANES_SET1(x) _mm256_set1_epi64x((long long)(x))
+#define LANES_XOR(a, b) _mm256_xor_si256(a, b)
+#define LANES_XOR5(a, b, c, d, e) LANES_XOR(LANES_XOR(LANES_XOR(a, b), LANES_XOR(c, d)), e)
+#define LANES_CHI(a, b, c) _mm256_xor_si256(a, _mm256_andnot_si256(b, c))
+#define LANES_ROL(a, n) _mm256_or_si256(_mm256_slli_epi64(a, n), _mm256_srli_epi64(a, 64 - (n)))
+
+#else
+
+#define KECCAK_BATCH_LANES 1
+
+#endif
+
+size_t keccak_batch_lanes(void)
+{
+    return KECCAK_BATCH_LANES;
+}
+
+#if KECCAK_BATCH_LANES > 1
+
+/* Rho and pi for the word at (x, y) - it is rotated by r and moves to
+   (y, 2x + 3y) */
+#define RHO_PI(x, y, r) B[(y) + 5 * ((2 * (x) + 3 * (y)) % 5)] = LANES_ROL(LANES_XOR(A[(x) + 5 * (y)], D[x]), r)
+
+static void keccakf_lanes(uint64_t st[25][KECCAK_BATCH_LANES])
+{
+    keccak_lanes_t A[25], B[25], C[5], D[5];
+
+    int i, x, y, round;
+
+    for (i = 0; i < 25; i++)
+    {
+        A[i] = LANES_LOAD(st[i]);
+    }
+
+    for (round = 0; round < KECCAK_ROUNDS; round++)
+    {
+        // Theta
+        for (x = 0; x < 5; x++)
+        {
+            C[x] = LANES_XOR5(A[x], A[x + 5], A[x + 10], A[x + 15], A[x + 20]);
+        }
+
+        for (x = 0; x < 5; x++)
+        {
+            D[x] = LANES_XOR(C[(x + 4) % 5], LANES_ROL(C[(x + 1) % 5], 1));
+        }
+
+        // Rho Pi
+        B[0] = LANES_XOR(A[0], D[0]);
+        RHO_PI(1, 0, 1);
+        RHO_PI(2, 0, 62);
+        RHO_PI(3, 0, 28);
+        RHO_PI(4, 0, 27);
+        RHO_PI(0, 1, 36);
+        RHO_PI(1, 1, 44);
+        RHO_PI(2, 1, 6);
+        RHO_PI(3, 1, 55);
+        RHO_PI(4, 1, 20);
+        RHO_PI(0, 2, 3);
+        RHO_PI(1, 2, 10);
+        RHO_PI(2, 2, 43);
+        RHO_PI(3, 2, 25);
+        RHO_PI(4, 2, 39);
+        RHO_PI(0, 3, 41);
+        RHO_PI(1, 3, 45);
+        RHO_PI(2, 3, 15);
+        RHO_PI(3, 3, 21);
+        RHO_PI(4, 3, 8);
+        RHO_PI(0, 4, 18);
+        RHO_PI(1, 4, 2);
+        RHO_PI(2, 4, 61);
+        RHO_PI(3, 4, 56);
+        RHO_PI(4, 4, 14);
+
+        // Chi
+        for (y = 0; y < 25; y += 5)
+        {
+            for (x = 0; x < 5; x++)
+            {
+                A[y + x] = LANES_CHI(B[y + x], B[y + (x + 1) % 5], B[y + (x + 2) % 5]);
+            }
+        }
+
+        // Iota
+        A[0] = LANES_XOR(A[0], LANES_SET1(keccakf_rndc[round]));
+    }
+
+    for (i = 0; i < 25; i++)
+    {
+        LANES_STORE(st[i], A[i]);
+    }
+}
+
+#undef RHO_PI
+
+#endif
+
+int keccak_batch(const uint8_t *const *in, const size_t *inlen, uint8_t *md, int mdlen, size_t count)
+{
+    /* Same rate as keccak(). A digest of 100 bytes or more leaves a rate of
+       nothing, or less than nothing, and one under 28 bytes has a rate too
+       big for keccak()'s padding buffer, which the lone input path uses */
+    if (mdlen != 200 && (mdlen < 28 || mdlen >= 100))
+    {
+        return -1;
+    }
+
+#if KECCAK_BATCH_LANES == 1
+    size_t n;
+
+    for (n = 0; n < count; n++)
+    {
+        keccak(in[n], (int)inlen[n], md + n * mdlen, mdlen);
+    }
+#else
+    const size_t rsiz = mdlen == 200 ? 136 : 200 - 2 * mdlen;
+
+    const size_t rsizw = rsiz / 8;
+
+    KECCAK_ALIGN(64) uint64_t st[25][KECCAK_BATCH_LANES];
+
+    /* Which input each lane is working on, and how much of it is absorbed */
+    size_t job[KECCAK_BATCH_LANES];
+
+    size_t offset[KECCAK_BATCH_LANES];
+
+    int active[KECCAK_BATCH_LANES];
+
+    int finishing[KECCAK_BATCH_LANES];
+
+    size_t next = 0, busy = 0, lane, i;
+
+    /* A lone input gains nothing from the wide permutation */
+    if (count < 2)
+    {
+        if (count == 1)
+        {
+            keccak(in[0], (int)inlen[0], md, mdlen);
+        }
+
+        return 0;
+    }
+
+    for (lane = 0; lane < KECCAK_BATCH_LANES; lane++)
+    {
+        for (i = 0; i < 25; i++)
+        {
+            st[i][lane] = 0;
+        }
+
+        active[lane] = next < count;
+        finishing[lane] = 0;
+        job[lane] = next;
+        offset[lane] = 0;
+
+        if (active[lane])
+        {
+            next++;
+            busy++;
+        }
+    }
+
+    while (busy > 0)
+    {
+        // absorb one block into every lane that has work
+        for (lane = 0; lane < KECCAK_BATCH_LANES; lane++)
+        {
+            const uint8_t *block;
+
+            /* Big enough for the largest rate, with the smallest digests */
+            uint8_t temp[200];
+
+            size_t remaining;
+
+            uint64_t word;
+
+            if (!active[lane])
+            {
+                continue;
+            }
+
+            remaining = inlen[job[lane]] - offset[lane];
+
+            block = in[job[lane]] + offset[lane];
+
+            if (remaining >= rsiz)
+            {
+                offset[lane] += rsiz;
+            }
+            else
+            {
+                // last block and padding
+                memcpy(temp, block, remaining);
+                temp[remaining++] = 1;
+                memset(temp + remaining, 0, rsiz - remaining);
+                temp[rsiz - 1] |= 0x80;
+
+                block = temp;
+                finishing[lane] = 1;
+            }
+
+            for (i = 0; i < rsizw; i++)
+            {
+                memcpy(&word, block + i * 8, sizeof(word));
+                st[i][lane] ^= word;
+            }
+        }
+
+        keccakf_lanes(st);
+
+        // collect finished digests, and start the next input in their lane
+        for (lane = 0; lane < KECCAK_BATCH_LANES; lane++)
+        {
+            uint64_t digest[25];
+
+            if (!finishing[lane])
+            {
+                continue;
+            }
+
+            for (i = 0; i < 25; i++)
+            {
+                digest[i] = st[i][lane];
+                st[i][lane] = 0;
+            }
+
+            memcpy(md + job[lane] * mdlen, digest, mdlen);
+
+            finishing[lane] = 0;
+            offset[lane] = 0;
+
+            if (next < count)
+            {
+                job[lane] = next++;
+            }
+            else
+            {
+                active[lane] = 0;
+                busy--;
+            }
+        }
+    }
+#endif
+
+    return 0;
+}
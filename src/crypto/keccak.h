@@ -4,6 +4,7 @@
 #ifndef KECCAK_H
 #define KECCAK_H
 
+#include <stddef.h>
 #include <stdint.h>
 #include <string.h>
 
@@ -23,4 +24,16 @@ void keccakf(uint64_t st[25], int norounds);
 
 void keccak1600(const uint8_t *in, int inlen, uint8_t *md);
 
+// how many inputs keccak_batch() permutes side by side - 8 with AVX-512,
+// 4 with AVX2, otherwise 1
+size_t keccak_batch_lanes(void);
+
+// compute count keccak hashes, each mdlen bytes, of in[i] into md + i * mdlen.
+// mdlen must be 200, or at least 28 and under 100 - otherwise nothing is
+// hashed and -1 is returned, else 0.
+// the same as calling keccak() on each input in turn. every input is fully
+// read before its own digest is written, and with equal length inputs the
+// digests are written in order
+int keccak_batch(const uint8_t *const *in, const size_t *inlen, uint8_t *md, int mdlen, size_t count);
+
 #endif
@@ -0,0 +1,236 @@
+// Copyright (c) 2018-2020, The TurtleCoin Developers
+//
+// Please see the included LICENSE file for more information.
+
+/* This file contains the thread local scratchpad arena shared by the
+   CryptoNight slow-hash routines */
+
+#include "hash-ops.h"
+
+#include <stdlib.h>
+
+#if defined(_MSC_VER) || defined(__MINGW32__)
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#endif
+
+#if defined(_MSC_VER)
+#define THREADV __declspec(thread)
+#else
+#define THREADV __thread
+#endif
+
+/* Scratchpads are rounded up to a whole number of these, so they can be
+   backed by huge pages */
+#define SLOW_HASH_HUGE_PAGE_SIZE 2097152
+
+/* How the current arena was allocated, so we know how to free it */
+enum slow_hash_arena_source
+{
+    ARENA_NONE = 0,
+    ARENA_HUGE_PAGES,
+    ARENA_PAGES,
+    ARENA_HEAP
+};
+
+static THREADV uint8_t *arena = NULL;
+
+static THREADV size_t arena_size = 0;
+
+static THREADV enum slow_hash_arena_source arena_source = ARENA_NONE;
+
+static THREADV size_t arena_holds = 0;
+
+#if defined(_MSC_VER) || defined(__MINGW32__)
+
+static BOOL SetLockPagesPrivilege(HANDLE hProcess, BOOL bEnable)
+{
+    struct
+    {
+        DWORD count;
+        LUID_AND_ATTRIBUTES privilege[1];
+    } info;
+
+    HANDLE token;
+
+    if (!OpenProcessToken(hProcess, TOKEN_ADJUST_PRIVILEGES, &token))
+    {
+        return FALSE;
+    }
+
+    info.count = 1;
+    info.privilege[0].Attributes = bEnable ? SE_PRIVILEGE_ENABLED : 0;
+
+    if (!LookupPrivilegeValue(NULL, SE_LOCK_MEMORY_NAME, &(info.privilege[0].Luid)))
+    {
+        return FALSE;
+    }
+
+    if (!AdjustTokenPrivileges(token, FALSE, (PTOKEN_PRIVILEGES)&info, 0, NULL, NULL))
+    {
+        return FALSE;
+    }
+
+    if (GetLastError() != ERROR_SUCCESS)
+    {
+        return FALSE;
+    }
+
+    CloseHandle(token);
+
+    return TRUE;
+}
+
+#endif
+
+static void slow_hash_arena_free(void)
+{
+    switch (arena_source)
+    {
+        case ARENA_HUGE_PAGES:
+        case ARENA_PAGES:
+        {
+#if defined(_MSC_VER) || defined(__MINGW32__)
+            VirtualFree(arena, 0, MEM_RELEASE);
+#else
+            munmap(arena, arena_size);
+#endif
+            break;
+        }
+        case ARENA_HEAP:
+        {
+            free(arena);
+            break;
+        }
+        default:
+        {
+            break;
+        }
+    }
+
+    arena = NULL;
+    arena_size = 0;
+    arena_source = ARENA_NONE;
+}
+
+/**
+ * @brief allocates the arena, trying 2MB huge pages first to reduce TLB
+ * misses during the random accesses to the scratchpad
+ *
+ * Falls back to normal pages (asking for transparent huge pages where the OS
+ * supports them), and then to the heap.
+ */
+static void slow_hash_arena_allocate(size_t size)
+{
+    size = (size + SLOW_HASH_HUGE_PAGE_SIZE - 1) / SLOW_HASH_HUGE_PAGE_SIZE * SLOW_HASH_HUGE_PAGE_SIZE;
+
+#if defined(_MSC_VER) || defined(__MINGW32__)
+    SetLockPagesPrivilege(GetCurrentProcess(), TRUE);
+
+    arena = (uint8_t *)VirtualAlloc(NULL, size, MEM_LARGE_PAGES | MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+
+    if (arena != NULL)
+    {
+        arena_source = ARENA_HUGE_PAGES;
+    }
+#else
+#if defined(MAP_HUGETLB)
+    arena = mmap(0, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+
+    if (arena != MAP_FAILED)
+    {
+        arena_source = ARENA_HUGE_PAGES;
+    }
+    else
+#endif
+    {
+        /* Transparent huge pages can only back 2MB aligned ranges, so map a
+           little extra and trim it back to an aligned arena */
+        uint8_t *mapping =
+            mmap(0, size + SLOW_HASH_HUGE_PAGE_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANON, -1, 0);
+
+        arena = mapping;
+
+        if (mapping != MAP_FAILED)
+        {
+            const size_t offset = (size_t)((uintptr_t)mapping & (SLOW_HASH_HUGE_PAGE_SIZE - 1));
+
+            const size_t head = offset == 0 ? 0 : SLOW_HASH_HUGE_PAGE_SIZE - offset;
+
+            arena = mapping + head;
+
+            if (head != 0)
+            {
+                munmap(mapping, head);
+            }
+
+            munmap(arena + size, SLOW_HASH_HUGE_PAGE_SIZE - head);
+
+            arena_source = ARENA_PAGES;
+
+#if defined(MADV_HUGEPAGE)
+            madvise(arena, size, MADV_HUGEPAGE);
+#endif
+        }
+    }
+
+    if (arena == MAP_FAILED)
+    {
+        arena = NULL;
+    }
+#endif
+
+    if (arena == NULL)
+    {
+        arena = (uint8_t *)malloc(size);
+
+        if (arena == NULL)
+        {
+            abort();
+        }
+
+        arena_source = ARENA_HEAP;
+    }
+
+    arena_size = size;
+}
+
+uint8_t *slow_hash_arena_acquire(size_t size)
+{
+    if (arena != NULL && arena_size >= size)
+    {
+        return arena;
+    }
+
+    slow_hash_arena_free();
+    slow_hash_arena_allocate(size);
+
+    return arena;
+}
+
+void slow_hash_arena_release(void)
+{
+    if (arena_holds == 0)
+    {
+        slow_hash_arena_free();
+    }
+}
+
+void slow_hash_arena_hold(void)
+{
+    arena_holds++;
+}
+
+void slow_hash_arena_unhold(void)
+{
+    if (arena_holds != 0 && --arena_holds == 0)
+    {
+        slow_hash_arena_free();
+    }
+}
+
+int slow_hash_arena_huge_pages(void)
+{
+    return arena_source == ARENA_HUGE_PAGES;
+}
@@ -226,32 +226,6 @@ STATIC INLINE void
     }
 }
 
-#ifdef FORCE_USE_HEAP
-STATIC INLINE void *aligned_malloc(size_t size, size_t align)
-{
-    void *result;
-#ifdef _MSC_VER
-    result = _aligned_malloc(size, align);
-#else /* _MSC_VER */
-    if (posix_memalign(&result, align, size))
-    {
-        result = NULL;
-    }
-#endif /* _MSC_VER */
-
-    return result;
-}
-
-STATIC INLINE void aligned_free(void *ptr)
-{
-#ifdef _MSC_VER
-    _aligned_free(ptr);
-#else /*_MSC_VER */
-    free(ptr);
-#endif /* _MSC_VER */
-}
-#endif /* FORCE_USE_HEAP */
-
 void cn_slow_hash(
     const void *data,
     size_t length,
@@ -274,7 +248,7 @@ void cn_slow_hash(
     RDATA_ALIGN16 uint8_t hp_state[page_size];
 #else /* FORCE_USE_HEAP */
 #pragma message("warning: ACTIVATING FORCE_USE_HEAP IN aarch64 + crypto in slow-hash-arm.c")
-    uint8_t *hp_state = (uint8_t *)aligned_malloc(page_size, 16);
+    uint8_t *hp_state = slow_hash_arena_acquire(page_size);
 #endif /* FORCE_USE_HEAP */
 
     uint8_t text[INIT_SIZE_BYTE];
@@ -365,7 +339,7 @@ void cn_slow_hash(
     extra_hashes[state.hs.b[0] & 3](&state, 200, hash);
 
 #ifdef FORCE_USE_HEAP
-    aligned_free(hp_state);
+    slow_hash_arena_release();
 #endif /*FORCE_USE_HEAP */
 }
 
@@ -533,7 +507,7 @@ void cn_slow_hash(
     uint8_t long_state[page_size];
 #else /* FORCE_USE_HEAP */
 #pragma message("warning: ACTIVATING FORCE_USE_HEAP IN aarch64 && !crypto in slow-hash.c")
-    uint8_t *long_state = (uint8_t *)malloc(page_size);
+    uint8_t *long_state = slow_hash_arena_acquire(page_size);
 #endif /* FORCE_USE_HEAP */
 
     if (prehashed)
@@ -625,7 +599,7 @@ void cn_slow_hash(
     extra_hashes[state.hs.b[0] & 3](&state, 200, hash);
 
 #ifdef FORCE_USE_HEAP
-    free(long_state);
+    slow_hash_arena_release();
 #endif /* FORCE_USE_HEAP */
 }
 
@@ -140,7 +140,7 @@ void cn_slow_hash(
     uint8_t long_state[page_size];
 #else /* FORCE_USE_HEAP */
 #pragma message("warning: ACTIVATING FORCE_USE_HEAP IN slow-hash-portable.c")
-    uint8_t *long_state = (uint8_t *)malloc(page_size);
+    uint8_t *long_state = slow_hash_arena_acquire(page_size);
 #endif /* FORCE_USE_HEAP */
 
     if (prehashed)
@@ -233,7 +233,7 @@ void cn_slow_hash(
     oaes_free((OAES_CTX **)&aes_ctx);
 
 #ifdef FORCE_USE_HEAP
-    free(long_state);
+    slow_hash_arena_release();
 #endif /* FORCE_USE_HEAP */
 }
 
@@ -118,8 +118,6 @@
 
 THREADV uint8_t *hp_state = NULL;
 
-THREADV int hp_allocated = 0;
-
 #if defined(_MSC_VER)
 #define cpuid(info, x) __cpuidex(info, x, 0)
 #else
@@ -359,55 +357,13 @@ STATIC INLINE void
     }
 }
 
-#if defined(_MSC_VER) || defined(__MINGW32__)
-
-BOOL SetLockPagesPrivilege(HANDLE hProcess, BOOL bEnable)
-{
-    struct
-    {
-        DWORD count;
-        LUID_AND_ATTRIBUTES privilege[1];
-    } info;
-
-    HANDLE token;
-
-    if (!OpenProcessToken(hProcess, TOKEN_ADJUST_PRIVILEGES, &token))
-    {
-        return FALSE;
-    }
-
-    info.count = 1;
-    info.privilege[0].Attributes = bEnable ? SE_PRIVILEGE_ENABLED : 0;
-
-    if (!LookupPrivilegeValue(NULL, SE_LOCK_MEMORY_NAME, &(info.privilege[0].Luid)))
-    {
-        return FALSE;
-    }
-
-    if (!AdjustTokenPrivileges(token, FALSE, (PTOKEN_PRIVILEGES)&info, 0, NULL, NULL))
-    {
-        return FALSE;
-    }
-
-    if (GetLastError() != ERROR_SUCCESS)
-    {
-        return FALSE;
-    }
-
-    CloseHandle(token);
-
-    return TRUE;
-}
-
-#endif
-
 /**
- * @brief allocate the 2MB scratch buffer using OS support for huge pages, if available
+ * @brief points hp_state at the thread's scratchpad arena
  *
- * This function tries to allocate the 2MB scratch buffer using a single
- * 2MB "huge page" (instead of the usual 4KB page sizes) to reduce TLB misses
- * during the random accesses to the scratch buffer.  This is one of the
- * important speed optimizations needed to make CryptoNight faster.
+ * The arena is backed by 2MB "huge pages" (instead of the usual 4KB page
+ * sizes) where available, to reduce TLB misses during the random accesses
+ * to the scratch buffer.  This is one of the important speed optimizations
+ * needed to make CryptoNight faster.  See slow-hash-arena.c.
  *
  * No parameters.  Updates a thread-local pointer, hp_state, to point to
  * the allocated buffer.
@@ -415,62 +371,19 @@ BOOL SetLockPagesPrivilege(HANDLE hProcess, BOOL bEnable)
 
 void slow_hash_allocate_state(uint32_t page_size)
 {
-    if (hp_state != NULL)
-    {
-        return;
-    }
-
-#if defined(_MSC_VER) || defined(__MINGW32__)
-    SetLockPagesPrivilege(GetCurrentProcess(), TRUE);
-    hp_state = (uint8_t *)VirtualAlloc(hp_state, page_size, MEM_LARGE_PAGES | MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
-#else
-#if defined(__APPLE__) || defined(__FreeBSD__) || defined(__OpenBSD__) || defined(__DragonFly__) || defined(__NetBSD__)
-    hp_state = mmap(0, page_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANON, 0, 0);
-#else
-    hp_state = mmap(0, page_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, 0, 0);
-#endif
-
-    if (hp_state == MAP_FAILED)
-    {
-        hp_state = NULL;
-    }
-#endif
-
-    hp_allocated = 1;
-
-    if (hp_state == NULL)
-    {
-        hp_allocated = 0;
-        hp_state = (uint8_t *)malloc(page_size);
-    }
+    hp_state = slow_hash_arena_acquire(page_size);
 }
 
 /**
- *@brief frees the state allocated by slow_hash_allocate_state
+ *@brief gives back the state allocated by slow_hash_allocate_state. It is only
+ * freed if the thread isn't holding the arena.
  */
 
 void slow_hash_free_state(uint32_t page_size)
 {
-    if (hp_state == NULL)
-    {
-        return;
-    }
-
-    if (!hp_allocated)
-    {
-        free(hp_state);
-    }
-    else
-    {
-#if defined(_MSC_VER) || defined(__MINGW32__)
-        VirtualFree(hp_state, 0, MEM_RELEASE);
-#else
-        munmap(hp_state, page_size);
-#endif
-    }
+    slow_hash_arena_release();
 
     hp_state = NULL;
-    hp_allocated = 0;
 }
 
 /**
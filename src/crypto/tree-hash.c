@@ -10,6 +10,37 @@
 #include <stddef.h>
 #include <string.h>
 
+/* How many pairs hash_pairs() hands to cn_fast_hash_batch() at once */
+#define TREE_HASH_BATCH 64
+
+/* Hashes pairs of adjacent hashes from in, writing the hash of in[2i] and
+   in[2i + 1] to out[i]. out may be the same buffer as in, as out[i] is only
+   written once that pair has been read, and nothing before the pair is read
+   after that. */
+static void hash_pairs(const char (*in)[HASH_SIZE], size_t pairs, char (*out)[HASH_SIZE])
+{
+    const void *data[TREE_HASH_BATCH];
+    size_t lengths[TREE_HASH_BATCH];
+    size_t i, n;
+
+    while (pairs > 0)
+    {
+        n = pairs < TREE_HASH_BATCH ? pairs : TREE_HASH_BATCH;
+
+        for (i = 0; i < n; i++)
+        {
+            data[i] = in[2 * i];
+            lengths[i] = 2 * HASH_SIZE;
+        }
+
+        cn_fast_hash_batch(data, lengths, out, n);
+
+        in += 2 * n;
+        out += n;
+        pairs -= n;
+    }
+}
+
 void tree_hash(const char (*hashes)[HASH_SIZE], size_t count, char *root_hash)
 {
     assert(count > 0);
@@ -33,18 +64,12 @@ void tree_hash(const char (*hashes)[HASH_SIZE], size_t count, char *root_hash)
         cnt &= ~(cnt >> 1);
         ints = alloca(cnt * HASH_SIZE);
         memcpy(ints, hashes, (2 * cnt - count) * HASH_SIZE);
-        for (i = 2 * cnt - count, j = 2 * cnt - count; j < cnt; i += 2, ++j)
-        {
-            cn_fast_hash(hashes[i], 2 * HASH_SIZE, ints[j]);
-        }
-        assert(i == count);
+        j = 2 * cnt - count;
+        hash_pairs(hashes + j, cnt - j, ints + j);
         while (cnt > 2)
         {
             cnt >>= 1;
-            for (i = 0, j = 0; j < cnt; i += 2, ++j)
-            {
-                cn_fast_hash(ints[i], 2 * HASH_SIZE, ints[j]);
-            }
+            hash_pairs(ints, cnt, ints);
         }
         cn_fast_hash(ints[0], 2 * HASH_SIZE, root_hash);
     }
@@ -85,21 +110,16 @@ void tree_branch(const char (*hashes)[HASH_SIZE], size_t count, char (*branch)[H
     assert(depth == tree_depth(count));
     ints = alloca((cnt - 1) * HASH_SIZE);
     memcpy(ints, hashes + 1, (2 * cnt - count - 1) * HASH_SIZE);
-    for (i = 2 * cnt - count, j = 2 * cnt - count - 1; j < cnt - 1; i += 2, ++j)
-    {
-        cn_fast_hash(hashes[i], 2 * HASH_SIZE, ints[j]);
-    }
-    assert(i == count);
+    i = 2 * cnt - count;
+    j = 2 * cnt - count - 1;
+    hash_pairs(hashes + i, cnt - 1 - j, ints + j);
     while (depth > 0)
     {
         assert(cnt == 1ULL << depth);
         cnt >>= 1;
         --depth;
         memcpy(branch[depth], ints[0], HASH_SIZE);
-        for (i = 1, j = 0; j < cnt - 1; i += 2, ++j)
-        {
-            cn_fast_hash(ints[i], 2 * HASH_SIZE, ints[j]);
-        }
+        hash_pairs(ints + 1, cnt - 1, ints);
     }
 }
 
@@ -0,0 +1,270 @@
+// Copyright (c) 2018-2020, The TurtleCoin Developers
+//
+// Please see the included LICENSE file for more information.
+
+///////////////////////////////////////////////////
+#include <cryptonotecore/BlockCadenceController.h>
+///////////////////////////////////////////////////
+
+#include <algorithm>
+#include <config/CryptoNoteConfig.h>
+#include <cryptonotecore/ITimeProvider.h>
+#include <utilities/Metrics.h>
+
+namespace CryptoNote
+{
+    namespace
+    {
+        /* Milliseconds */
+        const uint64_t ARRIVAL_WINDOW = 1000;
+
+        /* After this many windows without arrivals the rate is as good as
+           zero */
+        const uint64_t MAX_EMPTY_WINDOWS = 16;
+
+        uint64_t nowMilliseconds()
+        {
+            return timeProvider().nowMicroseconds() / 1000;
+        }
+
+        uint64_t divideRoundingUp(const uint64_t a, const uint64_t b)
+        {
+            return (a + b - 1) / b;
+        }
+
+        Metrics::Gauge &blockSizeGauge()
+        {
+            static Metrics::Gauge &gauge = Metrics::registry().gauge(
+                "cadence_block_size_bytes", "Transaction bytes the next block template is filled to");
+
+            return gauge;
+        }
+
+        Metrics::Gauge &arrivalRateGauge()
+        {
+            static Metrics::Gauge &gauge = Metrics::registry().gauge(
+                "cadence_arrival_rate_bytes", "Bytes per second of transactions arriving in the pool");
+
+            return gauge;
+        }
+    } // namespace
+
+    void BlockCadenceController::setPolicy(const BlockPolicy policy)
+    {
+        m_policy.store(policy, std::memory_order_relaxed);
+    }
+
+    BlockPolicy BlockCadenceController::getPolicy() const
+    {
+        return m_policy.load(std::memory_order_relaxed);
+    }
+
+    void BlockCadenceController::setDeadlineSlack(const uint64_t slack)
+    {
+        m_deadlineSlack.store(slack, std::memory_order_relaxed);
+    }
+
+    void BlockCadenceController::setBlockSizeLimits(const uint64_t staticBlockSize, const uint64_t maxBlockSize)
+    {
+        m_staticBlockSize.store(staticBlockSize, std::memory_order_relaxed);
+        m_maxBlockSize.store(std::max(staticBlockSize, maxBlockSize), std::memory_order_relaxed);
+    }
+
+    uint64_t BlockCadenceController::getAdmissionBlockSize() const
+    {
+        if (getPolicy() == BlockPolicy::Adaptive)
+        {
+            return m_maxBlockSize.load(std::memory_order_relaxed);
+        }
+
+        return m_staticBlockSize.load(std::memory_order_relaxed);
+    }
+
+    void BlockCadenceController::recordArrival(const uint64_t bytes)
+    {
+        const uint64_t now = nowMilliseconds();
+
+        std::scoped_lock lock(m_arrivalMutex);
+
+        advanceWindow(now);
+
+        m_windowBytes += bytes;
+    }
+
+    uint64_t BlockCadenceController::arrivalRate(const uint64_t now) const
+    {
+        std::scoped_lock lock(m_arrivalMutex);
+
+        advanceWindow(now);
+
+        return m_arrivalRate;
+    }
+
+    void BlockCadenceController::advanceWindow(const uint64_t now) const
+    {
+        if (m_windowStart == 0 || now < m_windowStart)
+        {
+            m_windowStart = now;
+            return;
+        }
+
+        const uint64_t windows = (now - m_windowStart) / ARRIVAL_WINDOW;
+
+        if (windows == 0)
+        {
+            return;
+        }
+
+        /* Moving average, with the newest window weighted 1/4 */
+        m_arrivalRate = (m_arrivalRate * 3 + m_windowBytes * 1000 / ARRIVAL_WINDOW) / 4;
+
+        /* Then any windows since that saw nothing arrive */
+        for (uint64_t i = 1; i < std::min(windows, MAX_EMPTY_WINDOWS); i++)
+        {
+            m_arrivalRate = m_arrivalRate * 3 / 4;
+        }
+
+        if (windows >= MAX_EMPTY_WINDOWS)
+        {
+            m_arrivalRate = 0;
+        }
+
+        m_windowStart += windows * ARRIVAL_WINDOW;
+        m_windowBytes = 0;
+    }
+
+    BlockCadencePlan BlockCadenceController::plan(
+        const std::vector<std::pair<uint64_t, uint64_t>> &demand,
+        const CapacityForecast &forecast,
+        const uint64_t lastBlockTime) const
+    {
+        BlockCadencePlan plan;
+
+        plan.policy = getPolicy();
+        plan.now = forecast.now;
+        plan.interval = std::max<uint64_t>(forecast.interval, 1);
+        plan.staticBlockSize = m_staticBlockSize.load(std::memory_order_relaxed);
+        plan.maxBlockSize = m_maxBlockSize.load(std::memory_order_relaxed);
+        plan.arrivalRate = arrivalRate(plan.now);
+
+        const uint64_t slack = m_deadlineSlack.load(std::memory_order_relaxed);
+
+        /* Enough to carry what arrives between blocks, and for every deadline,
+           everything due by it spread over the blocks we can seal before it.
+           Deadlines too close to make whatever the size don't count. */
+        plan.requiredBlockSize = plan.arrivalRate * plan.interval / 1000;
+
+        uint64_t earliestDeadline = 0;
+
+        for (const auto &[deadline, bytes] : demand)
+        {
+            plan.poolBytes += bytes;
+
+            if (deadline == 0)
+            {
+                continue;
+            }
+
+            if (earliestDeadline == 0)
+            {
+                earliestDeadline = deadline;
+            }
+
+            const uint64_t sealBy = deadline - std::min(deadline, slack);
+
+            if (sealBy < plan.now)
+            {
+                continue;
+            }
+
+            const uint64_t blocks = 1 + (sealBy - plan.now) / plan.interval;
+
+            plan.requiredBlockSize = std::max(plan.requiredBlockSize, divideRoundingUp(plan.poolBytes, blocks));
+        }
+
+        if (plan.policy == BlockPolicy::Static)
+        {
+            plan.blockSize = plan.staticBlockSize;
+
+            if (earliestDeadline != 0)
+            {
+                plan.sealAt = earliestDeadline - std::min(earliestDeadline, slack);
+            }
+
+            blockSizeGauge().set(plan.blockSize);
+            arrivalRateGauge().set(plan.arrivalRate);
+
+            return plan;
+        }
+
+        plan.blockSize = std::clamp(plan.requiredBlockSize, plan.staticBlockSize, plan.maxBlockSize);
+
+        blockSizeGauge().set(plan.blockSize);
+        arrivalRateGauge().set(plan.arrivalRate);
+
+        if (plan.poolBytes == 0 || plan.blockSize == 0)
+        {
+            return plan;
+        }
+
+        /* Blocks are filled in deadline order, so a deadline with more due
+           by it than one block holds needs the blocks before it sealed that
+           many intervals sooner */
+        uint64_t due = 0;
+
+        for (const auto &[deadline, bytes] : demand)
+        {
+            due += bytes;
+
+            /* Lost already, sealing early won't bring it back */
+            if (deadline == 0 || deadline < plan.now)
+            {
+                continue;
+            }
+
+            const uint64_t sealBy = deadline - std::min(deadline, slack);
+
+            const uint64_t earlier = (divideRoundingUp(due, plan.blockSize) - 1) * plan.interval;
+
+            plan.sealAt = std::min(plan.sealAt, sealBy - std::min(sealBy, earlier));
+        }
+
+        /* No use waiting once a full block is ready - anything else arriving
+           would have to wait for the next one anyway */
+        if (plan.poolBytes >= plan.blockSize)
+        {
+            plan.sealAt = plan.now;
+        }
+        else if (plan.arrivalRate != 0)
+        {
+            plan.sealAt = std::min(
+                plan.sealAt, plan.now + (plan.blockSize - plan.poolBytes) * 1000 / plan.arrivalRate);
+        }
+
+        if (plan.sealAt != BlockCadencePlan::NO_SEAL_TIME && lastBlockTime != 0)
+        {
+            plan.sealAt = std::max(plan.sealAt, lastBlockTime + parameters::BLOCK_CADENCE_MIN_INTERVAL);
+        }
+
+        return plan;
+    }
+
+    std::string BlockCadenceController::policyName(const BlockPolicy policy)
+    {
+        switch (policy)
+        {
+            case BlockPolicy::Static:
+            {
+                return "static";
+            }
+            case BlockPolicy::Adaptive:
+            {
+                return "adaptive";
+            }
+            default:
+            {
+                return "unknown";
+            }
+        }
+    }
+} // namespace CryptoNote
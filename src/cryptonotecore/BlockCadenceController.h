@@ -0,0 +1,136 @@
+// Copyright (c) 2018-2020, The TurtleCoin Developers
+//
+// Please see the included LICENSE file for more information.
+
+#pragma once
+
+#include "TransactionAdmissionController.h"
+
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace CryptoNote
+{
+    //RTcoin
+    /* How block templates are sized, and when the next block is due */
+    enum class BlockPolicy
+    {
+        /* 125% of the median block size, sealed a fixed slack before the
+           earliest deadline in the pool */
+        Static,
+
+        /* Sized and sealed from the pool's deadlines and arrival rate */
+        Adaptive
+    };
+
+    /* What the cadence controller decided for the next block, and the inputs
+       it decided it from. Times are unix milliseconds, sizes are bytes of
+       transactions. */
+    struct BlockCadencePlan
+    {
+        static constexpr uint64_t NO_SEAL_TIME = std::numeric_limits<uint64_t>::max();
+
+        BlockPolicy policy = BlockPolicy::Static;
+
+        uint64_t now = 0;
+
+        /* The next block template is filled up to this */
+        uint64_t blockSize = 0;
+
+        /* When the next block should be sealed by. NO_SEAL_TIME if the pool
+           is empty, or nothing in it has a deadline to hurry it along. */
+        uint64_t sealAt = NO_SEAL_TIME;
+
+        /* What the static policy uses */
+        uint64_t staticBlockSize = 0;
+
+        /* The most the adaptive policy uses */
+        uint64_t maxBlockSize = 0;
+
+        /* The smallest block size that meets every deadline in the pool, and
+           keeps up with transactions arriving */
+        uint64_t requiredBlockSize = 0;
+
+        /* Bytes per second */
+        uint64_t arrivalRate = 0;
+
+        uint64_t poolBytes = 0;
+
+        /* Milliseconds assumed between the blocks after the next */
+        uint64_t interval = 0;
+    };
+
+    /* Chooses how big the next block template is, and when to seal it.
+
+       The static policy sizes every template at 125% of the median block
+       size, as fillBlockTemplate() always has. The adaptive policy grows
+       the template past that, up to BLOCK_CADENCE_MAX_SIZE_PERCENT of the
+       median (short of twice the median, where the reward penalty takes the
+       whole reward) or the maximum cumulative block size, when the pool's
+       deadlines or arrival rate need it. It brings the seal time forward for
+       the same reasons - deadlines that need more than one block to clear,
+       or a block's worth of transactions already waiting.
+
+       Safe to call from any thread. */
+    class BlockCadenceController
+    {
+      public:
+        void setPolicy(const BlockPolicy policy);
+
+        BlockPolicy getPolicy() const;
+
+        /* Milliseconds before a deadline its block should be sealed */
+        void setDeadlineSlack(const uint64_t slack);
+
+        /* Bytes of transactions, for the static and adaptive policies, at
+           the current median */
+        void setBlockSizeLimits(const uint64_t staticBlockSize, const uint64_t maxBlockSize);
+
+        /* The block size admission control should assume - the largest
+           block the policy may make */
+        uint64_t getAdmissionBlockSize() const;
+
+        /* Called with each transaction added to the pool */
+        void recordArrival(const uint64_t bytes);
+
+        /* demand is the pool's bytes per deadline, earliest first, as from
+           ITransactionPool::getDeadlineDemand() */
+        BlockCadencePlan plan(
+            const std::vector<std::pair<uint64_t, uint64_t>> &demand,
+            const CapacityForecast &forecast,
+            const uint64_t lastBlockTime) const;
+
+        static std::string policyName(const BlockPolicy policy);
+
+      private:
+        /* Bytes per second, as of now */
+        uint64_t arrivalRate(const uint64_t now) const;
+
+        /* Closes any windows that have ended by now. m_arrivalMutex must be
+           held. */
+        void advanceWindow(const uint64_t now) const;
+
+        std::atomic<BlockPolicy> m_policy {BlockPolicy::Static};
+
+        std::atomic<uint64_t> m_deadlineSlack {0};
+
+        std::atomic<uint64_t> m_staticBlockSize {0};
+
+        std::atomic<uint64_t> m_maxBlockSize {0};
+
+        /* Arrivals are counted in windows of a second, and the rate is a
+           moving average of those windows */
+        mutable std::mutex m_arrivalMutex;
+
+        /* Unix milliseconds */
+        mutable uint64_t m_windowStart = 0;
+
+        mutable uint64_t m_windowBytes = 0;
+
+        mutable uint64_t m_arrivalRate = 0;
+    };
+} // namespace CryptoNote
@@ -10,6 +10,7 @@
 
 #include <common/Varint.h>
 #include <config/CryptoNoteConfig.h>
+#include <map>
 
 using namespace Crypto;
 using namespace CryptoNote;
@@ -81,6 +82,57 @@ const Crypto::Hash &CachedBlock::getBlockLongHash() const
     }
 }
 
+void CachedBlock::computeBlockLongHashes(const std::vector<CachedBlock> &blocks)
+{
+    /* Older versions are hashed one at a time - keep the scratchpad around
+       between them */
+    const SlowHashArena arena;
+
+    /* Blocks still to be hashed, grouped by major version */
+    std::map<uint8_t, std::vector<const CachedBlock *>> pending;
+
+    for (const auto &cachedBlock : blocks)
+    {
+        if (cachedBlock.blockLongHash.is_initialized())
+        {
+            continue;
+        }
+
+        if (CryptoNote::BATCH_HASHING_ALGORITHMS_BY_BLOCK_VERSION.count(cachedBlock.block.majorVersion) == 0)
+        {
+            cachedBlock.getBlockLongHash();
+            continue;
+        }
+
+        pending[cachedBlock.block.majorVersion].push_back(&cachedBlock);
+    }
+
+    for (const auto &[majorVersion, versionBlocks] : pending)
+    {
+        const auto hashingAlgorithm = CryptoNote::BATCH_HASHING_ALGORITHMS_BY_BLOCK_VERSION.at(majorVersion);
+
+        std::vector<const uint8_t *> data;
+        std::vector<size_t> lengths;
+
+        for (const auto cachedBlock : versionBlocks)
+        {
+            const BinaryArray &rawHashingBlock = cachedBlock->getParentBlockHashingBinaryArray(true);
+
+            data.push_back(rawHashingBlock.data());
+            lengths.push_back(rawHashingBlock.size());
+        }
+
+        std::vector<Hash> hashes(versionBlocks.size());
+
+        hashingAlgorithm(data.data(), lengths.data(), hashes.data(), hashes.size());
+
+        for (size_t i = 0; i < versionBlocks.size(); i++)
+        {
+            versionBlocks[i]->blockLongHash = hashes[i];
+        }
+    }
+}
+
 const Crypto::Hash &CachedBlock::getAuxiliaryBlockHeaderHash() const
 {
     if (!auxiliaryBlockHeaderHash.is_initialized())
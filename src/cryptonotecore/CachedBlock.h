@@ -8,6 +8,7 @@
 
 #include <CryptoNote.h>
 #include <boost/optional.hpp>
+#include <vector>
 
 namespace CryptoNote
 {
@@ -34,6 +35,13 @@ namespace CryptoNote
 
         uint32_t getBlockIndex() const;
 
+        //RTcoin
+        /* Fills in getBlockLongHash() for every block, hashing blocks of the
+           same major version together where the hashing algorithm supports
+           it. Lets a batch of blocks being validated share one pass through
+           the slow hash. */
+        static void computeBlockLongHashes(const std::vector<CachedBlock> &blocks);
+
       private:
         const BlockTemplate &block;
 
@@ -25,6 +25,19 @@ CachedTransaction::CachedTransaction(const BinaryArray &transactionBinaryArray):
     }
 }
 
+CachedTransaction::CachedTransaction(const TransactionView &view):
+    transactionBinaryArray(BinaryArray(view.data(), view.data() + view.size())),
+    transactionHash(view.getTransactionHash()),
+    transactionPrefixHash(view.getTransactionPrefixHash()),
+    transactionFee(view.getTransactionFee()),
+    transactionAmount(view.getTransactionAmount())
+{
+    if (!fromBinaryArray<Transaction>(transaction, this->transactionBinaryArray.value()))
+    {
+        throw std::runtime_error("CachedTransaction::CachedTransaction(TransactionView&), deserealization error.");
+    }
+}
+
 const Transaction &CachedTransaction::getTransaction() const
 {
     return transaction;
@@ -50,6 +63,48 @@ const Crypto::Hash &CachedTransaction::getTransactionPrefixHash() const
     return transactionPrefixHash.value();
 }
 
+void CachedTransaction::computeTransactionHashes(const std::vector<CachedTransaction> &transactions)
+{
+    std::vector<const void *> data;
+    std::vector<size_t> lengths;
+    std::vector<std::optional<Crypto::Hash> *> results;
+
+    /* The prefixes aren't kept around, so hold onto them until hashed */
+    std::vector<BinaryArray> prefixes;
+
+    prefixes.reserve(transactions.size());
+
+    for (const auto &cachedTransaction : transactions)
+    {
+        if (!cachedTransaction.transactionHash)
+        {
+            const BinaryArray &binaryArray = cachedTransaction.getTransactionBinaryArray();
+
+            data.push_back(binaryArray.data());
+            lengths.push_back(binaryArray.size());
+            results.push_back(&cachedTransaction.transactionHash);
+        }
+
+        if (!cachedTransaction.transactionPrefixHash)
+        {
+            prefixes.push_back(toBinaryArray(static_cast<const TransactionPrefix &>(cachedTransaction.transaction)));
+
+            data.push_back(prefixes.back().data());
+            lengths.push_back(prefixes.back().size());
+            results.push_back(&cachedTransaction.transactionPrefixHash);
+        }
+    }
+
+    std::vector<Crypto::Hash> hashes(data.size());
+
+    cn_fast_hash_batch(data.data(), lengths.data(), hashes.data(), hashes.size());
+
+    for (size_t i = 0; i < hashes.size(); i++)
+    {
+        *results[i] = hashes[i];
+    }
+}
+
 const BinaryArray &CachedTransaction::getTransactionBinaryArray() const
 {
     if (!transactionBinaryArray)
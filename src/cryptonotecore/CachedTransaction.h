@@ -7,7 +7,9 @@
 
 #include <CryptoNote.h>
 #include <boost/optional.hpp>
+#include <cryptonotecore/TransactionView.h>
 #include <optional>
+#include <vector>
 
 namespace CryptoNote
 {
@@ -20,6 +22,11 @@ namespace CryptoNote
 
         explicit CachedTransaction(const BinaryArray &transactionBinaryArray);
 
+        //RTcoin
+        /* Copies the viewed transaction, taking the hashes, fee and amount
+           from the view rather than working them out again */
+        explicit CachedTransaction(const TransactionView &view);
+
         const Transaction &getTransaction() const;
 
         const Crypto::Hash &getTransactionHash() const;
@@ -32,6 +39,12 @@ namespace CryptoNote
 
         uint64_t getTransactionAmount() const;
 
+        //RTcoin
+        /* Works out the transaction and prefix hashes of every transaction
+           given that doesn't have them yet, hashing them side by side with
+           cn_fast_hash_batch rather than one at a time */
+        static void computeTransactionHashes(const std::vector<CachedTransaction> &transactions);
+
       private:
         Transaction transaction;
 
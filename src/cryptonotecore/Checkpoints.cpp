@@ -7,12 +7,45 @@
 
 #include <common/StringTools.h>
 #include <config/Constants.h>
+#include <cstring>
 #include <fstream>
+#include <iterator>
+#include <limits>
 
 using namespace Logging;
 
 namespace CryptoNote
 {
+    namespace
+    {
+        /* Binary checkpoints file layout, little endian:
+
+           header      BinaryHeader
+           hashes      count hashes, for heights firstIndex to firstIndex + count - 1,
+                       NULL_HASH where that height has no checkpoint
+           digest      cn_fast_hash of the header and hashes
+
+           The hashes are used straight from the mapped file. */
+        struct BinaryHeader
+        {
+            char magic[8];
+
+            uint32_t version;
+
+            uint32_t firstIndex;
+
+            uint32_t count;
+
+            uint32_t reserved;
+        };
+
+        static_assert(sizeof(BinaryHeader) == 24, "Checkpoint header must be packed");
+
+        const char BINARY_MAGIC[8] = {'R', 'T', 'C', 'K', 'P', 'T', '\0', '\0'};
+
+        const uint32_t BINARY_VERSION = 1;
+    } // namespace
+
     //---------------------------------------------------------------------------
     Checkpoints::Checkpoints(std::shared_ptr<Logging::ILogger> log): logger(log, "checkpoints") {}
 
@@ -21,26 +54,48 @@ namespace CryptoNote
     {
         Crypto::Hash h = Constants::NULL_HASH;
 
-        if (!Common::podFromHex(hash_str, h))
+        if (!Common::podFromHex(hash_str, h) || h == Constants::NULL_HASH)
         {
             logger(ERROR, BRIGHT_RED) << "INVALID HASH IN CHECKPOINTS!";
             return false;
         }
 
-        /* The return value lets us check if it was inserted or not. If it wasn't,
-           there is already a key (i.e., a height value) existing */
-        if (!points.insert({index, h}).second)
+        unmapFile();
+
+        if (points.empty())
+        {
+            firstIndex = index;
+        }
+        else if (index < firstIndex)
+        {
+            /* Only happens if the checkpoints are out of order */
+            points.insert(points.begin(), firstIndex - index, Constants::NULL_HASH);
+            firstIndex = index;
+        }
+
+        const uint64_t offset = index - firstIndex;
+
+        if (offset >= points.size())
+        {
+            points.resize(offset + 1, Constants::NULL_HASH);
+        }
+        /* If the height already has a hash, there's a duplicate */
+        else if (points[offset] != Constants::NULL_HASH)
         {
             logger(ERROR, BRIGHT_RED) << "CHECKPOINT ALREADY EXISTS!";
             return false;
         }
 
+        points[offset] = h;
+
+        pointCount = points.size();
+
         return true;
     }
 
     bool Checkpoints::loadCheckpointsFromFile(const std::string &filename)
     {
-        std::ifstream file(filename);
+        std::ifstream file(filename, std::ios::binary);
 
         if (!file)
         {
@@ -49,6 +104,60 @@ namespace CryptoNote
             return false;
         }
 
+        //RTcoin
+        char magic[sizeof(BINARY_MAGIC)] = {};
+
+        file.read(magic, sizeof(magic));
+
+        if (file.gcount() == sizeof(magic) && std::memcmp(magic, BINARY_MAGIC, sizeof(magic)) == 0)
+        {
+            file.close();
+
+            auto mapping = std::make_shared<System::MemoryMappedFile>();
+
+            std::error_code ec;
+
+            mapping->open(filename, ec);
+
+            if (!ec && loadBinaryCheckpoints(filename, mapping->data(), mapping->size()))
+            {
+                points.clear();
+                points.shrink_to_fit();
+
+                mappedFile = mapping;
+
+                return true;
+            }
+
+            /* The file may just be read only - read it in, instead */
+            if (ec)
+            {
+                std::ifstream input(filename, std::ios::binary);
+
+                const std::vector<uint8_t> data(
+                    (std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+
+                if (loadBinaryCheckpoints(filename, data.data(), data.size()))
+                {
+                    const BinaryHeader *header = reinterpret_cast<const BinaryHeader *>(data.data());
+
+                    const Crypto::Hash *hashes =
+                        reinterpret_cast<const Crypto::Hash *>(data.data() + sizeof(BinaryHeader));
+
+                    mappedFile.reset();
+
+                    points.assign(hashes, hashes + header->count);
+
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+        file.clear();
+        file.seekg(0);
+
         /* The block this checkpoint is for (as a string) */
         std::string indexString;
 
@@ -58,6 +167,8 @@ namespace CryptoNote
         /* The block index (as a uint64_t) */
         uint64_t index;
 
+        uint64_t loaded = 0;
+
         /* Checkpoints file has this format:
 
            index,hash
@@ -78,6 +189,8 @@ namespace CryptoNote
                 {
                     return false;
                 }
+
+                loaded++;
             }
             catch (const std::out_of_range &)
             {
@@ -94,28 +207,158 @@ namespace CryptoNote
             }
         }
 
-        logger(INFO) << "Loaded " << points.size() << " checkpoints from " << filename;
+        logger(INFO) << "Loaded " << loaded << " checkpoints from " << filename;
 
         return true;
     }
 
+    //RTcoin
+    bool Checkpoints::loadBinaryCheckpoints(const std::string &filename, const uint8_t *data, uint64_t size)
+    {
+        BinaryHeader header;
+
+        if (size < sizeof(header) + sizeof(Crypto::Hash))
+        {
+            logger(ERROR, BRIGHT_RED) << "Invalid checkpoint file - too short: " << filename;
+            return false;
+        }
+
+        std::memcpy(&header, data, sizeof(header));
+
+        if (header.version != BINARY_VERSION)
+        {
+            logger(ERROR, BRIGHT_RED) << "Unsupported checkpoint file version " << header.version << ": " << filename;
+            return false;
+        }
+
+        const uint64_t hashesSize = static_cast<uint64_t>(header.count) * sizeof(Crypto::Hash);
+
+        if (size != sizeof(header) + hashesSize + sizeof(Crypto::Hash))
+        {
+            logger(ERROR, BRIGHT_RED) << "Invalid checkpoint file - size doesn't match the header: " << filename;
+            return false;
+        }
+
+        /* Hashing is the one pass over the file, and only reads it - a few
+           milliseconds per million checkpoints */
+        const Crypto::Hash digest = Crypto::cn_fast_hash(data, sizeof(header) + hashesSize);
+
+        if (std::memcmp(&digest, data + sizeof(header) + hashesSize, sizeof(digest)) != 0)
+        {
+            logger(ERROR, BRIGHT_RED) << "Invalid checkpoint file - digest mismatch, file is corrupt: " << filename;
+            return false;
+        }
+
+        const Crypto::Hash *hashes = reinterpret_cast<const Crypto::Hash *>(data + sizeof(header));
+
+        if (header.count != 0 && hashes[header.count - 1] == Constants::NULL_HASH)
+        {
+            logger(ERROR, BRIGHT_RED) << "Invalid checkpoint file - last height has no checkpoint: " << filename;
+            return false;
+        }
+
+        firstIndex = header.firstIndex;
+        pointCount = header.count;
+
+        if (pointCount != 0)
+        {
+            logger(INFO) << "Loaded checkpoints for heights " << firstIndex << " to " << firstIndex + pointCount - 1
+                         << " from " << filename;
+        }
+
+        return true;
+    }
+
+    //RTcoin
+    bool Checkpoints::saveCheckpointsToFile(const std::string &filename) const
+    {
+        if (pointCount > std::numeric_limits<uint32_t>::max())
+        {
+            logger(ERROR, BRIGHT_RED) << "Too many checkpoints to save";
+            return false;
+        }
+
+        BinaryHeader header;
+
+        std::memcpy(header.magic, BINARY_MAGIC, sizeof(header.magic));
+        header.version = BINARY_VERSION;
+        header.firstIndex = firstIndex;
+        header.count = static_cast<uint32_t>(pointCount);
+        header.reserved = 0;
+
+        const uint8_t *hashes = reinterpret_cast<const uint8_t *>(getHashes());
+
+        const uint8_t *headerBytes = reinterpret_cast<const uint8_t *>(&header);
+
+        std::vector<uint8_t> data(headerBytes, headerBytes + sizeof(header));
+
+        data.insert(data.end(), hashes, hashes + pointCount * sizeof(Crypto::Hash));
+
+        const Crypto::Hash digest = Crypto::cn_fast_hash(data.data(), data.size());
+
+        data.insert(data.end(), digest.data, digest.data + sizeof(digest.data));
+
+        std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+
+        file.write(reinterpret_cast<const char *>(data.data()), data.size());
+
+        if (!file)
+        {
+            logger(ERROR, BRIGHT_RED) << "Could not write checkpoints file: " << filename;
+            return false;
+        }
+
+        return true;
+    }
+
+    const Crypto::Hash *Checkpoints::getHashes() const
+    {
+        if (mappedFile)
+        {
+            return reinterpret_cast<const Crypto::Hash *>(mappedFile->data() + sizeof(BinaryHeader));
+        }
+
+        return points.data();
+    }
+
+    void Checkpoints::unmapFile()
+    {
+        if (!mappedFile)
+        {
+            return;
+        }
+
+        const Crypto::Hash *hashes = getHashes();
+
+        points.assign(hashes, hashes + pointCount);
+
+        mappedFile.reset();
+    }
+
     //---------------------------------------------------------------------------
     bool Checkpoints::isInCheckpointZone(uint32_t index) const
     {
-        return !points.empty() && (index <= (--points.end())->first);
+        return pointCount != 0 && index < firstIndex + pointCount;
     }
 
     //---------------------------------------------------------------------------
     bool Checkpoints::checkBlock(uint32_t index, const Crypto::Hash &h, bool &isCheckpoint) const
     {
-        auto it = points.find(index);
-        isCheckpoint = it != points.end();
+        const Crypto::Hash *expected = nullptr;
+
+        if (index >= firstIndex && index - firstIndex < pointCount)
+        {
+            expected = getHashes() + (index - firstIndex);
+        }
+
+        isCheckpoint = expected != nullptr && *expected != Constants::NULL_HASH;
+
         if (!isCheckpoint)
         {
             return true;
         }
 
-        if (it->second == h)
+        if (*expected == h)
         {
             if (index % 100 == 0)
             {
@@ -126,7 +369,7 @@ namespace CryptoNote
         else
         {
             logger(Logging::WARNING, BRIGHT_YELLOW) << "CHECKPOINT FAILED FOR HEIGHT " << index
-                                                    << ". EXPECTED HASH: " << it->second << ", FETCHED HASH: " << h;
+                                                    << ". EXPECTED HASH: " << *expected << ", FETCHED HASH: " << h;
             return false;
         }
     }
@@ -8,7 +8,9 @@
 #include "CryptoNoteBasicImpl.h"
 
 #include <logging/LoggerRef.h>
-#include <map>
+#include <memory>
+#include <system/MemoryMappedFile.h>
+#include <vector>
 
 namespace CryptoNote
 {
@@ -19,8 +21,15 @@ namespace CryptoNote
 
         bool addCheckpoint(uint32_t index, const std::string &hash_str);
 
+        /* Loads either a CSV of index,hash lines, or a binary file written by
+           saveCheckpointsToFile(), which is told apart by its header */
         bool loadCheckpointsFromFile(const std::string &fileName);
 
+        //RTcoin
+        /* Writes the checkpoints in the binary format, which loads without
+           any parsing */
+        bool saveCheckpointsToFile(const std::string &fileName) const;
+
         bool isInCheckpointZone(uint32_t index) const;
 
         bool checkBlock(uint32_t index, const Crypto::Hash &h) const;
@@ -28,7 +37,27 @@ namespace CryptoNote
         bool checkBlock(uint32_t index, const Crypto::Hash &h, bool &isCheckpoint) const;
 
       private:
-        std::map<uint32_t, Crypto::Hash> points;
+        bool loadBinaryCheckpoints(const std::string &fileName, const uint8_t *data, uint64_t size);
+
+        /* Hash of every height from firstIndex on, either from points, or from
+           the mapped file. NULL_HASH where there's no checkpoint */
+        const Crypto::Hash *getHashes() const;
+
+        /* Copy the mapped hashes into points, so more can be added */
+        void unmapFile();
+
+        //RTcoin
+        /* Dense, indexed by height - firstIndex, so lookups are constant time */
+        std::vector<Crypto::Hash> points;
+
+        /* Backs the hashes instead of points, when loaded from a binary file.
+           Shared so checkpoints can still be copied */
+        std::shared_ptr<System::MemoryMappedFile> mappedFile;
+
+        uint32_t firstIndex = 0;
+
+        /* Heights covered, from firstIndex. The last always has a checkpoint */
+        uint64_t pointCount = 0;
 
         Logging::LoggerRef logger;
     };
@@ -25,8 +25,10 @@
 #include <cryptonotecore/TransactionApi.h>
 #include <cryptonotecore/TransactionPool.h>
 #include <cryptonotecore/TransactionPoolCleaner.h>
+#include <cryptonotecore/TransactionPoolSnapshot.h>
 #include <cryptonotecore/UpgradeManager.h>
 #include <cryptonoteprotocol/CryptoNoteProtocolHandlerCommon.h>
+#include <fstream>
 #include <numeric>
 #include <set>
 #include <system/Timer.h>
@@ -34,7 +36,9 @@
 #include <utilities/Container.h>
 #include <utilities/FormatTools.h>
 #include <utilities/LicenseCanary.h>
+#include <utilities/Metrics.h>
 #include <utilities/ParseExtra.h>
+#include <utilities/Tracing.h>
 
 using namespace Crypto;
 
@@ -132,6 +136,96 @@ namespace CryptoNote
             return CachedBlock(blockTemplate).getBlockHash();
         }
 
+        //RTcoin
+        /* What happened to a block given to addBlock(), as a metric label */
+        const char *blockResultName(const std::error_code &result)
+        {
+            if (result == error::AddBlockErrorCode::ALREADY_EXISTS)
+            {
+                return "already_exists";
+            }
+
+            if (result == error::AddBlockErrorCondition::BLOCK_ADDED)
+            {
+                return "added";
+            }
+
+            if (result == error::AddBlockErrorCondition::BLOCK_REJECTED)
+            {
+                return "orphaned";
+            }
+
+            if (result == error::AddBlockErrorCondition::DESERIALIZATION_FAILED)
+            {
+                return "deserialization_failed";
+            }
+
+            if (result == error::AddBlockErrorCondition::BLOCK_VALIDATION_FAILED)
+            {
+                return "invalid_block";
+            }
+
+            if (result == error::AddBlockErrorCondition::TRANSACTION_VALIDATION_FAILED)
+            {
+                return "invalid_transaction";
+            }
+
+            return "rejected";
+        }
+
+        /* Transactions dropped from the pool before making it into a block */
+        Metrics::Counter &poolEvictions(const std::string &reason)
+        {
+            return Metrics::registry().counter(
+                "pool_evictions_total", "Transactions removed from the pool without being mined", {{"reason", reason}});
+        }
+
+        /* Transactions turned away as the pool had no room for them */
+        Metrics::Counter &poolRefusals()
+        {
+            static Metrics::Counter &counter = Metrics::registry().counter(
+                "pool_refusals_total", "Transactions refused as the pool was at its memory limit");
+
+            return counter;
+        }
+
+        /* Transactions turned away as their deadlines, or those already in
+           the pool, couldn't all be met if they were added */
+        Metrics::Counter &poolUnschedulable()
+        {
+            static Metrics::Counter &counter = Metrics::registry().counter(
+                "pool_unschedulable_total", "Transactions refused as the pool's deadlines could not all be met");
+
+            return counter;
+        }
+
+        /* Metrics for the transactions validated from one source - the pool,
+           or blocks */
+        struct TransactionValidationMetrics
+        {
+            explicit TransactionValidationMetrics(const std::string &source):
+                time(Metrics::registry().histogram(
+                    "core_transaction_validation_microseconds",
+                    "Time taken to validate a transaction",
+                    {{"source", source}})),
+                valid(Metrics::registry().counter(
+                    "core_transactions_validated_total",
+                    "Transactions validated, by where they came from and the outcome",
+                    {{"result", "valid"}, {"source", source}})),
+                invalid(Metrics::registry().counter(
+                    "core_transactions_validated_total",
+                    "Transactions validated, by where they came from and the outcome",
+                    {{"result", "invalid"}, {"source", source}}))
+            {
+            }
+
+            LatencyHistogram &time;
+
+            Metrics::Counter &valid;
+
+            Metrics::Counter &invalid;
+        };
+
         TransactionValidatorState extractSpentOutputs(const CachedTransaction &transaction)
         {
             TransactionValidatorState spentOutputs;
@@ -227,6 +321,12 @@ namespace CryptoNote
 
         const std::chrono::seconds OUTDATED_TRANSACTION_POLLING_INTERVAL = std::chrono::seconds(60);
 
+        /* How often to match up transaction latency events */
+        const std::chrono::seconds TRANSACTION_LATENCY_PROCESSING_INTERVAL = std::chrono::seconds(1);
+
+        /* How often to log a transaction latency summary, in processing intervals */
+        const uint64_t TRANSACTION_LATENCY_REPORT_INTERVAL = 60;
+
     } // namespace
 
     Core::Core(
@@ -257,7 +357,7 @@ namespace CryptoNote
 
         transactionPool = std::unique_ptr<ITransactionPoolCleanWrapper>(new TransactionPoolCleanWrapper(
             std::unique_ptr<ITransactionPool>(new TransactionPool(logger)),
-            std::unique_ptr<ITimeProvider>(new RealTimeProvider()),
+            std::unique_ptr<ITimeProvider>(new GlobalTimeProvider()),
             logger,
             currency.mempoolTxLiveTime()));
     }
@@ -281,6 +381,13 @@ namespace CryptoNote
 
     bool Core::notifyObservers(BlockchainMessage &&msg) /* noexcept */
     {
+        {
+            std::scoped_lock lock(m_changeMutex);
+            m_changeVersion++;
+        }
+
+        m_changeCondition.notify_all();
+
         try
         {
             for (auto &queue : queueList)
@@ -465,7 +572,7 @@ namespace CryptoNote
             auto transactions = alt->getRawTransactions(alt->getTransactionHashes());
             for (auto &transaction : transactions)
             {
-                const auto [success, error] = addTransactionToPool(std::move(transaction));
+                const auto [success, error, rejection] = addTransactionToPool(std::move(transaction));
                 if (success)
                 {
                     // TODO: send notification
@@ -674,14 +781,11 @@ namespace CryptoNote
 
         try
         {
-            const auto txs = transactionPool->getTransactionHashes();
-
-            /* Pop into a set for quicker .find() */
-            std::unordered_set<Crypto::Hash> poolTransactions(txs.begin(), txs.end());
-
             for (const auto &hash : transactionHashes)
             {
-                if (poolTransactions.find(hash) != poolTransactions.end())
+                /* Look up each hash in the pool's index, rather than copying
+                   out every hash in the pool */
+                if (transactionPool->checkIfTransactionPresent(hash))
                 {
                     /* It's in the pool */
                     transactionsInPool.insert(hash);
@@ -996,17 +1100,18 @@ namespace CryptoNote
 
     WalletTypes::RawTransaction Core::getRawTransaction(const std::vector<uint8_t> &rawTX)
     {
-        Transaction t;
-
-        /* Convert the binary array to a transaction */
-        fromBinaryArray(t, rawTX);
+        //RTcoin
+        /* Read the fields straight out of the binary array, rather than
+           deserializing the whole transaction, signatures and all */
+        const TransactionView view(rawTX);
 
         WalletTypes::RawTransaction transaction;
 
         /* Get the transaction hash from the binary array */
-        transaction.hash = getBinaryArrayHash(rawTX);
+        transaction.hash = view.getTransactionHash();
 
-        Utilities::ParsedExtra parsedExtra = Utilities::parseExtra(t.extra);
+        Utilities::ParsedExtra parsedExtra =
+            Utilities::parseExtra(std::vector<uint8_t>(view.getExtra(), view.getExtra() + view.getExtraSize()));
 
         /* Transaction public key, used for decrypting transactions along with
        private view key */
@@ -1015,23 +1120,46 @@ namespace CryptoNote
         /* Get the payment ID if it exists (Empty string if it doesn't) */
         transaction.paymentID = parsedExtra.paymentID;
 
-        transaction.unlockTime = t.unlockTime;
+        transaction.unlockTime = view.getUnlockTime();
+
+        transaction.keyOutputs.reserve(view.getOutputCount());
 
         /* Simplify the outputs */
-        for (const auto &output : t.outputs)
+        auto outputs = view.getOutputs();
+
+        TransactionView::Output output;
+
+        while (outputs.next(output))
         {
             WalletTypes::KeyOutput keyOutput;
 
             keyOutput.amount = output.amount;
-            keyOutput.key = boost::get<CryptoNote::KeyOutput>(output.target).key;
+            keyOutput.key = output.key;
 
             transaction.keyOutputs.push_back(keyOutput);
         }
 
+        transaction.keyInputs.reserve(view.getInputCount());
+
         /* Simplify the inputs */
-        for (const auto &input : t.inputs)
+        auto inputs = view.getInputs();
+
+        TransactionView::Input input;
+
+        while (inputs.next(input))
         {
-            transaction.keyInputs.push_back(boost::get<CryptoNote::KeyInput>(input));
+            if (input.isCoinbase)
+            {
+                throw std::runtime_error("Coinbase input in a non coinbase transaction");
+            }
+
+            CryptoNote::KeyInput keyInput;
+
+            keyInput.amount = input.amount;
+            keyInput.outputIndexes = input.getOutputIndexes();
+            keyInput.keyImage = input.keyImage;
+
+            transaction.keyInputs.push_back(std::move(keyInput));
         }
 
         return transaction;
@@ -1152,7 +1280,32 @@ namespace CryptoNote
         return getBlockHashes(startBlockIndex, static_cast<uint32_t>(maxCount));
     }
 
+    //RTcoin
     std::error_code Core::addBlock(const CachedBlock &cachedBlock, RawBlock &&rawBlock)
+    {
+        TRACE_SPAN("core", "addBlock");
+
+        static auto &processingTime = Metrics::registry().histogram(
+            "core_block_processing_microseconds", "Time taken to validate and store a block, whatever the outcome");
+
+        const auto start = std::chrono::steady_clock::now();
+
+        const auto result = processBlock(cachedBlock, std::move(rawBlock));
+
+        processingTime.record(Metrics::microsecondsSince(start));
+
+        /* Few enough blocks that looking the counter up each time is fine */
+        Metrics::registry()
+            .counter(
+                "core_blocks_processed_total",
+                "Blocks given to the core, by outcome",
+                {{"result", blockResultName(result)}})
+            .add();
+
+        return result;
+    }
+
+    std::error_code Core::processBlock(const CachedBlock &cachedBlock, RawBlock &&rawBlock)
     {
         throwIfNotInitialized();
         uint32_t blockIndex = cachedBlock.getBlockIndex();
@@ -1189,7 +1342,15 @@ namespace CryptoNote
 
         std::vector<CachedTransaction> transactions;
         uint64_t cumulativeSize = 0;
-        if (!extractTransactions(rawBlock.transactions, transactions, cumulativeSize))
+
+        //RTcoin
+        auto stageStart = std::chrono::steady_clock::now();
+
+        const bool extracted = extractTransactions(rawBlock.transactions, transactions, cumulativeSize);
+
+        m_blockProcessingTimings.deserialize += std::chrono::steady_clock::now() - stageStart;
+
+        if (!extracted)
         {
             logger(Logging::DEBUGGING) << "Couldn't deserialize raw block transactions in block " << blockStr;
             return error::AddBlockErrorCode::DESERIALIZATION_FAILED;
@@ -1211,7 +1372,13 @@ namespace CryptoNote
         }
 
         uint64_t minerReward = 0;
+
+        stageStart = std::chrono::steady_clock::now();
+
         auto blockValidationResult = validateBlock(cachedBlock, cache, minerReward);
+
+        m_blockProcessingTimings.blockValidation += std::chrono::steady_clock::now() - stageStart;
+
         if (blockValidationResult)
         {
             logger(Logging::DEBUGGING) << "Failed to validate block " << blockStr << ": "
@@ -1278,9 +1445,14 @@ namespace CryptoNote
         for (const auto &transaction : transactions)
         {
             uint64_t fee = 0;
+
+            stageStart = std::chrono::steady_clock::now();
+
             auto transactionValidationResult = validateTransaction(
                 transaction, validatorState, cache, m_transactionValidationThreadPool, fee, previousBlockIndex, false);
 
+            m_blockProcessingTimings.transactionValidation += std::chrono::steady_clock::now() - stageStart;
+
             if (!transactionValidationResult.valid)
             {
                 const auto hash = transaction.getTransactionHash();
@@ -1292,6 +1464,7 @@ namespace CryptoNote
                 {
                     logger(Logging::DEBUGGING) << "Invalid transaction " << hash << " is present in the pool, removing";
                     transactionPool->removeTransaction(hash);
+                    poolEvictions("invalid").add();
                     notifyObservers(makeDelTransactionMessage({hash}, Messages::DeleteTransaction::Reason::NotActual));
                 }
 
@@ -1347,6 +1520,10 @@ namespace CryptoNote
 
         auto ret = error::AddBlockErrorCode::ADDED_TO_ALTERNATIVE;
 
+        /* Includes switching chains and splitting segments, which are mostly
+           cache writes too */
+        stageStart = std::chrono::steady_clock::now();
+
         if (addOnTop)
         {
             if (cache->getChildCount() == 0)
@@ -1375,6 +1552,18 @@ namespace CryptoNote
                        be in the pool that would now be considered invalid */
                     checkAndRemoveInvalidPoolTransactions(validatorState);
 
+                    //RTcoin
+                    m_admissionController.recordBlock(cachedBlock.getBlock().timestamp);
+
+                    for (const auto &transaction : transactions)
+                    {
+                        m_latencyTracker.record(
+                            transaction.getTransactionHash(),
+                            TransactionLatencyTracker::Stage::IncludedInBlock,
+                            transaction.getTransaction().deadline,
+                            transaction.getTransactionBinaryArray().size());
+                    }
+
                     ret = error::AddBlockErrorCode::ADDED_TO_MAIN;
                     logger(Logging::DEBUGGING) << "Block " << blockStr << " added to main chain.";
                     if ((previousBlockIndex + 1) % 100 == 0)
@@ -1414,6 +1603,9 @@ namespace CryptoNote
                            be in the pool that would now be considered invalid */
                         checkAndRemoveInvalidPoolTransactions(validatorState);
 
+                        //RTcoin
+                        m_admissionController.recordBlock(cachedBlock.getBlock().timestamp);
+
                         copyTransactionsToPool(chainsLeaves[endpointIndex]);
 
                         switchMainChainStorage(chainsLeaves[0]->getStartBlockIndex(), *chainsLeaves[0]);
@@ -1493,6 +1685,9 @@ namespace CryptoNote
             updateMainChainSet();
         }
 
+        m_blockProcessingTimings.storage += std::chrono::steady_clock::now() - stageStart;
+        m_blockProcessingTimings.blocks++;
+
         logger(Logging::DEBUGGING) << "Block: " << blockStr << " successfully added";
         notifyOnSuccess(ret, previousBlockIndex, cachedBlock, *cache);
 
@@ -1507,6 +1702,9 @@ namespace CryptoNote
        stay in the pool at this time. */
     void Core::checkAndRemoveInvalidPoolTransactions(const TransactionValidatorState blockTransactionsState)
     {
+        //RTcoin
+        TRACE_SPAN("core", "checkPoolTransactions");
+
         auto &pool = *transactionPool;
 
         const auto poolHashes = pool.getTransactionHashes();
@@ -1555,6 +1753,7 @@ namespace CryptoNote
             if (!isValid)
             {
                 pool.removeTransaction(poolTxHash);
+                poolEvictions("conflict").add();
                 notifyObservers(
                     makeDelTransactionMessage({poolTxHash}, Messages::DeleteTransaction::Reason::NotActual));
             }
@@ -1813,32 +2012,49 @@ namespace CryptoNote
     }
 
     //RTcoin
-    std::tuple<bool, std::string> Core::addTransactionToPool(const BinaryArray &transactionBinaryArray)
+    std::tuple<bool, std::string, PoolRejection> Core::addTransactionToPool(const BinaryArray &transactionBinaryArray)
     {
-        throwIfNotInitialized();
+        std::optional<TransactionView> view;
 
-        Transaction transaction;
-        if (!fromBinaryArray<Transaction>(transaction, transactionBinaryArray))
+        try
+        {
+            view.emplace(transactionBinaryArray);
+        }
+        catch (const std::exception &)
         {
             logger(Logging::WARNING) << "Couldn't add transaction to pool due to deserialization error";
-            return {false, "Could not deserialize transaction"};
+            return {false, "Could not deserialize transaction", PoolRejection::Refused};
         }
 
-        CachedTransaction cachedTransaction(std::move(transaction));
-        auto transactionHash = cachedTransaction.getTransactionHash();
+        return addTransactionToPool(*view);
+    }
 
-        const auto [success, error] = addTransactionToPool(std::move(cachedTransaction));
+    //RTcoin
+    std::tuple<bool, std::string, PoolRejection> Core::addTransactionToPool(const TransactionView &transaction)
+    {
+        throwIfNotInitialized();
+
+        const Crypto::Hash transactionHash = transaction.getTransactionHash();
+
+        if (transactionPool->checkIfTransactionPresent(transactionHash))
+        {
+            return {false, "Transaction already exists in pool", PoolRejection::Refused};
+        }
+
+        CachedTransaction cachedTransaction(transaction);
+
+        const auto [success, error, rejection] = addTransactionToPool(std::move(cachedTransaction));
         if (!success)
         {
-            return {false, error};
+            return {false, error, rejection};
         }
 
         notifyObservers(makeAddTransactionMessage({transactionHash}));
-        return {true, ""};
+        return {true, "", PoolRejection::None};
     }
 
     //RTcoin
-    std::tuple<bool, std::string> Core::addTransactionToPool(CachedTransaction &&cachedTransaction)
+    std::tuple<bool, std::string, PoolRejection> Core::addTransactionToPool(CachedTransaction &&cachedTransaction)
     {
         TransactionValidatorState validatorState;
 
@@ -1851,24 +2067,83 @@ namespace CryptoNote
            an insane number of times */
         if (transactionPool->checkIfTransactionPresent(transactionHash))
         {
-            return {false, "Transaction already exists in pool"};
+            return {false, "Transaction already exists in pool", PoolRejection::Refused};
+        }
+
+        const uint64_t deadline = cachedTransaction.getTransaction().deadline;
+
+        const uint64_t size = cachedTransaction.getTransactionBinaryArray().size();
+
+        m_latencyTracker.record(transactionHash, TransactionLatencyTracker::Stage::Received, deadline, size);
+
+        /* Checked before validating, so a flood of transactions we've no room
+           for costs as little as possible */
+        const auto evictions = transactionPool->getEvictionsToFit(cachedTransaction);
+
+        if (!evictions)
+        {
+            poolRefusals().add();
+
+            logger(Logging::DEBUGGING) << "Refusing transaction " << transactionHash
+                                       << ", the pool is at its memory limit";
+
+            m_latencyTracker.record(transactionHash, TransactionLatencyTracker::Stage::Rejected);
+
+            return {false, "Transaction pool is full, try again with a higher fee", PoolRejection::Refused};
+        }
+
+        /* Also cheap, so done before validating - and synthetic transactions,
+           which skip validation, are still checked. The pool isn't held from
+           here until the transaction is added, so a burst arriving together
+           can overshoot a little. */
+        if (!transactionPool->isSchedulable(cachedTransaction, m_admissionController.forecast()))
+        {
+            poolUnschedulable().add();
+
+            logger(Logging::DEBUGGING) << "Refusing transaction " << transactionHash
+                                       << ", the pool's deadlines could not all be met with it";
+
+            m_latencyTracker.record(transactionHash, TransactionLatencyTracker::Stage::Rejected);
+
+            return {false,
+                    "Transaction deadline could not be met alongside those already in the pool",
+                    PoolRejection::Unschedulable};
         }
 
         const auto [success, error] = isTransactionValidForPool(cachedTransaction, validatorState);
         if (!success)
         {
-            return {false, error};
+            m_latencyTracker.record(transactionHash, TransactionLatencyTracker::Stage::Rejected);
+
+            return {false, error, PoolRejection::Refused};
+        }
+
+        for (const auto &hash : *evictions)
+        {
+            if (transactionPool->removeTransaction(hash))
+            {
+                logger(Logging::DEBUGGING) << "Evicted transaction " << hash << " from the pool to make room for "
+                                           << transactionHash;
+
+                poolEvictions("memory").add();
+
+                notifyObservers(makeDelTransactionMessage({hash}, Messages::DeleteTransaction::Reason::NotActual));
+            }
         }
 
         if (!transactionPool->pushTransaction(std::move(cachedTransaction), std::move(validatorState)))
         {
             logger(Logging::DEBUGGING) << "Failed to push transaction " << transactionHash
                                        << " to pool, already exists";
-            return {false, "Transaction already exists in pool"};
+            return {false, "Transaction already exists in pool", PoolRejection::Refused};
         }
 
+        m_latencyTracker.record(transactionHash, TransactionLatencyTracker::Stage::Validated, deadline, size);
+
+        m_cadenceController.recordArrival(size);
+
         logger(Logging::DEBUGGING) << "Transaction " << transactionHash << " has been added to pool";
-        return {true, ""};
+        return {true, "", PoolRejection::None};
     }
 
     std::tuple<bool, std::string> Core::isTransactionValidForPool(
@@ -1877,14 +2152,16 @@ namespace CryptoNote
     {
         const auto transactionHash = cachedTransaction.getTransactionHash();
 
-        if (cachedTransaction.getTransaction().version == CryptoNote::HACK_TRANSACTION_VERSION)
-        {  
-            return {true, "hack_transaction"};
-        }
+        //RTcoin
+        /* Synthetic transactions have no fee, but aren't fusion transactions.
+           They still go through validateTransaction() for their size and
+           deadline. */
+        const bool isHackTransaction =
+            cachedTransaction.getTransaction().version == CryptoNote::HACK_TRANSACTION_VERSION;
 
         /* If there are already a certain number of fusion transactions in
            the pool, then do not try to add another */
-        if (cachedTransaction.getTransactionFee() == 0
+        if (!isHackTransaction && cachedTransaction.getTransactionFee() == 0
             && transactionPool->getFusionTransactionCount() >= CryptoNote::parameters::FUSION_TX_MAX_POOL_COUNT)
         {
             return {false, "Pool already contains the maximum amount of fusion transactions"};
@@ -2045,7 +2322,7 @@ namespace CryptoNote
         }
 
         b.previousBlockHash = getTopBlockHash();
-        b.timestamp = time(nullptr);
+        b.timestamp = timeProvider().now();
 
         /* Ok, so if an attacker is fiddling around with timestamps on the network,
            they can make it so all the valid pools / miners don't produce valid
@@ -2287,6 +2564,9 @@ namespace CryptoNote
         std::vector<CachedTransaction> &transactions,
         uint64_t &cumulativeSize)
     {
+        //RTcoin
+        TRACE_SPAN("core", "extractTransactions");
+
         try
         {
             for (auto &rawTransaction : rawTransactions)
@@ -2300,6 +2580,11 @@ namespace CryptoNote
                 cumulativeSize += rawTransaction.size();
                 transactions.emplace_back(rawTransaction);
             }
+
+            //RTcoin
+            /* Every one of these gets its hashes looked at during validation,
+               so work them all out together */
+            CachedTransaction::computeTransactionHashes(transactions);
         }
         catch (std::runtime_error &e)
         {
@@ -2319,6 +2604,9 @@ namespace CryptoNote
         uint32_t blockIndex,
         const bool isPoolTransaction)
     {
+        //RTcoin
+        TRACE_SPAN("core", "validateTransaction");
+
         ValidateTransaction txValidator(
             cachedTransaction,
             state,
@@ -2330,8 +2618,21 @@ namespace CryptoNote
             blockMedianSize,
             isPoolTransaction);
 
+        //RTcoin
+        static TransactionValidationMetrics poolMetrics("pool");
+
+        static TransactionValidationMetrics blockMetrics("block");
+
+        auto &metrics = isPoolTransaction ? poolMetrics : blockMetrics;
+
+        const auto start = std::chrono::steady_clock::now();
+
         auto result = txValidator.validate();
 
+        metrics.time.record(Metrics::microsecondsSince(start));
+
+        (result.valid ? metrics.valid : metrics.invalid).add();
+
         fee = result.fee;
 
         return result;
@@ -2365,6 +2666,9 @@ namespace CryptoNote
 
     std::error_code Core::validateBlock(const CachedBlock &cachedBlock, IBlockchainCache *cache, uint64_t &minerReward)
     {
+        //RTcoin
+        TRACE_SPAN("core", "validateBlock");
+
         const auto &block = cachedBlock.getBlock();
         auto previousBlockIndex = cache->getBlockIndex(block.previousBlockHash);
         // assert(block.previousBlockHash == cache->getBlockHash(previousBlockIndex));
@@ -2445,6 +2749,9 @@ namespace CryptoNote
 
         if (verifyCoinbaseOutputRecipient)
         {
+            /* Not the window table path - the key comes from whoever sent the
+               block, so each new one would cost a table build, and push out
+               a table we'll use again */
             Crypto::generate_key_derivation(extra.recipientPublicViewKey, extra.transactionPrivateKey, derivation);
         }
 
@@ -2496,7 +2803,7 @@ namespace CryptoNote
 
     uint64_t CryptoNote::Core::getAdjustedTime() const
     {
-        return time(NULL);
+        return timeProvider().now();
     }
 
     const Currency &Core::getCurrency() const
@@ -2559,6 +2866,264 @@ namespace CryptoNote
         initialized = true;
     }
 
+    //RTcoin
+    bool Core::savePoolSnapshot(const std::string &filename) const
+    {
+        throwIfNotInitialized();
+
+        PoolSnapshot snapshot;
+
+        snapshot.topBlockIndex = getTopBlockIndex();
+        snapshot.topBlockHash = getTopBlockHash();
+
+        const auto transactions = transactionPool->getPoolTransactions();
+
+        snapshot.transactions.reserve(transactions.size());
+
+        for (const auto &transaction : transactions)
+        {
+            PoolSnapshotTransaction entry;
+
+            entry.transaction = transaction.getTransactionBinaryArray();
+            entry.receiveTime = transactionPool->getTransactionReceiveTime(transaction.getTransactionHash());
+            entry.deadline = transaction.getTransaction().deadline;
+            entry.fee = transaction.getTransactionFee();
+            entry.validatedHeight = snapshot.topBlockIndex;
+
+            snapshot.transactions.push_back(std::move(entry));
+        }
+
+        if (!CryptoNote::savePoolSnapshot(snapshot, filename))
+        {
+            logger(Logging::WARNING) << "Could not write pool snapshot: " << filename;
+            return false;
+        }
+
+        logger(Logging::INFO) << "Saved " << snapshot.transactions.size() << " pool transactions to " << filename;
+
+        return true;
+    }
+
+    size_t Core::loadPoolSnapshot(const std::string &filename)
+    {
+        throwIfNotInitialized();
+
+        const auto start = std::chrono::steady_clock::now();
+
+        auto snapshot = CryptoNote::loadPoolSnapshot(filename);
+
+        if (!snapshot)
+        {
+            if (std::ifstream(filename))
+            {
+                logger(Logging::WARNING) << "Could not read pool snapshot, starting with an empty pool: " << filename;
+            }
+
+            return 0;
+        }
+
+        auto &entries = snapshot->transactions;
+
+        const uint32_t topIndex = getTopBlockIndex();
+
+        uint32_t oldestHeight = snapshot->topBlockIndex;
+
+        for (const auto &entry : entries)
+        {
+            oldestHeight = std::min(oldestHeight, entry.validatedHeight);
+        }
+
+        /* If the chain the snapshot was taken on is still ours, the only
+           key images that can have been spent, and transactions included,
+           since are those in the blocks added on top. Otherwise we have to
+           ask the chain about every one. */
+        const bool sameChain = snapshot->topBlockIndex <= topIndex
+                               && getBlockHashByIndex(snapshot->topBlockIndex) == snapshot->topBlockHash;
+
+        TransactionValidatorState spentSince;
+
+        std::unordered_set<Crypto::Hash> includedSince;
+
+        if (sameChain)
+        {
+            for (uint32_t index = oldestHeight + 1; index <= topIndex; index++)
+            {
+                const auto block = getBlockByIndex(index);
+
+                std::vector<BinaryArray> transactions;
+                std::vector<Crypto::Hash> missed;
+
+                getTransactions(block.transactionHashes, transactions, missed);
+
+                includedSince.insert(block.transactionHashes.begin(), block.transactionHashes.end());
+
+                for (const auto &transaction : transactions)
+                {
+                    mergeStates(spentSince, extractSpentOutputs(CachedTransaction(transaction)));
+                }
+            }
+        }
+
+        const uint64_t now = getAdjustedTime();
+
+        std::vector<std::optional<CachedTransaction>> restored(entries.size());
+
+        /* Only reads the transaction, and the blocks read above, so these can
+           be checked side by side */
+        const auto isCandidate = [&](const CachedTransaction &transaction, const PoolSnapshotTransaction &entry) {
+            if (transaction.getTransactionFee() != entry.fee || transaction.getTransaction().deadline != entry.deadline)
+            {
+                return false;
+            }
+
+            if (!sameChain || entry.validatedHeight == topIndex)
+            {
+                return true;
+            }
+
+            const auto &hash = transaction.getTransactionHash();
+
+            return includedSince.count(hash) == 0 && !hasIntersections(spentSince, extractSpentOutputs(transaction));
+        };
+
+        /* Reads the chain, so done one at a time, on this thread, as
+           addTransactionToPool() does */
+        const auto isRestorable = [&](const CachedTransaction &transaction) {
+            if (sameChain)
+            {
+                return validateBlockTemplateTransaction(transaction, topIndex + 1);
+            }
+
+            /* Taken on another chain - the outputs it spends may not exist on
+               this one, so check it in full, as if it had just arrived */
+            if (isTransactionInChain(transaction.getTransactionHash()))
+            {
+                return false;
+            }
+
+            TransactionValidatorState state;
+
+            uint64_t fee;
+
+            return validateTransaction(
+                       transaction, state, chainsLeaves[0], m_transactionValidationThreadPool, fee, topIndex, true)
+                .valid;
+        };
+
+        /* A batch per job, as most transactions only need parsing and
+           hashing, which is too little work to be worth a job each */
+        const size_t BATCH_SIZE = 1024;
+
+        std::vector<std::future<bool>> jobs;
+
+        for (size_t batchStart = 0; batchStart < entries.size(); batchStart += BATCH_SIZE)
+        {
+            const size_t batchEnd = std::min(batchStart + BATCH_SIZE, entries.size());
+
+            jobs.push_back(m_transactionValidationThreadPool.addJob([&, batchStart, batchEnd] {
+                std::vector<CachedTransaction> transactions;
+
+                std::vector<size_t> indexes;
+
+                for (size_t i = batchStart; i < batchEnd; i++)
+                {
+                    /* Would be cleaned out of the pool straight away */
+                    if (now > entries[i].receiveTime + currency.mempoolTxLiveTime())
+                    {
+                        continue;
+                    }
+
+                    try
+                    {
+                        transactions.emplace_back(entries[i].transaction);
+                        indexes.push_back(i);
+                    }
+                    catch (const std::exception &)
+                    {
+                    }
+                }
+
+                /* Much quicker side by side than one at a time */
+                CachedTransaction::computeTransactionHashes(transactions);
+
+                for (size_t j = 0; j < transactions.size(); j++)
+                {
+                    if (isCandidate(transactions[j], entries[indexes[j]]))
+                    {
+                        restored[indexes[j]] = std::move(transactions[j]);
+                    }
+                }
+
+                return true;
+            }));
+        }
+
+        for (auto &job : jobs)
+        {
+            job.get();
+        }
+
+        size_t rechecked = 0;
+
+        for (size_t i = 0; i < restored.size(); i++)
+        {
+            if (!restored[i] || (sameChain && entries[i].validatedHeight == topIndex))
+            {
+                continue;
+            }
+
+            rechecked++;
+
+            if (!isRestorable(*restored[i]))
+            {
+                restored[i] = std::nullopt;
+            }
+        }
+
+        std::vector<Crypto::Hash> restoredHashes;
+
+        for (size_t i = 0; i < restored.size(); i++)
+        {
+            if (!restored[i])
+            {
+                continue;
+            }
+
+            const auto evictions = transactionPool->getEvictionsToFit(*restored[i]);
+
+            /* Out of room - the memory budget must have been lowered */
+            if (!evictions || !evictions->empty())
+            {
+                continue;
+            }
+
+            const Crypto::Hash hash = restored[i]->getTransactionHash();
+
+            auto state = extractSpentOutputs(*restored[i]);
+
+            if (transactionPool->restoreTransaction(std::move(*restored[i]), std::move(state), entries[i].receiveTime))
+            {
+                restoredHashes.push_back(hash);
+            }
+        }
+
+        const size_t restoredCount = restoredHashes.size();
+
+        if (restoredCount != 0)
+        {
+            notifyObservers(makeAddTransactionMessage(std::move(restoredHashes)));
+        }
+
+        const auto elapsed =
+            std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+
+        logger(Logging::INFO) << "Restored " << restoredCount << " of " << entries.size()
+                              << " pool transactions from snapshot in " << elapsed.count() << "ms, "
+                              << rechecked << " rechecked";
+
+        return restoredCount;
+    }
+
     void Core::initRootSegment()
     {
         std::unique_ptr<IBlockchainCache> cache = this->blockchainCacheFactory->createRootBlockchainCache(currency);
@@ -2570,6 +3135,8 @@ namespace CryptoNote
 
         contextGroup.spawn(std::bind(&Core::transactionPoolCleaningProcedure, this));
 
+        contextGroup.spawn(std::bind(&Core::transactionLatencyReportingProcedure, this));
+
         updateBlockMedianSize();
 
         chainsLeaves[0]->load();
@@ -3048,6 +3615,9 @@ namespace CryptoNote
         size_t &transactionsSize,
         uint64_t &fee)
     {
+        //RTcoin
+        TRACE_SPAN("core", "fillBlockTemplate");
+
         transactionsSize = 0;
         fee = 0;
 
@@ -3055,6 +3625,16 @@ namespace CryptoNote
 
         maxTotalSize = std::min(maxTotalSize, maxCumulativeSize) - currency.minerTxBlobReservedSize();
 
+        //RTcoin
+        /* Deadline pressure can take the template past that, but not as far as
+           twice the median, where the penalty would take the whole reward */
+        const size_t adaptiveMaxSize =
+            std::min((CryptoNote::parameters::BLOCK_CADENCE_MAX_SIZE_PERCENT * medianSize) / 100, maxCumulativeSize)
+            - currency.minerTxBlobReservedSize();
+
+        maxTotalSize = std::max<size_t>(
+            maxTotalSize, std::min<uint64_t>(getBlockCadence().blockSize, adaptiveMaxSize));
+
         TransactionSpentInputsChecker spentInputsChecker;
 
         /* Go get our regular and fusion transactions from the transaction pool */
@@ -3090,6 +3670,9 @@ namespace CryptoNote
 
                 block.transactionHashes.emplace_back(transaction.getTransactionHash());
 
+                m_latencyTracker.record(
+                    transaction.getTransactionHash(), TransactionLatencyTracker::Stage::AddedToTemplate);
+
                 return true;
             }
             else
@@ -3665,6 +4248,89 @@ namespace CryptoNote
         }
     }
 
+    //RTcoin
+    void Core::transactionLatencyReportingProcedure()
+    {
+        System::Timer timer(dispatcher);
+
+        try
+        {
+            for (uint64_t i = 1;; i++)
+            {
+                timer.sleep(TRANSACTION_LATENCY_PROCESSING_INTERVAL);
+
+                if (i % TRANSACTION_LATENCY_REPORT_INTERVAL == 0)
+                {
+                    logger(Logging::INFO) << "Transaction latency: " << m_latencyTracker.getSummaryLine();
+                }
+                else
+                {
+                    m_latencyTracker.process();
+                }
+            }
+        }
+        catch (System::InterruptedException &)
+        {
+            logger(Logging::DEBUGGING) << "transactionLatencyReportingProcedure has been interrupted";
+        }
+        catch (std::exception &e)
+        {
+            logger(Logging::ERROR) << "Error occurred while processing transaction latencies: " << e.what();
+        }
+    }
+
+    uint64_t Core::waitForChange(const uint64_t knownVersion, const std::chrono::milliseconds timeout)
+    {
+        std::unique_lock lock(m_changeMutex);
+
+        m_changeCondition.wait_for(lock, timeout, [&]() { return m_changeVersion != knownVersion; });
+
+        return m_changeVersion;
+    }
+
+    uint64_t Core::getPoolEarliestDeadline() const
+    {
+        throwIfNotInitialized();
+
+        return transactionPool->getEarliestDeadline();
+    }
+
+    BlockProcessingTimings Core::getBlockProcessingTimings() const
+    {
+        return m_blockProcessingTimings;
+    }
+
+    void Core::setBlockInterval(const uint64_t interval)
+    {
+        m_admissionController.setBlockInterval(interval);
+    }
+
+    CapacityForecast Core::getCapacityForecast() const
+    {
+        return m_admissionController.forecast();
+    }
+
+    void Core::setBlockCadence(const BlockPolicy policy, const uint64_t deadlineSlack)
+    {
+        m_cadenceController.setPolicy(policy);
+        m_cadenceController.setDeadlineSlack(deadlineSlack);
+
+        m_admissionController.setBlockSize(m_cadenceController.getAdmissionBlockSize());
+    }
+
+    BlockCadencePlan Core::getBlockCadence() const
+    {
+        return m_cadenceController.plan(
+            transactionPool->getDeadlineDemand(),
+            m_admissionController.forecast(),
+            m_admissionController.getLastBlockTime());
+    }
+
+    TransactionLatencyTracker &Core::getTransactionLatencyTracker()
+    {
+        return m_latencyTracker;
+    }
+
     void Core::updateBlockMedianSize()
     {
         auto mainChain = chainsLeaves[0];
@@ -3676,6 +4342,23 @@ namespace CryptoNote
 
         blockMedianSize =
             std::max(Common::medianValue(lastBlockSizes), static_cast<uint64_t>(nextBlockGrantedFullRewardZone));
+
+        //RTcoin
+        const size_t maxCumulativeSize = currency.maxBlockCumulativeSize(mainChain->getTopBlockIndex() + 1);
+
+        const size_t reservedSize = currency.minerTxBlobReservedSize();
+
+        /* The same limits fillBlockTemplate() fills blocks to under the static
+           and adaptive policies */
+        const size_t staticBlockSize = std::min((125 * blockMedianSize) / 100, maxCumulativeSize);
+
+        const size_t maxBlockSize =
+            std::min((CryptoNote::parameters::BLOCK_CADENCE_MAX_SIZE_PERCENT * blockMedianSize) / 100, maxCumulativeSize);
+
+        m_cadenceController.setBlockSizeLimits(
+            staticBlockSize - std::min(staticBlockSize, reservedSize), maxBlockSize - std::min(maxBlockSize, reservedSize));
+
+        m_admissionController.setBlockSize(m_cadenceController.getAdmissionBlockSize());
     }
 
     uint64_t Core::get_current_blockchain_height() const
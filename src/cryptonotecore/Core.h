@@ -19,13 +19,18 @@
 #include "ITransactionPool.h"
 #include "ITransactionPoolCleaner.h"
 #include "IUpgradeManager.h"
+#include "BlockCadenceController.h"
 #include "MessageQueue.h"
+#include "TransactionAdmissionController.h"
 #include "TransactionValidatiorState.h"
 
 #include <WalletTypes.h>
+#include <chrono>
+#include <condition_variable>
 #include <cryptonotecore/ValidateTransaction.h>
 #include <ctime>
 #include <logging/LoggerMessage.h>
+#include <mutex>
 #include <system/ContextGroup.h>
 #include <unordered_map>
 #include <utilities/ThreadPool.h>
@@ -33,6 +38,29 @@
 
 namespace CryptoNote
 {
+    //RTcoin
+    /* Time addBlock() has spent in each stage, summed over every block it
+       has been given since startup. Rejected blocks count towards the stages
+       they reached. */
+    struct BlockProcessingTimings
+    {
+        /* Blocks added to the main or an alternative chain */
+        uint64_t blocks = 0;
+
+        /* Deserializing and hashing the block's transactions */
+        std::chrono::nanoseconds deserialize {0};
+
+        /* Block header, coinbase and timestamp checks */
+        std::chrono::nanoseconds blockValidation {0};
+
+        /* Transaction validation, which is mostly checking ring signatures */
+        std::chrono::nanoseconds transactionValidation {0};
+
+        /* Writing the block to the main chain storage and the blockchain
+           cache (and so, the database) */
+        std::chrono::nanoseconds storage {0};
+    };
+
     class Core : public ICore, public ICoreInformation
     {
       public:
@@ -163,7 +191,12 @@ namespace CryptoNote
             const uint64_t endHeight,
             std::unordered_map<Crypto::Hash, std::vector<uint64_t>> &indexes) const override;
 
-        virtual std::tuple<bool, std::string> addTransactionToPool(const BinaryArray &transactionBinaryArray) override;
+        virtual std::tuple<bool, std::string, PoolRejection>
+            addTransactionToPool(const BinaryArray &transactionBinaryArray) override;
+
+        //RTcoin
+        virtual std::tuple<bool, std::string, PoolRejection>
+            addTransactionToPool(const TransactionView &transaction) override;
 
         virtual std::vector<Crypto::Hash> getPoolTransactionHashes() const override;
 
@@ -192,8 +225,48 @@ namespace CryptoNote
 
         virtual CoreStatistics getCoreStatistics() const override;
 
+        virtual TransactionLatencyTracker &getTransactionLatencyTracker() override;
+
         virtual std::time_t getStartTime() const;
 
+        //RTcoin
+        /* Blocks until a block or pool transaction is added or removed, or
+           the timeout expires. knownVersion is the value returned from the
+           previous call (or 0). Returns the current change version. */
+        uint64_t waitForChange(const uint64_t knownVersion, const std::chrono::milliseconds timeout);
+
+        /* Earliest deadline of any transaction in the pool, unix milliseconds,
+           or 0 if no pool transaction has a deadline */
+        uint64_t getPoolEarliestDeadline() const;
+
+        BlockProcessingTimings getBlockProcessingTimings() const;
+
+        /* Fixes the interval, in milliseconds, admission control expects
+           between blocks, e.g. when we produce them ourselves. 0 to measure
+           it from the blocks that arrive */
+        void setBlockInterval(const uint64_t interval);
+
+        /* The block space admission control expects between now and any
+           deadline */
+        virtual CapacityForecast getCapacityForecast() const override;
+
+        /* Picks the policy templates are sized and blocks sealed by, with the
+           slack, in milliseconds, to seal a block before its deadlines */
+        void setBlockCadence(const BlockPolicy policy, const uint64_t deadlineSlack);
+
+        /* The size of the next block template, and when to seal it */
+        BlockCadencePlan getBlockCadence() const;
+
+        /* Writes the pool out, to be restored with loadPoolSnapshot() on the
+           next start */
+        bool savePoolSnapshot(const std::string &filename) const;
+
+        /* Restores the pool from a snapshot. If it was taken on our chain,
+           only the transactions the blocks added since could have invalidated
+           are rechecked; otherwise every one is validated in full. Returns
+           how many transactions were restored. */
+        size_t loadPoolSnapshot(const std::string &filename);
+
         // ICoreInformation
         virtual size_t getPoolTransactionCount() const override;
 
@@ -267,8 +340,29 @@ namespace CryptoNote
 
         size_t blockMedianSize;
 
+        //RTcoin
+        TransactionLatencyTracker m_latencyTracker;
+
+        TransactionAdmissionController m_admissionController;
+
+        BlockCadenceController m_cadenceController;
+
+        /* Incremented every time observers are notified, so RPC clients can
+           wait for the chain or pool to change */
+        uint64_t m_changeVersion = 0;
+
+        std::mutex m_changeMutex;
+
+        std::condition_variable m_changeCondition;
+
+        BlockProcessingTimings m_blockProcessingTimings;
+
         void throwIfNotInitialized() const;
 
+        //RTcoin
+        /* Does the work of addBlock(), which times it */
+        std::error_code processBlock(const CachedBlock &cachedBlock, RawBlock &&rawBlock);
+
         bool extractTransactions(
             const std::vector<BinaryArray> &rawTransactions,
             std::vector<CachedTransaction> &transactions,
@@ -397,9 +491,11 @@ namespace CryptoNote
 
         void transactionPoolCleaningProcedure();
 
+        void transactionLatencyReportingProcedure();
+
         void updateBlockMedianSize();
 
-        std::tuple<bool, std::string> addTransactionToPool(CachedTransaction &&cachedTransaction);
+        std::tuple<bool, std::string, PoolRejection> addTransactionToPool(CachedTransaction &&cachedTransaction);
 
         std::tuple<bool, std::string> isTransactionValidForPool(
             const CachedTransaction &cachedTransaction,
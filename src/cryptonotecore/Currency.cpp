@@ -345,7 +345,8 @@ namespace CryptoNote
             Crypto::KeyDerivation derivation;
             Crypto::PublicKey outEphemeralPubKey;
 
-            bool r = Crypto::generate_key_derivation(publicViewKey, txkey.secretKey, derivation);
+            /* Every block template pays the same miner address */
+            bool r = Crypto::crypto_ops::generateKeyDerivationPrecomputed(publicViewKey, txkey.secretKey, derivation);
 
             if (!(r))
             {
@@ -16,6 +16,8 @@
 #include <cryptonotecore/DatabaseBlockchainCache.h>
 #include <cstdlib>
 #include <ctime>
+#include <utilities/MemoryBudget.h>
+#include <utilities/Tracing.h>
 
 namespace CryptoNote
 {
@@ -736,6 +738,8 @@ namespace CryptoNote
 
         cutTail(unitsCache, currentTop + 1 - splitBlockIndex);
 
+        trimUnitsCache();
+
         children.push_back(cache.get());
         logger(Logging::TRACE) << "Delete successfull";
 
@@ -1109,6 +1113,9 @@ namespace CryptoNote
         uint64_t blockDifficulty,
         RawBlock &&rawBlock)
     {
+        //RTcoin
+        TRACE_SPAN("cache", "pushBlock");
+
         BlockchainWriteBatch batch;
         logger(Logging::DEBUGGING) << "push block with hash " << cachedBlock.getBlockHash() << ", and "
                                    << cachedTransactions.size() + 1 << " transactions"; //+1 for base transaction
@@ -1176,10 +1183,24 @@ namespace CryptoNote
         logger(Logging::DEBUGGING) << "push block " << cachedBlock.getBlockHash() << " completed";
 
         unitsCache.push_back(blockInfo);
-        if (unitsCache.size() > unitsCacheSize)
+
+        trimUnitsCache();
+    }
+
+    //RTcoin
+    void DatabaseBlockchainCache::trimUnitsCache()
+    {
+        auto &budget = MemoryBudget::budget();
+
+        const size_t capacity = budget.capacity(
+            MemoryBudget::Subsystem::BlockInfoCache, sizeof(CachedBlockInfo), unitsCacheMinSize, unitsCacheMaxSize);
+
+        while (unitsCache.size() > capacity)
         {
             unitsCache.pop_front();
         }
+
+        budget.set(MemoryBudget::Subsystem::BlockInfoCache, unitsCache.size() * sizeof(CachedBlockInfo));
     }
 
     PushedBlockInfo DatabaseBlockchainCache::getPushedBlockInfo(uint32_t blockIndex) const
@@ -2255,6 +2276,8 @@ namespace CryptoNote
         topBlockHash = genesisBlock.getBlockHash();
 
         unitsCache.push_back(blockInfo);
+
+        trimUnitsCache();
     }
 
 } // namespace CryptoNote
@@ -256,7 +256,12 @@ namespace CryptoNote
 
         std::deque<CachedBlockInfo> unitsCache;
 
-        const size_t unitsCacheSize = 1000;
+        //RTcoin
+        /* The cache shrinks towards the minimum when memory is short. Anything
+           older than the cache is read from the database instead */
+        const size_t unitsCacheMinSize = parameters::CRYPTONOTE_REWARD_BLOCKS_WINDOW;
+
+        const size_t unitsCacheMaxSize = 1000;
 
         struct ExtendedPushedBlockInfo;
 
@@ -290,6 +295,11 @@ namespace CryptoNote
 
         void addGenesisBlock(CachedBlock &&genesisBlock);
 
+        //RTcoin
+        /* Drops the oldest units past what the memory budget allows, and
+           reports what's left */
+        void trimUnitsCache();
+
         enum class OutputSearchResult : uint8_t
         {
             FOUND,
@@ -15,6 +15,8 @@
 #include "ICoreDefinitions.h"
 #include "ICoreObserver.h"
 #include "MessageQueue.h"
+#include "TransactionAdmissionController.h"
+#include "TransactionLatencyTracker.h"
 
 #include <CryptoNote.h>
 #include <optional>
@@ -30,6 +32,20 @@ namespace CryptoNote
         BLOCKHAIN_UPDATED
     };
 
+    //RTcoin
+    /* Why the pool turned a transaction away */
+    enum class PoolRejection
+    {
+        None,
+
+        /* Invalid, already in the pool, or the pool is full */
+        Refused,
+
+        /* It, or a transaction already in the pool, couldn't make its
+           deadline in the blocks to come if it was added */
+        Unschedulable
+    };
+
     class ICore
     {
       public:
@@ -156,7 +172,14 @@ namespace CryptoNote
             const uint64_t endHeight,
             std::unordered_map<Crypto::Hash, std::vector<uint64_t>> &indexes) const = 0;
 
-        virtual std::tuple<bool, std::string> addTransactionToPool(const BinaryArray &transactionBinaryArray) = 0;
+        virtual std::tuple<bool, std::string, PoolRejection>
+            addTransactionToPool(const BinaryArray &transactionBinaryArray) = 0;
+
+        //RTcoin
+        /* Checks the pool for the transaction before deserializing it, so a
+           duplicate costs a hash rather than a parse */
+        virtual std::tuple<bool, std::string, PoolRejection>
+            addTransactionToPool(const TransactionView &transaction) = 0;
 
         virtual std::vector<Crypto::Hash> getPoolTransactionHashes() const = 0;
 
@@ -186,6 +209,12 @@ namespace CryptoNote
 
         virtual CoreStatistics getCoreStatistics() const = 0;
 
+        //RTcoin
+        virtual TransactionLatencyTracker &getTransactionLatencyTracker() = 0;
+
+        /* The block space we expect between now and any deadline */
+        virtual CapacityForecast getCapacityForecast() const = 0;
+
         virtual void save() = 0;
 
         virtual void load() = 0;
@@ -4,3 +4,28 @@
 // Please see the included LICENSE file for more information.
 
 #include "ITimeProvider.h"
+
+#include <atomic>
+
+namespace CryptoNote
+{
+    //RTcoin
+    namespace
+    {
+        std::atomic<ITimeProvider *> currentProvider {nullptr};
+    } // namespace
+
+    ITimeProvider &timeProvider()
+    {
+        static RealTimeProvider realTime;
+
+        ITimeProvider *provider = currentProvider.load(std::memory_order_acquire);
+
+        return provider != nullptr ? *provider : realTime;
+    }
+
+    void setTimeProvider(ITimeProvider *provider)
+    {
+        currentProvider.store(provider, std::memory_order_release);
+    }
+} // namespace CryptoNote
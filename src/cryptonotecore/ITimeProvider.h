@@ -5,6 +5,8 @@
 
 #pragma once
 
+#include <chrono>
+#include <cstdint>
 #include <time.h>
 
 namespace CryptoNote
@@ -13,6 +15,10 @@ namespace CryptoNote
     {
         virtual time_t now() = 0;
 
+        //RTcoin
+        /* Unix microseconds */
+        virtual uint64_t nowMicroseconds() = 0;
+
         virtual ~ITimeProvider() {}
     };
 
@@ -22,6 +28,37 @@ namespace CryptoNote
         {
             return time(nullptr);
         }
+
+        virtual uint64_t nowMicroseconds() override
+        {
+            return std::chrono::duration_cast<std::chrono::microseconds>(
+                       std::chrono::system_clock::now().time_since_epoch())
+                .count();
+        }
+    };
+
+    //RTcoin
+    /* The clock the pool, admission control, block cadence and deadline
+       checks run on. Real time, unless setTimeProvider() has swapped in
+       another, such as the simulator's virtual clock. */
+    ITimeProvider &timeProvider();
+
+    /* The provider must outlive its use. nullptr goes back to real time. */
+    void setTimeProvider(ITimeProvider *provider);
+
+    /* Forwards to whatever timeProvider() is at the time, for code that
+       takes its clock as an ITimeProvider */
+    struct GlobalTimeProvider : public ITimeProvider
+    {
+        virtual time_t now() override
+        {
+            return timeProvider().now();
+        }
+
+        virtual uint64_t nowMicroseconds() override
+        {
+            return timeProvider().nowMicroseconds();
+        }
     };
 
 } // namespace CryptoNote
@@ -6,6 +6,7 @@
 #pragma once
 
 #include "CachedTransaction.h"
+#include "TransactionAdmissionController.h"
 
 namespace CryptoNote
 {
@@ -18,6 +19,14 @@ namespace CryptoNote
 
         virtual bool pushTransaction(CachedTransaction &&tx, TransactionValidatorState &&transactionState) = 0;
 
+        //RTcoin
+        /* As pushTransaction(), for a transaction restored from a pool
+           snapshot, keeping the time (unix seconds) it was first received */
+        virtual bool restoreTransaction(
+            CachedTransaction &&tx,
+            TransactionValidatorState &&transactionState,
+            const uint64_t receiveTime) = 0;
+
         virtual const CachedTransaction &getTransaction(const Crypto::Hash &hash) const = 0;
 
         virtual const std::optional<CachedTransaction> tryGetTransaction(const Crypto::Hash &hash) const = 0;
@@ -41,8 +50,32 @@ namespace CryptoNote
 
         virtual uint64_t getTransactionReceiveTime(const Crypto::Hash &hash) const = 0;
 
+        //RTcoin
+        /* Unix milliseconds, 0 if no transaction in the pool has a deadline */
+        virtual uint64_t getEarliestDeadline() const = 0;
+
         virtual std::vector<Crypto::Hash> getTransactionHashesByPaymentId(const Crypto::Hash &paymentId) const = 0;
 
+        //RTcoin
+        /* The transactions to evict, lowest priority first, so the given
+           transaction fits in the pool's memory allowance. Empty if it
+           already fits, nullopt if it should be refused, as there aren't
+           enough transactions with a lower priority to make room */
+        virtual std::optional<std::vector<Crypto::Hash>>
+            getEvictionsToFit(const CachedTransaction &transaction) const = 0;
+
+        //RTcoin
+        /* Could every deadline in the pool still be met, in deadline order,
+           with the blocks forecast, if the given transaction was added? Only
+           deadlines at or after the transaction's own are checked, as it
+           can't push anything earlier back */
+        virtual bool isSchedulable(const CachedTransaction &transaction, const CapacityForecast &forecast) const = 0;
+
+        //RTcoin
+        /* Bytes of transactions in the pool with each deadline, earliest
+           first. Transactions without a deadline come first, under 0. */
+        virtual std::vector<std::pair<uint64_t, uint64_t>> getDeadlineDemand() const = 0;
+
         virtual void flush() = 0;
     };
 
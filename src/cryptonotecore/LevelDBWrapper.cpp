@@ -10,6 +10,10 @@
 #include "leveldb/db.h"
 #include "leveldb/table.h"
 #include "leveldb/write_batch.h"
+#include "utilities/MemoryBudget.h"
+#include "utilities/Metrics.h"
+
+#include <chrono>
 
 using namespace CryptoNote;
 using namespace Logging;
@@ -17,6 +21,23 @@ using namespace Logging;
 namespace
 {
     const std::string DB_NAME = "LevelDB";
+
+    //RTcoin
+    LatencyHistogram &readLatency()
+    {
+        static LatencyHistogram &histogram = Metrics::registry().histogram(
+            "db_read_microseconds", "Time taken to read a batch of keys", {{"backend", "leveldb"}});
+
+        return histogram;
+    }
+
+    LatencyHistogram &writeLatency()
+    {
+        static LatencyHistogram &histogram = Metrics::registry().histogram(
+            "db_write_microseconds", "Time taken to write a batch", {{"backend", "leveldb"}});
+
+        return histogram;
+    }
 }
 
 LevelDBWrapper::LevelDBWrapper(std::shared_ptr<Logging::ILogger> logger):
@@ -117,6 +138,8 @@ void LevelDBWrapper::init(const DataBaseConfig &config)
 
     db.reset(dbPtr);
     state.store(INITIALIZED);
+
+    updateMemoryUsage();
 }
 
 void LevelDBWrapper::shutdown()
@@ -185,6 +208,10 @@ std::error_code LevelDBWrapper::write(IWriteBatch &batch, bool sync)
         LevelDBbBatch.Delete(leveldb::Slice(key));
     }
 
+    updateMemoryUsage();
+
+    Metrics::ScopedTimer timer(writeLatency());
+
     leveldb::Status status = db->Write(writeOptions, &LevelDBbBatch);
 
     if (!status.ok())
@@ -215,6 +242,8 @@ std::error_code LevelDBWrapper::read(IReadBatch &batch)
     std::error_code error;
     std::vector<bool> resultStates;
 
+    Metrics::ScopedTimer timer(readLatency());
+
     for (const std::string &key : rawKeys)
     {
         std::string tmp_value;
@@ -243,3 +272,26 @@ std::string LevelDBWrapper::getDataDir(const DataBaseConfig &config)
 {
     return config.dataDir + '/' + DB_NAME;
 }
+
+//RTcoin
+void LevelDBWrapper::updateMemoryUsage()
+{
+    const uint64_t now = std::chrono::duration_cast<std::chrono::milliseconds>(
+                             std::chrono::steady_clock::now().time_since_epoch())
+                             .count();
+
+    uint64_t last = lastMemoryUpdate.load(std::memory_order_relaxed);
+
+    /* Only one thread does the update */
+    if (now - last < 1000 || !lastMemoryUpdate.compare_exchange_strong(last, now, std::memory_order_relaxed))
+    {
+        return;
+    }
+
+    std::string usage;
+
+    if (db->GetProperty("leveldb.approximate-memory-usage", &usage))
+    {
+        MemoryBudget::budget().set(MemoryBudget::Subsystem::Database, std::stoull(usage));
+    }
+}
@@ -47,6 +47,12 @@ namespace CryptoNote
 
         std::string getDataDir(const DataBaseConfig &config);
 
+        //RTcoin
+        /* Reports the memory held by the block cache and memtables, at most
+           once a second. LevelDB can't resize its cache once open, so unlike
+           RocksDB, this is only reported */
+        void updateMemoryUsage();
+
         enum State
         {
             NOT_INITIALIZED,
@@ -58,5 +64,9 @@ namespace CryptoNote
         std::unique_ptr<leveldb::DB> db;
 
         std::atomic<State> state;
+
+        //RTcoin
+        /* Steady clock milliseconds */
+        std::atomic<uint64_t> lastMemoryUpdate {0};
     };
 } // namespace CryptoNote
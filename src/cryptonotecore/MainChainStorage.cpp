@@ -8,7 +8,9 @@
 #include "common/CryptoNoteTools.h"
 #include "common/FileSystemShim.h"
 
+#include <limits>
 #include <sstream>
+#include <utilities/MemoryBudget.h>
 
 namespace CryptoNote
 {
@@ -30,11 +32,15 @@ namespace CryptoNote
     void MainChainStorage::pushBlock(const RawBlock &rawBlock)
     {
         storage.push_back(rawBlock);
+
+        updateMemoryBudget();
     }
 
     void MainChainStorage::popBlock()
     {
         storage.pop_back();
+
+        updateMemoryBudget();
     }
 
     void MainChainStorage::rewindTo(const uint32_t index) const
@@ -43,6 +49,8 @@ namespace CryptoNote
         {
             storage.pop_back();
         }
+
+        updateMemoryBudget();
     }
 
     RawBlock MainChainStorage::getBlockByIndex(uint32_t index) const
@@ -56,7 +64,11 @@ namespace CryptoNote
 
         try
         {
-            return storage[index];
+            RawBlock block = storage[index];
+
+            updateMemoryBudget();
+
+            return block;
         }
         catch (std::exception &)
         {
@@ -84,6 +96,24 @@ namespace CryptoNote
     void MainChainStorage::clear()
     {
         storage.clear();
+
+        updateMemoryBudget();
+    }
+
+    //RTcoin
+    void MainChainStorage::updateMemoryBudget() const
+    {
+        auto &budget = MemoryBudget::budget();
+
+        const uint64_t allowance = budget.allowance(MemoryBudget::Subsystem::BlockStorageCache);
+
+        const bool unlimited = allowance == std::numeric_limits<uint64_t>::max();
+
+        /* A limit of 0 is no limit, so an allowance of 0 still keeps the cache
+           down to the one block */
+        storage.setCacheMemoryLimit(unlimited ? 0 : std::max<uint64_t>(allowance, 1));
+
+        budget.set(MemoryBudget::Subsystem::BlockStorageCache, storage.cacheMemoryUsage());
     }
 
     std::unique_ptr<IMainChainStorage>
@@ -31,6 +31,10 @@ namespace CryptoNote
         virtual void clear() override;
 
       private:
+        //RTcoin
+        /* Fits the block cache to its memory allowance, and reports its usage */
+        void updateMemoryBudget() const;
+
         mutable SwappedVector<RawBlock> storage;
     };
 
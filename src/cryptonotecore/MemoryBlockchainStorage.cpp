@@ -8,19 +8,50 @@
 #include "serialization/SerializationOverloads.h"
 
 #include <cassert>
+#include <utilities/MemoryBudget.h>
 
 using namespace CryptoNote;
 
+namespace
+{
+    //RTcoin
+    uint64_t blockMemoryUsage(const RawBlock &rawBlock)
+    {
+        uint64_t size = rawBlock.block.size();
+
+        for (const auto &transaction : rawBlock.transactions)
+        {
+            size += transaction.size();
+        }
+
+        return size;
+    }
+
+    void addMemoryUsage(const int64_t bytes)
+    {
+        MemoryBudget::budget().add(MemoryBudget::Subsystem::AlternativeChains, bytes);
+    }
+} // namespace
+
 MemoryBlockchainStorage::MemoryBlockchainStorage(uint32_t reserveSize)
 {
     blocks.reserve(reserveSize);
 }
 
-MemoryBlockchainStorage::~MemoryBlockchainStorage() {}
+MemoryBlockchainStorage::~MemoryBlockchainStorage()
+{
+    addMemoryUsage(-static_cast<int64_t>(memoryUsage));
+}
 
 void MemoryBlockchainStorage::pushBlock(RawBlock &&rawBlock)
 {
+    const uint64_t size = blockMemoryUsage(rawBlock);
+
     blocks.push_back(rawBlock);
+
+    memoryUsage += size;
+
+    addMemoryUsage(static_cast<int64_t>(size));
 }
 
 RawBlock MemoryBlockchainStorage::getBlockByIndex(uint32_t index) const
@@ -50,5 +81,13 @@ std::unique_ptr<BlockchainStorage::IBlockchainStorageInternal>
     blocks.resize(splitIndex);
     blocks.shrink_to_fit();
 
+    /* Moved, rather than freed, so the total doesn't change */
+    for (const auto &block : newStorage->blocks)
+    {
+        newStorage->memoryUsage += blockMemoryUsage(block);
+    }
+
+    memoryUsage -= newStorage->memoryUsage;
+
     return newStorage;
 }
@@ -29,6 +29,11 @@ namespace CryptoNote
 
       private:
         std::vector<RawBlock> blocks;
+
+        //RTcoin
+        /* Bytes of raw blocks held, counted against the alternative chains'
+           memory allowance */
+        uint64_t memoryUsage = 0;
     };
 
 } // namespace CryptoNote
@@ -10,6 +10,12 @@
 #include "rocksdb/db.h"
 #include "rocksdb/table.h"
 #include "rocksdb/utilities/backupable_db.h"
+#include "utilities/MemoryBudget.h"
+#include "utilities/Metrics.h"
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
 
 using namespace CryptoNote;
 using namespace Logging;
@@ -17,6 +23,28 @@ using namespace Logging;
 namespace
 {
     const std::string DB_NAME = "DB";
+
+    //RTcoin
+    /* The block cache isn't shrunk any further than this, however short memory
+       is - below it, nearly every read goes to disk */
+    const uint64_t MIN_BLOCK_CACHE_SIZE = 8 * 1024 * 1024;
+
+    //RTcoin
+    LatencyHistogram &readLatency()
+    {
+        static LatencyHistogram &histogram = Metrics::registry().histogram(
+            "db_read_microseconds", "Time taken to read a batch of keys", {{"backend", "rocksdb"}});
+
+        return histogram;
+    }
+
+    LatencyHistogram &writeLatency()
+    {
+        static LatencyHistogram &histogram = Metrics::registry().histogram(
+            "db_write_microseconds", "Time taken to write a batch", {{"backend", "rocksdb"}});
+
+        return histogram;
+    }
 }
 
 RocksDBWrapper::RocksDBWrapper(std::shared_ptr<Logging::ILogger> logger):
@@ -69,6 +97,8 @@ void RocksDBWrapper::init(const DataBaseConfig &config)
 
     db.reset(dbPtr);
     state.store(INITIALIZED);
+
+    updateMemoryUsage();
 }
 
 void RocksDBWrapper::shutdown()
@@ -138,6 +168,10 @@ std::error_code RocksDBWrapper::write(IWriteBatch &batch, bool sync)
         rocksdbBatch.Delete(rocksdb::Slice(key));
     }
 
+    updateMemoryUsage();
+
+    Metrics::ScopedTimer timer(writeLatency());
+
     rocksdb::Status status = db->Write(writeOptions, &rocksdbBatch);
 
     if (!status.ok())
@@ -170,6 +204,11 @@ std::error_code RocksDBWrapper::read(IReadBatch &batch)
 
     std::vector<std::string> values;
     values.reserve(rawKeys.size());
+
+    updateMemoryUsage();
+
+    Metrics::ScopedTimer timer(readLatency());
+
     std::vector<rocksdb::Status> statuses = db->MultiGet(readOptions, keySlices, &values);
 
     std::error_code error;
@@ -204,6 +243,10 @@ std::error_code RocksDBWrapper::readThreadSafe(IReadBatch &batch)
 
     int i = 0;
 
+    updateMemoryUsage();
+
+    Metrics::ScopedTimer timer(readLatency());
+
     for (const std::string &key : rawKeys)
     {
         const rocksdb::Status status = db->Get(readOptions, rocksdb::Slice(key), &values[i]);
@@ -274,7 +317,10 @@ rocksdb::Options RocksDBWrapper::getDBOptions(const DataBaseConfig &config)
     fOptions.bottommost_compression = compressionLevel;
 
     rocksdb::BlockBasedTableOptions tableOptions;
-    tableOptions.block_cache = rocksdb::NewLRUCache(config.readCacheSize);
+    //RTcoin
+    blockCache = rocksdb::NewLRUCache(config.readCacheSize);
+    maxBlockCacheSize = config.readCacheSize;
+    tableOptions.block_cache = blockCache;
     std::shared_ptr<rocksdb::TableFactory> tfp(NewBlockBasedTableFactory(tableOptions));
     fOptions.table_factory = tfp;
 
@@ -285,3 +331,47 @@ std::string RocksDBWrapper::getDataDir(const DataBaseConfig &config)
 {
     return config.dataDir + '/' + DB_NAME;
 }
+
+//RTcoin
+void RocksDBWrapper::updateMemoryUsage()
+{
+    const uint64_t now = std::chrono::duration_cast<std::chrono::milliseconds>(
+                             std::chrono::steady_clock::now().time_since_epoch())
+                             .count();
+
+    uint64_t last = lastMemoryUpdate.load(std::memory_order_relaxed);
+
+    /* Only one thread does the update */
+    if (now - last < 1000 || !lastMemoryUpdate.compare_exchange_strong(last, now, std::memory_order_relaxed))
+    {
+        return;
+    }
+
+    uint64_t memtables = 0;
+
+    db->GetIntProperty("rocksdb.cur-size-all-mem-tables", &memtables);
+
+    auto &budget = MemoryBudget::budget();
+
+    const uint64_t allowance = budget.allowance(MemoryBudget::Subsystem::Database);
+
+    if (allowance != std::numeric_limits<uint64_t>::max())
+    {
+        /* The memtables are flushed on their own schedule, so the block cache
+           gets whatever they leave */
+        const uint64_t available = allowance > memtables ? allowance - memtables : 0;
+
+        const uint64_t capacity =
+            std::clamp(available, std::min(MIN_BLOCK_CACHE_SIZE, maxBlockCacheSize), maxBlockCacheSize);
+
+        if (capacity != blockCache->GetCapacity())
+        {
+            logger(DEBUGGING) << "Resizing block cache from " << blockCache->GetCapacity() << " to " << capacity
+                              << " bytes";
+
+            blockCache->SetCapacity(capacity);
+        }
+    }
+
+    budget.set(MemoryBudget::Subsystem::Database, memtables + blockCache->GetUsage());
+}
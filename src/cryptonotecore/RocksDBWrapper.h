@@ -6,6 +6,7 @@
 #pragma once
 
 #include "IDataBase.h"
+#include "rocksdb/cache.h"
 #include "rocksdb/db.h"
 
 #include <atomic>
@@ -49,6 +50,11 @@ namespace CryptoNote
 
         std::string getDataDir(const DataBaseConfig &config);
 
+        //RTcoin
+        /* Fits the block cache to the database's memory allowance, and reports
+           the memory held by the cache and memtables. At most once a second */
+        void updateMemoryUsage();
+
         enum State
         {
             NOT_INITIALIZED,
@@ -60,5 +66,14 @@ namespace CryptoNote
         std::unique_ptr<rocksdb::DB> db;
 
         std::atomic<State> state;
+
+        //RTcoin
+        std::shared_ptr<rocksdb::Cache> blockCache;
+
+        /* The configured read cache size, which the block cache never grows past */
+        uint64_t maxBlockCacheSize = 0;
+
+        /* Steady clock milliseconds */
+        std::atomic<uint64_t> lastMemoryUpdate {0};
     };
 } // namespace CryptoNote
@@ -187,6 +187,13 @@ template<class T> class SwappedVector
 
     void push_back(const T &item);
 
+    //RTcoin
+    /* Most bytes of items to keep in memory, by their serialized size, on top
+       of the pool size. 0 for no limit */
+    void setCacheMemoryLimit(uint64_t bytes);
+
+    uint64_t cacheMemoryUsage() const;
+
   private:
     struct ItemEntry;
     struct CacheEntry;
@@ -196,6 +203,7 @@ template<class T> class SwappedVector
       public:
         T item;
         typename std::list<CacheEntry>::iterator cacheIter;
+        uint64_t size;
     };
 
     struct CacheEntry
@@ -222,7 +230,15 @@ template<class T> class SwappedVector
 
     uint64_t m_cacheMisses;
 
+    uint64_t m_cacheMemoryUsage = 0;
+
+    uint64_t m_cacheMemoryLimit = 0;
+
     T *prepare(uint64_t index);
+
+    /* Drops the least recently used items until there's room for
+       incomingCount more, of incomingSize bytes in total */
+    void evict(size_t incomingCount, uint64_t incomingSize);
 };
 
 template<class T> SwappedVector<T>::SwappedVector() {}
@@ -309,6 +325,7 @@ bool SwappedVector<T>::open(const std::string &itemFileName, const std::string &
     m_poolSize = poolSize;
     m_items.clear();
     m_cache.clear();
+    m_cacheMemoryUsage = 0;
     m_cacheHits = 0;
     m_cacheMisses = 0;
     return true;
@@ -402,6 +419,7 @@ template<class T> void SwappedVector<T>::clear()
     m_itemsFileSize = 0;
     m_items.clear();
     m_cache.clear();
+    m_cacheMemoryUsage = 0;
 }
 
 template<class T> void SwappedVector<T>::pop_back()
@@ -424,6 +442,7 @@ template<class T> void SwappedVector<T>::pop_back()
     auto itemIter = m_items.find(m_offsets.size());
     if (itemIter != m_items.end())
     {
+        m_cacheMemoryUsage -= itemIter->second.size;
         m_cache.erase(itemIter->second.cacheIter);
         m_items.erase(itemIter);
     }
@@ -478,18 +497,42 @@ template<class T> void SwappedVector<T>::push_back(const T &item)
     *newItem = item;
 }
 
+template<class T> void SwappedVector<T>::setCacheMemoryLimit(uint64_t bytes)
+{
+    m_cacheMemoryLimit = bytes;
+    evict(0, 0);
+}
+
+template<class T> uint64_t SwappedVector<T>::cacheMemoryUsage() const
+{
+    return m_cacheMemoryUsage;
+}
+
 template<class T> T *SwappedVector<T>::prepare(uint64_t index)
 {
-    if (m_items.size() == m_poolSize)
-    {
-        auto cacheIter = m_cache.begin();
-        m_items.erase(cacheIter->itemIter);
-        m_cache.erase(cacheIter);
-    }
+    const uint64_t end = index + 1 < m_offsets.size() ? m_offsets[index + 1] : m_itemsFileSize;
+    const uint64_t size = end - m_offsets[index];
+
+    evict(1, size);
 
     auto itemIter = m_items.insert(std::make_pair(index, ItemEntry()));
     CacheEntry cacheEntry = {itemIter.first};
     auto cacheIter = m_cache.insert(m_cache.end(), cacheEntry);
     itemIter.first->second.cacheIter = cacheIter;
+    itemIter.first->second.size = size;
+    m_cacheMemoryUsage += size;
     return &itemIter.first->second.item;
 }
+
+template<class T> void SwappedVector<T>::evict(size_t incomingCount, uint64_t incomingSize)
+{
+    while (!m_cache.empty()
+           && (m_items.size() + incomingCount > m_poolSize
+               || (m_cacheMemoryLimit != 0 && m_cacheMemoryUsage + incomingSize > m_cacheMemoryLimit)))
+    {
+        auto cacheIter = m_cache.begin();
+        m_cacheMemoryUsage -= cacheIter->itemIter->second.size;
+        m_items.erase(cacheIter->itemIter);
+        m_cache.erase(cacheIter);
+    }
+}
@@ -0,0 +1,127 @@
+// Copyright (c) 2018-2020, The TurtleCoin Developers
+//
+// Please see the included LICENSE file for more information.
+
+///////////////////////////////////////////////////////////
+#include <cryptonotecore/TransactionAdmissionController.h>
+///////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <config/CryptoNoteConfig.h>
+#include <cryptonotecore/ITimeProvider.h>
+#include <utilities/Metrics.h>
+
+namespace CryptoNote
+{
+    namespace
+    {
+        const uint64_t TARGET_INTERVAL = parameters::DIFFICULTY_TARGET * 1000;
+
+        /* Blocks with a timestamp older than this when they arrive are from
+           syncing, and say nothing about how often blocks turn up now */
+        const uint64_t MAX_FRESH_BLOCK_AGE = parameters::DIFFICULTY_TARGET * 6;
+
+        uint64_t nowMilliseconds()
+        {
+            return timeProvider().nowMicroseconds() / 1000;
+        }
+
+        Metrics::Gauge &blockIntervalGauge()
+        {
+            static Metrics::Gauge &gauge = Metrics::registry().gauge(
+                "admission_block_interval_milliseconds", "Interval between blocks assumed by admission control");
+
+            return gauge;
+        }
+
+        Metrics::Gauge &blockSizeGauge()
+        {
+            static Metrics::Gauge &gauge = Metrics::registry().gauge(
+                "admission_block_size_bytes", "Transaction bytes per block assumed by admission control");
+
+            return gauge;
+        }
+    } // namespace
+
+    void TransactionAdmissionController::recordBlock(const uint64_t blockTimestamp)
+    {
+        const uint64_t now = nowMilliseconds();
+
+        if (now / 1000 > blockTimestamp + MAX_FRESH_BLOCK_AGE)
+        {
+            return;
+        }
+
+        const uint64_t lastBlockTime = m_lastBlockTime.exchange(now, std::memory_order_relaxed);
+
+        if (lastBlockTime == 0 || now < lastBlockTime)
+        {
+            return;
+        }
+
+        /* A gap longer than the target is either bad luck, or nobody making
+           blocks because there was nothing to put in them. Neither tells us
+           blocks will be slower when there is work to do. */
+        const uint64_t gap = std::min(now - lastBlockTime, TARGET_INTERVAL);
+
+        const uint64_t measured = m_measuredInterval.load(std::memory_order_relaxed);
+
+        /* Moving average, with the newest gap weighted 1/8 */
+        const uint64_t interval = measured == 0 ? gap : (measured * 7 + gap) / 8;
+
+        /* 0 means not measured yet */
+        m_measuredInterval.store(std::max<uint64_t>(interval, 1), std::memory_order_relaxed);
+
+        blockIntervalGauge().set(getBlockInterval());
+    }
+
+    void TransactionAdmissionController::setBlockSize(const uint64_t bytes)
+    {
+        m_blockSize.store(bytes, std::memory_order_relaxed);
+
+        blockSizeGauge().set(bytes);
+    }
+
+    void TransactionAdmissionController::setBlockInterval(const uint64_t interval)
+    {
+        m_fixedInterval.store(interval, std::memory_order_relaxed);
+
+        blockIntervalGauge().set(getBlockInterval());
+    }
+
+    uint64_t TransactionAdmissionController::getBlockInterval() const
+    {
+        const uint64_t fixed = m_fixedInterval.load(std::memory_order_relaxed);
+
+        if (fixed != 0)
+        {
+            return fixed;
+        }
+
+        const uint64_t measured = m_measuredInterval.load(std::memory_order_relaxed);
+
+        return measured != 0 ? measured : TARGET_INTERVAL;
+    }
+
+    uint64_t TransactionAdmissionController::getLastBlockTime() const
+    {
+        return m_lastBlockTime.load(std::memory_order_relaxed);
+    }
+
+    CapacityForecast TransactionAdmissionController::forecast() const
+    {
+        CapacityForecast forecast;
+
+        forecast.now = nowMilliseconds();
+        forecast.interval = getBlockInterval();
+        forecast.blockSize = m_blockSize.load(std::memory_order_relaxed);
+
+        const uint64_t lastBlockTime = m_lastBlockTime.load(std::memory_order_relaxed);
+
+        /* An overdue block could turn up any moment - as could the first,
+           if we haven't seen one since starting */
+        forecast.nextBlock = std::max(forecast.now, lastBlockTime + forecast.interval);
+
+        return forecast;
+    }
+} // namespace CryptoNote
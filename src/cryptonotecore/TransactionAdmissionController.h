@@ -0,0 +1,85 @@
+// Copyright (c) 2018-2020, The TurtleCoin Developers
+//
+// Please see the included LICENSE file for more information.
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace CryptoNote
+{
+    //RTcoin
+    /* How much block space we expect to have between now and some deadline.
+       Blocks are assumed to arrive every interval milliseconds from
+       nextBlock onwards, each with room for blockSize bytes of transactions.
+       All times are unix milliseconds. */
+    struct CapacityForecast
+    {
+        uint64_t now = 0;
+
+        uint64_t nextBlock = 0;
+
+        uint64_t interval = 0;
+
+        uint64_t blockSize = 0;
+
+        /* Bytes of transactions the blocks expected by the deadline can hold */
+        uint64_t capacityBy(const uint64_t deadline) const
+        {
+            if (deadline < nextBlock || interval == 0)
+            {
+                return 0;
+            }
+
+            return (1 + (deadline - nextBlock) / interval) * blockSize;
+        }
+    };
+
+    /* Models the block space coming up, so the pool can turn away deadline
+       transactions it has no hope of getting into a block in time, rather
+       than taking them and missing everything else's deadlines as well.
+
+       Block size follows the limit the block template uses - the median
+       block size, plus the 25% growth allowed over it, capped at the
+       maximum cumulative block size. The interval between blocks is fixed
+       if setBlockInterval() was given one, such as the block producer's
+       maximum interval, or measured from when recent blocks arrived,
+       falling back to the difficulty target until we've seen some.
+
+       Safe to call from any thread. */
+    class TransactionAdmissionController
+    {
+      public:
+        /* Called with each block added to the main chain, with the block's
+           own timestamp, in seconds, so blocks downloaded whilst syncing
+           aren't mistaken for the chain's cadence */
+        void recordBlock(const uint64_t blockTimestamp);
+
+        /* Bytes of transactions the next block can hold */
+        void setBlockSize(const uint64_t bytes);
+
+        /* In milliseconds, 0 to measure it from arriving blocks */
+        void setBlockInterval(const uint64_t interval);
+
+        /* In milliseconds */
+        uint64_t getBlockInterval() const;
+
+        /* Unix milliseconds, 0 if no block has arrived since we started */
+        uint64_t getLastBlockTime() const;
+
+        CapacityForecast forecast() const;
+
+      private:
+        std::atomic<uint64_t> m_blockSize {0};
+
+        std::atomic<uint64_t> m_fixedInterval {0};
+
+        /* Moving average of the gap between blocks arriving, milliseconds,
+           0 until we've seen two in a row */
+        std::atomic<uint64_t> m_measuredInterval {0};
+
+        /* Unix milliseconds, 0 if no block has arrived since we started */
+        std::atomic<uint64_t> m_lastBlockTime {0};
+    };
+} // namespace CryptoNote
@@ -0,0 +1,335 @@
+// Copyright (c) 2018-2020, The TurtleCoin Developers
+//
+// Please see the included LICENSE file for more information.
+
+//////////////////////////////////////////////////////
+#include <cryptonotecore/TransactionLatencyTracker.h>
+//////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <chrono>
+#include <cryptonotecore/ITimeProvider.h>
+#include <iomanip>
+#include <sstream>
+
+namespace CryptoNote
+{
+    namespace
+    {
+        /* Must be a power of two. At 5 events per transaction, this covers a
+           few seconds at thousands of transactions per second between drains */
+        const size_t EVENT_RING_CAPACITY = 1 << 17;
+
+        /* Stop following new transactions once we are following this many */
+        const size_t MAX_TRACKED_TRANSACTIONS = 1 << 20;
+
+        /* Forget about transactions that haven't been included after this long */
+        const uint64_t MAX_TRACKED_AGE = std::chrono::microseconds(std::chrono::hours(1)).count();
+
+        uint64_t nowMicroseconds()
+        {
+            return timeProvider().nowMicroseconds();
+        }
+    } // namespace
+
+    constexpr std::array<uint64_t, 4> TransactionLatencyTracker::SIZE_CLASSES;
+
+    TransactionLatencyTracker::TransactionLatencyTracker(): m_events(EVENT_RING_CAPACITY) {}
+
+    void TransactionLatencyTracker::record(
+        const Crypto::Hash &hash,
+        const Stage stage,
+        const uint64_t deadline,
+        const uint64_t size)
+    {
+        m_events.tryPush({hash, nowMicroseconds(), deadline, size, stage});
+    }
+
+    void TransactionLatencyTracker::process()
+    {
+        std::scoped_lock lock(m_mutex);
+
+        m_events.drain([this](const Event &event) { processEvent(event); });
+
+        expireTransactions(nowMicroseconds());
+    }
+
+    void TransactionLatencyTracker::processEvent(const Event &event)
+    {
+        auto it = m_timelines.find(event.hash);
+
+        if (it == m_timelines.end())
+        {
+            if (m_timelines.size() >= MAX_TRACKED_TRANSACTIONS)
+            {
+                m_droppedTimelines++;
+                return;
+            }
+
+            it = m_timelines.emplace(event.hash, Timeline()).first;
+
+            it->second.deadlineEntry = m_byDeadline.end();
+            it->second.firstSeenEntry = m_byFirstSeen.emplace(event.timestamp, event.hash);
+        }
+
+        Timeline &timeline = it->second;
+
+        if (event.deadline != 0 && event.deadline != timeline.deadline)
+        {
+            timeline.deadline = event.deadline;
+
+            if (!timeline.expired)
+            {
+                if (timeline.deadlineEntry != m_byDeadline.end())
+                {
+                    m_byDeadline.erase(timeline.deadlineEntry);
+                }
+
+                timeline.deadlineEntry = m_byDeadline.emplace(event.deadline, event.hash);
+            }
+        }
+
+        if (event.size != 0)
+        {
+            timeline.size = event.size;
+        }
+
+        uint64_t &stageTime = timeline.stages[static_cast<size_t>(event.stage)];
+
+        /* We only care about the first time a transaction reaches a stage -
+           it may be added to many block templates before it is mined */
+        if (stageTime != 0)
+        {
+            return;
+        }
+
+        stageTime = event.timestamp;
+
+        switch (event.stage)
+        {
+            case Stage::Validated:
+            {
+                recordDelay(Delay::ReceivedToValidated, timeline, Stage::Received, Stage::Validated);
+                break;
+            }
+            case Stage::Relayed:
+            {
+                recordDelay(Delay::ValidatedToRelayed, timeline, Stage::Validated, Stage::Relayed);
+                break;
+            }
+            case Stage::AddedToTemplate:
+            {
+                recordDelay(Delay::ValidatedToTemplate, timeline, Stage::Validated, Stage::AddedToTemplate);
+                break;
+            }
+            case Stage::IncludedInBlock:
+            {
+                recordDelay(Delay::TemplateToIncluded, timeline, Stage::AddedToTemplate, Stage::IncludedInBlock);
+                recordDelay(Delay::ReceivedToIncluded, timeline, Stage::Received, Stage::IncludedInBlock);
+
+                recordDeadline(timeline, event.timestamp);
+
+                /* Nothing more will happen to this transaction */
+                eraseTimeline(it);
+
+                break;
+            }
+            case Stage::Rejected:
+            {
+                if (timeline.deadline != 0 && !timeline.expired)
+                {
+                    m_deadlines[sizeClass(timeline.size)].rejected++;
+                }
+
+                eraseTimeline(it);
+
+                break;
+            }
+            default:
+            {
+                break;
+            }
+        }
+    }
+
+    void TransactionLatencyTracker::recordDelay(
+        const Delay delay,
+        const Timeline &timeline,
+        const Stage from,
+        const Stage to)
+    {
+        const uint64_t start = timeline.stages[static_cast<size_t>(from)];
+        const uint64_t end = timeline.stages[static_cast<size_t>(to)];
+
+        /* Didn't see the earlier stage, i.e. we first heard of this
+           transaction in a block */
+        if (start == 0 || end < start)
+        {
+            return;
+        }
+
+        m_delays[static_cast<size_t>(delay)].record(end - start);
+    }
+
+    void TransactionLatencyTracker::recordDeadline(const Timeline &timeline, const uint64_t includedAt)
+    {
+        if (timeline.deadline == 0 || timeline.expired)
+        {
+            return;
+        }
+
+        auto &counts = m_deadlines[sizeClass(timeline.size)];
+
+        if (includedAt / 1000 <= timeline.deadline)
+        {
+            counts.met++;
+        }
+        else
+        {
+            counts.missed++;
+        }
+    }
+
+    void TransactionLatencyTracker::expireTransactions(const uint64_t now)
+    {
+        /* Both indexes are in time order, so we only ever look at the
+           transactions that are actually due, rather than every one */
+        while (!m_byDeadline.empty() && now / 1000 > m_byDeadline.begin()->first)
+        {
+            Timeline &timeline = m_timelines.at(m_byDeadline.begin()->second);
+
+            timeline.expired = true;
+            m_deadlines[sizeClass(timeline.size)].expired++;
+
+            m_byDeadline.erase(m_byDeadline.begin());
+            timeline.deadlineEntry = m_byDeadline.end();
+        }
+
+        while (!m_byFirstSeen.empty() && now - std::min(now, m_byFirstSeen.begin()->first) > MAX_TRACKED_AGE)
+        {
+            eraseTimeline(m_timelines.find(m_byFirstSeen.begin()->second));
+        }
+    }
+
+    void TransactionLatencyTracker::eraseTimeline(const Timelines::iterator it)
+    {
+        if (it->second.deadlineEntry != m_byDeadline.end())
+        {
+            m_byDeadline.erase(it->second.deadlineEntry);
+        }
+
+        m_byFirstSeen.erase(it->second.firstSeenEntry);
+
+        m_timelines.erase(it);
+    }
+
+    size_t TransactionLatencyTracker::sizeClass(const uint64_t size)
+    {
+        for (size_t i = 0; i < SIZE_CLASSES.size(); i++)
+        {
+            if (size <= SIZE_CLASSES[i])
+            {
+                return i;
+            }
+        }
+
+        return SIZE_CLASSES.size();
+    }
+
+    TransactionLatencyTracker::Summary TransactionLatencyTracker::getSummary()
+    {
+        process();
+
+        std::scoped_lock lock(m_mutex);
+
+        Summary summary;
+
+        for (size_t i = 0; i < DELAY_COUNT; i++)
+        {
+            const auto &histogram = m_delays[i];
+
+            summary.delays.push_back({delayName(static_cast<Delay>(i)),
+                                      histogram.count(),
+                                      histogram.mean(),
+                                      histogram.valueAtPercentile(50),
+                                      histogram.valueAtPercentile(90),
+                                      histogram.valueAtPercentile(99),
+                                      histogram.valueAtPercentile(99.9),
+                                      histogram.max()});
+        }
+
+        summary.deadlines = m_deadlines;
+        summary.tracked = m_timelines.size();
+        summary.dropped = m_events.dropped() + m_droppedTimelines;
+
+        return summary;
+    }
+
+    std::string TransactionLatencyTracker::getSummaryLine()
+    {
+        const Summary summary = getSummary();
+
+        DeadlineCounts total;
+
+        for (const auto &counts : summary.deadlines)
+        {
+            total.met += counts.met;
+            total.missed += counts.missed;
+            total.expired += counts.expired;
+            total.rejected += counts.rejected;
+        }
+
+        std::stringstream stream;
+
+        stream << std::fixed << std::setprecision(1);
+
+        for (const auto &delay : summary.delays)
+        {
+            if (delay.count == 0)
+            {
+                continue;
+            }
+
+            stream << delay.name << " p50/p99 " << delay.p50 / 1000.0 << "/" << delay.p99 / 1000.0 << "ms, ";
+        }
+
+        stream << "deadlines met " << total.met << ", missed " << total.missed << ", expired " << total.expired
+               << ", rejected " << total.rejected << ", tracking " << summary.tracked << " transactions";
+
+        if (summary.dropped != 0)
+        {
+            stream << ", " << summary.dropped << " events dropped";
+        }
+
+        return stream.str();
+    }
+
+    std::string TransactionLatencyTracker::delayName(const Delay delay)
+    {
+        switch (delay)
+        {
+            case Delay::ReceivedToValidated:
+                return "received_to_validated";
+            case Delay::ValidatedToRelayed:
+                return "validated_to_relayed";
+            case Delay::ValidatedToTemplate:
+                return "validated_to_template";
+            case Delay::TemplateToIncluded:
+                return "template_to_included";
+            case Delay::ReceivedToIncluded:
+                return "received_to_included";
+            default:
+                return "unknown";
+        }
+    }
+
+    std::string TransactionLatencyTracker::sizeClassName(const size_t sizeClass)
+    {
+        if (sizeClass < SIZE_CLASSES.size())
+        {
+            return "<=" + std::to_string(SIZE_CLASSES[sizeClass]);
+        }
+
+        return ">" + std::to_string(SIZE_CLASSES.back());
+    }
+} // namespace CryptoNote
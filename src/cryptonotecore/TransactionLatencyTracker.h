@@ -0,0 +1,207 @@
+// Copyright (c) 2018-2020, The TurtleCoin Developers
+//
+// Please see the included LICENSE file for more information.
+
+#pragma once
+
+#include <CryptoTypes.h>
+#include <array>
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utilities/LatencyHistogram.h>
+#include <utilities/LockFreeRing.h>
+#include <vector>
+
+namespace CryptoNote
+{
+    //RTcoin
+    /* Tracks how long transactions take to get through the daemon, from when
+       we first hear about them to when they are included in a block, and
+       whether they made their deadline.
+
+       Recording a stage only pushes a small event onto a lock free ring, so
+       the hot paths (validation, relay, block templates) never take a lock.
+       The events are matched up into per transaction timelines, and the
+       histograms updated, whenever the ring is drained. */
+    class TransactionLatencyTracker
+    {
+      public:
+        enum class Stage : uint8_t
+        {
+            Received = 0,
+            Validated,
+            Relayed,
+            AddedToTemplate,
+            IncludedInBlock,
+            /* Turned away from the pool - nothing more will happen to it */
+            Rejected,
+            StageCount
+        };
+
+        /* Stage to stage delays we keep histograms for */
+        enum class Delay : uint8_t
+        {
+            ReceivedToValidated = 0,
+            ValidatedToRelayed,
+            ValidatedToTemplate,
+            TemplateToIncluded,
+            ReceivedToIncluded,
+            DelayCount
+        };
+
+        static constexpr size_t STAGE_COUNT = static_cast<size_t>(Stage::StageCount);
+
+        static constexpr size_t DELAY_COUNT = static_cast<size_t>(Delay::DelayCount);
+
+        /* Upper bounds, in bytes, of the size classes deadline results are
+           split into. Anything bigger falls into a final catch all class. */
+        static constexpr std::array<uint64_t, 4> SIZE_CLASSES = {512, 2048, 8192, 32768};
+
+        static constexpr size_t SIZE_CLASS_COUNT = SIZE_CLASSES.size() + 1;
+
+        struct DeadlineCounts
+        {
+            /* Included in a block before the deadline */
+            uint64_t met = 0;
+
+            /* Included in a block after the deadline */
+            uint64_t missed = 0;
+
+            /* Deadline passed whilst the transaction was still waiting */
+            uint64_t expired = 0;
+
+            /* Refused by the pool, so never waited at all */
+            uint64_t rejected = 0;
+        };
+
+        struct Summary
+        {
+            /* Microseconds */
+            struct DelaySummary
+            {
+                std::string name;
+
+                uint64_t count;
+
+                double mean;
+
+                uint64_t p50;
+
+                uint64_t p90;
+
+                uint64_t p99;
+
+                uint64_t p999;
+
+                uint64_t max;
+            };
+
+            std::vector<DelaySummary> delays;
+
+            std::array<DeadlineCounts, SIZE_CLASS_COUNT> deadlines;
+
+            /* Transactions we are currently following */
+            uint64_t tracked;
+
+            /* Events lost because the ring was full, or we were already
+               following too many transactions */
+            uint64_t dropped;
+        };
+
+        TransactionLatencyTracker();
+
+        /* Safe to call from any thread, never blocks. deadline is an absolute
+           unix timestamp in milliseconds, or 0 if there is none. */
+        void record(const Crypto::Hash &hash, const Stage stage, const uint64_t deadline = 0, const uint64_t size = 0);
+
+        /* Match up any pending events, and expire old transactions. */
+        void process();
+
+        /* Processes pending events, then summarizes everything seen so far. */
+        Summary getSummary();
+
+        /* One line human readable version of getSummary(), for the log */
+        std::string getSummaryLine();
+
+        static std::string delayName(const Delay delay);
+
+        static std::string sizeClassName(const size_t sizeClass);
+
+      private:
+        struct Event
+        {
+            Crypto::Hash hash;
+
+            uint64_t timestamp;
+
+            uint64_t deadline;
+
+            uint64_t size;
+
+            Stage stage;
+        };
+
+        /* Transaction hashes ordered by a time, so whatever is due to expire
+           next is at the front */
+        typedef std::multimap<uint64_t, Crypto::Hash> ExpiryIndex;
+
+        struct Timeline
+        {
+            /* Unix microseconds, 0 if the stage hasn't happened yet */
+            std::array<uint64_t, STAGE_COUNT> stages {};
+
+            uint64_t deadline = 0;
+
+            uint64_t size = 0;
+
+            /* Already counted as expired, don't count it again if it turns up
+               in a block later */
+            bool expired = false;
+
+            /* Our entry in m_byDeadline, or its end() if there's no deadline,
+               or it has already passed */
+            ExpiryIndex::iterator deadlineEntry;
+
+            /* Our entry in m_byFirstSeen */
+            ExpiryIndex::iterator firstSeenEntry;
+        };
+
+        typedef std::unordered_map<Crypto::Hash, Timeline> Timelines;
+
+        void processEvent(const Event &event);
+
+        void recordDelay(const Delay delay, const Timeline &timeline, const Stage from, const Stage to);
+
+        void recordDeadline(const Timeline &timeline, const uint64_t includedAt);
+
+        void expireTransactions(const uint64_t now);
+
+        /* Forgets a transaction, along with its index entries */
+        void eraseTimeline(const Timelines::iterator it);
+
+        static size_t sizeClass(const uint64_t size);
+
+        LockFreeRing<Event> m_events;
+
+        /* Protects everything below - only taken by whoever is processing
+           events, never by the threads recording them */
+        std::mutex m_mutex;
+
+        Timelines m_timelines;
+
+        /* Timelines whose deadline hasn't passed yet, by deadline (unix
+           milliseconds) */
+        ExpiryIndex m_byDeadline;
+
+        /* Every timeline, by when we first heard of it (unix microseconds) */
+        ExpiryIndex m_byFirstSeen;
+
+        std::array<LatencyHistogram, DELAY_COUNT> m_delays;
+
+        std::array<DeadlineCounts, SIZE_CLASS_COUNT> m_deadlines;
+
+        uint64_t m_droppedTimelines = 0;
+    };
+} // namespace CryptoNote
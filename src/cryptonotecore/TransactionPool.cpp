@@ -6,11 +6,26 @@
 #include "TransactionPool.h"
 
 #include "CryptoNoteBasicImpl.h"
+#include "ITimeProvider.h"
 #include "common/TransactionExtra.h"
 #include "common/int-util.h"
+#include "config/CryptoNoteConfig.h"
+#include "utilities/MemoryBudget.h"
 
 namespace CryptoNote
 {
+    namespace
+    {
+        //RTcoin
+        /* Roughly what holding a transaction in the pool costs - the blob, the
+           deserialized transaction, which is about the same size again, and
+           the hashes, indexes and container nodes around them */
+        uint64_t transactionMemoryUsage(const CachedTransaction &transaction)
+        {
+            return transaction.getTransactionBinaryArray().size() * 2 + 512;
+        }
+    } // namespace
+
     /* Is the left hand side preferred over the right hand side? */
     bool TransactionPool::TransactionPriorityComparator::operator()(
         const PendingTransactionInfo &lhs,
@@ -146,15 +161,39 @@ namespace CryptoNote
     {
     }
 
+    //RTcoin
+    TransactionPool::~TransactionPool()
+    {
+        MemoryBudget::budget().add(MemoryBudget::Subsystem::TransactionPool, -static_cast<int64_t>(m_memoryUsage));
+    }
+
     //RTcoin
     bool TransactionPool::pushTransaction(CachedTransaction &&transaction, TransactionValidatorState &&transactionState)
     {
-        auto pendingTx = PendingTransactionInfo {static_cast<uint64_t>(time(nullptr)), std::move(transaction)};
+        return addTransaction(
+            std::move(transaction), std::move(transactionState), static_cast<uint64_t>(timeProvider().now()));
+    }
+
+    //RTcoin
+    bool TransactionPool::restoreTransaction(
+        CachedTransaction &&transaction,
+        TransactionValidatorState &&transactionState,
+        const uint64_t receiveTime)
+    {
+        return addTransaction(std::move(transaction), std::move(transactionState), receiveTime);
+    }
+
+    bool TransactionPool::addTransaction(
+        CachedTransaction &&transaction,
+        TransactionValidatorState &&transactionState,
+        const uint64_t receiveTime)
+    {
+        auto pendingTx = PendingTransactionInfo {receiveTime, std::move(transaction)};
 
         Crypto::Hash paymentId;
 
         //RTcoin
-        if (pendingTx.cachedTransaction.getTransaction().version != 1234)
+        if (pendingTx.cachedTransaction.getTransaction().version != CryptoNote::HACK_TRANSACTION_VERSION)
         {
             if (getPaymentIdFromTxExtra(pendingTx.cachedTransaction.getTransaction().extra, paymentId))
             {
@@ -180,7 +219,24 @@ namespace CryptoNote
 
         logger(Logging::DEBUGGING) << "pushed transaction " << pendingTx.getTransactionHash() << " to pool";
 
-        return transactionHashIndex.insert(std::move(pendingTx)).second;
+        const uint64_t memoryUsage = transactionMemoryUsage(pendingTx.cachedTransaction);
+
+        const uint64_t deadline = pendingTx.cachedTransaction.getTransaction().deadline;
+
+        const uint64_t size = pendingTx.cachedTransaction.getTransactionBinaryArray().size();
+
+        if (!transactionHashIndex.insert(std::move(pendingTx)).second)
+        {
+            return false;
+        }
+
+        m_memoryUsage += memoryUsage;
+
+        m_deadlineDemand[deadline] += size;
+
+        MemoryBudget::budget().add(MemoryBudget::Subsystem::TransactionPool, static_cast<int64_t>(memoryUsage));
+
+        return true;
     }
 
     const std::optional<CachedTransaction> TransactionPool::tryGetTransaction(const Crypto::Hash &hash) const
@@ -219,8 +275,24 @@ namespace CryptoNote
         }
 
         excludeFromState(poolState, it->cachedTransaction);
+
+        const uint64_t memoryUsage = transactionMemoryUsage(it->cachedTransaction);
+
+        const auto demand = m_deadlineDemand.find(it->cachedTransaction.getTransaction().deadline);
+
+        demand->second -= it->cachedTransaction.getTransactionBinaryArray().size();
+
+        if (demand->second == 0)
+        {
+            m_deadlineDemand.erase(demand);
+        }
+
         transactionHashIndex.erase(it);
 
+        m_memoryUsage -= memoryUsage;
+
+        MemoryBudget::budget().add(MemoryBudget::Subsystem::TransactionPool, -static_cast<int64_t>(memoryUsage));
+
         logger(Logging::DEBUGGING) << "transaction " << hash << " removed from pool";
         return true;
     }
@@ -235,7 +307,10 @@ namespace CryptoNote
         {
             size_t transactionFee = transaction.cachedTransaction.getTransactionFee();
 
-            if (transactionFee == 0)
+            //RTcoin
+            /* Synthetic transactions have no fee either, but aren't fusions */
+            if (transactionFee == 0
+                && transaction.cachedTransaction.getTransaction().version != CryptoNote::HACK_TRANSACTION_VERSION)
             {
                 fusionTransactionCount++;
             }
@@ -327,6 +402,26 @@ namespace CryptoNote
         return it->receiveTime;
     }
 
+    //RTcoin
+    uint64_t TransactionPool::getEarliestDeadline() const
+    {
+        std::scoped_lock lock(m_transactionsMutex);
+
+        /* The cost index is sorted by deadline first, so skip past any
+           transactions without a deadline and the next one is the earliest */
+        for (const auto &transactionItem : transactionCostIndex)
+        {
+            const uint64_t deadline = transactionItem.cachedTransaction.getTransaction().deadline;
+
+            if (deadline != 0)
+            {
+                return deadline;
+            }
+        }
+
+        return 0;
+    }
+
     std::vector<Crypto::Hash> TransactionPool::getTransactionHashesByPaymentId(const Crypto::Hash &paymentId) const
     {
         std::scoped_lock lock(m_transactionsMutex);
@@ -344,6 +439,115 @@ namespace CryptoNote
         return transactionHashes;
     }
 
+    //RTcoin
+    std::optional<std::vector<Crypto::Hash>>
+        TransactionPool::getEvictionsToFit(const CachedTransaction &transaction) const
+    {
+        const uint64_t allowance = MemoryBudget::budget().allowance(MemoryBudget::Subsystem::TransactionPool);
+
+        const uint64_t memoryUsage = transactionMemoryUsage(transaction);
+
+        std::scoped_lock lock(m_transactionsMutex);
+
+        /* When the pool is already over its allowance, a new transaction only
+           has to replace as much as it adds. The pool shrinks the rest of the
+           way as transactions are mined or expire, rather than all at once */
+        const uint64_t limit = std::max(allowance, m_memoryUsage);
+
+        if (m_memoryUsage + memoryUsage <= limit)
+        {
+            return std::vector<Crypto::Hash>();
+        }
+
+        const uint64_t bytesToFree = m_memoryUsage + memoryUsage - limit;
+
+        const PendingTransactionInfo candidate {static_cast<uint64_t>(timeProvider().now()), transaction};
+
+        std::vector<Crypto::Hash> evictions;
+
+        uint64_t freed = 0;
+
+        /* The cost index is ordered most preferred first, so the cheapest
+           transactions to lose are at the back */
+        for (auto it = transactionCostIndex.rbegin(); it != transactionCostIndex.rend() && freed < bytesToFree; ++it)
+        {
+            if (!TransactionPriorityComparator()(candidate, *it))
+            {
+                return std::nullopt;
+            }
+
+            evictions.push_back(it->getTransactionHash());
+
+            freed += transactionMemoryUsage(it->cachedTransaction);
+        }
+
+        /* Larger than the whole allowance */
+        if (freed < bytesToFree)
+        {
+            return std::nullopt;
+        }
+
+        return evictions;
+    }
+
+    //RTcoin
+    bool TransactionPool::isSchedulable(const CachedTransaction &transaction, const CapacityForecast &forecast) const
+    {
+        const uint64_t deadline = transaction.getTransaction().deadline;
+
+        const uint64_t size = transaction.getTransactionBinaryArray().size();
+
+        std::scoped_lock lock(m_transactionsMutex);
+
+        /* Blocks are filled in deadline order, so everything due by a
+           deadline, including anything already late, has to fit in the
+           blocks that arrive before it. Deadlines already passed are lost
+           either way, so aren't held against the new transaction. */
+        uint64_t demand = 0;
+
+        bool checkedOwnDeadline = deadline == 0;
+
+        for (const auto &[due, bytes] : m_deadlineDemand)
+        {
+            if (!checkedOwnDeadline && due > deadline)
+            {
+                if (demand + size > forecast.capacityBy(deadline))
+                {
+                    return false;
+                }
+
+                checkedOwnDeadline = true;
+            }
+
+            demand += bytes;
+
+            if (due == 0 || due < deadline || due < forecast.now)
+            {
+                continue;
+            }
+
+            if (demand + size > forecast.capacityBy(due))
+            {
+                return false;
+            }
+        }
+
+        if (!checkedOwnDeadline && demand + size > forecast.capacityBy(deadline))
+        {
+            return false;
+        }
+
+        return true;
+    }
+
+    //RTcoin
+    std::vector<std::pair<uint64_t, uint64_t>> TransactionPool::getDeadlineDemand() const
+    {
+        std::scoped_lock lock(m_transactionsMutex);
+
+        return {m_deadlineDemand.begin(), m_deadlineDemand.end()};
+    }
+
     void TransactionPool::flush()
     {
         const auto txns = getTransactionHashes();
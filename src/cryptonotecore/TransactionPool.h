@@ -17,6 +17,7 @@
 #include <boost/multi_index_container.hpp>
 #include <logging/LoggerMessage.h>
 #include <logging/LoggerRef.h>
+#include <map>
 #include <unordered_map>
 
 namespace CryptoNote
@@ -26,9 +27,16 @@ namespace CryptoNote
       public:
         TransactionPool(std::shared_ptr<Logging::ILogger> logger);
 
+        virtual ~TransactionPool() override;
+
         virtual bool
             pushTransaction(CachedTransaction &&transaction, TransactionValidatorState &&transactionState) override;
 
+        virtual bool restoreTransaction(
+            CachedTransaction &&transaction,
+            TransactionValidatorState &&transactionState,
+            const uint64_t receiveTime) override;
+
         virtual const CachedTransaction &getTransaction(const Crypto::Hash &hash) const override;
 
         virtual const std::optional<CachedTransaction> tryGetTransaction(const Crypto::Hash &hash) const override;
@@ -52,11 +60,27 @@ namespace CryptoNote
 
         virtual uint64_t getTransactionReceiveTime(const Crypto::Hash &hash) const override;
 
+        virtual uint64_t getEarliestDeadline() const override;
+
         virtual std::vector<Crypto::Hash> getTransactionHashesByPaymentId(const Crypto::Hash &paymentId) const override;
 
+        virtual std::optional<std::vector<Crypto::Hash>>
+            getEvictionsToFit(const CachedTransaction &transaction) const override;
+
+        virtual bool
+            isSchedulable(const CachedTransaction &transaction, const CapacityForecast &forecast) const override;
+
+        virtual std::vector<std::pair<uint64_t, uint64_t>> getDeadlineDemand() const override;
+
         virtual void flush() override;
 
       private:
+        //RTcoin
+        bool addTransaction(
+            CachedTransaction &&transaction,
+            TransactionValidatorState &&transactionState,
+            const uint64_t receiveTime);
+
         TransactionValidatorState poolState;
 
         struct PendingTransactionInfo
@@ -126,6 +150,15 @@ namespace CryptoNote
 
         mutable std::mutex m_transactionsMutex;
 
+        //RTcoin
+        /* Estimated bytes held by the transactions in the pool */
+        uint64_t m_memoryUsage = 0;
+
+        /* Bytes of transactions in the pool with each deadline, the demand
+           the blocks to come have to meet. Transactions without a deadline
+           are under 0, as they're also put into blocks first */
+        std::map<uint64_t, uint64_t> m_deadlineDemand;
+
         Logging::LoggerRef logger;
     };
 
@@ -11,6 +11,7 @@
 
 #include <system/InterruptedException.h>
 #include <system/Timer.h>
+#include <utilities/Metrics.h>
 
 namespace CryptoNote
 {
@@ -37,6 +38,14 @@ namespace CryptoNote
                && transactionPool->pushTransaction(std::move(tx), std::move(transactionState));
     }
 
+    bool TransactionPoolCleanWrapper::restoreTransaction(
+        CachedTransaction &&tx,
+        TransactionValidatorState &&transactionState,
+        const uint64_t receiveTime)
+    {
+        return transactionPool->restoreTransaction(std::move(tx), std::move(transactionState), receiveTime);
+    }
+
     const CachedTransaction &TransactionPoolCleanWrapper::getTransaction(const Crypto::Hash &hash) const
     {
         return transactionPool->getTransaction(hash);
@@ -94,12 +103,35 @@ namespace CryptoNote
         return transactionPool->getTransactionReceiveTime(hash);
     }
 
+    uint64_t TransactionPoolCleanWrapper::getEarliestDeadline() const
+    {
+        return transactionPool->getEarliestDeadline();
+    }
+
     std::vector<Crypto::Hash>
         TransactionPoolCleanWrapper::getTransactionHashesByPaymentId(const Crypto::Hash &paymentId) const
     {
         return transactionPool->getTransactionHashesByPaymentId(paymentId);
     }
 
+    std::optional<std::vector<Crypto::Hash>>
+        TransactionPoolCleanWrapper::getEvictionsToFit(const CachedTransaction &transaction) const
+    {
+        return transactionPool->getEvictionsToFit(transaction);
+    }
+
+    bool TransactionPoolCleanWrapper::isSchedulable(
+        const CachedTransaction &transaction,
+        const CapacityForecast &forecast) const
+    {
+        return transactionPool->isSchedulable(transaction, forecast);
+    }
+
+    std::vector<std::pair<uint64_t, uint64_t>> TransactionPoolCleanWrapper::getDeadlineDemand() const
+    {
+        return transactionPool->getDeadlineDemand();
+    }
+
     void TransactionPoolCleanWrapper::flush()
     {
         return transactionPool->flush();
@@ -109,6 +141,17 @@ namespace CryptoNote
     {
         try
         {
+            //RTcoin
+            static auto &expired = Metrics::registry().counter(
+                "pool_evictions_total",
+                "Transactions removed from the pool without being mined",
+                {{"reason", "expired"}});
+
+            static auto &invalidMixins = Metrics::registry().counter(
+                "pool_evictions_total",
+                "Transactions removed from the pool without being mined",
+                {{"reason", "invalid_mixins"}});
+
             uint64_t currentTime = timeProvider->now();
             auto transactionHashes = transactionPool->getTransactionHashes();
 
@@ -122,6 +165,10 @@ namespace CryptoNote
                     recentlyDeletedTransactions.emplace(hash, currentTime);
                     transactionPool->removeTransaction(hash);
                     deletedTransactions.emplace_back(std::move(hash));
+                    expired.add();
+
+                    /* Gone, so there's nothing left to check */
+                    continue;
                 }
 
                 CachedTransaction transaction = transactionPool->getTransaction(hash);
@@ -137,6 +184,7 @@ namespace CryptoNote
                     recentlyDeletedTransactions.emplace(hash, currentTime);
                     transactionPool->removeTransaction(hash);
                     deletedTransactions.emplace_back(std::move(hash));
+                    invalidMixins.add();
                 }
             }
 
@@ -39,6 +39,11 @@ namespace CryptoNote
 
         virtual bool pushTransaction(CachedTransaction &&tx, TransactionValidatorState &&transactionState) override;
 
+        virtual bool restoreTransaction(
+            CachedTransaction &&tx,
+            TransactionValidatorState &&transactionState,
+            const uint64_t receiveTime) override;
+
         virtual const CachedTransaction &getTransaction(const Crypto::Hash &hash) const override;
 
         virtual const std::optional<CachedTransaction> tryGetTransaction(const Crypto::Hash &hash) const override;
@@ -62,8 +67,18 @@ namespace CryptoNote
 
         virtual uint64_t getTransactionReceiveTime(const Crypto::Hash &hash) const override;
 
+        virtual uint64_t getEarliestDeadline() const override;
+
         virtual std::vector<Crypto::Hash> getTransactionHashesByPaymentId(const Crypto::Hash &paymentId) const override;
 
+        virtual std::optional<std::vector<Crypto::Hash>>
+            getEvictionsToFit(const CachedTransaction &transaction) const override;
+
+        virtual bool
+            isSchedulable(const CachedTransaction &transaction, const CapacityForecast &forecast) const override;
+
+        virtual std::vector<std::pair<uint64_t, uint64_t>> getDeadlineDemand() const override;
+
         virtual void flush() override;
 
         virtual std::vector<Crypto::Hash> clean(const uint32_t height) override;
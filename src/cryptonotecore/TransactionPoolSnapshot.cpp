@@ -0,0 +1,130 @@
+// Copyright (c) 2018-2020, The TurtleCoin Developers
+//
+// Please see the included LICENSE file for more information.
+
+////////////////////////////////////////////////////////////
+#include <cryptonotecore/TransactionPoolSnapshot.h>
+////////////////////////////////////////////////////////////
+
+#include <common/MemoryInputStream.h>
+#include <common/StringOutputStream.h>
+#include <config/CryptoNoteConfig.h>
+#include <cstdio>
+#include <fstream>
+#include <serialization/BinaryInputStreamSerializer.h>
+#include <serialization/BinaryOutputStreamSerializer.h>
+#include <serialization/CryptoNoteSerialization.h>
+#include <serialization/SerializationOverloads.h>
+#include <stdexcept>
+
+namespace CryptoNote
+{
+    namespace
+    {
+        const uint32_t SNAPSHOT_VERSION = 1;
+    } // namespace
+
+    void PoolSnapshotTransaction::serialize(ISerializer &s)
+    {
+        uint64_t size = transaction.size();
+
+        s(size, "size");
+
+        if (s.type() == ISerializer::INPUT)
+        {
+            if (size > parameters::CRYPTONOTE_MAX_TX_SIZE)
+            {
+                throw std::runtime_error("Transaction in pool snapshot is too large");
+            }
+
+            transaction.resize(size);
+        }
+
+        s.binary(transaction.data(), transaction.size(), "transaction");
+        s(receiveTime, "receive_time");
+        s(deadline, "deadline");
+        s(fee, "fee");
+        s(validatedHeight, "validated_height");
+    }
+
+    void PoolSnapshot::serialize(ISerializer &s)
+    {
+        uint32_t version = SNAPSHOT_VERSION;
+
+        s(version, "version");
+
+        if (version != SNAPSHOT_VERSION)
+        {
+            throw std::runtime_error("Unsupported pool snapshot version " + std::to_string(version));
+        }
+
+        s(topBlockIndex, "top_block_index");
+        s(topBlockHash, "top_block_hash");
+        s(transactions, "transactions");
+    }
+
+    bool savePoolSnapshot(PoolSnapshot &snapshot, const std::string &filename)
+    {
+        std::string data;
+
+        Common::StringOutputStream stream(data);
+        BinaryOutputStreamSerializer s(stream);
+
+        snapshot.serialize(s);
+
+        const std::string temporary = filename + ".tmp";
+
+        {
+            std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+
+            file.write(data.data(), data.size());
+
+            if (!file)
+            {
+                return false;
+            }
+        }
+
+        return std::rename(temporary.c_str(), filename.c_str()) == 0;
+    }
+
+    std::optional<PoolSnapshot> loadPoolSnapshot(const std::string &filename)
+    {
+        std::ifstream file(filename, std::ios::binary);
+
+        if (!file)
+        {
+            return std::nullopt;
+        }
+
+        /* Read in whole, as deserializing from memory is much quicker than
+           from the stream a few bytes at a time */
+        file.seekg(0, std::ios::end);
+
+        std::string data(static_cast<size_t>(file.tellg()), '\0');
+
+        file.seekg(0, std::ios::beg);
+        file.read(data.data(), data.size());
+
+        if (!file)
+        {
+            return std::nullopt;
+        }
+
+        PoolSnapshot snapshot;
+
+        try
+        {
+            Common::MemoryInputStream stream(data.data(), data.size());
+            BinaryInputStreamSerializer s(stream);
+
+            snapshot.serialize(s);
+        }
+        catch (const std::exception &)
+        {
+            return std::nullopt;
+        }
+
+        return snapshot;
+    }
+} // namespace CryptoNote
@@ -0,0 +1,60 @@
+// Copyright (c) 2018-2020, The TurtleCoin Developers
+//
+// Please see the included LICENSE file for more information.
+
+#pragma once
+
+#include <CryptoNote.h>
+#include <optional>
+#include <serialization/ISerializer.h>
+#include <string>
+#include <vector>
+
+namespace CryptoNote
+{
+    //RTcoin
+    /* A transaction as it was in the pool when the snapshot was taken */
+    struct PoolSnapshotTransaction
+    {
+        BinaryArray transaction;
+
+        /* Unix seconds, as the pool keeps it, so the transaction still times
+           out of the pool when it would have */
+        uint64_t receiveTime = 0;
+
+        /* Unix milliseconds, 0 for none. Also in the transaction, but kept
+           alongside it, with the fee, to check the blob against. */
+        uint64_t deadline = 0;
+
+        uint64_t fee = 0;
+
+        /* The top block index the transaction was last checked against. The
+           pool is rechecked as each block is added, so anything spent in the
+           blocks after this is all that can have invalidated it. */
+        uint32_t validatedHeight = 0;
+
+        void serialize(ISerializer &s);
+    };
+
+    /* The pool written out on shutdown, and read back in on start up, so a
+       restarted node doesn't begin with an empty pool, or have to validate
+       every transaction it had from scratch */
+    struct PoolSnapshot
+    {
+        /* The chain the snapshot was taken on top of */
+        uint32_t topBlockIndex = 0;
+
+        Crypto::Hash topBlockHash;
+
+        std::vector<PoolSnapshotTransaction> transactions;
+
+        void serialize(ISerializer &s);
+    };
+
+    /* Written to a temporary file, then renamed over the old snapshot, so a
+       crash part way through leaves the previous one intact */
+    bool savePoolSnapshot(PoolSnapshot &snapshot, const std::string &filename);
+
+    /* nullopt if there's no snapshot, or it can't be read */
+    std::optional<PoolSnapshot> loadPoolSnapshot(const std::string &filename);
+} // namespace CryptoNote
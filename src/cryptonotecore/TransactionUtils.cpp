@@ -6,7 +6,10 @@
 #include "TransactionUtils.h"
 
 #include "CryptoNoteFormatUtils.h"
+#include "common/CryptoNoteTools.h"
 #include "common/TransactionExtra.h"
+#include "common/Varint.h"
+#include "config/CryptoNoteConfig.h"
 #include "crypto/crypto.h"
 
 #include <unordered_set>
@@ -170,4 +173,47 @@ namespace CryptoNote
         return true;
     }
 
+    Transaction createHackTransaction(const uint64_t size, const uint64_t deadline, const uint64_t nonce)
+    {
+        Transaction transaction;
+
+        transaction.version = HACK_TRANSACTION_VERSION;
+        transaction.unlockTime = 0;
+        transaction.deadline = deadline;
+        transaction.size = size;
+
+        /* Everything but the extra payload. The empty extra still costs one
+           byte for its length prefix. */
+        const uint64_t headerSize = getObjectBinarySize(transaction) - 1;
+
+        uint64_t payloadSize = size > headerSize + 1 ? size - headerSize - 1 : 0;
+
+        /* The length prefix of the payload is a varint, so a larger payload
+           may need a longer prefix - shrink the payload to compensate */
+        while (payloadSize > 0 && headerSize + Tools::get_varint_data(payloadSize).size() + payloadSize > size)
+        {
+            payloadSize--;
+        }
+
+        transaction.extra.assign(payloadSize, 0x55);
+
+        /* As much of the nonce as fits - a tiny transaction may not have room
+           for all of it */
+        const size_t nonceSize = std::min<size_t>(transaction.extra.size(), sizeof(nonce));
+
+        std::memcpy(transaction.extra.data() + transaction.extra.size() - nonceSize, &nonce, nonceSize);
+
+        /* The size field has to be the real size, which can be a byte or two
+           off what was asked for - or well over, if that's smaller than an
+           empty transaction. It's a varint, so setting it can change the size
+           again, but this settles within a few rounds. */
+        for (uint64_t actual = getObjectBinarySize(transaction); actual != transaction.size;
+             actual = getObjectBinarySize(transaction))
+        {
+            transaction.size = actual;
+        }
+
+        return transaction;
+    }
+
 } // namespace CryptoNote
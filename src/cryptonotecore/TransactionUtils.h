@@ -41,4 +41,12 @@ namespace CryptoNote
         std::vector<uint32_t> &out,
         uint64_t &amount);
 
+    //RTcoin
+    /* Build a synthetic HACK_TRANSACTION_VERSION transaction whose serialized
+       size is as close to `size` bytes as possible. `deadline` is an absolute
+       unix timestamp in milliseconds. `nonce` is written into the end of the
+       payload, as transactions of the same size and deadline would otherwise
+       be identical, and share a hash. */
+    Transaction createHackTransaction(const uint64_t size, const uint64_t deadline, const uint64_t nonce);
+
 } // namespace CryptoNote
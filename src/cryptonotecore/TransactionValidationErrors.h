@@ -47,7 +47,11 @@ namespace CryptoNote
             WRONG_FEE,
             SIZE_TOO_LARGE,
             MINER_OUTPUT_NOT_CLAIMED,
-            CHAIN_IS_HALTING
+            CHAIN_IS_HALTING,
+            DEADLINE_PASSED,
+            DEADLINE_TOO_FAR,
+            SYNTHETIC_TRANSACTION_NOT_EMPTY,
+            SYNTHETIC_TRANSACTION_IN_CHAIN
         };
 
         // custom category:
@@ -139,6 +143,14 @@ namespace CryptoNote
                                "tx_extra.";
                     case TransactionValidationError::CHAIN_IS_HALTING:
                         return "Chain will be halting shortly, new transactions are not permitted at this point.";
+                    case TransactionValidationError::DEADLINE_PASSED:
+                        return "Transaction deadline has already passed";
+                    case TransactionValidationError::DEADLINE_TOO_FAR:
+                        return "Transaction deadline is further away than the pool keeps transactions";
+                    case TransactionValidationError::SYNTHETIC_TRANSACTION_NOT_EMPTY:
+                        return "Synthetic transaction has inputs, outputs or signatures";
+                    case TransactionValidationError::SYNTHETIC_TRANSACTION_IN_CHAIN:
+                        return "Synthetic transaction is already in the blockchain";
                     default:
                         return "Unknown error";
                 }
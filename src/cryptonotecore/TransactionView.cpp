@@ -0,0 +1,304 @@
+// Copyright (c) 2018-2020, The TurtleCoin Developers
+//
+// Please see the included LICENSE file for more information.
+
+//////////////////////////////////////////
+#include <cryptonotecore/TransactionView.h>
+//////////////////////////////////////////
+
+#include <config/CryptoNoteConfig.h>
+#include <crypto/hash.h>
+#include <stdexcept>
+
+namespace CryptoNote
+{
+    namespace
+    {
+        /* Variant tags, as in CryptoNoteSerialization.cpp */
+        const uint8_t BASE_INPUT_TAG = 0xff;
+
+        const uint8_t KEY_TAG = 0x2;
+
+        /* Reads one input, throwing if it's malformed. The output indexes are
+           checked, but left where they are */
+        void readInput(BufferReader &reader, TransactionView::Input &input)
+        {
+            const uint8_t tag = reader.byte();
+
+            if (tag == BASE_INPUT_TAG)
+            {
+                input.isCoinbase = true;
+                input.blockIndex = reader.varint<uint32_t>();
+                input.amount = 0;
+                input.outputIndexCount = 0;
+                input.outputIndexes = nullptr;
+            }
+            else if (tag == KEY_TAG)
+            {
+                input.isCoinbase = false;
+                input.blockIndex = 0;
+                input.amount = reader.varint<uint64_t>();
+                input.outputIndexCount = reader.count(1);
+                input.outputIndexes = reader.take(0);
+
+                for (uint64_t i = 0; i < input.outputIndexCount; i++)
+                {
+                    reader.varint<uint32_t>();
+                }
+
+                reader.bytes(&input.keyImage, sizeof(input.keyImage));
+            }
+            else
+            {
+                throw std::runtime_error("Unknown variant tag");
+            }
+        }
+
+        void readOutput(BufferReader &reader, TransactionView::Output &output)
+        {
+            output.amount = reader.varint<uint64_t>();
+
+            if (reader.byte() != KEY_TAG)
+            {
+                throw std::runtime_error("Unknown variant tag");
+            }
+
+            reader.bytes(&output.key, sizeof(output.key));
+        }
+    } // namespace
+
+    std::vector<uint32_t> TransactionView::Input::getOutputIndexes() const
+    {
+        std::vector<uint32_t> result(outputIndexCount);
+
+        /* Already checked, the reader only needs to know it won't run off the
+           end of the indexes */
+        BufferReader reader(outputIndexes, outputIndexCount * 5);
+
+        for (auto &index : result)
+        {
+            index = reader.varint<uint32_t>();
+        }
+
+        return result;
+    }
+
+    TransactionView::InputReader::InputReader(const uint8_t *data, size_t size, uint64_t count):
+        m_reader(data, size),
+        m_remaining(count)
+    {
+    }
+
+    bool TransactionView::InputReader::next(Input &input)
+    {
+        if (m_remaining == 0)
+        {
+            return false;
+        }
+
+        readInput(m_reader, input);
+
+        m_remaining--;
+
+        return true;
+    }
+
+    TransactionView::OutputReader::OutputReader(const uint8_t *data, size_t size, uint64_t count):
+        m_reader(data, size),
+        m_remaining(count)
+    {
+    }
+
+    bool TransactionView::OutputReader::next(Output &output)
+    {
+        if (m_remaining == 0)
+        {
+            return false;
+        }
+
+        readOutput(m_reader, output);
+
+        m_remaining--;
+
+        return true;
+    }
+
+    TransactionView::TransactionView(const BinaryArray &transaction):
+        TransactionView(transaction.data(), transaction.size())
+    {
+    }
+
+    TransactionView::TransactionView(const uint8_t *data, size_t size): m_data(data), m_size(size)
+    {
+        BufferReader reader(data, size);
+
+        m_version = reader.varint<uint8_t>();
+
+        if (CURRENT_TRANSACTION_VERSION < m_version && m_version != HACK_TRANSACTION_VERSION)
+        {
+            throw std::runtime_error("Wrong transaction version");
+        }
+
+        m_unlockTime = reader.varint<uint64_t>();
+
+        if (m_version == HACK_TRANSACTION_VERSION)
+        {
+            m_deadline = reader.varint<uint64_t>();
+
+            /* Has to be the real size, not whatever the sender chose */
+            if (reader.varint<uint64_t>() != size)
+            {
+                throw std::runtime_error("Synthetic transaction size does not match its size field");
+            }
+        }
+
+        /* Smallest input is a tag and a one byte varint */
+        m_inputCount = reader.count(2);
+        m_inputsOffset = reader.consumed();
+
+        uint64_t inputAmount = 0;
+
+        bool haveCoinbaseInput = false;
+
+        /* Total signatures, which follow the prefix */
+        uint64_t signatureCount = 0;
+
+        Input input;
+
+        for (uint64_t i = 0; i < m_inputCount; i++)
+        {
+            readInput(reader, input);
+
+            inputAmount += input.amount;
+            haveCoinbaseInput |= input.isCoinbase;
+            signatureCount += input.outputIndexCount;
+        }
+
+        m_isCoinbase = m_inputCount == 1 && haveCoinbaseInput;
+
+        m_outputCount = reader.count(2 + sizeof(Crypto::PublicKey));
+        m_outputsOffset = reader.consumed();
+
+        m_amount = 0;
+
+        Output output;
+
+        for (uint64_t i = 0; i < m_outputCount; i++)
+        {
+            readOutput(reader, output);
+
+            m_amount += output.amount;
+        }
+
+        m_fee = haveCoinbaseInput ? 0 : inputAmount - m_amount;
+
+        m_extraSize = reader.count(1);
+        m_extraOffset = reader.consumed();
+
+        reader.take(m_extraSize);
+
+        m_prefixSize = reader.consumed();
+
+        /* Coinbase transactions have no signatures, and the base input has
+           none either, so the count already comes out as zero for them */
+        reader.take(signatureCount * sizeof(Crypto::Signature));
+
+        if (reader.consumed() != size)
+        {
+            throw std::runtime_error("failed to unpack type");
+        }
+    }
+
+    const uint8_t *TransactionView::data() const
+    {
+        return m_data;
+    }
+
+    size_t TransactionView::size() const
+    {
+        return m_size;
+    }
+
+    uint8_t TransactionView::getVersion() const
+    {
+        return m_version;
+    }
+
+    uint64_t TransactionView::getUnlockTime() const
+    {
+        return m_unlockTime;
+    }
+
+    uint64_t TransactionView::getDeadline() const
+    {
+        return m_deadline;
+    }
+
+    bool TransactionView::isCoinbase() const
+    {
+        return m_isCoinbase;
+    }
+
+    uint64_t TransactionView::getInputCount() const
+    {
+        return m_inputCount;
+    }
+
+    uint64_t TransactionView::getOutputCount() const
+    {
+        return m_outputCount;
+    }
+
+    TransactionView::InputReader TransactionView::getInputs() const
+    {
+        return InputReader(m_data + m_inputsOffset, m_size - m_inputsOffset, m_inputCount);
+    }
+
+    TransactionView::OutputReader TransactionView::getOutputs() const
+    {
+        return OutputReader(m_data + m_outputsOffset, m_size - m_outputsOffset, m_outputCount);
+    }
+
+    const uint8_t *TransactionView::getExtra() const
+    {
+        return m_data + m_extraOffset;
+    }
+
+    size_t TransactionView::getExtraSize() const
+    {
+        return m_extraSize;
+    }
+
+    const Crypto::Hash &TransactionView::getTransactionHash() const
+    {
+        if (!m_transactionHash)
+        {
+            m_transactionHash = Crypto::cn_fast_hash(m_data, m_size);
+        }
+
+        return m_transactionHash.value();
+    }
+
+    const Crypto::Hash &TransactionView::getTransactionPrefixHash() const
+    {
+        /* The prefix is serialized on its own exactly as it is at the start of
+           the transaction, so hash those bytes rather than reserializing */
+        if (!m_transactionPrefixHash)
+        {
+            m_transactionPrefixHash = Crypto::cn_fast_hash(m_data, m_prefixSize);
+        }
+
+        return m_transactionPrefixHash.value();
+    }
+
+    uint64_t TransactionView::getTransactionFee() const
+    {
+        return m_fee;
+    }
+
+    uint64_t TransactionView::getTransactionAmount() const
+    {
+        return m_amount;
+    }
+
+} // namespace CryptoNote
@@ -0,0 +1,161 @@
+// Copyright (c) 2018-2020, The TurtleCoin Developers
+//
+// Please see the included LICENSE file for more information.
+
+#pragma once
+
+#include <CryptoNote.h>
+#include <optional>
+#include <serialization/BufferReader.h>
+#include <vector>
+
+namespace CryptoNote
+{
+    /* A binary serialized transaction, read where it lies. The layout is
+       checked once, when the view is made, against the same rules as
+       fromBinaryArray(), and fields are then read straight out of the buffer,
+       without copying or allocating. The buffer must outlive the view.
+
+       Use this when a handful of fields is all that's needed - the hash to
+       check the pool, the key images, the fee. To validate or store the
+       transaction, make a CachedTransaction from the view. */
+    class TransactionView
+    {
+      public:
+        struct Input
+        {
+            /* Only blockIndex is set for coinbase inputs */
+            bool isCoinbase;
+
+            uint32_t blockIndex;
+
+            uint64_t amount;
+
+            /* Ring size, and so the number of signatures for this input */
+            uint64_t outputIndexCount;
+
+            Crypto::KeyImage keyImage;
+
+            /* Where the varint encoded output indexes start in the buffer */
+            const uint8_t *outputIndexes;
+
+            /* Decode the ring member output indexes */
+            std::vector<uint32_t> getOutputIndexes() const;
+        };
+
+        struct Output
+        {
+            uint64_t amount;
+
+            Crypto::PublicKey key;
+        };
+
+        /* Reads the inputs in order. next() returns false once they run out */
+        class InputReader
+        {
+          public:
+            bool next(Input &input);
+
+          private:
+            friend class TransactionView;
+
+            InputReader(const uint8_t *data, size_t size, uint64_t count);
+
+            BufferReader m_reader;
+
+            uint64_t m_remaining;
+        };
+
+        class OutputReader
+        {
+          public:
+            bool next(Output &output);
+
+          private:
+            friend class TransactionView;
+
+            OutputReader(const uint8_t *data, size_t size, uint64_t count);
+
+            BufferReader m_reader;
+
+            uint64_t m_remaining;
+        };
+
+        /* Throws if the data isn't a well formed transaction */
+        explicit TransactionView(const BinaryArray &transaction);
+
+        TransactionView(const uint8_t *data, size_t size);
+
+        const uint8_t *data() const;
+
+        size_t size() const;
+
+        uint8_t getVersion() const;
+
+        uint64_t getUnlockTime() const;
+
+        /* 0 for anything but HACK_TRANSACTION_VERSION transactions */
+        uint64_t getDeadline() const;
+
+        bool isCoinbase() const;
+
+        uint64_t getInputCount() const;
+
+        uint64_t getOutputCount() const;
+
+        InputReader getInputs() const;
+
+        OutputReader getOutputs() const;
+
+        const uint8_t *getExtra() const;
+
+        size_t getExtraSize() const;
+
+        const Crypto::Hash &getTransactionHash() const;
+
+        const Crypto::Hash &getTransactionPrefixHash() const;
+
+        /* Same as CachedTransaction - 0 if there's a coinbase input */
+        uint64_t getTransactionFee() const;
+
+        uint64_t getTransactionAmount() const;
+
+      private:
+        const uint8_t *m_data;
+
+        size_t m_size;
+
+        uint8_t m_version;
+
+        uint64_t m_unlockTime;
+
+        uint64_t m_deadline = 0;
+
+        bool m_isCoinbase = false;
+
+        /* Offsets are from the start of the buffer */
+        size_t m_inputsOffset;
+
+        uint64_t m_inputCount;
+
+        size_t m_outputsOffset;
+
+        uint64_t m_outputCount;
+
+        size_t m_extraOffset;
+
+        size_t m_extraSize;
+
+        /* The prefix runs from the start of the buffer up to here */
+        size_t m_prefixSize;
+
+        uint64_t m_fee;
+
+        uint64_t m_amount;
+
+        mutable std::optional<Crypto::Hash> m_transactionHash;
+
+        mutable std::optional<Crypto::Hash> m_transactionPrefixHash;
+    };
+
+} // namespace CryptoNote
@@ -6,9 +6,11 @@
 // Please see the included LICENSE file for more information.
 
 #include <config/CryptoNoteConfig.h>
+#include <cryptonotecore/ITimeProvider.h>
 #include <cryptonotecore/Mixins.h>
 #include <cryptonotecore/TransactionValidationErrors.h>
 #include <cryptonotecore/ValidateTransaction.h>
+#include <utilities/Tracing.h>
 #include <utilities/Utilities.h>
 
 ValidateTransaction::ValidateTransaction(
@@ -51,6 +53,20 @@ TransactionValidationResult ValidateTransaction::validate()
         return m_validationResult;
     }
 
+    //RTcoin
+    /* Verify the deadline, if any, hasn't passed and isn't absurdly far off.
+       Before the synthetic transaction check, as they're the ones with
+       deadlines. */
+    if (!validateTransactionDeadline())
+    {
+        return m_validationResult;
+    }
+
+    if (isHackTransaction())
+    {
+        return m_validationResult;
+    }
+
     /* Validate the transaction inputs are non empty, key images are valid, etc. */
     if (!validateTransactionInputs())
     {
@@ -69,9 +85,6 @@ TransactionValidationResult ValidateTransaction::validate()
         return m_validationResult;
     }
 
-    //RTcoin
-    //Verify deadline reasonable
-
     /* Validate the transaction extra is a reasonable size. */
     if (!validateTransactionExtra())
     {
@@ -120,6 +133,12 @@ TransactionValidationResult ValidateTransaction::revalidateAfterHeightChange()
         return m_validationResult;
     }
 
+    //RTcoin
+    if (isHackTransaction())
+    {
+        return m_validationResult;
+    }
+
     /* Validate the transaction extra is still a reasonable size. */
     if (!validateTransactionExtra())
     {
@@ -139,8 +158,53 @@ TransactionValidationResult ValidateTransaction::revalidateAfterHeightChange()
 }
 
 
+//RTcoin
+/* Synthetic load transactions have no inputs or outputs, just a padded extra
+   of the requested size, so once the size is checked there is nothing left
+   to verify. Returns true if this is one, having set the result - valid only
+   if it really is empty, as it skips every input and output check, and
+   isn't in the chain yet. */
+bool ValidateTransaction::isHackTransaction()
+{
+    if (m_transaction.version != CryptoNote::HACK_TRANSACTION_VERSION)
+    {
+        return false;
+    }
+
+    if (!m_transaction.inputs.empty() || !m_transaction.outputs.empty() || !m_transaction.signatures.empty())
+    {
+        setTransactionValidationResult(
+            CryptoNote::error::TransactionValidationError::SYNTHETIC_TRANSACTION_NOT_EMPTY,
+            "Synthetic transaction has inputs, outputs or signatures");
+
+        return true;
+    }
+
+    /* With no key images, nothing else stops the same one being mined
+       again, so check it isn't in this chain already */
+    for (const CryptoNote::IBlockchainCache *segment = m_blockchainCache; segment != nullptr;
+         segment = segment->getParent())
+    {
+        if (segment->hasTransaction(m_cachedTransaction.getTransactionHash()))
+        {
+            setTransactionValidationResult(
+                CryptoNote::error::TransactionValidationError::SYNTHETIC_TRANSACTION_IN_CHAIN,
+                "Synthetic transaction is already in the blockchain");
+
+            return true;
+        }
+    }
+
+    m_validationResult.valid = true;
+    setTransactionValidationResult(CryptoNote::error::TransactionValidationError::VALIDATION_SUCCESS);
+
+    return true;
+}
+
 bool ValidateTransaction::validateTransactionSize()
 {
+    TRACE_SPAN("validate", "validateTransactionSize");
+
     const auto maxTransactionSize = m_blockSizeMedian * 2 - m_currency.minerTxBlobReservedSize();
 
     if (m_cachedTransaction.getTransactionBinaryArray().size() > maxTransactionSize)
@@ -156,6 +220,8 @@ bool ValidateTransaction::validateTransactionSize()
 
 bool ValidateTransaction::validateTransactionInputs()
 {
+    TRACE_SPAN("validate", "validateTransactionInputs");
+
     if (m_transaction.inputs.empty())
     {
         setTransactionValidationResult(
@@ -265,6 +331,8 @@ bool ValidateTransaction::validateTransactionInputs()
 
 bool ValidateTransaction::validateTransactionOutputs()
 {
+    TRACE_SPAN("validate", "validateTransactionOutputs");
+
     uint64_t sumOfOutputs = 0;
 
     for (const auto &output : m_transaction.outputs)
@@ -334,6 +402,8 @@ bool ValidateTransaction::validateTransactionOutputs()
  */
 bool ValidateTransaction::validateTransactionFee()
 {
+    TRACE_SPAN("validate", "validateTransactionFee");
+
     if (m_sumOfInputs == 0)
     {
         throw std::runtime_error("Error! You must call validateTransactionInputs() and "
@@ -385,8 +455,46 @@ bool ValidateTransaction::validateTransactionFee()
     return true;
 }
 
+//RTcoin
+/* Only pool transactions are checked - a block can include transactions
+   that missed their deadline, and they're still valid, just late */
+bool ValidateTransaction::validateTransactionDeadline()
+{
+    const uint64_t deadline = m_transaction.deadline;
+
+    if (!m_isPoolTransaction || deadline == 0)
+    {
+        return true;
+    }
+
+    const uint64_t now = CryptoNote::timeProvider().nowMicroseconds() / 1000;
+
+    if (deadline < now)
+    {
+        setTransactionValidationResult(
+            CryptoNote::error::TransactionValidationError::DEADLINE_PASSED,
+            "Transaction deadline has already passed");
+
+        return false;
+    }
+
+    /* It would be dropped from the pool long before then anyway */
+    if (deadline - now > CryptoNote::parameters::CRYPTONOTE_MEMPOOL_TX_LIVETIME * 1000)
+    {
+        setTransactionValidationResult(
+            CryptoNote::error::TransactionValidationError::DEADLINE_TOO_FAR,
+            "Transaction deadline is further away than the pool keeps transactions");
+
+        return false;
+    }
+
+    return true;
+}
+
 bool ValidateTransaction::validateTransactionExtra()
 {
+    TRACE_SPAN("validate", "validateTransactionExtra");
+
     const uint64_t heightToEnforce =
         CryptoNote::parameters::MAX_EXTRA_SIZE_V2_HEIGHT + CryptoNote::parameters::CRYPTONOTE_MINED_MONEY_UNLOCK_WINDOW;
 
@@ -408,6 +516,8 @@ bool ValidateTransaction::validateTransactionExtra()
 
 bool ValidateTransaction::validateInputOutputRatio()
 {
+    TRACE_SPAN("validate", "validateInputOutputRatio");
+
     if (m_isPoolTransaction || m_blockHeight >= CryptoNote::parameters::NORMAL_TX_MAX_OUTPUT_COUNT_V1_HEIGHT)
     {
         if (m_transaction.outputs.size() > CryptoNote::parameters::NORMAL_TX_MAX_OUTPUT_COUNT_V1)
@@ -425,6 +535,8 @@ bool ValidateTransaction::validateInputOutputRatio()
 
 bool ValidateTransaction::validateTransactionMixin()
 {
+    TRACE_SPAN("validate", "validateTransactionMixin");
+
     /* This allows us to accept blocks with transaction mixins for the mined money unlock window
      * that may be using older mixin rules on the network. This helps to clear out the transaction
      * pool during a network soft fork that requires a mixin lower or upper bound change */
@@ -462,6 +574,8 @@ bool ValidateTransaction::validateTransactionMixin()
 
 bool ValidateTransaction::validateTransactionInputsExpensive()
 {
+    TRACE_SPAN("validate", "validateTransactionInputsExpensive");
+
     /* Don't need to do expensive transaction validation for transactions
      * in a checkpoints range - they are assumed valid, and the transaction
      * hash would change thus invalidation the checkpoints if not. */
@@ -61,6 +61,8 @@ class ValidateTransaction
     //////////////////////////////
     /* PRIVATE MEMBER FUNCTIONS */
     //////////////////////////////
+    bool isHackTransaction();
+
     bool validateTransactionSize();
 
     bool validateTransactionInputs();
@@ -69,6 +71,8 @@ class ValidateTransaction
 
     bool validateTransactionFee();
 
+    bool validateTransactionDeadline();
+
     bool validateTransactionExtra();
 
     bool validateInputOutputRatio();
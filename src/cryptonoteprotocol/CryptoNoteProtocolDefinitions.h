@@ -9,6 +9,7 @@
 #include "cryptonotecore/CryptoNoteBasic.h"
 
 #include <cryptonotecore/Core.h>
+#include <limits>
 #include <list>
 
 // ISerializer-based serialization
@@ -73,9 +74,18 @@ namespace CryptoNote
     /************************************************************************/
     /*                                                                      */
     /************************************************************************/
+    //RTcoin
+    const uint32_t NO_HOP_BUDGET = std::numeric_limits<uint32_t>::max();
+
     struct NOTIFY_NEW_TRANSACTIONS_request
     {
         std::vector<BinaryArray> txs;
+
+        //RTcoin
+        /* Milliseconds each transaction in txs has left to propagate before
+           it has to be in a block. NO_HOP_BUDGET for transactions without a
+           deadline. Empty from peers that don't send it. */
+        std::vector<uint32_t> hop_budgets;
     };
 
     struct NOTIFY_NEW_TRANSACTIONS
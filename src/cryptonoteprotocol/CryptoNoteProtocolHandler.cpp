@@ -10,8 +10,10 @@
 #include "cryptonotecore/CryptoNoteBasicImpl.h"
 #include "cryptonotecore/CryptoNoteFormatUtils.h"
 #include "cryptonotecore/Currency.h"
+#include "cryptonotecore/ITimeProvider.h"
 #include "p2p/LevinProtocol.h"
 
+#include <algorithm>
 #include <boost/scope_exit.hpp>
 #include <boost/uuid/uuid_io.hpp>
 #include <config/Ascii.h>
@@ -21,6 +23,8 @@
 #include <serialization/SerializationTools.h>
 #include <system/Dispatcher.h>
 #include <utilities/FormatTools.h>
+#include <utilities/MemoryBudget.h>
+#include <utilities/Metrics.h>
 
 using namespace Logging;
 using namespace Common;
@@ -73,6 +77,46 @@ namespace CryptoNote
             return rawBlocks;
         }
 
+        //RTcoin
+        /* Milliseconds a transaction has left to reach whoever makes the
+           block it goes in. Not less a block interval - producers seal early
+           for deadlines, rather than at the usual interval. Can be negative.
+           NO_HOP_BUDGET for transactions without a deadline. */
+        int64_t deadlineBudget(const uint64_t deadline, const CapacityForecast &forecast)
+        {
+            if (deadline == 0)
+            {
+                return NO_HOP_BUDGET;
+            }
+
+            return static_cast<int64_t>(deadline) - static_cast<int64_t>(forecast.now);
+        }
+
+        Metrics::Counter &relaySkippedCounter()
+        {
+            static Metrics::Counter &counter = Metrics::registry().counter(
+                "p2p_relay_skipped_transactions_total", "Transactions not relayed as they can't make their deadline");
+
+            return counter;
+        }
+
+        Metrics::Counter &relaySkippedBytesCounter()
+        {
+            static Metrics::Counter &counter = Metrics::registry().counter(
+                "p2p_relay_skipped_bytes_total", "Bytes of transactions not relayed as they can't make their deadline");
+
+            return counter;
+        }
+
+        /* Whether a NOTIFY_NEW_TRANSACTIONS is the answer to the
+           NOTIFY_MISSING_TXS we sent for a lite block, rather than the
+           ordinary relay the peer may send before it answers */
+        bool answersPendingLiteBlock(const std::vector<BinaryArray> &txs, const PendingLiteBlock &pending)
+        {
+            return std::any_of(txs.begin(), txs.end(), [&pending](const auto &tx) {
+                return pending.missed_transactions.count(getBinaryArrayHash(tx)) != 0;
+            });
+        }
     } // namespace
 
     // unpack to strings to maintain protocol compatibility with older versions
@@ -139,6 +183,10 @@ namespace CryptoNote
                 [](const BinaryArray &s) { return std::string(s.begin(), s.end()); });
             s(transactions, "txs");
         }
+
+        //RTcoin
+        /* Older peers skip the key, and leave it out */
+        serializeAsBinary(request.hop_budgets, "hop_budgets", s);
     }
 
     static inline void serialize(NOTIFY_RESPONSE_GET_OBJECTS_request &request, ISerializer &s)
@@ -530,7 +578,8 @@ namespace CryptoNote
             return 1;
         }
 
-        if (context.m_pending_lite_block.has_value())
+        //RTcoin
+        if (context.m_pending_lite_block.has_value() && answersPendingLiteBlock(arg.txs, *context.m_pending_lite_block))
         {
             logger(Logging::TRACE)
                 << context
@@ -539,30 +588,50 @@ namespace CryptoNote
         }
         else
         {
-            const auto it = std::remove_if(
-                arg.txs.begin(),
-                arg.txs.end(),
-                [this, &context](const auto &tx)
+            //RTcoin
+            const uint64_t received = timeProvider().nowMicroseconds();
+
+            /* Budgets from peers that don't send them are ignored */
+            const bool hasHopBudgets = arg.hop_budgets.size() == arg.txs.size();
+
+            /* Each transaction is hashed once, from the view, and that hash is
+               used to skip ones already in the pool and to record the relay */
+            std::vector<RelayedTransaction> added;
+
+            for (size_t i = 0; i < arg.txs.size(); i++)
+            {
+                try
                 {
-                    const auto [success, error] = this->m_core.addTransactionToPool(tx);
+                    const TransactionView view(arg.txs[i]);
 
-                    if (!success)
+                    if (std::get<0>(m_core.addTransactionToPool(view)))
                     {
-                        this->logger(Logging::DEBUGGING) << context << "Tx verification failed";
+                        added.push_back(
+                            {std::move(arg.txs[i]),
+                             view.getTransactionHash(),
+                             view.getDeadline(),
+                             hasHopBudgets ? arg.hop_budgets[i] : NO_HOP_BUDGET});
+
+                        continue;
                     }
+                }
+                catch (const std::exception &)
+                {
+                }
 
-                    /* We return the opposite of success in this lambda */
-                    return !success;
-                });
-            if (it != arg.txs.end())
-            {
-                arg.txs.erase(it, arg.txs.end());
+                logger(Logging::DEBUGGING) << context << "Tx verification failed";
             }
 
-            if (arg.txs.size() > 0)
+            if (!added.empty())
             {
+                /* The time it took to get here, and through our pool, comes
+                   out of what the sender gave us */
+                const uint64_t now = timeProvider().nowMicroseconds();
+
+                const uint64_t residency = (now - std::min(now, received)) / 1000;
+
                 // TODO: add announce usage here
-                relay_post_notify<NOTIFY_NEW_TRANSACTIONS>(*m_p2p, arg, &context.m_connection_id);
+                relayWithinBudget(added, P2P_TRANSACTION_HOP_TIME + residency, &context.m_connection_id);
             }
         }
 
@@ -944,7 +1013,14 @@ namespace CryptoNote
             size_t count = 0;
             auto it = context.m_needed_objects.begin();
 
-            while (it != context.m_needed_objects.end() && count < BLOCKS_SYNCHRONIZING_DEFAULT_COUNT)
+            //RTcoin
+            /* Over the memory budget, ask for fewer blocks at once, so fewer are
+               held waiting to be processed, and syncing slows to let the pool
+               and caches shrink */
+            const uint64_t maxCount = MemoryBudget::budget().isOverBudget() ? BLOCKS_SYNCHRONIZING_LOW_MEMORY_COUNT
+                                                                            : BLOCKS_SYNCHRONIZING_DEFAULT_COUNT;
+
+            while (it != context.m_needed_objects.end() && count < maxCount)
             {
                 if (!(check_having_blocks && m_core.hasBlock(*it)))
                 {
@@ -1202,8 +1278,107 @@ namespace CryptoNote
 
     void CryptoNoteProtocolHandler::relayTransactions(const std::vector<BinaryArray> &transactions)
     {
-        auto buf = LevinProtocol::encode(NOTIFY_NEW_TRANSACTIONS::request {transactions});
-        m_p2p->externalRelayNotifyToAll(NOTIFY_NEW_TRANSACTIONS::ID, buf, nullptr);
+        //RTcoin
+        std::vector<RelayedTransaction> relayed;
+
+        for (const auto &transaction : transactions)
+        {
+            const TransactionView view(transaction);
+
+            relayed.push_back({transaction, view.getTransactionHash(), view.getDeadline(), NO_HOP_BUDGET});
+        }
+
+        relayWithinBudget(relayed, 0, nullptr);
+    }
+
+    //RTcoin
+    void CryptoNoteProtocolHandler::relayWithinBudget(
+        std::vector<RelayedTransaction> &transactions,
+        const uint64_t elapsed,
+        const boost::uuids::uuid *excludeConnection)
+    {
+        const auto forecast = m_core.getCapacityForecast();
+
+        /* Budget, and index into transactions */
+        std::vector<std::pair<int64_t, size_t>> urgency;
+
+        for (size_t i = 0; i < transactions.size(); i++)
+        {
+            const auto &transaction = transactions[i];
+
+            int64_t budget = deadlineBudget(transaction.deadline, forecast);
+
+            if (transaction.hopBudget != NO_HOP_BUDGET)
+            {
+                budget = std::min(budget, static_cast<int64_t>(transaction.hopBudget) - static_cast<int64_t>(elapsed));
+            }
+
+            /* Not worth the bandwidth if it can't get another hop further.
+               It's still in our pool, should we be the one to mine it. */
+            if (m_deadlineAwareRelay && budget < P2P_TRANSACTION_HOP_TIME)
+            {
+                relaySkippedCounter().add();
+                relaySkippedBytesCounter().add(transaction.transaction.size());
+                continue;
+            }
+
+            urgency.emplace_back(budget, i);
+        }
+
+        if (urgency.empty())
+        {
+            return;
+        }
+
+        /* Peers add them to their pools in the order given, so the ones with
+           the least time left go first */
+        if (m_deadlineAwareRelay)
+        {
+            std::stable_sort(
+                urgency.begin(), urgency.end(), [](const auto &a, const auto &b) { return a.first < b.first; });
+        }
+
+        NOTIFY_NEW_TRANSACTIONS::request request;
+        std::vector<Crypto::Hash> transactionHashes;
+
+        request.txs.reserve(urgency.size());
+        request.hop_budgets.reserve(urgency.size());
+        transactionHashes.reserve(urgency.size());
+
+        for (const auto &[budget, i] : urgency)
+        {
+            auto &transaction = transactions[i];
+
+            request.txs.push_back(std::move(transaction.transaction));
+
+            /* Only below zero if we're relaying regardless of deadlines */
+            request.hop_budgets.push_back(
+                transaction.deadline == 0 ? NO_HOP_BUDGET
+                                          : static_cast<uint32_t>(std::clamp<int64_t>(budget, 0, NO_HOP_BUDGET - 1)));
+
+            transactionHashes.push_back(transaction.hash);
+        }
+
+        relay_post_notify<NOTIFY_NEW_TRANSACTIONS>(*m_p2p, request, excludeConnection);
+
+        recordRelayedTransactions(transactionHashes);
+    }
+
+    //RTcoin
+    void CryptoNoteProtocolHandler::setDeadlineAwareRelay(const bool enabled)
+    {
+        m_deadlineAwareRelay = enabled;
+    }
+
+    //RTcoin
+    void CryptoNoteProtocolHandler::recordRelayedTransactions(const std::vector<Crypto::Hash> &transactionHashes)
+    {
+        auto &tracker = m_core.getTransactionLatencyTracker();
+
+        for (const auto &hash : transactionHashes)
+        {
+            tracker.record(hash, TransactionLatencyTracker::Stage::Relayed);
+        }
     }
 
     void CryptoNoteProtocolHandler::requestMissingPoolTransactions(const CryptoNoteConnectionContext &context)
@@ -46,6 +46,11 @@ namespace CryptoNote
 
         void set_p2p_endpoint(IP2pEndpoint *p2p);
 
+        //RTcoin
+        /* On by default. Off, every transaction is relayed, in the order it
+           came in, whatever its deadline - so the simulator can compare. */
+        void setDeadlineAwareRelay(const bool enabled);
+
         // ICore& get_core() { return m_core; }
         virtual bool isSynchronized() const override
         {
@@ -148,6 +153,29 @@ namespace CryptoNote
             std::vector<RawBlock> &&rawBlocks,
             const std::vector<CachedBlock> &cachedBlocks);
 
+        void recordRelayedTransactions(const std::vector<Crypto::Hash> &transactionHashes);
+
+        struct RelayedTransaction
+        {
+            BinaryArray transaction;
+
+            Crypto::Hash hash;
+
+            /* Unix milliseconds, 0 for none */
+            uint64_t deadline;
+
+            /* As the peer that sent it gave it, NO_HOP_BUDGET if they didn't */
+            uint32_t hopBudget;
+        };
+
+        /* Relays the transactions that still have time to reach a block, most
+           urgent first, and drops the rest. elapsed is how much of the hop
+           budgets has been used up since they were received. */
+        void relayWithinBudget(
+            std::vector<RelayedTransaction> &transactions,
+            const uint64_t elapsed,
+            const boost::uuids::uuid *excludeConnection);
+
         Logging::LoggerRef logger;
 
       private:
@@ -181,6 +209,8 @@ namespace CryptoNote
 
         std::atomic<size_t> m_peersCount;
 
+        std::atomic<bool> m_deadlineAwareRelay {true};
+
         Tools::ObserverManager<ICryptoNoteProtocolObserver> m_observerManager;
     };
 } // namespace CryptoNote
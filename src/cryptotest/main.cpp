@@ -5,6 +5,7 @@
 #include "CryptoNote.h"
 #include "CryptoTypes.h"
 #include "common/StringTools.h"
+#include "crypto/chukwa-batch.h"
 #include "crypto/crypto.h"
 #include "crypto/multisig.h"
 
@@ -215,6 +216,152 @@ template<typename T> void benchmark(T hashFunction, std::string hashFunctionName
               << (iterations / std::chrono::duration_cast<std::chrono::seconds>(elapsedTime).count()) << " H/s\n";
 }
 
+//RTcoin
+/* As BENCHMARK, but holds the slow hash scratchpad arena for the whole run,
+   so the scratchpad is only allocated and faulted in once */
+#define BENCHMARK_WARM(hashFunction, iterations) benchmarkWarm(hashFunction, #hashFunction, iterations)
+
+template<typename T> void benchmarkWarm(T hashFunction, std::string hashFunctionName, uint64_t iterations)
+{
+    const SlowHashArena arena;
+
+    const BinaryArray &rawData = Common::fromHex(INPUT_DATA);
+
+    Hash hash = Hash();
+
+    /* Allocate the arena before the timer starts */
+    hashFunction(rawData.data(), rawData.size(), hash);
+
+    const std::string arenaType = slow_hash_arena_huge_pages() ? "huge pages" : "normal pages";
+
+    benchmark(hashFunction, hashFunctionName + " (warm arena, " + arenaType + ")", iterations);
+}
+
+const std::vector<size_t> CHUKWA_LANE_WIDTHS = {1, 2, 4, 8};
+
+/* INPUT_DATA once per lane, each with a different nonce, as a miner would
+   hash them. Lane 0 is left as INPUT_DATA. */
+std::vector<BinaryArray> chukwaLaneInputs()
+{
+    /* Where the nonce sits in INPUT_DATA's block hashing blob */
+    const size_t nonceOffset = 39;
+
+    std::vector<BinaryArray> inputs(CHUKWA_MAX_LANES, Common::fromHex(INPUT_DATA));
+
+    for (size_t lane = 0; lane < inputs.size(); lane++)
+    {
+        inputs[lane][nonceOffset] += static_cast<uint8_t>(lane);
+    }
+
+    return inputs;
+}
+
+/* Checks the batch Chukwa kernel gives, in every lane and at every lane
+   width, the same hash as hashFunction does for that lane's input, and
+   that lane 0 gives the known hash of INPUT_DATA */
+template<typename T>
+void testChukwaBatch(
+    T hashFunction,
+    const std::string &hashFunctionName,
+    const std::string &expectedOutput,
+    const size_t iterations,
+    const size_t memory,
+    const size_t threads)
+{
+    const std::vector<BinaryArray> inputs = chukwaLaneInputs();
+
+    std::vector<const uint8_t *> data;
+    std::vector<size_t> lengths;
+    std::vector<Hash> expected(inputs.size());
+
+    for (size_t lane = 0; lane < inputs.size(); lane++)
+    {
+        data.push_back(inputs[lane].data());
+        lengths.push_back(inputs[lane].size());
+
+        hashFunction(inputs[lane].data(), inputs[lane].size(), expected[lane]);
+    }
+
+    if (!CompareHashes(expected[0], expectedOutput))
+    {
+        std::cout << hashFunctionName << ": Hashes are not equal!\n"
+                  << "Expected: " << expectedOutput << "\nActual: " << expected[0] << "\nTerminating.";
+
+        exit(1);
+    }
+
+    for (const auto lanes : CHUKWA_LANE_WIDTHS)
+    {
+        std::vector<Hash> hashes(CHUKWA_MAX_LANES);
+
+        chukwa_slow_hash_batch(
+            data.data(), lengths.data(), hashes.data(), hashes.size(), iterations, memory, threads, lanes);
+
+        for (size_t lane = 0; lane < hashes.size(); lane++)
+        {
+            if (hashes[lane] != expected[lane])
+            {
+                std::cout << hashFunctionName << " (" << lanes << " lanes): Hashes are not equal in lane " << lane
+                          << "!\n"
+                          << "Expected: " << expected[lane] << "\nActual: " << hashes[lane] << "\nTerminating.";
+
+                exit(1);
+            }
+        }
+
+        std::cout << hashFunctionName << " (" << lanes << " lanes): " << hashes[0] << std::endl;
+    }
+}
+
+/* Reports hashes per second for the batch Chukwa kernel at each lane width,
+   and which width it will pick by itself on this machine */
+void benchmarkChukwaBatch(
+    const std::string &hashFunctionName,
+    const size_t iterations,
+    const size_t memory,
+    const size_t threads,
+    const uint64_t hashCount)
+{
+    const std::vector<BinaryArray> inputs = chukwaLaneInputs();
+
+    std::vector<const uint8_t *> data;
+    std::vector<size_t> lengths;
+
+    for (const auto &input : inputs)
+    {
+        data.push_back(input.data());
+        lengths.push_back(input.size());
+    }
+
+    std::vector<Hash> hashes(CHUKWA_MAX_LANES);
+
+    for (const auto lanes : CHUKWA_LANE_WIDTHS)
+    {
+        /* Warm up, so allocating the scratchpads isn't timed */
+        chukwa_slow_hash_batch(data.data(), lengths.data(), hashes.data(), lanes, iterations, memory, threads, lanes);
+
+        const uint64_t batches = std::max<uint64_t>(1, hashCount / lanes);
+
+        auto startTimer = std::chrono::high_resolution_clock::now();
+
+        for (uint64_t i = 0; i < batches; i++)
+        {
+            chukwa_slow_hash_batch(
+                data.data(), lengths.data(), hashes.data(), lanes, iterations, memory, threads, lanes);
+        }
+
+        auto elapsedTime = std::chrono::high_resolution_clock::now() - startTimer;
+
+        const double seconds = std::chrono::duration_cast<std::chrono::duration<double>>(elapsedTime).count();
+
+        std::cout << hashFunctionName << " (" << lanes << " lanes): " << static_cast<uint64_t>(batches * lanes / seconds)
+                  << " H/s\n";
+    }
+
+    std::cout << hashFunctionName << " preferred lanes: " << chukwa_preferred_lanes(iterations, memory, threads)
+              << "\n";
+}
+
 void benchmarkUnderivePublicKey()
 {
     Crypto::KeyDerivation derivation;
@@ -276,6 +423,82 @@ void benchmarkGenerateKeyDerivation()
         std::chrono::duration_cast<std::chrono::microseconds>(elapsedTime).count() / loopIterations;
 
     std::cout << "Time to perform generateKeyDerivation: " << timePerDerivation / 1000.0 << " ms" << std::endl;
+
+    //RTcoin
+    /* Same again, against a public key we keep a window table for */
+    Crypto::crypto_ops::clearPrecomputedPoints();
+
+    startTimer = std::chrono::high_resolution_clock::now();
+
+    for (uint64_t i = 0; i < loopIterations; i++)
+    {
+        Crypto::crypto_ops::generateKeyDerivationPrecomputed(txPublicKey, privateViewKey, derivation);
+    }
+
+    elapsedTime = std::chrono::high_resolution_clock::now() - startTimer;
+
+    const auto timePerPrecomputedDerivation =
+        std::chrono::duration_cast<std::chrono::microseconds>(elapsedTime).count() / loopIterations;
+
+    std::cout << "Time to perform generateKeyDerivationPrecomputed: " << timePerPrecomputedDerivation / 1000.0
+              << " ms" << std::endl;
+}
+
+//RTcoin
+/* Compares hashing a pile of independent buffers one at a time against
+   hashing them with cn_fast_hash_batch, at a few typical sizes - 64 bytes
+   being a pair of tree hash leaves */
+void benchmarkFastHashBatch()
+{
+    const size_t bufferCount = 4096;
+
+    const uint64_t rounds = 20;
+
+    std::cout << "cn_fast_hash_batch lanes: " << cn_fast_hash_batch_lanes() << std::endl;
+
+    for (const size_t size : {64, 256, 1024})
+    {
+        const std::vector<uint8_t> buffer(bufferCount * size, 0x5a);
+
+        std::vector<const void *> data;
+        std::vector<size_t> lengths(bufferCount, size);
+
+        for (size_t i = 0; i < bufferCount; i++)
+        {
+            data.push_back(buffer.data() + i * size);
+        }
+
+        std::vector<Hash> hashes(bufferCount);
+
+        auto startTimer = std::chrono::high_resolution_clock::now();
+
+        for (uint64_t round = 0; round < rounds; round++)
+        {
+            for (size_t i = 0; i < bufferCount; i++)
+            {
+                cn_fast_hash(data[i], lengths[i], hashes[i]);
+            }
+        }
+
+        const double singleSeconds = std::chrono::duration_cast<std::chrono::duration<double>>(
+                                         std::chrono::high_resolution_clock::now() - startTimer)
+                                         .count();
+
+        startTimer = std::chrono::high_resolution_clock::now();
+
+        for (uint64_t round = 0; round < rounds; round++)
+        {
+            cn_fast_hash_batch(data.data(), lengths.data(), hashes.data(), bufferCount);
+        }
+
+        const double batchSeconds = std::chrono::duration_cast<std::chrono::duration<double>>(
+                                        std::chrono::high_resolution_clock::now() - startTimer)
+                                        .count();
+
+        std::cout << "cn_fast_hash (" << size << " bytes): "
+                  << static_cast<uint64_t>(rounds * bufferCount / singleSeconds) << " H/s, batched: "
+                  << static_cast<uint64_t>(rounds * bufferCount / batchSeconds) << " H/s" << std::endl;
+    }
 }
 
 void TestDeterministicSubwalletCreation(
@@ -449,6 +672,76 @@ int main(int argc, char **argv)
             std::cout << "passed" << std::endl;
         }
 
+        {
+            std::cout << "Crypto::crypto_ops::generateKeyDerivationPrecomputed: ";
+
+            Crypto::PublicKey publicKey("492390897da1cabd3886e3eff43ad1d04aa510a905bec0acd31a0a2f260e7862");
+
+            Crypto::SecretKey secretKey("73a8e577d58f7c11992201d4014ac7eef39c1e9f6f6d78673103de60a0c3240b");
+
+            Crypto::KeyDerivation expected;
+
+            Crypto::generate_key_derivation(publicKey, secretKey, expected);
+
+            /* Once to build the table, once to use it */
+            for (int i = 0; i < 2; i++)
+            {
+                Crypto::KeyDerivation derivation;
+
+                if (!Crypto::crypto_ops::generateKeyDerivationPrecomputed(publicKey, secretKey, derivation)
+                    || derivation != expected)
+                {
+                    std::cout << "failed" << std::endl;
+
+                    exit(1);
+                }
+            }
+
+            std::cout << "passed" << std::endl;
+        }
+
+        {
+            std::cout << "Crypto::cn_fast_hash_batch: ";
+
+            const BinaryArray &rawData = Common::fromHex(INPUT_DATA);
+
+            /* Every length from empty to a few Keccak blocks, so lanes finish
+               at different times and get handed the next input */
+            const std::vector<uint8_t> buffer(600, 0xa5);
+
+            std::vector<const void *> data = {rawData.data()};
+            std::vector<size_t> lengths = {rawData.size()};
+
+            for (size_t length = 0; length <= buffer.size(); length++)
+            {
+                data.push_back(buffer.data());
+                lengths.push_back(length);
+            }
+
+            std::vector<Hash> hashes(data.size());
+
+            cn_fast_hash_batch(data.data(), lengths.data(), hashes.data(), hashes.size());
+
+            if (!CompareHashes(hashes[0], CN_FAST_HASH))
+            {
+                std::cout << "failed" << std::endl;
+
+                exit(1);
+            }
+
+            for (size_t i = 0; i < hashes.size(); i++)
+            {
+                if (hashes[i] != cn_fast_hash(data[i], lengths[i]))
+                {
+                    std::cout << "failed" << std::endl;
+
+                    exit(1);
+                }
+            }
+
+            std::cout << "passed" << std::endl;
+        }
+
         {
             std::cout << "Crypto::generate_deterministic_subwallet_keys: ";
 
@@ -706,6 +999,23 @@ int main(int argc, char **argv)
 
         std::cout << std::endl;
 
+        testChukwaBatch(
+            chukwa_slow_hash_v1,
+            "chukwa_slow_hash_v1_batch",
+            CHUKWA_V1,
+            CHUKWA_ITERS_V1,
+            CHUKWA_MEMORY_V1,
+            CHUKWA_THREADS_V1);
+        testChukwaBatch(
+            chukwa_slow_hash_v2,
+            "chukwa_slow_hash_v2_batch",
+            CHUKWA_V2,
+            CHUKWA_ITERS_V2,
+            CHUKWA_MEMORY_V2,
+            CHUKWA_THREADS_V2);
+
+        std::cout << std::endl;
+
         for (uint64_t height = 0; height <= 8192; height += 512)
         {
             TEST_HASH_FUNCTION_WITH_HEIGHT(cn_soft_shell_slow_hash_v0, CN_SOFT_SHELL_V0[height / 512], height);
@@ -731,6 +1041,7 @@ int main(int argc, char **argv)
 
             benchmarkUnderivePublicKey();
             benchmarkGenerateKeyDerivation();
+            benchmarkFastHashBatch();
 
             BENCHMARK(cn_slow_hash_v0, o_iterations);
             BENCHMARK(cn_slow_hash_v1, o_iterations);
@@ -756,8 +1067,20 @@ int main(int argc, char **argv)
             BENCHMARK(cn_turtle_lite_slow_hash_v1, o_iterations_long);
             BENCHMARK(cn_turtle_lite_slow_hash_v2, o_iterations_long);
 
+            BENCHMARK_WARM(cn_slow_hash_v2, o_iterations);
+            BENCHMARK_WARM(cn_lite_slow_hash_v2, o_iterations);
+            BENCHMARK_WARM(cn_dark_slow_hash_v2, o_iterations);
+            BENCHMARK_WARM(cn_dark_lite_slow_hash_v2, o_iterations);
+            BENCHMARK_WARM(cn_turtle_slow_hash_v2, o_iterations_long);
+            BENCHMARK_WARM(cn_turtle_lite_slow_hash_v2, o_iterations_long);
+
             BENCHMARK(chukwa_slow_hash_v1, o_iterations_long);
             BENCHMARK(chukwa_slow_hash_v2, o_iterations_long);
+
+            benchmarkChukwaBatch(
+                "chukwa_slow_hash_v1_batch", CHUKWA_ITERS_V1, CHUKWA_MEMORY_V1, CHUKWA_THREADS_V1, o_iterations_long);
+            benchmarkChukwaBatch(
+                "chukwa_slow_hash_v2_batch", CHUKWA_ITERS_V2, CHUKWA_MEMORY_V2, CHUKWA_THREADS_V2, o_iterations_long);
         }
     }
     catch (std::exception &e)
@@ -0,0 +1,240 @@
+// Copyright (c) 2018-2020, The TurtleCoin Developers
+//
+// Please see the included LICENSE file for more information.
+
+//////////////////////////
+#include "BlockProducer.h"
+//////////////////////////
+
+#include <common/CryptoNoteTools.h>
+#include <common/TransactionExtra.h>
+#include <cryptonotecore/CachedBlock.h>
+#include <cryptonoteprotocol/CryptoNoteProtocolDefinitions.h>
+#include <errors/ValidateParameters.h>
+#include <iomanip>
+#include <sstream>
+#include <utilities/Addresses.h>
+
+namespace
+{
+    /* Longest we wait before re-checking whether a block is due, even if
+       nothing has changed. Also bounds how long stop() takes. */
+    const std::chrono::milliseconds MAX_WAIT = std::chrono::seconds(1);
+
+    /* How often to log producer statistics */
+    const std::chrono::seconds STATISTICS_INTERVAL = std::chrono::seconds(60);
+
+    uint64_t nowMilliseconds()
+    {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(
+                   std::chrono::system_clock::now().time_since_epoch())
+            .count();
+    }
+} // namespace
+
+BlockProducer::BlockProducer(
+    const std::shared_ptr<CryptoNote::Core> core,
+    const std::shared_ptr<CryptoNote::ICryptoNoteProtocolHandler> syncManager,
+    const std::string &address,
+    const uint64_t maxInterval,
+    std::shared_ptr<Logging::ILogger> logger):
+    m_core(core),
+    m_syncManager(syncManager),
+    m_maxInterval(maxInterval),
+    logger(logger, "BlockProducer")
+{
+    const Error error = validateAddresses({address}, false);
+
+    if (error != SUCCESS)
+    {
+        throw std::invalid_argument("Block producer address is not valid: " + error.getErrorMessage());
+    }
+
+    std::tie(m_publicSpendKey, m_publicViewKey) = Utilities::addressToKeys(address);
+}
+
+BlockProducer::~BlockProducer()
+{
+    stop();
+}
+
+void BlockProducer::start()
+{
+    m_stopped = false;
+    m_thread = std::thread(&BlockProducer::produceLoop, this);
+}
+
+void BlockProducer::stop()
+{
+    m_stopped = true;
+
+    if (m_thread.joinable())
+    {
+        m_thread.join();
+    }
+}
+
+void BlockProducer::produceLoop()
+{
+    uint64_t version = 0;
+
+    auto lastStatistics = std::chrono::steady_clock::now();
+
+    while (!m_stopped)
+    {
+        if (std::chrono::steady_clock::now() - lastStatistics >= STATISTICS_INTERVAL)
+        {
+            logStatistics();
+            lastStatistics = std::chrono::steady_clock::now();
+        }
+
+        const auto wait = timeUntilDue();
+
+        if (wait.count() != 0)
+        {
+            /* Wake up early if a transaction arrives with an earlier
+               deadline, or a block arrives from elsewhere */
+            version = m_core->waitForChange(version, std::min(wait, MAX_WAIT));
+            continue;
+        }
+
+        try
+        {
+            if (produceBlock())
+            {
+                m_lastBlockTime = nowMilliseconds();
+            }
+            else
+            {
+                /* Don't spin if the core won't give us a usable template */
+                version = m_core->waitForChange(version, MAX_WAIT);
+            }
+        }
+        catch (const std::exception &e)
+        {
+            logger(Logging::ERROR) << "Failed to produce block: " << e.what();
+            version = m_core->waitForChange(version, MAX_WAIT);
+        }
+    }
+}
+
+std::chrono::milliseconds BlockProducer::timeUntilDue() const
+{
+    if (m_core->getPoolTransactionCount() == 0)
+    {
+        return MAX_WAIT;
+    }
+
+    const uint64_t now = nowMilliseconds();
+
+    uint64_t due = m_core->getBlockCadence().sealAt;
+
+    /* Nothing in the pool is in a hurry, and there's no interval to fall
+       back on - don't leave them waiting forever */
+    if (due == CryptoNote::BlockCadencePlan::NO_SEAL_TIME && m_maxInterval == 0)
+    {
+        return std::chrono::milliseconds(0);
+    }
+
+    if (m_maxInterval != 0)
+    {
+        due = std::min(due, m_lastBlockTime + m_maxInterval);
+    }
+
+    return std::chrono::milliseconds(due - std::min(due, now));
+}
+
+bool BlockProducer::produceBlock()
+{
+    const auto start = std::chrono::steady_clock::now();
+
+    CryptoNote::BlockTemplate blockTemplate;
+
+    uint64_t difficulty;
+
+    bool isEmpty;
+
+    uint32_t height;
+
+    const auto [success, error] = m_core->getBlockTemplate(
+        blockTemplate, m_publicViewKey, m_publicSpendKey, {}, difficulty, isEmpty, height);
+
+    if (!success)
+    {
+        logger(Logging::WARNING) << "Failed to create block template: " << error;
+        return false;
+    }
+
+    /* Pool transactions may not fit, or not be valid yet */
+    if (isEmpty)
+    {
+        return false;
+    }
+
+    /* Proof of work isn't checked, but keep the merge mining tag consistent
+       with blocks from the external miner */
+    if (blockTemplate.majorVersion >= CryptoNote::BLOCK_MAJOR_VERSION_2)
+    {
+        CryptoNote::TransactionExtraMergeMiningTag mmTag;
+        mmTag.depth = 0;
+        mmTag.merkleRoot = CryptoNote::CachedBlock(blockTemplate).getAuxiliaryBlockHeaderHash();
+
+        blockTemplate.parentBlock.baseTransaction.extra.clear();
+
+        if (!CryptoNote::appendMergeMiningTagToExtra(blockTemplate.parentBlock.baseTransaction.extra, mmTag))
+        {
+            logger(Logging::WARNING) << "Failed to append merge mining tag";
+            return false;
+        }
+    }
+
+    const std::vector<uint8_t> rawBlock = CryptoNote::toBinaryArray(blockTemplate);
+
+    const auto submitResult = m_core->submitBlock(rawBlock);
+
+    if (submitResult != CryptoNote::error::AddBlockErrorCondition::BLOCK_ADDED)
+    {
+        logger(Logging::WARNING) << "Produced block was not accepted: " << submitResult.message();
+        return false;
+    }
+
+    if (submitResult == CryptoNote::error::AddBlockErrorCode::ADDED_TO_MAIN
+        || submitResult == CryptoNote::error::AddBlockErrorCode::ADDED_TO_ALTERNATIVE_AND_SWITCHED)
+    {
+        CryptoNote::NOTIFY_NEW_BLOCK::request newBlockMessage;
+
+        newBlockMessage.block = CryptoNote::RawBlockLegacy(rawBlock, blockTemplate, m_core);
+
+        newBlockMessage.hop = 0;
+
+        newBlockMessage.current_blockchain_height = m_core->getTopBlockIndex() + 1;
+
+        m_syncManager->relayBlock(newBlockMessage);
+    }
+
+    m_sealTime.record(
+        std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count());
+
+    m_blocksProduced++;
+
+    logger(Logging::DEBUGGING) << "Produced block " << height << " with " << blockTemplate.transactionHashes.size()
+                               << " transactions";
+
+    return true;
+}
+
+void BlockProducer::logStatistics()
+{
+    if (m_sealTime.count() == 0)
+    {
+        return;
+    }
+
+    std::stringstream stream;
+
+    stream << std::fixed << std::setprecision(2) << "Produced " << m_blocksProduced << " blocks, seal time p50/p99/max "
+           << m_sealTime.valueAtPercentile(50) / 1000.0 << "/" << m_sealTime.valueAtPercentile(99) / 1000.0 << "/"
+           << m_sealTime.max() / 1000.0 << "ms";
+
+    logger(Logging::INFO) << stream.str();
+}
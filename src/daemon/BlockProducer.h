@@ -0,0 +1,76 @@
+// Copyright (c) 2018-2020, The TurtleCoin Developers
+//
+// Please see the included LICENSE file for more information.
+
+#pragma once
+
+#include "cryptonotecore/Core.h"
+#include "cryptonoteprotocol/CryptoNoteProtocolHandlerCommon.h"
+
+#include <atomic>
+#include <chrono>
+#include <logging/LoggerRef.h>
+#include <thread>
+#include <utilities/LatencyHistogram.h>
+
+//RTcoin
+/* Produces blocks inside the daemon, instead of via an external miner.
+
+   Templates are built straight from the core, and sealed blocks handed back
+   to it and relayed to peers without any HTTP, JSON or hex encoding in
+   between. Blocks are sealed when the core's block cadence says they are
+   due, or maxInterval milliseconds after the last block if that is non
+   zero, and never while the pool is empty. */
+class BlockProducer
+{
+  public:
+    BlockProducer(
+        const std::shared_ptr<CryptoNote::Core> core,
+        const std::shared_ptr<CryptoNote::ICryptoNoteProtocolHandler> syncManager,
+        const std::string &address,
+        const uint64_t maxInterval,
+        std::shared_ptr<Logging::ILogger> logger);
+
+    ~BlockProducer();
+
+    void start();
+
+    void stop();
+
+  private:
+    void produceLoop();
+
+    /* How long until the next block is due, zero if it is due now */
+    std::chrono::milliseconds timeUntilDue() const;
+
+    /* Returns false if there was nothing to put in the block, or the core
+       rejected it */
+    bool produceBlock();
+
+    void logStatistics();
+
+    const std::shared_ptr<CryptoNote::Core> m_core;
+
+    const std::shared_ptr<CryptoNote::ICryptoNoteProtocolHandler> m_syncManager;
+
+    Crypto::PublicKey m_publicSpendKey;
+
+    Crypto::PublicKey m_publicViewKey;
+
+    const uint64_t m_maxInterval;
+
+    /* When we last sealed a block, unix milliseconds */
+    uint64_t m_lastBlockTime = 0;
+
+    uint64_t m_blocksProduced = 0;
+
+    /* Microseconds from starting to build a template to the block being
+       added and relayed */
+    LatencyHistogram m_sealTime;
+
+    std::atomic<bool> m_stopped = true;
+
+    std::thread m_thread;
+
+    Logging::LoggerRef logger;
+};
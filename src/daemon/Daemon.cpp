@@ -5,6 +5,7 @@
 //
 // Please see the included LICENSE file for more information.
 
+#include "BlockProducer.h"
 #include "DaemonCommandsHandler.h"
 #include "DaemonConfiguration.h"
 #include "common/CryptoNoteTools.h"
@@ -35,6 +36,7 @@
 #include <config/CryptoNoteCheckpoints.h>
 #include <logger/Logger.h>
 #include <logging/LoggerManager.h>
+#include <utilities/MemoryBudget.h>
 
 #if defined(WIN32)
 
@@ -221,6 +223,13 @@ int main(int argc, char *argv[])
         exit(1);
     }
 
+    //RTcoin
+    if (config.blockPolicy != "static" && config.blockPolicy != "adaptive")
+    {
+        std::cout << "Block policy must be static or adaptive" << std::endl;
+        exit(1);
+    }
+
     try
     {
         fs::path cwdPath = fs::current_path();
@@ -306,6 +315,14 @@ int main(int argc, char *argv[])
         }
         CryptoNote::Currency currency = currencyBuilder.currency();
 
+        //RTcoin
+        MemoryBudget::budget().setTarget(config.memoryBudgetMB * 1024 * 1024);
+
+        if (config.memoryBudgetMB != 0)
+        {
+            logger(INFO) << "Memory budget: " << config.memoryBudgetMB << " MB";
+        }
+
         DataBaseConfig dbConfig(
             config.dataDirectory,
             config.dbThreads,
@@ -353,6 +370,19 @@ int main(int argc, char *argv[])
             }
         }
 
+        //RTcoin
+        if (!config.exportCheckpoints.empty())
+        {
+            if (!checkpoints.saveCheckpointsToFile(config.exportCheckpoints))
+            {
+                return 1;
+            }
+
+            logger(INFO) << "Checkpoints saved to: " << config.exportCheckpoints;
+
+            return 0;
+        }
+
         NetNodeConfig netNodeConfig;
         netNodeConfig.init(
             config.p2pInterface,
@@ -414,6 +444,15 @@ int main(int argc, char *argv[])
 
         ccore->load();
 
+        //RTcoin
+        ccore->setBlockCadence(
+            config.blockPolicy == "adaptive" ? CryptoNote::BlockPolicy::Adaptive : CryptoNote::BlockPolicy::Static,
+            config.producerDeadlineSlack);
+
+        const std::string poolSnapshotFile = config.dataDirectory + "/" + currency.txPoolFileName();
+
+        ccore->loadPoolSnapshot(poolSnapshotFile);
+
         logger(INFO) << "Core initialized OK";
 
         const auto cprotocol =
@@ -465,6 +504,32 @@ int main(int argc, char *argv[])
             ip = "127.0.0.1";
         }
 
+        //RTcoin
+        std::unique_ptr<BlockProducer> blockProducer;
+
+        if (!config.producerAddress.empty())
+        {
+            logger(INFO) << "Starting block producer...";
+
+            blockProducer = std::make_unique<BlockProducer>(
+                ccore,
+                cprotocol,
+                config.producerAddress,
+                config.producerMaxInterval,
+                logManager);
+
+            blockProducer->start();
+
+            /* The producer guarantees a block at least this often while
+               there's anything in the pool, so admission control can count
+               on it. Without a limit it seals whenever a deadline needs it,
+               so the gaps it leaves say nothing about when it could have
+               sealed - don't let admission control learn them. */
+            ccore->setBlockInterval(
+                config.producerMaxInterval != 0 ? config.producerMaxInterval
+                                                : CryptoNote::parameters::BLOCK_CADENCE_MIN_INTERVAL);
+        }
+
         DaemonCommandsHandler dch(*ccore, *p2psrv, logManager, ip, port, config);
 
         if (!config.noConsole)
@@ -486,6 +551,12 @@ int main(int argc, char *argv[])
         dch.stop_handling();
 
         // stop components
+        if (blockProducer)
+        {
+            logger(INFO) << "Stopping block producer...";
+            blockProducer->stop();
+        }
+
         logger(INFO) << "Stopping core rpc server...";
         rpcServer.stop();
 
@@ -494,6 +565,10 @@ int main(int argc, char *argv[])
         p2psrv->deinit();
 
         cprotocol->set_p2p_endpoint(nullptr);
+
+        //RTcoin
+        ccore->savePoolSnapshot(poolSnapshotFile);
+
         ccore->save();
     }
     catch (const std::exception &e)
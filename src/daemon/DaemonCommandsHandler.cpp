@@ -12,11 +12,13 @@
 #include <cryptonotecore/Currency.h>
 #include <cryptonoteprotocol/CryptoNoteProtocolHandler.h>
 #include <ctime>
+#include <fstream>
 #include <daemon/DaemonCommandsHandler.h>
 #include <p2p/NetNode.h>
 #include <serialization/SerializationTools.h>
 #include <utilities/ColouredMsg.h>
 #include <utilities/FormatTools.h>
+#include <utilities/Tracing.h>
 #include <utilities/Utilities.h>
 
 namespace
@@ -90,6 +92,15 @@ DaemonCommandsHandler::DaemonCommandsHandler(
         "set_log <level> - Change current log level, <level> is a number 0-4");
     m_consoleHandler.setHandler(
         "status", std::bind(&DaemonCommandsHandler::status, this, std::placeholders::_1), "Show daemon status");
+    //RTcoin
+    m_consoleHandler.setHandler(
+        "trace",
+        std::bind(&DaemonCommandsHandler::trace, this, std::placeholders::_1),
+        "trace <on|off> - Start or stop recording tracing spans");
+    m_consoleHandler.setHandler(
+        "trace_dump",
+        std::bind(&DaemonCommandsHandler::trace_dump, this, std::placeholders::_1),
+        "trace_dump <seconds> <file> - Write the last <seconds> of spans to <file>, for chrome://tracing or Perfetto");
 }
 
 //--------------------------------------------------------------------------------
@@ -432,3 +443,53 @@ bool DaemonCommandsHandler::status(const std::vector<std::string> &args)
 
     return true;
 }
+
+//--------------------------------------------------------------------------------
+//RTcoin
+bool DaemonCommandsHandler::trace(const std::vector<std::string> &args)
+{
+    if (args.size() != 1 || (args[0] != "on" && args[0] != "off"))
+    {
+        std::cout << "use: trace <on|off>" << ENDL;
+        return true;
+    }
+
+    if (!Tracing::SPANS_COMPILED)
+    {
+        std::cout << WarningMsg("This daemon was built without ENABLE_TRACING, so there are no spans to record")
+                  << std::endl;
+        return true;
+    }
+
+    Tracing::tracer().setEnabled(args[0] == "on");
+
+    std::cout << "Tracing " << (args[0] == "on" ? "started" : "stopped") << ENDL;
+
+    return true;
+}
+
+//--------------------------------------------------------------------------------
+bool DaemonCommandsHandler::trace_dump(const std::vector<std::string> &args)
+{
+    uint64_t seconds = 0;
+
+    if (args.size() != 2 || !Common::fromString(args[0], seconds))
+    {
+        std::cout << "use: trace_dump <seconds> <file>" << ENDL;
+        return true;
+    }
+
+    std::ofstream file(args[1]);
+
+    file << Tracing::tracer().dump(seconds);
+
+    if (!file)
+    {
+        std::cout << WarningMsg("Failed to write trace to " + args[1]) << std::endl;
+        return true;
+    }
+
+    std::cout << "Wrote the last " << seconds << " seconds of spans to " << args[1] << ENDL;
+
+    return true;
+}
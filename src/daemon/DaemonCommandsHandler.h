@@ -81,4 +81,9 @@ class DaemonCommandsHandler
     bool print_pool_sh(const std::vector<std::string> &args);
 
     bool status(const std::vector<std::string> &args);
+
+    //RTcoin
+    bool trace(const std::vector<std::string> &args);
+
+    bool trace_dump(const std::vector<std::string> &args);
 };
@@ -65,9 +65,14 @@ namespace DaemonConfig
             "dump-config",
             "Prints the current configuration to the screen",
             cxxopts::value<bool>()->default_value("false")->implicit_value("true"))(
+            "export-checkpoints",
+            "Save the checkpoints given by load-checkpoints to <file> in the binary format, which loads faster, "
+            "and exit",
+            cxxopts::value<std::string>(),
+            "<file>")(
             "load-checkpoints",
-            "Specify a file <path> containing a CSV of Blockchain checkpoints for faster sync. A value of 'default' "
-            "uses the built-in checkpoints.",
+            "Specify a file <path> containing a CSV of Blockchain checkpoints for faster sync, or a binary "
+            "checkpoints file made with export-checkpoints. A value of 'default' uses the built-in checkpoints.",
             cxxopts::value<std::string>()->default_value(config.checkPoints),
             "<path>")(
             "log-file",
@@ -78,6 +83,11 @@ namespace DaemonConfig
             "Specify log level",
             cxxopts::value<int>()->default_value(std::to_string(config.logLevel)),
             "#")(
+            "memory-budget",
+            "Keep the transaction pool, caches and peer write queues to about this many megabytes (MB) in total, "
+            "shrinking caches and refusing low fee transactions as it's reached. 0 means no limit",
+            cxxopts::value<uint64_t>()->default_value(std::to_string(config.memoryBudgetMB)),
+            "#")(
             "no-console",
             "Disable daemon console commands",
             cxxopts::value<bool>()->default_value("false")->implicit_value("true"))(
@@ -172,6 +182,25 @@ namespace DaemonConfig
             cxxopts::value<int>()->default_value(std::to_string(CryptoNote::LEVELDB_MAX_FILE_SIZE_MB)),
             "#");
 
+        options.add_options("Block Producer")(
+            "producer-address",
+            "Produce blocks inside the daemon, paying the reward to <address>, instead of using an external miner",
+            cxxopts::value<std::string>(),
+            "<address>")(
+            "producer-deadline-slack",
+            "Seal a block this many milliseconds before the earliest deadline in the pool",
+            cxxopts::value<uint64_t>()->default_value(std::to_string(config.producerDeadlineSlack)),
+            "#")(
+            "producer-max-interval",
+            "Seal a block at least this often, in milliseconds, while the pool is not empty. 0 means no limit",
+            cxxopts::value<uint64_t>()->default_value(std::to_string(config.producerMaxInterval)),
+            "#")(
+            "block-policy",
+            "How block templates are sized and when blocks are sealed: static (125% of the median block size) or "
+            "adaptive (from the pool's deadlines and arrival rate)",
+            cxxopts::value<std::string>()->default_value(config.blockPolicy),
+            "<policy>");
+
         options.add_options("Syncing")(
             "transaction-validation-threads",
             "Number of threads to use to validate a transaction's inputs in parallel",
@@ -192,6 +221,12 @@ namespace DaemonConfig
                 config.outputFile = cli["save-config"].as<std::string>();
             }
 
+            //RTcoin
+            if (cli.count("export-checkpoints") > 0)
+            {
+                config.exportCheckpoints = cli["export-checkpoints"].as<std::string>();
+            }
+
             if (cli.count("help") > 0)
             {
                 config.help = cli["help"].as<bool>();
@@ -259,6 +294,12 @@ namespace DaemonConfig
                 config.enableDbCompression = cli["db-enable-compression"].as<bool>();
             }
 
+            //RTcoin
+            if (cli.count("memory-budget") > 0)
+            {
+                config.memoryBudgetMB = cli["memory-budget"].as<uint64_t>();
+            }
+
             if (cli.count("no-console") > 0)
             {
                 config.noConsole = cli["no-console"].as<bool>();
@@ -392,6 +433,26 @@ namespace DaemonConfig
                 config.transactionValidationThreads = cli["transaction-validation-threads"].as<uint32_t>();
             }
 
+            if (cli.count("producer-address") > 0)
+            {
+                config.producerAddress = cli["producer-address"].as<std::string>();
+            }
+
+            if (cli.count("producer-deadline-slack") > 0)
+            {
+                config.producerDeadlineSlack = cli["producer-deadline-slack"].as<uint64_t>();
+            }
+
+            if (cli.count("producer-max-interval") > 0)
+            {
+                config.producerMaxInterval = cli["producer-max-interval"].as<uint64_t>();
+            }
+
+            if (cli.count("block-policy") > 0)
+            {
+                config.blockPolicy = cli["block-policy"].as<std::string>();
+            }
+
             if (config.help) // Do we want to display the help message?
             {
                 std::cout << options.help({}) << std::endl;
@@ -483,6 +544,18 @@ namespace DaemonConfig
                         throw std::runtime_error(std::string(e.what()) + " - Invalid value for " + cfgKey);
                     }
                 }
+                else if (cfgKey.compare("memory-budget") == 0)
+                {
+                    try
+                    {
+                        config.memoryBudgetMB = std::stoull(cfgValue);
+                        updated = true;
+                    }
+                    catch (std::exception &e)
+                    {
+                        throw std::runtime_error(std::string(e.what()) + " - Invalid value for " + cfgKey);
+                    }
+                }
                 else if (cfgKey.compare("db-enable-compression") == 0)
                 {
                     config.enableDbCompression = cfgValue.at(0) == '1';
@@ -739,6 +812,11 @@ namespace DaemonConfig
             config.logLevel = j["log-level"].GetInt();
         }
 
+        if (j.HasMember("memory-budget"))
+        {
+            config.memoryBudgetMB = j["memory-budget"].GetUint64();
+        }
+
         /* Using levelDB, lets set the level DB defaults. Will overwrite with
          * passed in values later if present. */
         if (j.HasMember("db-enable-level-db") && j["db-enable-level-db"].GetBool())
@@ -892,6 +970,26 @@ namespace DaemonConfig
         {
             config.transactionValidationThreads = j["transaction-validation-threads"].GetInt();
         }
+
+        if (j.HasMember("producer-address"))
+        {
+            config.producerAddress = j["producer-address"].GetString();
+        }
+
+        if (j.HasMember("producer-deadline-slack"))
+        {
+            config.producerDeadlineSlack = j["producer-deadline-slack"].GetUint64();
+        }
+
+        if (j.HasMember("producer-max-interval"))
+        {
+            config.producerMaxInterval = j["producer-max-interval"].GetUint64();
+        }
+
+        if (j.HasMember("block-policy"))
+        {
+            config.blockPolicy = j["block-policy"].GetString();
+        }
     }
 
     Document asJSON(const DaemonConfiguration &config)
@@ -904,6 +1002,7 @@ namespace DaemonConfig
         j.AddMember("load-checkpoints", config.checkPoints, alloc);
         j.AddMember("log-file", config.logFile, alloc);
         j.AddMember("log-level", config.logLevel, alloc);
+        j.AddMember("memory-budget", config.memoryBudgetMB, alloc);
         j.AddMember("no-console", config.noConsole, alloc);
         j.AddMember("db-enable-level-db", config.enableLevelDB, alloc);
         j.AddMember("db-enable-compression", config.enableDbCompression, alloc);
@@ -962,6 +1061,10 @@ namespace DaemonConfig
         j.AddMember("fee-address", config.feeAddress, alloc);
         j.AddMember("fee-amount", config.feeAmount, alloc);
         j.AddMember("transaction-validation-threads", config.transactionValidationThreads, alloc);
+        j.AddMember("producer-address", config.producerAddress, alloc);
+        j.AddMember("producer-deadline-slack", config.producerDeadlineSlack, alloc);
+        j.AddMember("producer-max-interval", config.producerMaxInterval, alloc);
+        j.AddMember("block-policy", config.blockPolicy, alloc);
 
         return j;
     }
@@ -48,6 +48,10 @@ namespace DaemonConfig
             enableDbCompression = false;
             resync = false;
             enableLevelDB = false;
+            producerDeadlineSlack = 500;
+            producerMaxInterval = 0;
+            blockPolicy = "static";
+            memoryBudgetMB = 0;
         }
 
         std::string dataDirectory;
@@ -84,6 +88,23 @@ namespace DaemonConfig
 
         uint32_t transactionValidationThreads;
 
+        //RTcoin
+        /* Produce blocks in the daemon, paying the reward to this address.
+           Empty to leave block production to an external miner. */
+        std::string producerAddress;
+
+        /* Milliseconds before the earliest pool deadline to seal a block */
+        uint64_t producerDeadlineSlack;
+
+        /* Most milliseconds between produced blocks, 0 for no limit */
+        uint64_t producerMaxInterval;
+
+        /* How templates are sized and blocks sealed, static or adaptive */
+        std::string blockPolicy;
+
+        /* Memory target for the pool, caches and queues, 0 for no limit */
+        uint64_t memoryBudgetMB;
+
         uint64_t dbThreads;
 
         uint64_t dbMaxOpenFiles;
@@ -114,6 +135,10 @@ namespace DaemonConfig
 
         std::string outputFile;
 
+        //RTcoin
+        /* Where to write the loaded checkpoints in the binary format, if set */
+        std::string exportCheckpoints;
+
         std::vector<std::string> genesisAwardAddresses;
 
         bool help;
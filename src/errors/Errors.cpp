@@ -354,6 +354,16 @@ std::string Error::getErrorMessage() const
         case API_HASH_NOT_FOUND:
         {
             return "The requested hash could not be found.";
+        }
+        case PREPARED_TRANSACTION_INPUTS_IN_USE:
+        {
+            return "Some of the inputs in the prepared transaction are being used by another transaction "
+                   "which is currently being sent. If that transaction fails, this one can be sent again.";
+        }
+        case API_TRANSACTION_UNSCHEDULABLE:
+        {
+            return "The transaction deadline cannot be met with the block space available. Try again later, or with "
+                   "a later deadline.";
         }
             /* No default case so the compiler warns us if we missed one */
     }
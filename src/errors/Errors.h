@@ -261,6 +261,14 @@ enum ErrorCode
 
     /* Could not find the requested item */
     API_HASH_NOT_FOUND = 67,
+
+    /* Some of the inputs in a prepared transaction are being used by another
+     * transaction that is currently being sent */
+    PREPARED_TRANSACTION_INPUTS_IN_USE = 68,
+
+    /* The transaction pool could not meet the transaction's deadline, or
+       those of the transactions already in it, if it was added */
+    API_TRANSACTION_UNSCHEDULABLE = 69,
 };
 
 class Error
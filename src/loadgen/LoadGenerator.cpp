@@ -0,0 +1,478 @@
+// Copyright (c) 2018-2020, The TurtleCoin Developers
+//
+// Please see the included LICENSE file for more information.
+
+//////////////////////////
+#include "LoadGenerator.h"
+//////////////////////////
+
+#include "rapidjson/document.h"
+#include "rapidjson/stringbuffer.h"
+#include "rapidjson/writer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <common/CryptoNoteTools.h>
+#include <common/StringTools.h>
+#include <crypto/random.h>
+#include <cryptonotecore/CryptoNoteFormatUtils.h>
+#include <cryptonotecore/TransactionUtils.h>
+#include <fstream>
+#include <httplib.h>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <utilities/ColouredMsg.h>
+#include <version.h>
+
+namespace LoadGenerator
+{
+    namespace
+    {
+        uint64_t nowMicroseconds()
+        {
+            return std::chrono::duration_cast<std::chrono::microseconds>(
+                       std::chrono::system_clock::now().time_since_epoch())
+                .count();
+        }
+
+        double percentile(std::vector<uint64_t> &values, const double p)
+        {
+            if (values.empty())
+            {
+                return 0;
+            }
+
+            const size_t index = std::min(values.size() - 1, static_cast<size_t>(p * values.size()));
+
+            std::nth_element(values.begin(), values.begin() + index, values.end());
+
+            return static_cast<double>(values[index]);
+        }
+    } // namespace
+
+    LoadGenerator::LoadGenerator(const LoadGeneratorConfig &config):
+        m_config(config),
+        m_random(config.seed),
+        m_nonce(Random::randomValue<uint64_t>()),
+        m_records(config.connections)
+    {
+    }
+
+    void LoadGenerator::start()
+    {
+        std::cout << InformationMsg("Offering ") << InformationMsg(m_config.rate)
+                  << InformationMsg(" transactions per second to ") << InformationMsg(m_config.daemonHost) << ":"
+                  << InformationMsg(m_config.daemonPort) << InformationMsg(" over ")
+                  << InformationMsg(m_config.connections) << InformationMsg(" connections for ")
+                  << InformationMsg(m_config.duration) << InformationMsg(" seconds\n\n");
+
+        const DeadlineCounts before = getDaemonDeadlineCounts();
+
+        m_running = true;
+        m_startTime = nowMicroseconds();
+
+        std::vector<std::thread> senders;
+
+        for (size_t i = 0; i < m_config.connections; i++)
+        {
+            senders.emplace_back(&LoadGenerator::sendLoop, this, i);
+        }
+
+        std::thread reporter(&LoadGenerator::printProgress, this);
+
+        generate();
+
+        /* Let the senders drain the queue, then exit */
+        for (size_t i = 0; i < m_config.connections; i++)
+        {
+            PendingSubmission last;
+            last.last = true;
+            m_queue.push(last);
+        }
+
+        for (auto &sender : senders)
+        {
+            sender.join();
+        }
+
+        m_running = false;
+
+        reporter.join();
+
+        writeRecords();
+
+        printSummary();
+
+        if (m_config.settle != 0)
+        {
+            std::cout << InformationMsg("Waiting ") << InformationMsg(m_config.settle)
+                      << InformationMsg(" seconds for transactions to be mined...") << std::endl;
+
+            std::this_thread::sleep_for(std::chrono::seconds(m_config.settle));
+        }
+
+        printDeadlineSummary(before, getDaemonDeadlineCounts());
+    }
+
+    void LoadGenerator::generate()
+    {
+        const uint64_t end = m_config.duration * 1000 * 1000;
+
+        uint64_t offset = 0;
+
+        while (true)
+        {
+            offset = nextInterArrival(offset);
+
+            if (offset >= end)
+            {
+                break;
+            }
+
+            const uint64_t scheduledTime = m_startTime + offset;
+
+            /* Build the transaction before we need it, so the time spent
+               hashing it doesn't delay the arrival */
+            PendingSubmission submission = makeSubmission(scheduledTime);
+
+            const uint64_t now = nowMicroseconds();
+
+            if (scheduledTime > now)
+            {
+                std::this_thread::sleep_for(std::chrono::microseconds(scheduledTime - now));
+            }
+
+            m_queue.push(std::move(submission));
+
+            m_generated++;
+        }
+    }
+
+    uint64_t LoadGenerator::nextInterArrival(const uint64_t now)
+    {
+        const double meanGap = 1000.0 * 1000.0 / m_config.rate;
+
+        switch (m_config.arrival)
+        {
+            case ArrivalProcess::Constant:
+            {
+                return now + static_cast<uint64_t>(meanGap);
+            }
+            case ArrivalProcess::Poisson:
+            {
+                std::exponential_distribution<double> gap(1.0 / meanGap);
+                return now + static_cast<uint64_t>(gap(m_random));
+            }
+            case ArrivalProcess::Bursty:
+            {
+                /* Arrivals only happen during the first 1 / burstFactor of
+                   every period, at burstFactor times the mean rate, so the
+                   mean rate over a whole period is still --rate */
+                const uint64_t period = m_config.burstPeriod * 1000;
+                const uint64_t onTime = static_cast<uint64_t>(period / m_config.burstFactor);
+
+                std::exponential_distribution<double> gap(m_config.burstFactor / meanGap);
+
+                uint64_t next = now + static_cast<uint64_t>(gap(m_random));
+
+                /* Poisson arrivals are memoryless, so if we fell into the off
+                   part of the period, we can just restart from the beginning
+                   of the next on part */
+                while (next % period >= onTime)
+                {
+                    next = (next / period + 1) * period + static_cast<uint64_t>(gap(m_random));
+                }
+
+                return next;
+            }
+        }
+
+        throw std::runtime_error("Unknown arrival process");
+    }
+
+    uint64_t LoadGenerator::nextSize()
+    {
+        switch (m_config.sizeDistribution)
+        {
+            case SizeDistribution::Fixed:
+            {
+                return m_config.sizeMin;
+            }
+            case SizeDistribution::Uniform:
+            {
+                std::uniform_int_distribution<uint64_t> size(m_config.sizeMin, m_config.sizeMax);
+                return size(m_random);
+            }
+            case SizeDistribution::Pareto:
+            {
+                /* Bounded pareto by inverse transform sampling */
+                std::uniform_real_distribution<double> uniform(0, 1);
+
+                const double u = uniform(m_random);
+                const double alpha = m_config.sizeAlpha;
+                const double low = std::pow(static_cast<double>(std::max<uint64_t>(m_config.sizeMin, 1)), alpha);
+                const double high = std::pow(static_cast<double>(std::max<uint64_t>(m_config.sizeMax, 1)), alpha);
+
+                const double size = std::pow(-(u * high - u * low - high) / (high * low), -1.0 / alpha);
+
+                return std::clamp<uint64_t>(static_cast<uint64_t>(size), m_config.sizeMin, m_config.sizeMax);
+            }
+        }
+
+        throw std::runtime_error("Unknown size distribution");
+    }
+
+    uint64_t LoadGenerator::nextDeadline()
+    {
+        switch (m_config.deadlineDistribution)
+        {
+            case DeadlineDistribution::Fixed:
+            {
+                return m_config.deadlineMin;
+            }
+            case DeadlineDistribution::Uniform:
+            {
+                std::uniform_int_distribution<uint64_t> deadline(m_config.deadlineMin, m_config.deadlineMax);
+                return deadline(m_random);
+            }
+            case DeadlineDistribution::Exponential:
+            {
+                std::exponential_distribution<double> deadline(1.0 / std::max<uint64_t>(m_config.deadlineMin, 1));
+                return static_cast<uint64_t>(deadline(m_random));
+            }
+        }
+
+        throw std::runtime_error("Unknown deadline distribution");
+    }
+
+    PendingSubmission LoadGenerator::makeSubmission(const uint64_t scheduledTime)
+    {
+        PendingSubmission submission;
+
+        submission.scheduledTime = scheduledTime;
+        submission.deadline = scheduledTime / 1000 + nextDeadline();
+
+        const CryptoNote::Transaction transaction =
+            CryptoNote::createHackTransaction(nextSize(), submission.deadline, m_nonce++);
+
+        const auto blob = CryptoNote::toBinaryArray(transaction);
+
+        submission.hash = CryptoNote::getBinaryArrayHash(blob);
+        submission.size = blob.size();
+
+        rapidjson::StringBuffer sb;
+
+        rapidjson::Writer<rapidjson::StringBuffer> writer(sb);
+
+        writer.String(Common::toHex(blob));
+
+        submission.body = sb.GetString();
+
+        return submission;
+    }
+
+    void LoadGenerator::sendLoop(const size_t connectionIndex)
+    {
+        /* One client per thread - the client keeps its socket open between
+           requests, so every sender has its own persistent connection */
+        httplib::Client client(m_config.daemonHost.c_str(), m_config.daemonPort, 10 /* 10 second timeout */);
+
+        const httplib::Headers headers = {{"User-Agent", std::string("loadgen/") + PROJECT_VERSION_LONG}};
+
+        auto &records = m_records[connectionIndex];
+
+        while (true)
+        {
+            const PendingSubmission submission = m_queue.pop();
+
+            if (submission.last)
+            {
+                break;
+            }
+
+            SubmissionRecord record;
+
+            record.hash = submission.hash;
+            record.size = submission.size;
+            record.deadline = submission.deadline;
+            record.scheduledTime = submission.scheduledTime;
+            record.submitTime = nowMicroseconds();
+
+            const auto res = client.Post("/transaction", headers, submission.body, "application/json");
+
+            record.responseTime = nowMicroseconds();
+            record.status = res ? res->status : 0;
+
+            if (record.status == 202)
+            {
+                m_accepted++;
+            }
+            else if (record.status == 0)
+            {
+                m_failed++;
+            }
+            else
+            {
+                m_rejected++;
+            }
+
+            records.push_back(record);
+        }
+    }
+
+    void LoadGenerator::printProgress()
+    {
+        uint64_t lastGenerated = 0;
+
+        while (m_running)
+        {
+            std::this_thread::sleep_for(std::chrono::seconds(1));
+
+            const uint64_t generated = m_generated;
+
+            std::cout << InformationMsg("Offered: ") << generated - lastGenerated << "/s"
+                      << InformationMsg(", accepted: ") << m_accepted << InformationMsg(", rejected: ")
+                      << m_rejected << InformationMsg(", failed: ") << m_failed << std::endl;
+
+            lastGenerated = generated;
+        }
+    }
+
+    void LoadGenerator::writeRecords() const
+    {
+        std::vector<SubmissionRecord> all;
+
+        for (const auto &records : m_records)
+        {
+            all.insert(all.end(), records.begin(), records.end());
+        }
+
+        std::sort(all.begin(), all.end(), [](const auto &a, const auto &b) {
+            return a.scheduledTime < b.scheduledTime;
+        });
+
+        std::ofstream file(m_config.outputFile);
+
+        if (!file)
+        {
+            std::cout << WarningMsg("Failed to open ") << WarningMsg(m_config.outputFile)
+                      << WarningMsg(" for writing!") << std::endl;
+            return;
+        }
+
+        file << "hash,size,deadline_ms,scheduled_us,submit_us,response_us,status\n";
+
+        for (const auto &record : all)
+        {
+            file << record.hash << "," << record.size << "," << record.deadline << "," << record.scheduledTime
+                 << "," << record.submitTime << "," << record.responseTime << "," << record.status << "\n";
+        }
+
+        std::cout << SuccessMsg("Wrote ") << SuccessMsg(all.size()) << SuccessMsg(" submission records to ")
+                  << SuccessMsg(m_config.outputFile) << std::endl;
+    }
+
+    void LoadGenerator::printSummary() const
+    {
+        std::vector<uint64_t> queueDelays;
+        std::vector<uint64_t> responseTimes;
+
+        for (const auto &records : m_records)
+        {
+            for (const auto &record : records)
+            {
+                queueDelays.push_back(record.submitTime - std::min(record.submitTime, record.scheduledTime));
+                responseTimes.push_back(record.responseTime - record.submitTime);
+            }
+        }
+
+        const double elapsed = m_config.duration;
+
+        std::cout << "\n"
+                  << InformationMsg("Offered rate:  ") << m_generated / elapsed << "/s\n"
+                  << InformationMsg("Accepted rate: ") << m_accepted / elapsed << "/s\n"
+                  << InformationMsg("Rejected:      ") << m_rejected << "\n"
+                  << InformationMsg("Failed:        ") << m_failed << "\n"
+                  << std::fixed << std::setprecision(1)
+                  << InformationMsg("Queue delay p50/p99 (us):   ") << percentile(queueDelays, 0.5) << " / "
+                  << percentile(queueDelays, 0.99) << "\n"
+                  << InformationMsg("Response time p50/p99 (us): ") << percentile(responseTimes, 0.5) << " / "
+                  << percentile(responseTimes, 0.99) << "\n"
+                  << std::endl;
+    }
+
+    DeadlineCounts LoadGenerator::getDaemonDeadlineCounts() const
+    {
+        DeadlineCounts counts;
+
+        httplib::Client client(m_config.daemonHost.c_str(), m_config.daemonPort, 10 /* 10 second timeout */);
+
+        const auto res = client.Get("/latency");
+
+        if (!res || res->status != 200)
+        {
+            return counts;
+        }
+
+        rapidjson::Document body;
+
+        if (body.Parse(res->body.c_str()).HasParseError() || !body.HasMember("deadlines"))
+        {
+            return counts;
+        }
+
+        for (const auto &sizeClass : body["deadlines"].GetArray())
+        {
+            counts.met += sizeClass["met"].GetUint64();
+            counts.missed += sizeClass["missed"].GetUint64();
+            counts.expired += sizeClass["expired"].GetUint64();
+
+            /* Not reported by daemons without admission control */
+            if (sizeClass.HasMember("rejected"))
+            {
+                counts.rejected += sizeClass["rejected"].GetUint64();
+            }
+        }
+
+        counts.valid = true;
+
+        return counts;
+    }
+
+    void LoadGenerator::printDeadlineSummary(const DeadlineCounts &before, const DeadlineCounts &after) const
+    {
+        if (!before.valid || !after.valid)
+        {
+            std::cout << WarningMsg("Could not read deadline counters from the daemon /latency endpoint")
+                      << std::endl;
+            return;
+        }
+
+        /* The daemon counters are cumulative, so only look at what changed
+           during our run. Transactions still waiting to be mined aren't
+           counted yet - use --settle to give them a chance. */
+        const uint64_t met = after.met - before.met;
+        const uint64_t missed = after.missed - before.missed;
+        const uint64_t expired = after.expired - before.expired;
+        const uint64_t rejected = after.rejected - before.rejected;
+
+        const uint64_t resolved = met + missed + expired;
+
+        const uint64_t pending = m_accepted > resolved ? m_accepted - resolved : 0;
+
+        const double missRatio = resolved == 0 ? 0 : static_cast<double>(missed + expired) / resolved;
+
+        std::cout << InformationMsg("Deadlines met:     ") << met << "\n"
+                  << InformationMsg("Deadlines missed:  ") << missed << "\n"
+                  << InformationMsg("Deadlines expired: ") << expired << "\n"
+                  << InformationMsg("Rejected by pool:  ") << rejected << "\n"
+                  << InformationMsg("Still pending:     ") << pending << "\n"
+                  << std::fixed << std::setprecision(2) << InformationMsg("Miss ratio at ")
+                  << m_generated / static_cast<double>(m_config.duration) << "/s offered: " << missRatio * 100
+                  << "%\n"
+                  << std::endl;
+    }
+
+} // namespace LoadGenerator
@@ -0,0 +1,140 @@
+// Copyright (c) 2018-2020, The TurtleCoin Developers
+//
+// Please see the included LICENSE file for more information.
+
+#pragma once
+
+#include "LoadGeneratorConfig.h"
+
+#include <CryptoTypes.h>
+#include <atomic>
+#include <mutex>
+#include <random>
+#include <string>
+#include <utilities/ThreadSafeQueue.h>
+#include <vector>
+
+namespace LoadGenerator
+{
+    /* A transaction that has been synthesized and is waiting for a free
+       connection to be submitted on */
+    struct PendingSubmission
+    {
+        Crypto::Hash hash;
+
+        /* JSON body of the /transaction request */
+        std::string body;
+
+        uint64_t size = 0;
+
+        /* Absolute deadline, unix milliseconds */
+        uint64_t deadline = 0;
+
+        /* When the arrival process scheduled this transaction, unix microseconds */
+        uint64_t scheduledTime = 0;
+
+        /* Tells a sender thread to exit */
+        bool last = false;
+    };
+
+    /* Deadline counters from the daemons /latency endpoint, summed over
+       every size class */
+    struct DeadlineCounts
+    {
+        uint64_t met = 0;
+
+        uint64_t missed = 0;
+
+        uint64_t expired = 0;
+
+        /* Turned away by the pool, and so not in the miss ratio */
+        uint64_t rejected = 0;
+
+        /* False if we couldn't reach the daemon */
+        bool valid = false;
+    };
+
+    struct SubmissionRecord
+    {
+        Crypto::Hash hash;
+
+        uint64_t size;
+
+        uint64_t deadline;
+
+        uint64_t scheduledTime;
+
+        /* When we started writing the request, unix microseconds */
+        uint64_t submitTime;
+
+        /* When the daemon responded, unix microseconds */
+        uint64_t responseTime;
+
+        /* HTTP status, or 0 if the connection failed */
+        int status;
+    };
+
+    /* Open loop load generator. Arrivals are scheduled independently of how
+       fast the daemon responds, so a slow daemon shows up as queueing delay
+       between scheduledTime and submitTime, rather than a lower offered load. */
+    class LoadGenerator
+    {
+      public:
+        LoadGenerator(const LoadGeneratorConfig &config);
+
+        void start();
+
+      private:
+        void generate();
+
+        void sendLoop(const size_t connectionIndex);
+
+        void printProgress();
+
+        void writeRecords() const;
+
+        void printSummary() const;
+
+        DeadlineCounts getDaemonDeadlineCounts() const;
+
+        void printDeadlineSummary(const DeadlineCounts &before, const DeadlineCounts &after) const;
+
+        /* Time from now until the next arrival, in microseconds */
+        uint64_t nextInterArrival(uint64_t now);
+
+        uint64_t nextSize();
+
+        uint64_t nextDeadline();
+
+        PendingSubmission makeSubmission(const uint64_t scheduledTime);
+
+        LoadGeneratorConfig m_config;
+
+        std::mt19937_64 m_random;
+
+        /* Counts up from a random start with each transaction, so neither
+           two transactions from one run, nor from two runs against the same
+           node, are identical. Not drawn from m_random, which is seeded, and
+           the same between runs. */
+        uint64_t m_nonce;
+
+        ThreadSafeQueue<PendingSubmission> m_queue;
+
+        /* Start of the run, unix microseconds */
+        uint64_t m_startTime = 0;
+
+        std::atomic<uint64_t> m_generated = 0;
+
+        std::atomic<uint64_t> m_accepted = 0;
+
+        std::atomic<uint64_t> m_rejected = 0;
+
+        std::atomic<uint64_t> m_failed = 0;
+
+        std::atomic<bool> m_running = false;
+
+        /* Each sender thread owns one slot, merged at the end of the run */
+        std::vector<std::vector<SubmissionRecord>> m_records;
+    };
+
+} // namespace LoadGenerator
@@ -0,0 +1,241 @@
+// Copyright (c) 2018-2020, The TurtleCoin Developers
+//
+// Please see the included LICENSE file for more information.
+
+////////////////////////////////
+#include "LoadGeneratorConfig.h"
+////////////////////////////////
+
+#include <config/CliHeader.h>
+#include <config/CryptoNoteConfig.h>
+#include <cxxopts.hpp>
+#include <iostream>
+#include <utilities/ColouredMsg.h>
+#include <utilities/Utilities.h>
+
+namespace LoadGenerator
+{
+    namespace
+    {
+        ArrivalProcess parseArrival(const std::string &str)
+        {
+            if (str == "constant")
+            {
+                return ArrivalProcess::Constant;
+            }
+            else if (str == "poisson")
+            {
+                return ArrivalProcess::Poisson;
+            }
+            else if (str == "bursty")
+            {
+                return ArrivalProcess::Bursty;
+            }
+
+            throw std::runtime_error("--arrival must be one of constant, poisson, bursty");
+        }
+
+        SizeDistribution parseSizeDistribution(const std::string &str)
+        {
+            if (str == "fixed")
+            {
+                return SizeDistribution::Fixed;
+            }
+            else if (str == "uniform")
+            {
+                return SizeDistribution::Uniform;
+            }
+            else if (str == "pareto")
+            {
+                return SizeDistribution::Pareto;
+            }
+
+            throw std::runtime_error("--size-distribution must be one of fixed, uniform, pareto");
+        }
+
+        DeadlineDistribution parseDeadlineDistribution(const std::string &str)
+        {
+            if (str == "fixed")
+            {
+                return DeadlineDistribution::Fixed;
+            }
+            else if (str == "uniform")
+            {
+                return DeadlineDistribution::Uniform;
+            }
+            else if (str == "exponential")
+            {
+                return DeadlineDistribution::Exponential;
+            }
+
+            throw std::runtime_error("--deadline-distribution must be one of fixed, uniform, exponential");
+        }
+    } // namespace
+
+    LoadGeneratorConfig::LoadGeneratorConfig(): help(false), version(false) {}
+
+    void LoadGeneratorConfig::parse(int argc, char **argv)
+    {
+        cxxopts::Options options(argv[0], CryptoNote::getProjectCLIHeader());
+
+        std::string arrivalStr;
+        std::string sizeDistributionStr;
+        std::string deadlineDistributionStr;
+
+        options.add_options("Core")(
+            "help", "Display this help message", cxxopts::value<bool>(help)->implicit_value("true"))(
+            "version",
+            "Output software version information",
+            cxxopts::value<bool>(version)->default_value("false")->implicit_value("true"));
+
+        options.add_options("Daemon")(
+            "daemon-address",
+            "The daemon [host:port] combination to submit transactions to. This option overrides --daemon-host and "
+            "--daemon-rpc-port",
+            cxxopts::value<std::string>(daemonAddress),
+            "<host:port>")(
+            "daemon-host",
+            "The daemon host to submit transactions to",
+            cxxopts::value<std::string>(daemonHost)->default_value("127.0.0.1"),
+            "<host>")(
+            "daemon-rpc-port",
+            "The daemon RPC port to submit transactions to",
+            cxxopts::value<uint16_t>(daemonPort)->default_value(std::to_string(CryptoNote::RPC_DEFAULT_PORT)),
+            "#")(
+            "connections",
+            "The number of persistent connections to submit transactions over",
+            cxxopts::value<size_t>(connections)->default_value("8"),
+            "#");
+
+        options.add_options("Load")(
+            "rate",
+            "The offered load, in transactions per second",
+            cxxopts::value<double>(rate)->default_value("1000"),
+            "#")(
+            "duration",
+            "How long to generate load for, in seconds",
+            cxxopts::value<uint64_t>(duration)->default_value("60"),
+            "#")(
+            "arrival",
+            "The arrival process: constant, poisson or bursty",
+            cxxopts::value<std::string>(arrivalStr)->default_value("poisson"),
+            "<process>")(
+            "burst-factor",
+            "Ratio of the peak rate to the mean rate when --arrival is bursty",
+            cxxopts::value<double>(burstFactor)->default_value("4"),
+            "#")(
+            "burst-period",
+            "Length of one on/off cycle when --arrival is bursty, in milliseconds",
+            cxxopts::value<uint64_t>(burstPeriod)->default_value("1000"),
+            "#")(
+            "seed",
+            "Seed for the random number generator, so runs can be repeated",
+            cxxopts::value<uint64_t>(seed)->default_value("1"),
+            "#");
+
+        options.add_options("Transactions")(
+            "size-distribution",
+            "The transaction size distribution: fixed, uniform or pareto",
+            cxxopts::value<std::string>(sizeDistributionStr)->default_value("fixed"),
+            "<distribution>")(
+            "size",
+            "The transaction size in bytes. The minimum size for uniform and pareto",
+            cxxopts::value<uint64_t>(sizeMin)->default_value("256"),
+            "#")(
+            "size-max",
+            "The maximum transaction size in bytes for uniform and pareto",
+            cxxopts::value<uint64_t>(sizeMax)->default_value("16384"),
+            "#")(
+            "size-alpha",
+            "The shape of the pareto size distribution. Smaller is heavier tailed",
+            cxxopts::value<double>(sizeAlpha)->default_value("1.5"),
+            "#")(
+            "deadline-distribution",
+            "The relative deadline distribution: fixed, uniform or exponential",
+            cxxopts::value<std::string>(deadlineDistributionStr)->default_value("fixed"),
+            "<distribution>")(
+            "deadline",
+            "The relative deadline in milliseconds. The minimum for uniform, the mean for exponential",
+            cxxopts::value<uint64_t>(deadlineMin)->default_value("30000"),
+            "#")(
+            "deadline-max",
+            "The maximum relative deadline in milliseconds for uniform",
+            cxxopts::value<uint64_t>(deadlineMax)->default_value("120000"),
+            "#")(
+            "output",
+            "Where to write the per transaction submit log (CSV)",
+            cxxopts::value<std::string>(outputFile)->default_value("loadgen.csv"),
+            "<file>")(
+            "settle",
+            "How long to wait after the run for transactions to be mined before reading the daemons deadline "
+            "counters, in seconds",
+            cxxopts::value<uint64_t>(settle)->default_value("0"),
+            "#");
+
+        try
+        {
+            auto result = options.parse(argc, argv);
+        }
+        catch (const cxxopts::OptionException &e)
+        {
+            std::cout << WarningMsg("Error: Unable to parse command line argument options: ") << WarningMsg(e.what())
+                      << "\n\n";
+            std::cout << options.help({}) << std::endl;
+            exit(1);
+        }
+
+        if (help) // Do we want to display the help message?
+        {
+            std::cout << options.help({}) << std::endl;
+            exit(0);
+        }
+        else if (version) // Do we want to display the software version?
+        {
+            std::cout << InformationMsg(CryptoNote::getProjectCLIHeader()) << std::endl;
+            exit(0);
+        }
+
+        arrival = parseArrival(arrivalStr);
+        sizeDistribution = parseSizeDistribution(sizeDistributionStr);
+        deadlineDistribution = parseDeadlineDistribution(deadlineDistributionStr);
+
+        if (!daemonAddress.empty())
+        {
+            if (!Utilities::parseDaemonAddressFromString(daemonHost, daemonPort, daemonAddress))
+            {
+                throw std::runtime_error("Could not parse --daemon-address option");
+            }
+        }
+
+        if (rate <= 0)
+        {
+            throw std::runtime_error("--rate must be greater than zero");
+        }
+
+        if (connections == 0)
+        {
+            throw std::runtime_error("--connections must not be zero");
+        }
+
+        if (burstFactor < 1)
+        {
+            throw std::runtime_error("--burst-factor must be at least 1");
+        }
+
+        if (sizeDistribution != SizeDistribution::Fixed && sizeMax < sizeMin)
+        {
+            throw std::runtime_error("--size-max must not be less than --size");
+        }
+
+        if (sizeAlpha <= 0)
+        {
+            throw std::runtime_error("--size-alpha must be greater than zero");
+        }
+
+        if (deadlineDistribution == DeadlineDistribution::Uniform && deadlineMax < deadlineMin)
+        {
+            throw std::runtime_error("--deadline-max must not be less than --deadline");
+        }
+    }
+
+} // namespace LoadGenerator
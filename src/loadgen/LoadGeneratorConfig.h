@@ -0,0 +1,104 @@
+// Copyright (c) 2018-2020, The TurtleCoin Developers
+//
+// Please see the included LICENSE file for more information.
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace LoadGenerator
+{
+    enum class ArrivalProcess
+    {
+        /* Evenly spaced arrivals */
+        Constant,
+
+        /* Exponentially distributed inter-arrival times */
+        Poisson,
+
+        /* On/off modulated poisson - all arrivals happen in bursts */
+        Bursty
+    };
+
+    enum class SizeDistribution
+    {
+        Fixed,
+
+        Uniform,
+
+        /* Heavy tailed, truncated at sizeMax */
+        Pareto
+    };
+
+    enum class DeadlineDistribution
+    {
+        Fixed,
+
+        Uniform,
+
+        Exponential
+    };
+
+    struct LoadGeneratorConfig
+    {
+        LoadGeneratorConfig();
+
+        void parse(int argc, char **argv);
+
+        std::string daemonAddress;
+
+        std::string daemonHost;
+
+        uint16_t daemonPort;
+
+        /* Offered load, in transactions per second */
+        double rate;
+
+        /* How long to generate load for, in seconds */
+        uint64_t duration;
+
+        ArrivalProcess arrival;
+
+        /* Ratio of the peak rate to the mean rate in bursty mode */
+        double burstFactor;
+
+        /* Length of one on/off cycle in bursty mode, in milliseconds */
+        uint64_t burstPeriod;
+
+        SizeDistribution sizeDistribution;
+
+        /* Transaction size in bytes. The minimum for non fixed distributions */
+        uint64_t sizeMin;
+
+        uint64_t sizeMax;
+
+        /* Shape parameter of the pareto distribution */
+        double sizeAlpha;
+
+        DeadlineDistribution deadlineDistribution;
+
+        /* Relative deadline in milliseconds. The minimum for uniform, the
+           mean for exponential */
+        uint64_t deadlineMin;
+
+        uint64_t deadlineMax;
+
+        /* Number of persistent connections to the daemon */
+        size_t connections;
+
+        uint64_t seed;
+
+        /* Where to write the per transaction submit log */
+        std::string outputFile;
+
+        /* How long to wait after the run for submitted transactions to be
+           mined, before reading the daemons deadline counters, in seconds */
+        uint64_t settle;
+
+        bool help;
+
+        bool version;
+    };
+
+} // namespace LoadGenerator
@@ -0,0 +1,29 @@
+// Copyright (c) 2018-2020, The TurtleCoin Developers
+//
+// Please see the included LICENSE file for more information.
+
+#include "LoadGenerator.h"
+
+#include <iostream>
+#include <utilities/ColouredMsg.h>
+
+int main(int argc, char **argv)
+{
+    LoadGenerator::LoadGeneratorConfig config;
+
+    try
+    {
+        config.parse(argc, argv);
+
+        LoadGenerator::LoadGenerator generator(config);
+
+        generator.start();
+    }
+    catch (const std::exception &e)
+    {
+        std::cout << WarningMsg("Unhandled exception caught: ") << WarningMsg(e.what()) << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
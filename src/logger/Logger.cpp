@@ -8,9 +8,7 @@
 
 #include <algorithm>
 #include <ctime>
-#include <iomanip>
 #include <iostream>
-#include <sstream>
 
 namespace Logger
 {
@@ -120,30 +118,65 @@ namespace Logger
 
     void Logger::log(const std::string message, const LogLevel level, const std::vector<LogCategory> categories) const
     {
-        if (level == DISABLED)
+        if (level == DISABLED || level > m_logLevel)
         {
             return;
         }
+
+        /* Formatting the time is slow, and most messages land in the same
+           second as the previous one */
+        thread_local std::time_t lastTime = 0;
+
+        thread_local std::string lastTimeStr;
+
         const std::time_t now = std::time(nullptr);
-        std::stringstream output;
-        output << "[" << std::put_time(std::localtime(&now), "%H:%M:%S") << "] "
-               << "[" << logLevelToString(level) << "]";
+
+        if (now != lastTime || lastTimeStr.empty())
+        {
+            char buffer[16];
+
+            std::tm localTime {};
+
+#ifdef _WIN32
+            localtime_s(&localTime, &now);
+#else
+            localtime_r(&now, &localTime);
+#endif
+
+            std::strftime(buffer, sizeof(buffer), "%H:%M:%S", &localTime);
+
+            lastTime = now;
+            lastTimeStr = buffer;
+        }
+
+        std::string output;
+
+        output.reserve(message.size() + 64);
+
+        output += "[";
+        output += lastTimeStr;
+        output += "] [";
+        output += logLevelToString(level);
+        output += "]";
+
         for (const auto &category : categories)
         {
-            output << " [" << logCategoryToString(category) << "]";
+            output += " [";
+            output += logCategoryToString(category);
+            output += "]";
         }
-        output << ": " << message;
-        if (level <= m_logLevel)
+
+        output += ": ";
+        output += message;
+
+        /* If the user provides a callback, log to that instead */
+        if (m_callback)
         {
-            /* If the user provides a callback, log to that instead */
-            if (m_callback)
-            {
-                m_callback(output.str(), message, level, categories);
-            }
-            else
-            {
-                std::cout << output.str() << std::endl;
-            }
+            m_callback(output, message, level, categories);
+        }
+        else
+        {
+            std::cout << output << std::endl;
         }
     }
 
@@ -0,0 +1,301 @@
+// Copyright (c) 2018-2020, The TurtleCoin Developers
+//
+// Please see the included LICENSE file for more information.
+
+#include "AsyncLogger.h"
+
+#include <algorithm>
+#include <chrono>
+
+namespace Logging
+{
+    namespace
+    {
+        /* Messages each thread can have waiting to be written. If a thread
+           fills its queue, it waits for the writer to catch up */
+        const uint64_t QUEUE_SIZE = 1024;
+
+        /* How long the writer sleeps for if nobody wakes it */
+        const std::chrono::milliseconds WRITER_IDLE_TIMEOUT(1000);
+
+        std::atomic<uint64_t> nextLoggerId(0);
+    } // namespace
+
+    /* Fixed size ring buffer, written by one thread and read by the writer.
+       Slots are reused, so once their strings have grown, logging a message
+       doesn't allocate */
+    class AsyncLogger::MessageQueue
+    {
+      public:
+        MessageQueue(): messages(QUEUE_SIZE), head(0), tail(0), abandoned(false) {}
+
+        std::vector<Message> messages;
+
+        /* Next message to be written. Only the writer advances this, once
+           the message has been written */
+        alignas(64) std::atomic<uint64_t> head;
+
+        /* Next free slot. Only the owning thread advances this */
+        alignas(64) std::atomic<uint64_t> tail;
+
+        /* Set when the owning thread exits, so the writer can discard the
+           queue once it is empty */
+        std::atomic<bool> abandoned;
+    };
+
+    AsyncLogger::AsyncLogger(ILogger &logger):
+        m_logger(logger),
+        m_id(nextLoggerId++),
+        m_shouldStop(false),
+        m_writerSleeping(false),
+        m_writerThread(&AsyncLogger::writerLoop, this)
+    {
+    }
+
+    AsyncLogger::~AsyncLogger()
+    {
+        m_shouldStop = true;
+
+        wakeWriter();
+
+        m_writerThread.join();
+    }
+
+    void AsyncLogger::operator()(
+        const std::string &category,
+        Level level,
+        boost::posix_time::ptime time,
+        const std::string &body)
+    {
+        MessageQueue &queue = threadQueue();
+
+        const uint64_t tail = queue.tail.load(std::memory_order_relaxed);
+
+        /* Queue is full. Wait for the writer, rather than dropping messages */
+        while (tail - queue.head.load(std::memory_order_acquire) >= QUEUE_SIZE)
+        {
+            wakeWriter();
+            std::this_thread::yield();
+        }
+
+        Message &message = queue.messages[tail % QUEUE_SIZE];
+
+        message.category = category;
+        message.level = level;
+        message.time = time;
+        message.body = body;
+
+        queue.tail.store(tail + 1);
+
+        if (level <= ERROR)
+        {
+            flush();
+        }
+        else if (m_writerSleeping)
+        {
+            wakeWriter();
+        }
+    }
+
+    bool AsyncLogger::isEnabled(Level level) const
+    {
+        return m_logger.isEnabled(level);
+    }
+
+    void AsyncLogger::flush()
+    {
+        std::vector<std::pair<std::shared_ptr<MessageQueue>, uint64_t>> targets;
+
+        {
+            std::scoped_lock lock(m_queuesMutex);
+
+            for (const auto &queue : m_queues)
+            {
+                targets.emplace_back(queue, queue->tail.load());
+            }
+        }
+
+        wakeWriter();
+
+        std::unique_lock lock(m_writerMutex);
+
+        m_batchWritten.wait(
+            lock,
+            [&targets]()
+            {
+                return std::all_of(
+                    targets.begin(),
+                    targets.end(),
+                    [](const auto &target) { return target.first->head.load() >= target.second; });
+            });
+    }
+
+    AsyncLogger::MessageQueue &AsyncLogger::threadQueue()
+    {
+        /* Queues this thread has with each logger it has used */
+        struct ThreadQueues
+        {
+            ~ThreadQueues()
+            {
+                for (auto &[id, queue] : queues)
+                {
+                    queue->abandoned = true;
+                }
+            }
+
+            std::vector<std::pair<uint64_t, std::shared_ptr<MessageQueue>>> queues;
+        };
+
+        thread_local ThreadQueues threadQueues;
+
+        for (auto &[id, queue] : threadQueues.queues)
+        {
+            if (id == m_id)
+            {
+                return *queue;
+            }
+        }
+
+        /* First message from this thread. Forget queues of loggers which
+           have since been destroyed, then make our own */
+        auto &queues = threadQueues.queues;
+
+        queues.erase(
+            std::remove_if(
+                queues.begin(), queues.end(), [](const auto &entry) { return entry.second.use_count() == 1; }),
+            queues.end());
+
+        auto queue = std::make_shared<MessageQueue>();
+
+        {
+            std::scoped_lock lock(m_queuesMutex);
+            m_queues.push_back(queue);
+        }
+
+        queues.emplace_back(m_id, queue);
+
+        return *queue;
+    }
+
+    void AsyncLogger::wakeWriter()
+    {
+        /* Taking the lock means the writer is either yet to check for
+           messages, or already waiting, so can't miss the notification */
+        {
+            std::scoped_lock lock(m_writerMutex);
+        }
+
+        m_writerWakeup.notify_one();
+    }
+
+    void AsyncLogger::writerLoop()
+    {
+        while (true)
+        {
+            if (writeBatch())
+            {
+                continue;
+            }
+
+            if (m_shouldStop)
+            {
+                break;
+            }
+
+            std::unique_lock lock(m_writerMutex);
+
+            m_writerSleeping = true;
+
+            bool haveMessages = false;
+
+            {
+                std::scoped_lock queuesLock(m_queuesMutex);
+
+                haveMessages = std::any_of(
+                    m_queues.begin(),
+                    m_queues.end(),
+                    [](const auto &queue) { return queue->head.load() != queue->tail.load(); });
+            }
+
+            if (!haveMessages && !m_shouldStop)
+            {
+                m_writerWakeup.wait_for(lock, WRITER_IDLE_TIMEOUT);
+            }
+
+            m_writerSleeping = false;
+        }
+    }
+
+    bool AsyncLogger::writeBatch()
+    {
+        {
+            std::scoped_lock lock(m_queuesMutex);
+
+            /* Drop queues of threads which have exited, once we've written
+               everything they logged */
+            m_queues.erase(
+                std::remove_if(
+                    m_queues.begin(),
+                    m_queues.end(),
+                    [](const auto &queue) { return queue->abandoned && queue->head.load() == queue->tail.load(); }),
+                m_queues.end());
+
+            m_batchQueues = m_queues;
+        }
+
+        m_batch.clear();
+        m_batchEnds.clear();
+
+        for (const auto &queue : m_batchQueues)
+        {
+            const uint64_t head = queue->head.load(std::memory_order_relaxed);
+            const uint64_t tail = queue->tail.load(std::memory_order_acquire);
+
+            for (uint64_t i = head; i < tail; i++)
+            {
+                m_batch.push_back(&queue->messages[i % QUEUE_SIZE]);
+            }
+
+            m_batchEnds.push_back(tail);
+        }
+
+        if (m_batch.empty())
+        {
+            return false;
+        }
+
+        /* Each queue is already in order, interleave the threads by time */
+        std::stable_sort(
+            m_batch.begin(), m_batch.end(), [](const Message *a, const Message *b) { return a->time < b->time; });
+
+        try
+        {
+            for (const Message *message : m_batch)
+            {
+                m_logger(message->category, message->level, message->time, message->body);
+            }
+
+            m_logger.flush();
+        }
+        catch (const std::exception &)
+        {
+            /* Nowhere to report a failure to log. Carry on, so the logging
+               threads aren't blocked forever */
+        }
+
+        /* Only hand the slots back now we're done with them */
+        for (size_t i = 0; i < m_batchQueues.size(); i++)
+        {
+            m_batchQueues[i]->head.store(m_batchEnds[i], std::memory_order_release);
+        }
+
+        {
+            std::scoped_lock lock(m_writerMutex);
+        }
+
+        m_batchWritten.notify_all();
+
+        return true;
+    }
+
+} // namespace Logging
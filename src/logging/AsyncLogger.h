@@ -0,0 +1,102 @@
+// Copyright (c) 2018-2020, The TurtleCoin Developers
+//
+// Please see the included LICENSE file for more information.
+
+#pragma once
+
+#include "ILogger.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Logging
+{
+    /* Hands messages off to a background thread, which passes them on to the
+       wrapped logger in batches, and flushes it after each batch. Every thread
+       that logs gets its own single producer queue, so logging a message never
+       takes a lock, and formatting and writing it happen on the writer thread.
+
+       FATAL and ERROR messages are written before returning, so they aren't
+       lost if the process exits straight afterwards. */
+    class AsyncLogger : public ILogger
+    {
+      public:
+        AsyncLogger(ILogger &logger);
+
+        ~AsyncLogger();
+
+        AsyncLogger(const AsyncLogger &) = delete;
+
+        AsyncLogger &operator=(const AsyncLogger &) = delete;
+
+        virtual void
+            operator()(const std::string &category, Level level, boost::posix_time::ptime time, const std::string &body)
+                override;
+
+        virtual bool isEnabled(Level level) const override;
+
+        /* Blocks until every message logged before the call has been written */
+        virtual void flush() override;
+
+      private:
+        struct Message
+        {
+            std::string category;
+
+            Level level;
+
+            boost::posix_time::ptime time;
+
+            std::string body;
+        };
+
+        class MessageQueue;
+
+        /* Get the calling thread's queue, creating it on first use */
+        MessageQueue &threadQueue();
+
+        void writerLoop();
+
+        /* Write everything currently queued. Returns false if there was
+           nothing to write */
+        bool writeBatch();
+
+        void wakeWriter();
+
+        ILogger &m_logger;
+
+        /* Unique across instances, so a thread's cached queue can't be
+           mistaken for another logger's */
+        const uint64_t m_id;
+
+        /* Queue of every thread that has logged */
+        std::vector<std::shared_ptr<MessageQueue>> m_queues;
+
+        std::mutex m_queuesMutex;
+
+        /* Queues and messages gathered by the writer, reused between batches */
+        std::vector<std::shared_ptr<MessageQueue>> m_batchQueues;
+
+        std::vector<uint64_t> m_batchEnds;
+
+        std::vector<Message *> m_batch;
+
+        std::atomic<bool> m_shouldStop;
+
+        std::atomic<bool> m_writerSleeping;
+
+        std::mutex m_writerMutex;
+
+        std::condition_variable m_writerWakeup;
+
+        /* Signalled after each batch is written */
+        std::condition_variable m_batchWritten;
+
+        std::thread m_writerThread;
+    };
+
+} // namespace Logging
@@ -5,17 +5,75 @@
 
 #include "CommonLogger.h"
 
+#include <algorithm>
+#include <boost/date_time/gregorian/gregorian.hpp>
+
 namespace Logging
 {
     namespace
     {
+        /* The date and time of day, formatted as boost would stream them, for
+           the second a message was logged in. Busy loggers log many messages a
+           second, so only the fractional part is formatted per message */
+        struct TimestampCache
+        {
+            boost::gregorian::date date;
+
+            int64_t seconds = -1;
+
+            std::string dateStr;
+
+            std::string timeStr;
+        };
+
+        void formatTimestamp(boost::posix_time::ptime time, std::string &dateStr, std::string &timeStr)
+        {
+            thread_local TimestampCache cache;
+
+            const boost::posix_time::time_duration timeOfDay = time.time_of_day();
+
+            const int64_t seconds = timeOfDay.total_seconds();
+
+            if (seconds != cache.seconds || time.date() != cache.date)
+            {
+                cache.date = time.date();
+                cache.seconds = seconds;
+                cache.dateStr = boost::gregorian::to_simple_string(cache.date);
+                cache.timeStr = boost::posix_time::to_simple_string(boost::posix_time::seconds(seconds));
+            }
+
+            dateStr = cache.dateStr;
+            timeStr = cache.timeStr;
+
+            const size_t digits = boost::posix_time::time_duration::num_fractional_digits();
+
+            /* Like boost, only show the fraction if there is one */
+            if (timeOfDay.fractional_seconds() != 0)
+            {
+                const std::string fraction = std::to_string(timeOfDay.fractional_seconds());
+
+                timeStr += '.';
+                timeStr.append(digits - std::min(digits, fraction.size()), '0');
+                timeStr += fraction;
+            }
+        }
+
         std::string formatPattern(
             const std::string &pattern,
             const std::string &category,
             Level level,
             boost::posix_time::ptime time)
         {
-            std::stringstream s;
+            std::string s;
+
+            std::string dateStr;
+
+            std::string timeStr;
+
+            if (pattern.find("%D") != std::string::npos || pattern.find("%T") != std::string::npos)
+            {
+                formatTimestamp(time, dateStr, timeStr);
+            }
 
             for (const char *p = pattern.c_str(); p && *p != 0; ++p)
             {
@@ -27,28 +85,38 @@ namespace Logging
                         case 0:
                             break;
                         case 'C':
-                            s << category;
+                            s += category;
                             break;
                         case 'D':
-                            s << time.date();
+                            s += dateStr;
                             break;
                         case 'T':
-                            s << time.time_of_day();
+                            s += timeStr;
                             break;
                         case 'L':
-                            s << std::setw(7) << std::left << ILogger::LEVEL_NAMES[level];
+                        {
+                            const std::string &levelName = ILogger::LEVEL_NAMES[level];
+                            s += levelName;
+                            s.append(7 - std::min<size_t>(7, levelName.size()), ' ');
                             break;
+                        }
                         default:
-                            s << *p;
+                            s += *p;
                     }
                 }
                 else
                 {
-                    s << *p;
+                    s += *p;
+                }
+
+                /* Pattern ended with a lone % */
+                if (*p == 0)
+                {
+                    break;
                 }
             }
 
-            return s.str();
+            return s;
         }
 
     } // namespace
@@ -81,6 +149,11 @@ namespace Logging
         }
     }
 
+    bool CommonLogger::isEnabled(Level level) const
+    {
+        return level <= logLevel;
+    }
+
     void CommonLogger::setPattern(const std::string &pattern)
     {
         this->pattern = pattern;
@@ -20,6 +20,8 @@ namespace Logging
             operator()(const std::string &category, Level level, boost::posix_time::ptime time, const std::string &body)
                 override;
 
+        virtual bool isEnabled(Level level) const override;
+
         virtual void disableCategory(const std::string &category);
 
         virtual void setMaxLevel(Level level);
@@ -18,7 +18,6 @@ namespace Logging
     void ConsoleLogger::doLogString(const std::string &message)
     {
         std::lock_guard<std::mutex> lock(mutex);
-        bool readingText = true;
         bool changedColor = false;
         std::string color = "";
 
@@ -41,28 +40,35 @@ namespace Logging
 
             {DEFAULT, Color::Default}};
 
-        for (size_t charPos = 0; charPos < message.size(); ++charPos)
+        size_t textStart = 0;
+
+        while (textStart < message.size())
         {
-            if (message[charPos] == ILogger::COLOR_DELIMETER)
-            {
-                readingText = !readingText;
-                color += message[charPos];
-                if (readingText)
-                {
-                    auto it = colorMapping.find(color);
-                    Common::Console::setTextColor(it == colorMapping.end() ? Color::Default : it->second);
-                    changedColor = true;
-                    color.clear();
-                }
-            }
-            else if (readingText)
+            const size_t colorStart = message.find(ILogger::COLOR_DELIMETER, textStart);
+
+            const size_t textEnd = colorStart == std::string::npos ? message.size() : colorStart;
+
+            std::cout.write(message.data() + textStart, textEnd - textStart);
+
+            if (colorStart == std::string::npos)
             {
-                std::cout << message[charPos];
+                break;
             }
-            else
+
+            const size_t colorEnd = message.find(ILogger::COLOR_DELIMETER, colorStart + 1);
+
+            if (colorEnd == std::string::npos)
             {
-                color += message[charPos];
+                break;
             }
+
+            color.assign(message, colorStart, colorEnd - colorStart + 1);
+
+            auto it = colorMapping.find(color);
+            Common::Console::setTextColor(it == colorMapping.end() ? Color::Default : it->second);
+            changedColor = true;
+
+            textStart = colorEnd + 1;
         }
 
         if (changedColor)
@@ -71,4 +77,10 @@ namespace Logging
         }
     }
 
+    void ConsoleLogger::flush()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::cout.flush();
+    }
+
 } // namespace Logging
@@ -16,6 +16,8 @@ namespace Logging
       public:
         ConsoleLogger(Level level = DEBUGGING);
 
+        virtual void flush() override;
+
       protected:
         virtual void doLogString(const std::string &message) override;
 
@@ -7,12 +7,49 @@
 
 namespace Logging
 {
+    namespace
+    {
+        /* Write out early if this much is buffered */
+        const size_t MAX_BUFFER_SIZE = 64 * 1024;
+    } // namespace
+
     FileLogger::FileLogger(Level level): StreamLogger(level) {}
 
+    FileLogger::~FileLogger()
+    {
+        flush();
+    }
+
     void FileLogger::init(const std::string &fileName)
     {
         fileStream.open(fileName, std::ios::app);
         StreamLogger::attachToStream(fileStream);
     }
 
+    void FileLogger::doLogString(const std::string &message)
+    {
+        std::lock_guard<std::mutex> lock(bufferMutex);
+
+        buffer += message;
+
+        if (buffer.size() >= MAX_BUFFER_SIZE)
+        {
+            StreamLogger::doLogString(buffer);
+            buffer.clear();
+        }
+    }
+
+    void FileLogger::flush()
+    {
+        std::lock_guard<std::mutex> lock(bufferMutex);
+
+        if (!buffer.empty())
+        {
+            /* Colour codes come in pairs in each message, so stripping them
+               from the whole batch at once is the same as one at a time */
+            StreamLogger::doLogString(buffer);
+            buffer.clear();
+        }
+    }
+
 } // namespace Logging
@@ -16,10 +16,23 @@ namespace Logging
       public:
         FileLogger(Level level = DEBUGGING);
 
+        ~FileLogger();
+
         void init(const std::string &filename);
 
+        virtual void flush() override;
+
+      protected:
+        /* Messages are buffered, and written in one go on flush(), or when
+           the buffer fills up */
+        virtual void doLogString(const std::string &message) override;
+
       private:
         std::ofstream fileStream;
+
+        std::string buffer;
+
+        std::mutex bufferMutex;
     };
 
 } // namespace Logging
@@ -67,6 +67,16 @@ namespace Logging
             Level level,
             boost::posix_time::ptime time,
             const std::string &body) = 0;
+
+        /* Whether a message at this level could be logged at all. Checked
+           before a message is built, so disabled messages cost nothing */
+        virtual bool isEnabled(Level level) const
+        {
+            return true;
+        }
+
+        /* Write out anything the logger has buffered */
+        virtual void flush() {}
     };
 
 #ifndef ENDL
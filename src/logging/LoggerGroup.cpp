@@ -31,4 +31,12 @@ namespace Logging
         }
     }
 
+    void LoggerGroup::flush()
+    {
+        for (auto &logger : loggers)
+        {
+            logger->flush();
+        }
+    }
+
 } // namespace Logging
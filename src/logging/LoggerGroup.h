@@ -24,6 +24,8 @@ namespace Logging
             operator()(const std::string &category, Level level, boost::posix_time::ptime time, const std::string &body)
                 override;
 
+        virtual void flush() override;
+
       protected:
         std::vector<ILogger *> loggers;
     };
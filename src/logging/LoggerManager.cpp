@@ -8,26 +8,86 @@
 #include "ConsoleLogger.h"
 #include "FileLogger.h"
 
+#include <algorithm>
 #include <thread>
 
 namespace Logging
 {
     using Common::JsonValue;
 
-    LoggerManager::LoggerManager() {}
+    LoggerManager::LoggerManager(): enabledLevel(logLevel), writer(*this), asyncLogger(writer) {}
 
     void LoggerManager::operator()(
         const std::string &category,
         Level level,
         boost::posix_time::ptime time,
         const std::string &body)
+    {
+        if (isEnabled(level))
+        {
+            asyncLogger(category, level, time, body);
+        }
+    }
+
+    bool LoggerManager::isEnabled(Level level) const
+    {
+        return level <= enabledLevel.load(std::memory_order_relaxed);
+    }
+
+    void LoggerManager::setMaxLevel(Level level)
     {
         std::unique_lock<std::mutex> lock(reconfigureLock);
-        LoggerGroup::operator()(category, level, time, body);
+        LoggerGroup::setMaxLevel(level);
+        updateEnabledLevel();
+    }
+
+    void LoggerManager::flush()
+    {
+        asyncLogger.flush();
+    }
+
+    void LoggerManager::updateEnabledLevel()
+    {
+        Level maxLoggerLevel = FATAL;
+
+        for (const auto &logger : loggers)
+        {
+            for (int level = TRACE; level > maxLoggerLevel; level--)
+            {
+                if (logger->isEnabled(static_cast<Level>(level)))
+                {
+                    maxLoggerLevel = static_cast<Level>(level);
+                    break;
+                }
+            }
+        }
+
+        enabledLevel = std::min(logLevel, maxLoggerLevel);
+    }
+
+    LoggerManager::Writer::Writer(LoggerManager &manager): manager(manager) {}
+
+    void LoggerManager::Writer::operator()(
+        const std::string &category,
+        Level level,
+        boost::posix_time::ptime time,
+        const std::string &body)
+    {
+        std::unique_lock<std::mutex> lock(manager.reconfigureLock);
+        manager.LoggerGroup::operator()(category, level, time, body);
+    }
+
+    void LoggerManager::Writer::flush()
+    {
+        std::unique_lock<std::mutex> lock(manager.reconfigureLock);
+        manager.LoggerGroup::flush();
     }
 
     void LoggerManager::configure(const JsonValue &val)
     {
+        /* Write out anything queued for the loggers we're about to replace */
+        asyncLogger.flush();
+
         std::unique_lock<std::mutex> lock(reconfigureLock);
         loggers.clear();
         LoggerGroup::loggers.clear();
@@ -143,11 +203,12 @@ namespace Logging
         {
             throw std::runtime_error("loggers parameter missing");
         }
-        setMaxLevel(globalLevel);
+        LoggerGroup::setMaxLevel(globalLevel);
         for (const auto &category : globalDisabledCategories)
         {
             disableCategory(category);
         }
+        updateEnabledLevel();
     }
 
 } // namespace Logging
@@ -6,14 +6,19 @@
 #pragma once
 
 #include "../common/JsonValue.h"
+#include "AsyncLogger.h"
 #include "LoggerGroup.h"
 
+#include <atomic>
 #include <list>
 #include <memory>
 #include <mutex>
 
 namespace Logging
 {
+    /* Messages are checked against the log level on the calling thread, then
+       handed to a background thread which formats and writes them - see
+       AsyncLogger */
     class LoggerManager : public LoggerGroup
     {
       public:
@@ -25,10 +30,47 @@ namespace Logging
             operator()(const std::string &category, Level level, boost::posix_time::ptime time, const std::string &body)
                 override;
 
+        virtual bool isEnabled(Level level) const override;
+
+        virtual void setMaxLevel(Level level) override;
+
+        /* Blocks until everything logged so far has been written */
+        virtual void flush() override;
+
       private:
+        /* Runs on the async logger's thread, writing to the configured loggers */
+        class Writer : public ILogger
+        {
+          public:
+            Writer(LoggerManager &manager);
+
+            virtual void operator()(
+                const std::string &category,
+                Level level,
+                boost::posix_time::ptime time,
+                const std::string &body) override;
+
+            virtual void flush() override;
+
+          private:
+            LoggerManager &manager;
+        };
+
+        /* Most verbose level any configured logger will take */
+        void updateEnabledLevel();
+
         std::vector<std::unique_ptr<CommonLogger>> loggers;
 
         std::mutex reconfigureLock;
+
+        /* Checked by logging threads without taking reconfigureLock */
+        std::atomic<Level> enabledLevel;
+
+        Writer writer;
+
+        /* Last, so it stops, writing out anything queued, before the loggers
+           are destroyed */
+        AsyncLogger asyncLogger;
     };
 
 } // namespace Logging
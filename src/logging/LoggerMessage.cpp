@@ -7,6 +7,33 @@
 
 namespace Logging
 {
+    namespace
+    {
+        /* microsec_clock::local_time() looks up the time zone for every call,
+           which takes a global lock in some C libraries. The offset from UTC
+           barely changes, so just look it up once a minute per thread */
+        boost::posix_time::ptime localTime()
+        {
+            thread_local boost::posix_time::ptime offsetUpdated;
+
+            thread_local boost::posix_time::time_duration utcOffset;
+
+            const boost::posix_time::ptime now = boost::posix_time::microsec_clock::universal_time();
+
+            if (offsetUpdated.is_not_a_date_time() || now - offsetUpdated >= boost::posix_time::minutes(1))
+            {
+                utcOffset = boost::posix_time::microsec_clock::local_time() - now;
+
+                /* Round off the time taken between the two calls */
+                utcOffset = boost::posix_time::seconds((utcOffset.total_milliseconds() + 500) / 1000);
+
+                offsetUpdated = now;
+            }
+
+            return now + utcOffset;
+        }
+    } // namespace
+
     LoggerMessage::LoggerMessage(
         std::shared_ptr<ILogger> logger,
         const std::string &category,
@@ -14,13 +41,19 @@ namespace Logging
         const std::string &color):
         std::ostream(this),
         std::streambuf(),
-        logger(logger),
-        category(category),
+        enabled(logger->isEnabled(level)),
+        message(enabled ? color : std::string()),
+        category(enabled ? category : std::string()),
         logLevel(level),
-        message(color),
-        timestamp(boost::posix_time::microsec_clock::local_time()),
+        logger(enabled ? logger : nullptr),
+        timestamp(enabled ? localTime() : boost::posix_time::ptime()),
         gotText(false)
     {
+        /* Makes every << a no-op, so nothing is formatted */
+        if (!enabled)
+        {
+            setstate(std::ios::badbit);
+        }
     }
 
     LoggerMessage::~LoggerMessage()
@@ -36,11 +69,12 @@ namespace Logging
     LoggerMessage::LoggerMessage(LoggerMessage &&other):
         std::ostream(std::move(other)),
         std::streambuf(std::move(other)),
+        enabled(other.enabled),
+        message(other.message),
         category(other.category),
         logLevel(other.logLevel),
         logger(other.logger),
-        message(other.message),
-        timestamp(boost::posix_time::microsec_clock::local_time()),
+        timestamp(enabled ? localTime() : boost::posix_time::ptime()),
         gotText(false)
     {
         this->set_rdbuf(this);
@@ -50,11 +84,12 @@ namespace Logging
     LoggerMessage::LoggerMessage(LoggerMessage &&other):
         std::ostream(nullptr),
         std::streambuf(),
+        enabled(other.enabled),
+        message(other.message),
         category(other.category),
         logLevel(other.logLevel),
         logger(other.logger),
-        message(other.message),
-        timestamp(boost::posix_time::microsec_clock::local_time()),
+        timestamp(enabled ? localTime() : boost::posix_time::ptime()),
         gotText(false)
     {
         if (this != &other)
@@ -102,6 +137,11 @@ namespace Logging
 
     int LoggerMessage::sync()
     {
+        if (!enabled)
+        {
+            return 0;
+        }
+
         (*logger)(category, logLevel, timestamp, message);
         gotText = false;
         message = DEFAULT;
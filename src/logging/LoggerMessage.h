@@ -35,6 +35,10 @@ namespace Logging
 
         int overflow(int c) override;
 
+        /* Whether the logger will take this message. If not, nothing is
+           built or formatted */
+        const bool enabled;
+
         std::string message;
 
         const std::string category;
@@ -24,17 +24,31 @@ namespace Logging
         if (stream != nullptr && stream->good())
         {
             std::lock_guard<std::mutex> lock(mutex);
-            bool readingText = true;
-            for (size_t charPos = 0; charPos < message.size(); ++charPos)
+
+            /* Write out the text between the colour codes */
+            size_t textStart = 0;
+
+            while (textStart < message.size())
             {
-                if (message[charPos] == ILogger::COLOR_DELIMETER)
+                const size_t colorStart = message.find(ILogger::COLOR_DELIMETER, textStart);
+
+                const size_t textEnd = colorStart == std::string::npos ? message.size() : colorStart;
+
+                stream->write(message.data() + textStart, textEnd - textStart);
+
+                if (colorStart == std::string::npos)
                 {
-                    readingText = !readingText;
+                    break;
                 }
-                else if (readingText)
+
+                const size_t colorEnd = message.find(ILogger::COLOR_DELIMETER, colorStart + 1);
+
+                if (colorEnd == std::string::npos)
                 {
-                    *stream << message[charPos];
+                    break;
                 }
+
+                textStart = colorEnd + 1;
             }
 
             *stream << std::flush;
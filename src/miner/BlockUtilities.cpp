@@ -102,3 +102,59 @@ Crypto::Hash getBlockLongHash(const CryptoNote::BlockTemplate &block)
         throw std::runtime_error("Unknown block major version.");
     }
 }
+
+size_t getBlockLongHashBatchSize(const CryptoNote::BlockTemplate &block)
+{
+    const auto it = CryptoNote::BATCH_HASHING_SIZES_BY_BLOCK_VERSION.find(block.majorVersion);
+
+    if (it == CryptoNote::BATCH_HASHING_SIZES_BY_BLOCK_VERSION.end())
+    {
+        return 1;
+    }
+
+    return it->second();
+}
+
+std::vector<Crypto::Hash>
+    getBlockLongHashes(const CryptoNote::BlockTemplate &block, const uint32_t nonceStep, const size_t count)
+{
+    const auto it = CryptoNote::BATCH_HASHING_ALGORITHMS_BY_BLOCK_VERSION.find(block.majorVersion);
+
+    if (it == CryptoNote::BATCH_HASHING_ALGORITHMS_BY_BLOCK_VERSION.end())
+    {
+        std::vector<Crypto::Hash> hashes;
+
+        CryptoNote::BlockTemplate nonceBlock = block;
+
+        for (size_t i = 0; i < count; i++)
+        {
+            hashes.push_back(getBlockLongHash(nonceBlock));
+            nonceBlock.nonce += nonceStep;
+        }
+
+        return hashes;
+    }
+
+    CryptoNote::BlockTemplate nonceBlock = block;
+
+    std::vector<std::vector<uint8_t>> rawHashingBlocks;
+    std::vector<const uint8_t *> data;
+    std::vector<size_t> lengths;
+
+    rawHashingBlocks.reserve(count);
+
+    for (size_t i = 0; i < count; i++)
+    {
+        rawHashingBlocks.push_back(getParentBlockHashingBinaryArray(nonceBlock, true));
+        data.push_back(rawHashingBlocks.back().data());
+        lengths.push_back(rawHashingBlocks.back().size());
+
+        nonceBlock.nonce += nonceStep;
+    }
+
+    std::vector<Crypto::Hash> hashes(count);
+
+    it->second(data.data(), lengths.data(), hashes.data(), count);
+
+    return hashes;
+}
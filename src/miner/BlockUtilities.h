@@ -24,3 +24,14 @@ Crypto::Hash getBlockHash(const CryptoNote::BlockTemplate &block);
 Crypto::Hash getMerkleRoot(const CryptoNote::BlockTemplate &block);
 
 Crypto::Hash getBlockLongHash(const CryptoNote::BlockTemplate &block);
+
+//RTcoin
+/* How many nonces getBlockLongHashes() should be asked for at once to get the
+   most hashes per second out of this machine */
+size_t getBlockLongHashBatchSize(const CryptoNote::BlockTemplate &block);
+
+/* The long hashes of block with the nonces block.nonce, block.nonce + nonceStep,
+   ... block.nonce + (count - 1) * nonceStep, hashed together where the hashing
+   algorithm supports it */
+std::vector<Crypto::Hash>
+    getBlockLongHashes(const CryptoNote::BlockTemplate &block, const uint32_t nonceStep, const size_t count);
@@ -0,0 +1,104 @@
+// Copyright (c) 2018-2020, The TurtleCoin Developers
+//
+// Please see the included LICENSE file for more information.
+
+//////////////////////////
+#include "CadencePolicy.h"
+//////////////////////////
+
+#include <algorithm>
+
+namespace Miner
+{
+    constexpr std::chrono::milliseconds CadencePolicy::NEVER;
+
+    CadencePolicy::CadencePolicy(const CryptoNote::MiningConfig &config):
+        m_cadence(config.cadence),
+        m_blockInterval(config.blockInterval),
+        m_poolThreshold(config.poolThreshold),
+        m_deadlineSlack(config.deadlineSlack)
+    {
+    }
+
+    std::chrono::milliseconds CadencePolicy::timeUntilDue(
+        const ChainState &state,
+        const uint64_t now,
+        const uint64_t lastBlockTime) const
+    {
+        if (state.poolSize == 0)
+        {
+            return NEVER;
+        }
+
+        switch (m_cadence)
+        {
+            case CryptoNote::BlockCadence::Interval:
+            {
+                return untilInterval(now, lastBlockTime);
+            }
+            case CryptoNote::BlockCadence::PoolSize:
+            {
+                if (state.poolSize >= m_poolThreshold)
+                {
+                    return std::chrono::milliseconds(0);
+                }
+
+                return untilInterval(now, lastBlockTime);
+            }
+            case CryptoNote::BlockCadence::Deadline:
+            {
+                /* Nothing in the pool has a deadline, and there's no interval
+                   to fall back on - don't leave them waiting forever */
+                if (state.earliestDeadline == 0 && m_blockInterval == 0)
+                {
+                    return std::chrono::milliseconds(0);
+                }
+
+                std::chrono::milliseconds wait = untilInterval(now, lastBlockTime);
+
+                if (state.earliestDeadline != 0)
+                {
+                    const uint64_t due = state.earliestDeadline - std::min(state.earliestDeadline, m_deadlineSlack);
+
+                    wait = std::min(wait, std::chrono::milliseconds(due - std::min(due, now)));
+                }
+
+                return wait;
+            }
+            case CryptoNote::BlockCadence::Adaptive:
+            {
+                /* Nothing in a hurry, and there's no interval to fall back
+                   on - don't leave them waiting forever */
+                if (state.sealAt == 0 && m_blockInterval == 0)
+                {
+                    return std::chrono::milliseconds(0);
+                }
+
+                std::chrono::milliseconds wait = untilInterval(now, lastBlockTime);
+
+                if (state.sealAt != 0)
+                {
+                    wait = std::min(wait, std::chrono::milliseconds(state.sealAt - std::min(state.sealAt, now)));
+                }
+
+                return wait;
+            }
+            default:
+            {
+                return std::chrono::milliseconds(0);
+            }
+        }
+    }
+
+    std::chrono::milliseconds CadencePolicy::untilInterval(const uint64_t now, const uint64_t lastBlockTime) const
+    {
+        if (m_blockInterval == 0)
+        {
+            return NEVER;
+        }
+
+        const uint64_t due = lastBlockTime + m_blockInterval;
+
+        return std::chrono::milliseconds(due - std::min(due, now));
+    }
+} // namespace Miner
@@ -0,0 +1,42 @@
+// Copyright (c) 2018-2020, The TurtleCoin Developers
+//
+// Please see the included LICENSE file for more information.
+
+#pragma once
+
+#include "ChainState.h"
+#include "MiningConfig.h"
+
+#include <chrono>
+
+namespace Miner
+{
+    //RTcoin
+    /* Decides when the next block should be produced. Faster cadences get
+       transactions into blocks sooner, at the cost of more, smaller blocks. */
+    class CadencePolicy
+    {
+      public:
+        CadencePolicy(const CryptoNote::MiningConfig &config);
+
+        /* How long until the next block is due, given the daemon state and
+           when we last produced a block (both unix milliseconds). Zero means
+           produce one now, NEVER means only a change in the chain or pool
+           can make one due. We never produce empty blocks. */
+        std::chrono::milliseconds
+            timeUntilDue(const ChainState &state, const uint64_t now, const uint64_t lastBlockTime) const;
+
+        static constexpr std::chrono::milliseconds NEVER = std::chrono::milliseconds::max();
+
+      private:
+        std::chrono::milliseconds untilInterval(const uint64_t now, const uint64_t lastBlockTime) const;
+
+        const CryptoNote::BlockCadence m_cadence;
+
+        const uint64_t m_blockInterval;
+
+        const uint64_t m_poolThreshold;
+
+        const uint64_t m_deadlineSlack;
+    };
+} // namespace Miner
@@ -0,0 +1,152 @@
+// Copyright (c) 2018-2020, The TurtleCoin Developers
+//
+// Please see the included LICENSE file for more information.
+
+//////////////////////////
+#include "ChainNotifier.h"
+//////////////////////////
+
+#include "rapidjson/document.h"
+#include "rapidjson/stringbuffer.h"
+#include "rapidjson/writer.h"
+
+#include <JsonHelper.h>
+#include <iostream>
+#include <utilities/ColouredMsg.h>
+
+namespace Miner
+{
+    namespace
+    {
+        /* How long each long poll waits for a change. Kept short so we notice
+           promptly when we are asked to stop. */
+        const uint64_t LONG_POLL_TIMEOUT = 1000;
+    } // namespace
+
+    ChainNotifier::ChainNotifier(
+        const std::string &daemonHost,
+        const uint16_t daemonPort,
+        const bool poll,
+        const size_t pollInterval,
+        std::function<void(const ChainState &)> callback):
+
+        m_httpClient(daemonHost.c_str(), daemonPort, 10 /* 10 second timeout */),
+        m_poll(poll),
+        m_pollInterval(pollInterval),
+        m_callback(callback)
+    {
+    }
+
+    ChainNotifier::~ChainNotifier()
+    {
+        stop();
+    }
+
+    void ChainNotifier::start()
+    {
+        m_stopped = false;
+        m_thread = std::thread(&ChainNotifier::notifyLoop, this);
+    }
+
+    void ChainNotifier::stop()
+    {
+        {
+            std::scoped_lock lock(m_mutex);
+            m_stopped = true;
+        }
+
+        m_stopping.notify_all();
+
+        if (m_thread.joinable())
+        {
+            m_thread.join();
+        }
+    }
+
+    void ChainNotifier::notifyLoop()
+    {
+        std::optional<uint64_t> lastVersion;
+
+        while (!m_stopped)
+        {
+            const auto state = m_poll ? requestChainState(m_httpClient, 0, 0)
+                                      : requestChainState(m_httpClient, lastVersion.value_or(0), LONG_POLL_TIMEOUT);
+
+            if (!state)
+            {
+                std::cout << WarningMsg("Failed to get chain state - Is your daemon open?\n");
+
+                sleep(std::chrono::seconds(1));
+                continue;
+            }
+
+            if (state->version != lastVersion)
+            {
+                lastVersion = state->version;
+                m_callback(*state);
+            }
+
+            if (m_poll)
+            {
+                sleep(std::chrono::seconds(m_pollInterval));
+            }
+        }
+    }
+
+    void ChainNotifier::sleep(const std::chrono::milliseconds duration)
+    {
+        std::unique_lock lock(m_mutex);
+
+        m_stopping.wait_for(lock, duration, [this]() { return m_stopped.load(); });
+    }
+
+    std::optional<ChainState> ChainNotifier::requestChainState(
+        httplib::Client &client,
+        const uint64_t knownVersion,
+        const uint64_t timeout)
+    {
+        rapidjson::StringBuffer sb;
+
+        rapidjson::Writer<rapidjson::StringBuffer> writer(sb);
+
+        writer.StartObject();
+        {
+            writer.Key("timeout");
+            writer.Uint64(timeout);
+
+            writer.Key("version");
+            writer.Uint64(knownVersion);
+        }
+        writer.EndObject();
+
+        const auto res = client.Post("/block/notify", sb.GetString(), "application/json");
+
+        if (!res || res->status != 200)
+        {
+            return std::nullopt;
+        }
+
+        rapidjson::Document jsonBody;
+
+        if (jsonBody.Parse(res->body.c_str()).HasParseError())
+        {
+            return std::nullopt;
+        }
+
+        ChainState state;
+
+        state.version = getUint64FromJSON(jsonBody, "version");
+        state.height = getUint64FromJSON(jsonBody, "height");
+        state.topBlockHash.fromJSON(getJsonValue(jsonBody, "hash"));
+        state.poolSize = getUint64FromJSON(jsonBody, "transactionsPoolSize");
+        state.earliestDeadline = getUint64FromJSON(jsonBody, "earliestDeadline");
+
+        /* Not sent by older daemons */
+        if (hasMember(jsonBody, "sealAt"))
+        {
+            state.sealAt = getUint64FromJSON(jsonBody, "sealAt");
+        }
+
+        return state;
+    }
+} // namespace Miner
@@ -0,0 +1,69 @@
+// Copyright (c) 2018-2020, The TurtleCoin Developers
+//
+// Please see the included LICENSE file for more information.
+
+#pragma once
+
+#include "ChainState.h"
+#include "httplib.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <thread>
+
+namespace Miner
+{
+    //RTcoin
+    /* Watches the daemon for new blocks and pool transactions on its own
+       connection and thread, and calls back whenever anything changes.
+
+       By default this long polls /block/notify, so the daemon pushes changes
+       to us as soon as they happen. In poll mode we ask every pollInterval
+       seconds instead. */
+    class ChainNotifier
+    {
+      public:
+        ChainNotifier(
+            const std::string &daemonHost,
+            const uint16_t daemonPort,
+            const bool poll,
+            const size_t pollInterval,
+            std::function<void(const ChainState &)> callback);
+
+        ~ChainNotifier();
+
+        void start();
+
+        void stop();
+
+        /* Returns as soon as the daemon state differs from knownVersion, or
+           the timeout (milliseconds) expires. nullopt if the request failed. */
+        static std::optional<ChainState>
+            requestChainState(httplib::Client &client, const uint64_t knownVersion, const uint64_t timeout);
+
+      private:
+        void notifyLoop();
+
+        /* Returns early if we are stopped */
+        void sleep(const std::chrono::milliseconds duration);
+
+        httplib::Client m_httpClient;
+
+        const bool m_poll;
+
+        const size_t m_pollInterval;
+
+        std::function<void(const ChainState &)> m_callback;
+
+        std::atomic<bool> m_stopped = true;
+
+        std::mutex m_mutex;
+
+        std::condition_variable m_stopping;
+
+        std::thread m_thread;
+    };
+} // namespace Miner
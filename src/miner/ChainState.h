@@ -0,0 +1,33 @@
+// Copyright (c) 2018-2020, The TurtleCoin Developers
+//
+// Please see the included LICENSE file for more information.
+
+#pragma once
+
+#include "CryptoTypes.h"
+
+#include <cstdint>
+
+namespace Miner
+{
+    //RTcoin
+    /* What the daemon last told us about its chain and pool, from /block/notify */
+    struct ChainState
+    {
+        /* Changes every time a block or pool transaction is added or removed */
+        uint64_t version = 0;
+
+        uint64_t height = 0;
+
+        Crypto::Hash topBlockHash;
+
+        uint64_t poolSize = 0;
+
+        /* Unix milliseconds, 0 if no pool transaction has a deadline */
+        uint64_t earliestDeadline = 0;
+
+        /* When the daemon's block cadence says the next block is due, unix
+           milliseconds, 0 if nothing is hurrying it along */
+        uint64_t sealAt = 0;
+    };
+} // namespace Miner
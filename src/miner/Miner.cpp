@@ -108,23 +108,34 @@ namespace CryptoNote
         {
             BlockTemplate block = blockTemplate;
 
+            //RTcoin
+            /* Hash as many nonces at once as the hashing algorithm does
+               quickest on this machine */
+            const size_t batchSize = getBlockLongHashBatchSize(block);
+
+            /* Don't reallocate the scratchpad for every nonce */
+            const Crypto::SlowHashArena arena;
+
             while (m_state == MiningState::MINING_IN_PROGRESS)
             {
-                Crypto::Hash hash = getBlockLongHash(block);
+                const std::vector<Crypto::Hash> hashes = getBlockLongHashes(block, nonceStep, batchSize);
 
-                //if (check_hash(hash, difficulty))
+                for (const auto &hash : hashes)
                 {
-                    if (!setStateBlockFound())
+                    //if (check_hash(hash, difficulty))
                     {
+                        if (!setStateBlockFound())
+                        {
+                            return;
+                        }
+
+                        m_block = block;
                         return;
                     }
-                    
-                    m_block = block;
-                    return;
-                }
 
-                //incrementHashCount();
-                //block.nonce += nonceStep;
+                    //incrementHashCount();
+                    //block.nonce += nonceStep;
+                }
             }
         }
         catch (const std::exception &e)
@@ -5,6 +5,8 @@
 
 #pragma once
 
+#include "ChainState.h"
+
 namespace Miner
 {
     enum class MinerEventType : uint8_t
@@ -12,10 +14,14 @@ namespace Miner
         BLOCK_MINED,
         BLOCKCHAIN_UPDATED,
         BLOCK_MINE_START,
+        TEMPLATE_READY,
     };
 
     struct MinerEvent
     {
         MinerEventType type;
+
+        /* Only set for BLOCKCHAIN_UPDATED */
+        ChainState chainState;
     };
 } // namespace Miner
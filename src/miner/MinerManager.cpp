@@ -17,6 +17,8 @@
 #include <common/TransactionExtra.h>
 #include <config/CryptoNoteConfig.h>
 #include <miner/BlockUtilities.h>
+#include <system/InterruptedException.h>
+#include <system/Timer.h>
 #include <utilities/ColouredMsg.h>
 #include <utilities/FormatTools.h>
 
@@ -24,6 +26,18 @@ namespace Miner
 {
     namespace
     {
+        /* How many times to wait for the daemon to apply the block we just
+           mined before giving up on prefetching the next template. Each wait
+           is a one second long poll. */
+        const size_t PREFETCH_ATTEMPTS = 5;
+
+        uint64_t nowMilliseconds()
+        {
+            return std::chrono::duration_cast<std::chrono::milliseconds>(
+                       std::chrono::system_clock::now().time_since_epoch())
+                .count();
+        }
+
         MinerEvent BlockMinedEvent()
         {
             MinerEvent event;
@@ -31,10 +45,11 @@ namespace Miner
             return event;
         }
 
-        MinerEvent BlockchainUpdatedEvent()
+        MinerEvent BlockchainUpdatedEvent(const ChainState &state)
         {
             MinerEvent event;
             event.type = MinerEventType::BLOCKCHAIN_UPDATED;
+            event.chainState = state;
             return event;
         }
 
@@ -45,6 +60,13 @@ namespace Miner
             return event;
         }
 
+        MinerEvent TemplateReadyEvent()
+        {
+            MinerEvent event;
+            event.type = MinerEventType::TEMPLATE_READY;
+            return event;
+        }
+
         void adjustMergeMiningTag(CryptoNote::BlockTemplate &blockTemplate)
         {
             if (blockTemplate.majorVersion >= CryptoNote::BLOCK_MAJOR_VERSION_2)
@@ -68,28 +90,48 @@ namespace Miner
         const CryptoNote::MiningConfig &config,
         const std::shared_ptr<httplib::Client> httpClient):
 
+        m_dispatcher(dispatcher),
         m_contextGroup(dispatcher),
         m_config(config),
         m_miner(dispatcher),
-        m_blockchainMonitor(dispatcher, m_config.scanPeriod, httpClient),
-        m_blockchainChecker(dispatcher, m_config.checkTime),
+        m_cadencePolicy(m_config),
+        m_chainNotifier(
+            m_config.daemonHost,
+            m_config.daemonPort,
+            m_config.poll,
+            m_config.scanPeriod,
+            [this](const ChainState &state)
+            {
+                /* Called on the notifier thread - hand it over to the dispatcher */
+                m_dispatcher.remoteSpawn([this, state]() { pushEvent(BlockchainUpdatedEvent(state)); });
+            }),
+        m_cadenceTimer(dispatcher),
+        m_prefetchClient(m_config.daemonHost.c_str(), m_config.daemonPort, 10 /* 10 second timeout */),
         m_eventOccurred(dispatcher),
         m_lastBlockTimestamp(0),
         m_httpClient(httpClient)
     {
     }
 
-    void MinerManager::start()
+    MinerManager::~MinerManager()
     {
-        //CryptoNote::BlockMiningParameters params = requestMiningParameters();
-        //adjustBlockTemplate(params.blockTemplate);
+        m_chainNotifier.stop();
 
+        if (m_prefetchThread.joinable())
+        {
+            m_prefetchThread.join();
+        }
+    }
+
+    void MinerManager::start()
+    {
         isRunning = true;
 
-        //startBlockchainMonitoring();
         std::thread reporter(std::bind(&MinerManager ::printHashRate, this));
-        startBlockchainChecker();
-        //startMining(params);
+
+        /* Everything is driven by the daemon telling us the chain or pool
+           has changed, and the cadence timer */
+        m_chainNotifier.start();
 
         eventLoop();
         isRunning = false;
@@ -123,23 +165,45 @@ namespace Miner
 
             switch (event.type)
             {
+                case MinerEventType::BLOCKCHAIN_UPDATED:
+                {
+                    m_chainState = event.chainState;
+
+                    maybeStartMining();
+
+                    break;
+                }
                 case MinerEventType::BLOCK_MINE_START:
                 {
-                    CryptoNote::BlockMiningParameters params = requestMiningParameters();
-                    adjustBlockTemplate(params.blockTemplate);
+                    maybeStartMining();
+
+                    break;
+                }
+                case MinerEventType::TEMPLATE_READY:
+                {
+                    m_prefetchInFlight = false;
 
-                    if (!params.isEmpty)
+                    if (m_waitingForTemplate)
                     {
-                        //startBlockchainMonitoring();
-                        startMining(params);
+                        m_waitingForTemplate = false;
+
+                        /* We decided a block was due from the chain state
+                           before our last one. The template comes with the
+                           state after it, so check again - this takes the
+                           template if so, or fetches one if it failed or was
+                           empty. */
+                        m_mining = false;
+                        maybeStartMining();
                     }
-                    
+
                     break;
                 }
                 case MinerEventType::BLOCK_MINED:
                 {
-                    //stopBlockchainMonitoring();
-                    
+                    /* Start fetching the next template on the other
+                       connection, whilst we submit this one */
+                    startPrefetch(m_minedBlock.previousBlockHash);
+
                     if (submitBlock(m_minedBlock))
                     {
                         m_lastBlockTimestamp = m_minedBlock.timestamp;
@@ -152,111 +216,203 @@ namespace Miner
                         }
                     }
 
-                    CryptoNote::BlockMiningParameters params = requestMiningParameters();
-                    adjustBlockTemplate(params.blockTemplate);
+                    m_mining = false;
+                    m_lastBlockTime = nowMilliseconds();
 
-                    if (!params.isEmpty)
-                    {
-                        startMining(params);
-                    }
+                    maybeStartMining();
 
-                    //startBlockchainMonitoring();
-                    //startMining(params);
                     break;
                 }
-                /*
-                case MinerEventType::BLOCKCHAIN_UPDATED:
-                {
-                    stopMining();
-                    stopBlockchainMonitoring();
-                    CryptoNote::BlockMiningParameters params = requestMiningParameters();
-                    adjustBlockTemplate(params.blockTemplate);
-                    startBlockchainMonitoring();
-                    startMining(params);
-                    break;
-                }
-                */
             }
         }
     }
 
-    MinerEvent MinerManager::waitEvent()
+    void MinerManager::maybeStartMining()
     {
-        while (m_events.empty())
+        if (m_mining)
         {
-            m_eventOccurred.wait();
-            m_eventOccurred.clear();
+            /* We'll check again once this block is done */
+            return;
         }
 
-        MinerEvent event = std::move(m_events.front());
-        m_events.pop();
+        const auto wait = m_cadencePolicy.timeUntilDue(m_chainState, nowMilliseconds(), m_lastBlockTime);
 
-        return event;
-    }
+        if (wait.count() != 0)
+        {
+            /* Check again when it will be due, or every checkTime seconds,
+               in case we missed something */
+            scheduleCadenceCheck(std::min<std::chrono::milliseconds>(wait, std::chrono::seconds(m_config.checkTime)));
+            return;
+        }
 
-    void MinerManager::pushEvent(MinerEvent &&event)
-    {
-        m_events.push(std::move(event));
-        m_eventOccurred.set();
+        m_mining = true;
+
+        if (auto params = takePrefetchedTemplate())
+        {
+            startMining(*params);
+            return;
+        }
+
+        /* It'll be here shortly, and probably sooner than we could fetch one */
+        if (m_prefetchInFlight)
+        {
+            m_waitingForTemplate = true;
+            return;
+        }
+
+        CryptoNote::BlockMiningParameters params = requestMiningParameters();
+
+        if (params.isEmpty)
+        {
+            m_mining = false;
+            return;
+        }
+
+        startMining(params);
     }
 
-    void MinerManager::startMining(const CryptoNote::BlockMiningParameters &params)
+    void MinerManager::scheduleCadenceCheck(const std::chrono::milliseconds delay)
     {
-        m_contextGroup.spawn(
-            [this, params]()
+        m_cadenceTimer.interrupt();
+        m_cadenceTimer.wait();
+
+        m_cadenceTimer.spawn(
+            [this, delay]()
             {
                 try
                 {
-                    m_minedBlock = m_miner.mine(params, m_config.threadCount);
-                    pushEvent(BlockMinedEvent());
+                    System::Timer timer(m_dispatcher);
+                    timer.sleep(delay);
+                    pushEvent(BlockMineStartEvent());
                 }
-                catch (const std::exception &)
+                catch (const System::InterruptedException &)
                 {
                 }
             });
     }
 
-    void MinerManager::stopMining()
+    void MinerManager::startPrefetch(const Crypto::Hash &previousBlockHash)
     {
-        m_miner.stop();
+        if (m_prefetchThread.joinable())
+        {
+            m_prefetchThread.join();
+        }
+
+        m_prefetchInFlight = true;
+        m_prefetchedTemplate = std::nullopt;
+
+        m_prefetchThread =
+            std::thread(&MinerManager::prefetchTemplate, this, previousBlockHash, m_chainState.version);
     }
 
-    void MinerManager::startBlockchainChecker()
+    void MinerManager::prefetchTemplate(const Crypto::Hash previousBlockHash, const uint64_t knownVersion)
     {
-        m_contextGroup.spawn(
-            [this]()
+        std::optional<PrefetchedTemplate> prefetched;
+
+        uint64_t version = knownVersion;
+
+        /* Wait for the daemon to move past the block our template was built
+           on - usually because it has just added the block we are submitting
+           on the other connection */
+        for (size_t i = 0; i < PREFETCH_ATTEMPTS; i++)
+        {
+            const auto state = ChainNotifier::requestChainState(m_prefetchClient, version, 1000);
+
+            if (!state)
             {
-                try
+                break;
+            }
+
+            if (state->topBlockHash != previousBlockHash)
+            {
+                if (auto params = tryRequestMiningParameters(m_prefetchClient))
                 {
-                    pushEvent(BlockMineStartEvent());
-                    
-                    while (1)
-                    {
-                        m_blockchainChecker.waitBlockchainCheckerExpired();
+                    prefetched = PrefetchedTemplate {*params, *state, nowMilliseconds()};
+                }
 
-                        if (m_blockchainChecker.getCheckerStatus())
-                        {
-                            break;
-                        }
+                break;
+            }
 
-                        pushEvent(BlockMineStartEvent());
-                    }
-                }
-                catch (const std::exception &)
+            version = state->version;
+        }
+
+        m_dispatcher.remoteSpawn(
+            [this, prefetched]()
+            {
+                /* We may see the new top block here before the notifier
+                   tells us about it */
+                if (prefetched && prefetched->chainState.version > m_chainState.version)
                 {
+                    m_chainState = prefetched->chainState;
                 }
+
+                m_prefetchedTemplate = prefetched;
+                pushEvent(TemplateReadyEvent());
             });
     }
 
-    void MinerManager::startBlockchainMonitoring()
+    std::optional<CryptoNote::BlockMiningParameters> MinerManager::takePrefetchedTemplate()
+    {
+        if (!m_prefetchedTemplate)
+        {
+            return std::nullopt;
+        }
+
+        const PrefetchedTemplate prefetched = *m_prefetchedTemplate;
+
+        m_prefetchedTemplate = std::nullopt;
+
+        /* Built on a block that's no longer the top one, however recent it
+           is - anything mined on it would be orphaned */
+        if (prefetched.params.blockTemplate.previousBlockHash != m_chainState.topBlockHash)
+        {
+            return std::nullopt;
+        }
+
+        /* Use it if nothing has changed since it was fetched, or it's recent
+           enough that we won't be missing many pool transactions */
+        const bool fresh = prefetched.chainState.version == m_chainState.version
+                           || nowMilliseconds() - prefetched.fetchedAt <= m_config.maxTemplateAge;
+
+        if (!fresh || prefetched.params.isEmpty)
+        {
+            return std::nullopt;
+        }
+
+        return prefetched.params;
+    }
+
+    MinerEvent MinerManager::waitEvent()
+    {
+        while (m_events.empty())
+        {
+            m_eventOccurred.wait();
+            m_eventOccurred.clear();
+        }
+
+        MinerEvent event = std::move(m_events.front());
+        m_events.pop();
+
+        return event;
+    }
+
+    void MinerManager::pushEvent(MinerEvent &&event)
     {
+        m_events.push(std::move(event));
+        m_eventOccurred.set();
+    }
+
+    void MinerManager::startMining(CryptoNote::BlockMiningParameters params)
+    {
+        adjustBlockTemplate(params.blockTemplate);
+
         m_contextGroup.spawn(
-            [this]()
+            [this, params]()
             {
-                try 
+                try
                 {
-                    m_blockchainMonitor.waitBlockchainUpdate();
-                    pushEvent(BlockchainUpdatedEvent());
+                    m_minedBlock = m_miner.mine(params, m_config.threadCount);
+                    pushEvent(BlockMinedEvent());
                 }
                 catch (const std::exception &)
                 {
@@ -264,9 +420,9 @@ namespace Miner
             });
     }
 
-    void MinerManager::stopBlockchainMonitoring()
+    void MinerManager::stopMining()
     {
-        m_blockchainMonitor.stop();
+        m_miner.stop();
     }
 
     bool MinerManager::submitBlock(const CryptoNote::BlockTemplate &minedBlock)
@@ -296,74 +452,82 @@ namespace Miner
     {
         while (true)
         {
-            rapidjson::StringBuffer sb;
+            if (auto params = tryRequestMiningParameters(*m_httpClient))
+            {
+                return *params;
+            }
 
-            rapidjson::Writer<rapidjson::StringBuffer> writer(sb);
+            std::this_thread::sleep_for(std::chrono::seconds(1));
+        }
+    }
 
-            writer.StartObject();
-            {
-                writer.Key("address");
-                writer.String(m_config.miningAddress);
+    std::optional<CryptoNote::BlockMiningParameters>
+        MinerManager::tryRequestMiningParameters(httplib::Client &client) const
+    {
+        rapidjson::StringBuffer sb;
 
-                writer.Key("reserveSize");
-                writer.Uint(0);
-            }
-            writer.EndObject();
+        rapidjson::Writer<rapidjson::StringBuffer> writer(sb);
 
-            auto res = m_httpClient->Post("/block/template", sb.GetString(), "application/json");
+        writer.StartObject();
+        {
+            writer.Key("address");
+            writer.String(m_config.miningAddress);
 
-            if (!res)
-            {
-                std::cout << WarningMsg("Failed to get block template - Is your daemon open?\n");
+            writer.Key("reserveSize");
+            writer.Uint(0);
+        }
+        writer.EndObject();
 
-                std::this_thread::sleep_for(std::chrono::seconds(1));
-                continue;
-            }
+        auto res = client.Post("/block/template", sb.GetString(), "application/json");
 
-            if (res->status != 201)
-            {
-                std::stringstream stream;
+        if (!res)
+        {
+            std::cout << WarningMsg("Failed to get block template - Is your daemon open?\n");
 
-                stream << "Failed to get block template - received unexpected http "
-                       << "code from server: " << res->status << std::endl;
+            return std::nullopt;
+        }
 
-                std::cout << WarningMsg(stream.str()) << std::endl;
+        if (res->status != 201)
+        {
+            std::stringstream stream;
 
-                std::this_thread::sleep_for(std::chrono::seconds(1));
-                continue;
-            }
+            stream << "Failed to get block template - received unexpected http "
+                   << "code from server: " << res->status << std::endl;
 
-            rapidjson::Document jsonBody;
+            std::cout << WarningMsg(stream.str()) << std::endl;
 
-            if (jsonBody.Parse(res->body.c_str()).HasParseError())
-            {
-                std::stringstream stream;
+            return std::nullopt;
+        }
 
-                stream << "Failed to parse block template from daemon. Received data:\n" << res->body << std::endl;
+        rapidjson::Document jsonBody;
 
-                std::cout << WarningMsg(stream.str());
+        if (jsonBody.Parse(res->body.c_str()).HasParseError())
+        {
+            std::stringstream stream;
 
-                std::this_thread::sleep_for(std::chrono::seconds(1));
+            stream << "Failed to parse block template from daemon. Received data:\n" << res->body << std::endl;
 
-                continue;
-            }
+            std::cout << WarningMsg(stream.str());
 
-            CryptoNote::BlockMiningParameters params;
+            return std::nullopt;
+        }
 
-            params.difficulty = getUint64FromJSON(jsonBody, "difficulty");
-            
-            std::vector<uint8_t> blob = Common::fromHex(getStringFromJSON(jsonBody, "blob"));
+        CryptoNote::BlockMiningParameters params;
 
-            if (!fromBinaryArray(params.blockTemplate, blob))
-            {
-                std::cout << WarningMsg("Couldn't parse block template from daemon.") << std::endl;
+        params.difficulty = getUint64FromJSON(jsonBody, "difficulty");
 
-                std::this_thread::sleep_for(std::chrono::seconds(1));
-                continue;
-            }
+        params.isEmpty = getBoolFromJSON(jsonBody, "isEmpty");
+
+        std::vector<uint8_t> blob = Common::fromHex(getStringFromJSON(jsonBody, "blob"));
 
-            return params;
+        if (!fromBinaryArray(params.blockTemplate, blob))
+        {
+            std::cout << WarningMsg("Couldn't parse block template from daemon.") << std::endl;
+
+            return std::nullopt;
         }
+
+        return params;
     }
 
     void MinerManager::adjustBlockTemplate(CryptoNote::BlockTemplate &blockTemplate) const
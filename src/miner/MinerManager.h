@@ -6,16 +6,18 @@
 
 #pragma once
 
-#include "BlockchainMonitor.h"
-#include "BlockchainChecker.h"
+#include "CadencePolicy.h"
+#include "ChainNotifier.h"
 #include "Miner.h"
 #include "MinerEvent.h"
 #include "MiningConfig.h"
 #include "logging/LoggerRef.h"
 
+#include <optional>
 #include <queue>
 #include <system/ContextGroup.h>
 #include <system/Event.h>
+#include <thread>
 
 namespace System
 {
@@ -32,18 +34,61 @@ namespace Miner
             const CryptoNote::MiningConfig &config,
             const std::shared_ptr<httplib::Client> httpClient);
 
+        ~MinerManager();
+
         void start();
 
       private:
+        /* A block template fetched ahead of time, while we were submitting the
+           previous block */
+        struct PrefetchedTemplate
+        {
+            CryptoNote::BlockMiningParameters params;
+
+            /* The daemon's chain state when the template was fetched */
+            ChainState chainState;
+
+            /* Unix milliseconds */
+            uint64_t fetchedAt;
+        };
+
+        System::Dispatcher &m_dispatcher;
+
         System::ContextGroup m_contextGroup;
 
         CryptoNote::MiningConfig m_config;
 
         CryptoNote::Miner m_miner;
 
-        BlockchainMonitor m_blockchainMonitor;
+        //RTcoin
+        CadencePolicy m_cadencePolicy;
+
+        ChainNotifier m_chainNotifier;
+
+        /* Latest state pushed to us by the daemon */
+        ChainState m_chainState;
+
+        /* Wakes us up when the cadence policy says a block is due */
+        System::ContextGroup m_cadenceTimer;
+
+        /* Separate connection, so we can fetch the next template whilst the
+           main connection is busy submitting a block */
+        httplib::Client m_prefetchClient;
 
-        BlockchainChecker m_blockchainChecker;
+        std::thread m_prefetchThread;
+
+        std::optional<PrefetchedTemplate> m_prefetchedTemplate;
+
+        bool m_mining = false;
+
+        bool m_prefetchInFlight = false;
+
+        /* A block is due, but we are waiting for the prefetch to finish
+           rather than fetching a template ourselves */
+        bool m_waitingForTemplate = false;
+
+        /* When we last produced a block, unix milliseconds */
+        uint64_t m_lastBlockTime = 0;
 
         System::Event m_eventOccurred;
 
@@ -65,20 +110,28 @@ namespace Miner
 
         void printHashRate();
 
-        void startMining(const CryptoNote::BlockMiningParameters &params);
+        void startMining(CryptoNote::BlockMiningParameters params);
 
         void stopMining();
 
-        void startBlockchainMonitoring();
+        /* Starts mining if the cadence policy says a block is due, otherwise
+           sets a timer for when it will be */
+        void maybeStartMining();
+
+        void scheduleCadenceCheck(const std::chrono::milliseconds delay);
 
-        void startBlockchainChecker();
+        void startPrefetch(const Crypto::Hash &previousBlockHash);
 
-        void stopBlockchainMonitoring();
+        void prefetchTemplate(const Crypto::Hash previousBlockHash, const uint64_t knownVersion);
+
+        std::optional<CryptoNote::BlockMiningParameters> takePrefetchedTemplate();
 
         bool submitBlock(const CryptoNote::BlockTemplate &minedBlock);
 
         CryptoNote::BlockMiningParameters requestMiningParameters();
 
+        std::optional<CryptoNote::BlockMiningParameters> tryRequestMiningParameters(httplib::Client &client) const;
+
         void adjustBlockTemplate(CryptoNote::BlockTemplate &blockTemplate) const;
     };
 
@@ -30,7 +30,29 @@ namespace CryptoNote
     namespace
     {
         const size_t CONCURRENCY_LEVEL = std::thread::hardware_concurrency();
-    }
+
+        BlockCadence parseCadence(const std::string &str)
+        {
+            if (str == "interval")
+            {
+                return BlockCadence::Interval;
+            }
+            else if (str == "pool-size")
+            {
+                return BlockCadence::PoolSize;
+            }
+            else if (str == "deadline")
+            {
+                return BlockCadence::Deadline;
+            }
+            else if (str == "adaptive")
+            {
+                return BlockCadence::Adaptive;
+            }
+
+            throw std::runtime_error("--cadence must be one of interval, pool-size, deadline, adaptive");
+        }
+    } // namespace
 
     MiningConfig::MiningConfig(): help(false), version(false) {}
 
@@ -38,6 +60,8 @@ namespace CryptoNote
     {
         cxxopts::Options options(argv[0], getProjectCLIHeader());
 
+        std::string cadenceStr;
+
         options.add_options("Core")(
             "help", "Display this help message", cxxopts::value<bool>(help)->implicit_value("true"))(
             "version",
@@ -61,14 +85,40 @@ namespace CryptoNote
             "scan-time",
             "Blockchain polling interval (seconds). How often miner will check the Blockchain for updates",
             cxxopts::value<size_t>(scanPeriod)->default_value("1"),
-            "#");
+            "#")(
+            "poll",
+            "Poll the daemon every --scan-time seconds, instead of having the daemon notify us of new blocks and "
+            "transactions",
+            cxxopts::value<bool>(poll)->default_value("false")->implicit_value("true"));
 
         options.add_options("Mining")(
             "master", "Only master can mine blocks", cxxopts::value<bool>(master)->default_value("false")->implicit_value("true"))(
             "checkTime",
-            "Mine every checktime period",
+            "Re-check whether a block is due at least this often (seconds), even if nothing has changed",
             cxxopts::value<size_t>(checkTime)->default_value("10"),
             "#")(
+            "cadence",
+            "When to produce the next block: interval, pool-size, deadline or adaptive",
+            cxxopts::value<std::string>(cadenceStr)->default_value("pool-size"),
+            "<policy>")(
+            "block-interval",
+            "Milliseconds between blocks for the interval cadence. The longest to wait between blocks for the "
+            "pool-size, deadline and adaptive cadences, 0 to wait indefinitely",
+            cxxopts::value<uint64_t>(blockInterval)->default_value("0"),
+            "#")(
+            "pool-threshold",
+            "Produce a block once the pool holds this many transactions, for the pool-size cadence",
+            cxxopts::value<uint64_t>(poolThreshold)->default_value("1"),
+            "#")(
+            "deadline-slack",
+            "Produce a block this many milliseconds before the earliest deadline in the pool, for the deadline "
+            "cadence",
+            cxxopts::value<uint64_t>(deadlineSlack)->default_value("500"),
+            "#")(
+            "max-template-age",
+            "Discard a prefetched block template older than this many milliseconds if the pool has changed since",
+            cxxopts::value<uint64_t>(maxTemplateAge)->default_value("50"),
+            "#")(
             "address", "The valid CryptoNote miner's address", cxxopts::value<std::string>(miningAddress), "<address>")(
             "block-timestamp-interval",
             "Timestamp incremental step for each subsequent block. May be set only if --first-block-timestamp has been "
@@ -154,6 +204,23 @@ namespace CryptoNote
             throw std::runtime_error("--scan-time must not be zero");
         }
 
+        if (checkTime == 0)
+        {
+            throw std::runtime_error("--checkTime must not be zero");
+        }
+
+        cadence = parseCadence(cadenceStr);
+
+        if (cadence == BlockCadence::Interval && blockInterval == 0)
+        {
+            throw std::runtime_error("--block-interval must not be zero with the interval cadence");
+        }
+
+        if (poolThreshold == 0)
+        {
+            throw std::runtime_error("--pool-threshold must not be zero");
+        }
+
         if (firstBlockTimestamp == 0 && blockTimestampInterval != 0)
         {
             throw std::runtime_error(
@@ -12,6 +12,26 @@
 
 namespace CryptoNote
 {
+    //RTcoin
+    /* When to produce the next block */
+    enum class BlockCadence
+    {
+        /* Every blockInterval milliseconds */
+        Interval,
+
+        /* As soon as the pool holds poolThreshold transactions, or
+           blockInterval milliseconds have passed, if non zero */
+        PoolSize,
+
+        /* deadlineSlack milliseconds before the earliest deadline in the
+           pool, or blockInterval milliseconds have passed, if non zero */
+        Deadline,
+
+        /* When the daemon's block cadence controller says, or blockInterval
+           milliseconds have passed, if non zero */
+        Adaptive
+    };
+
     struct MiningConfig
     {
         MiningConfig();
@@ -38,6 +58,24 @@ namespace CryptoNote
 
         int64_t blockTimestampInterval;
 
+        BlockCadence cadence;
+
+        /* Milliseconds */
+        uint64_t blockInterval;
+
+        uint64_t poolThreshold;
+
+        /* Milliseconds */
+        uint64_t deadlineSlack;
+
+        /* Don't use a prefetched block template older than this, unless the
+           pool hasn't changed since it was fetched. Milliseconds. */
+        uint64_t maxTemplateAge;
+
+        /* Poll the daemon every scanPeriod rather than waiting for it to
+           notify us of changes */
+        bool poll;
+
         bool master;
 
         bool help;
@@ -5,7 +5,11 @@
 
 #include "LevinProtocol.h"
 
+#include <array>
+#include <atomic>
+#include <string>
 #include <system/TcpConnection.h>
+#include <utilities/Metrics.h>
 
 using namespace CryptoNote;
 
@@ -33,6 +37,81 @@ namespace
     };
 #pragma pack(pop)
 
+    //RTcoin
+    /* Traffic counters for one command */
+    struct CommandMetrics
+    {
+        explicit CommandMetrics(const std::string &command):
+            receivedBytes(Metrics::registry().counter(
+                "p2p_received_bytes_total", "Bytes received from peers, headers included", {{"command", command}})),
+            sentBytes(Metrics::registry().counter(
+                "p2p_sent_bytes_total", "Bytes sent to peers, headers included", {{"command", command}})),
+            receivedMessages(Metrics::registry().counter(
+                "p2p_received_messages_total", "Messages received from peers", {{"command", command}})),
+            sentMessages(Metrics::registry().counter(
+                "p2p_sent_messages_total", "Messages sent to peers", {{"command", command}}))
+        {
+        }
+
+        Metrics::Counter &receivedBytes;
+
+        Metrics::Counter &sentBytes;
+
+        Metrics::Counter &receivedMessages;
+
+        Metrics::Counter &sentMessages;
+    };
+
+    /* P2P and protocol commands each get this many ids from their pool base */
+    const uint32_t COMMANDS_PER_POOL = 32;
+
+    const std::array<uint32_t, 2> COMMAND_POOLS = {1000, 2000};
+
+    /* Command ids come from peers, so anything outside the known pools shares
+       the one slot, rather than making a new metric per id */
+    const size_t UNKNOWN_COMMAND_SLOT = COMMAND_POOLS.size() * COMMANDS_PER_POOL;
+
+    CommandMetrics &commandMetrics(const uint32_t command)
+    {
+        static std::array<std::atomic<CommandMetrics *>, UNKNOWN_COMMAND_SLOT + 1> slots {};
+
+        size_t slot = UNKNOWN_COMMAND_SLOT;
+
+        for (size_t i = 0; i < COMMAND_POOLS.size(); i++)
+        {
+            if (command >= COMMAND_POOLS[i] && command < COMMAND_POOLS[i] + COMMANDS_PER_POOL)
+            {
+                slot = i * COMMANDS_PER_POOL + (command - COMMAND_POOLS[i]);
+            }
+        }
+
+        CommandMetrics *metrics = slots[slot].load(std::memory_order_acquire);
+
+        if (metrics != nullptr)
+        {
+            return *metrics;
+        }
+
+        auto created = new CommandMetrics(slot == UNKNOWN_COMMAND_SLOT ? "unknown" : std::to_string(command));
+
+        /* Another thread may have got there first - both point at the same
+           counters in the registry, so just drop ours */
+        if (!slots[slot].compare_exchange_strong(metrics, created, std::memory_order_acq_rel))
+        {
+            delete created;
+            return *metrics;
+        }
+
+        return *created;
+    }
+
+    void countSent(const uint32_t command, const uint64_t bytes)
+    {
+        CommandMetrics &metrics = commandMetrics(command);
+
+        metrics.sentBytes.add(bytes);
+        metrics.sentMessages.add();
+    }
 } // namespace
 
 bool LevinProtocol::Command::needReply() const
@@ -61,6 +140,8 @@ void LevinProtocol::sendMessage(uint32_t command, const BinaryArray &out, bool n
     stream.writeSome(out.data(), out.size());
 
     writeStrict(writeBuffer.data(), writeBuffer.size());
+
+    countSent(command, writeBuffer.size());
 }
 
 bool LevinProtocol::readCommand(Command &cmd)
@@ -98,6 +179,11 @@ bool LevinProtocol::readCommand(Command &cmd)
     cmd.isNotify = !head.m_have_to_return_data;
     cmd.isResponse = (head.m_flags & LEVIN_PACKET_RESPONSE) == LEVIN_PACKET_RESPONSE;
 
+    CommandMetrics &metrics = commandMetrics(cmd.command);
+
+    metrics.receivedBytes.add(sizeof(head) + head.m_cb);
+    metrics.receivedMessages.add();
+
     return true;
 }
 
@@ -120,6 +206,8 @@ void LevinProtocol::sendReply(uint32_t command, const BinaryArray &out, int32_t
     stream.writeSome(out.data(), out.size());
 
     writeStrict(writeBuffer.data(), writeBuffer.size());
+
+    countSent(command, writeBuffer.size());
 }
 
 void LevinProtocol::writeStrict(const uint8_t *ptr, size_t size)
@@ -39,6 +39,7 @@
 #include <boost/uuid/uuid_io.hpp>
 #include <config/CryptoNoteConfig.h>
 #include <crypto/random.h>
+#include <cryptonoteprotocol/CryptoNoteProtocolDefinitions.h>
 #include <fstream>
 #include <miniupnpc/miniupnpc.h>
 #include <miniupnpc/upnpcommands.h>
@@ -50,6 +51,8 @@
 #include <system/Ipv4Resolver.h>
 #include <system/TcpConnector.h>
 #include <system/TcpListener.h>
+#include <utilities/MemoryBudget.h>
+#include <utilities/Tracing.h>
 
 using namespace Common;
 using namespace Logging;
@@ -125,6 +128,41 @@ namespace
         }
     }
 
+    //RTcoin
+    /* Span names have to outlive the span, so map the command ids we know to
+       literals */
+    const char *commandSpanName(const uint32_t command)
+    {
+        switch (command)
+        {
+            case COMMAND_HANDSHAKE::ID:
+                return "handshake";
+            case COMMAND_TIMED_SYNC::ID:
+                return "timedSync";
+            case COMMAND_PING::ID:
+                return "ping";
+            case NOTIFY_NEW_BLOCK::ID:
+                return "newBlock";
+            case NOTIFY_NEW_TRANSACTIONS::ID:
+                return "newTransactions";
+            case NOTIFY_REQUEST_GET_OBJECTS::ID:
+                return "requestGetObjects";
+            case NOTIFY_RESPONSE_GET_OBJECTS::ID:
+                return "responseGetObjects";
+            case NOTIFY_REQUEST_CHAIN::ID:
+                return "requestChain";
+            case NOTIFY_RESPONSE_CHAIN_ENTRY::ID:
+                return "responseChainEntry";
+            case NOTIFY_REQUEST_TX_POOL::ID:
+                return "requestTxPool";
+            case NOTIFY_NEW_LITE_BLOCK::ID:
+                return "newLiteBlock";
+            case NOTIFY_MISSING_TXS::ID:
+                return "missingTxs";
+            default:
+                return "unknownCommand";
+        }
+    }
 } // namespace
 
 namespace CryptoNote
@@ -152,17 +190,35 @@ namespace CryptoNote
     // P2pConnectionContext implementation
     //-----------------------------------------------------------------------------------
 
+    //RTcoin
+    P2pConnectionContext::~P2pConnectionContext()
+    {
+        MemoryBudget::budget().add(MemoryBudget::Subsystem::P2PWriteQueues, -static_cast<int64_t>(writeQueueSize));
+    }
+
     bool P2pConnectionContext::pushMessage(P2pMessage &&msg)
     {
-        writeQueueSize += msg.size();
+        auto &budget = MemoryBudget::budget();
+
+        const size_t messageSize = msg.size();
+
+        /* Under memory pressure, the peers slowest to read what we send them
+           are the first to go */
+        const bool overAllowance = budget.usage(MemoryBudget::Subsystem::P2PWriteQueues) + messageSize
+                                   > budget.allowance(MemoryBudget::Subsystem::P2PWriteQueues);
 
-        if (writeQueueSize > P2P_CONNECTION_MAX_WRITE_BUFFER_SIZE)
+        if (writeQueueSize + messageSize > P2P_CONNECTION_MAX_WRITE_BUFFER_SIZE
+            || (overAllowance && writeQueueSize + messageSize > P2P_CONNECTION_LOW_MEMORY_WRITE_BUFFER_SIZE))
         {
             logger(DEBUGGING) << *this << "Write queue overflows. Interrupt connection";
             interrupt();
             return false;
         }
 
+        writeQueueSize += messageSize;
+
+        budget.add(MemoryBudget::Subsystem::P2PWriteQueues, static_cast<int64_t>(messageSize));
+
         writeQueue.push_back(std::move(msg));
         queueEvent.set();
         return true;
@@ -179,6 +235,7 @@ namespace CryptoNote
 
         std::vector<P2pMessage> msgs(std::move(writeQueue));
         writeQueue.clear();
+        MemoryBudget::budget().add(MemoryBudget::Subsystem::P2PWriteQueues, -static_cast<int64_t>(writeQueueSize));
         writeQueueSize = 0;
         writeOperationStartTime = Clock::now();
         queueEvent.clear();
@@ -283,6 +340,9 @@ namespace CryptoNote
         P2pConnectionContext &ctx,
         bool &handled)
     {
+        //RTcoin
+        TRACE_SPAN("p2p", commandSpanName(cmd.command));
+
         int ret = 0;
         handled = true;
 
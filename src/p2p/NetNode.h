@@ -108,6 +108,9 @@ namespace CryptoNote
         {
         }
 
+        //RTcoin
+        ~P2pConnectionContext();
+
         bool pushMessage(P2pMessage &&msg);
 
         std::vector<P2pMessage> popBuffer();
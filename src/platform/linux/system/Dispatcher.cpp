@@ -9,6 +9,7 @@
 
 #include <cassert>
 #include <fcntl.h>
+#include <pthread.h>
 #include <stdexcept>
 #include <string.h>
 #include <sys/epoll.h>
@@ -16,6 +17,7 @@
 #include <sys/timerfd.h>
 #include <ucontext.h>
 #include <unistd.h>
+#include <utilities/Metrics.h>
 
 namespace System
 {
@@ -52,6 +54,25 @@ namespace System
 
         const size_t STACK_SIZE = 64 * 1024;
 
+        //RTcoin
+        /* Tracks how many remotely spawned procedures are waiting, and how long
+           each waited before the dispatcher ran it */
+        std::function<void()> timeRemoteSpawn(std::function<void()> &&procedure)
+        {
+            static Metrics::Gauge &queueDepth = Metrics::registry().gauge(
+                "dispatcher_remote_spawn_queue_depth", "Procedures spawned from other threads, not yet run");
+
+            static LatencyHistogram &waitTime = Metrics::registry().histogram(
+                "dispatcher_remote_spawn_wait_microseconds", "Time procedures spawned from other threads waited to run");
+
+            queueDepth.add(1);
+
+            return [procedure = std::move(procedure), start = std::chrono::steady_clock::now()]() {
+                queueDepth.add(-1);
+                waitTime.record(Metrics::microsecondsSince(start));
+                procedure();
+            };
+        }
     }; // namespace
 
     Dispatcher::Dispatcher()
@@ -335,9 +356,11 @@ namespace System
 
     void Dispatcher::remoteSpawn(std::function<void()> &&procedure)
     {
+        std::function<void()> timedProcedure = timeRemoteSpawn(std::move(procedure));
+
         {
             MutextGuard guard(*reinterpret_cast<pthread_mutex_t *>(this->mutex));
-            remoteSpawningProcedures.push(std::move(procedure));
+            remoteSpawningProcedures.push(std::move(timedProcedure));
         }
         uint64_t one = 1;
         auto transferred = write(remoteSpawnEvent, &one, sizeof one);
@@ -18,6 +18,7 @@
 #include <sys/time.h>
 #include <sys/types.h>
 #include <unistd.h>
+#include <utilities/Metrics.h>
 
 namespace System
 {
@@ -53,6 +54,25 @@ namespace System
 
         const size_t STACK_SIZE = 64 * 1024;
 
+        //RTcoin
+        /* Tracks how many remotely spawned procedures are waiting, and how long
+           each waited before the dispatcher ran it */
+        std::function<void()> timeRemoteSpawn(std::function<void()> &&procedure)
+        {
+            static Metrics::Gauge &queueDepth = Metrics::registry().gauge(
+                "dispatcher_remote_spawn_queue_depth", "Procedures spawned from other threads, not yet run");
+
+            static LatencyHistogram &waitTime = Metrics::registry().histogram(
+                "dispatcher_remote_spawn_wait_microseconds", "Time procedures spawned from other threads waited to run");
+
+            queueDepth.add(1);
+
+            return [procedure = std::move(procedure), start = std::chrono::steady_clock::now()]() {
+                queueDepth.add(-1);
+                waitTime.record(Metrics::microsecondsSince(start));
+                procedure();
+            };
+        }
     } // namespace
 
     static_assert(Dispatcher::SIZEOF_PTHREAD_MUTEX_T == sizeof(pthread_mutex_t), "invalid pthread mutex size");
@@ -310,8 +330,10 @@ namespace System
 
     void Dispatcher::remoteSpawn(std::function<void()> &&procedure)
     {
+        std::function<void()> timedProcedure = timeRemoteSpawn(std::move(procedure));
+
         MutextGuard guard(*reinterpret_cast<pthread_mutex_t *>(this->mutex));
-        remoteSpawningProcedures.push(std::move(procedure));
+        remoteSpawningProcedures.push(std::move(timedProcedure));
         if (remoteSpawned == false)
         {
             remoteSpawned = true;
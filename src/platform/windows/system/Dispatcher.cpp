@@ -19,6 +19,7 @@
 #include "ErrorMessage.h"
 
 #include <winsock2.h>
+#include <utilities/Metrics.h>
 
 namespace System
 {
@@ -32,6 +33,26 @@ namespace System
         const size_t STACK_SIZE = 16384;
 
         const size_t RESERVE_STACK_SIZE = 2097152;
+
+        //RTcoin
+        /* Tracks how many remotely spawned procedures are waiting, and how long
+           each waited before the dispatcher ran it */
+        std::function<void()> timeRemoteSpawn(std::function<void()> &&procedure)
+        {
+            static Metrics::Gauge &queueDepth = Metrics::registry().gauge(
+                "dispatcher_remote_spawn_queue_depth", "Procedures spawned from other threads, not yet run");
+
+            static LatencyHistogram &waitTime = Metrics::registry().histogram(
+                "dispatcher_remote_spawn_wait_microseconds", "Time procedures spawned from other threads waited to run");
+
+            queueDepth.add(1);
+
+            return [procedure = std::move(procedure), start = std::chrono::steady_clock::now()]() {
+                queueDepth.add(-1);
+                waitTime.record(Metrics::microsecondsSince(start));
+                procedure();
+            };
+        }
     } // namespace
 
     Dispatcher::Dispatcher()
@@ -294,8 +315,10 @@ namespace System
 
     void Dispatcher::remoteSpawn(std::function<void()> &&procedure)
     {
+        std::function<void()> timedProcedure = timeRemoteSpawn(std::move(procedure));
+
         EnterCriticalSection(reinterpret_cast<LPCRITICAL_SECTION>(criticalSection));
-        remoteSpawningProcedures.push(std::move(procedure));
+        remoteSpawningProcedures.push(std::move(timedProcedure));
         if (!remoteNotificationSent)
         {
             remoteNotificationSent = true;
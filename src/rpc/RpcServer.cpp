@@ -17,8 +17,46 @@
 #include <utilities/Addresses.h>
 #include <utilities/ColouredMsg.h>
 #include <utilities/FormatTools.h>
+#include <utilities/MemoryBudget.h>
+#include <utilities/Metrics.h>
 #include <utilities/ParseExtra.h>
 
+namespace
+{
+    //RTcoin
+    /* The request path with hashes and heights replaced, so every request to
+       a route shares one metric, e.g. "GET /block/{hash}/raw" */
+    std::string routeName(const httplib::Request &req)
+    {
+        std::string route = req.method + " ";
+
+        size_t start = 1;
+
+        while (start <= req.path.size())
+        {
+            const size_t end = std::min(req.path.find('/', start), req.path.size());
+
+            const std::string_view segment = std::string_view(req.path).substr(start, end - start);
+
+            const auto allOf = [segment](int (*test)(int))
+            {
+                return std::all_of(segment.begin(), segment.end(), [test](unsigned char c) { return test(c) != 0; });
+            };
+
+            const bool isNumber = !segment.empty() && allOf(::isdigit);
+
+            const bool isHash = segment.size() == 64 && allOf(::isxdigit);
+
+            route += "/";
+            route += isHash ? "{hash}" : isNumber ? "{height}" : std::string(segment);
+
+            start = end + 1;
+        }
+
+        return route;
+    }
+} // namespace
+
 RpcServer::RpcServer(
     const uint16_t bindPort,
     const std::string rpcBindIp,
@@ -51,6 +89,11 @@ RpcServer::RpcServer(
         }
     }
 
+    //RTcoin
+    /* Let block producers and load generators keep a single connection open,
+       rather than reconnecting every few requests */
+    m_server.set_keep_alive_max_count(std::numeric_limits<size_t>::max());
+
     const bool bodyRequired = true;
 
     const bool bodyNotRequired = false;
@@ -97,6 +140,9 @@ RpcServer::RpcServer(
             "/block/(\\d+)/raw", /* /block/{height}/raw */
             router(&RpcServer::getRawBlockByHeight, RpcMode::BlockExplorerEnabled, bodyNotRequired, syncNotRequired))
 
+        .Get(
+            "/block/cadence", router(&RpcServer::getBlockCadence, RpcMode::Default, bodyNotRequired, syncNotRequired))
+
         .Get("/block/count", router(&RpcServer::getBlockCount, RpcMode::Default, bodyNotRequired, syncNotRequired))
 
         .Get(
@@ -105,6 +151,9 @@ RpcServer::RpcServer(
 
         .Get("/block/last", router(&RpcServer::getLastBlockHeader, RpcMode::Default, bodyNotRequired, syncNotRequired))
 
+        .Post(
+            "/block/notify", router(&RpcServer::waitForChainChange, RpcMode::Default, bodyRequired, syncNotRequired))
+
         .Post("/block/template", router(&RpcServer::getBlockTemplate, RpcMode::Default, bodyRequired, syncNotRequired))
 
         .Get("/fee", router(&RpcServer::fee, RpcMode::Default, bodyNotRequired, syncNotRequired))
@@ -119,6 +168,14 @@ RpcServer::RpcServer(
 
         .Get("/info", router(&RpcServer::info, RpcMode::Default, bodyNotRequired, syncNotRequired))
 
+        .Get(
+            "/latency",
+            router(&RpcServer::getTransactionLatency, RpcMode::Default, bodyNotRequired, syncNotRequired))
+
+        .Get("/memory", router(&RpcServer::getMemory, RpcMode::Default, bodyNotRequired, syncNotRequired))
+
+        .Get("/metrics", router(&RpcServer::getMetrics, RpcMode::Default, bodyNotRequired, syncNotRequired))
+
         .Get("/peers", router(&RpcServer::peers, RpcMode::Default, bodyNotRequired, syncNotRequired))
 
         .Post("/sync", router(&RpcServer::getWalletSyncData, RpcMode::Default, bodyRequired, syncNotRequired))
@@ -200,26 +257,22 @@ std::tuple<std::string, uint16_t> RpcServer::getConnectionInfo()
     return {m_host, m_port};
 }
 
-std::optional<rapidjson::Document>
-    RpcServer::getJsonBody(const httplib::Request &req, httplib::Response &res, const bool bodyRequired)
+bool RpcServer::getJsonBody(
+    const httplib::Request &req,
+    httplib::Response &res,
+    const bool bodyRequired,
+    Common::JsonRequestBody &jsonBody)
 {
-    rapidjson::Document jsonBody;
-
     if (!bodyRequired)
     {
-        /* Some compilers are stupid and can't figure out just `return jsonBody`
-         * and we can't construct a std::optional(jsonBody) since the copy
-         * constructor is deleted, so we need to std::move */
-        return std::optional<rapidjson::Document>(std::move(jsonBody));
+        return true;
     }
 
     /* Some methods, most notably POST(/block) and POST(/transaction) may
      * have plain-text style bodies that will not parse as JSON without
      * being enclosed in quotes. Some libraries properly enclose the values
-     * in quotes while others do not. This permits either forms to work */
-    const auto bodyAsJSONString = "\"" + req.body + "\"";
-
-    if (jsonBody.Parse(req.body.c_str()).HasParseError() && jsonBody.Parse(bodyAsJSONString.c_str()).HasParseError())
+     * in quotes while others do not. The parser permits either form */
+    if (!jsonBody.parse(req.body))
     {
         std::stringstream stream;
 
@@ -239,10 +292,10 @@ std::optional<rapidjson::Document>
 
         res.status = 400;
 
-        return std::nullopt;
+        return false;
     }
 
-    return std::optional<rapidjson::Document>(std::move(jsonBody));
+    return true;
 }
 
 void RpcServer::middleware(
@@ -262,6 +315,10 @@ void RpcServer::middleware(
         Logger::DEBUG,
         {Logger::DAEMON_RPC});
 
+    //RTcoin
+    Metrics::ScopedTimer timer(Metrics::registry().histogram(
+        "rpc_request_microseconds", "Time taken to handle RPC requests", {{"route", routeName(req)}}));
+
     if (m_corsHeader != "")
     {
         res.set_header("Access-Control-Allow-Origin", m_corsHeader);
@@ -269,9 +326,9 @@ void RpcServer::middleware(
 
     res.set_header("Content-Type", "application/json");
 
-    const auto jsonBody = getJsonBody(req, res, bodyRequired);
+    Common::JsonRequestBody jsonBody;
 
-    if (!jsonBody)
+    if (!getJsonBody(req, res, bodyRequired, jsonBody))
     {
         return;
     }
@@ -304,7 +361,7 @@ void RpcServer::middleware(
 
     try
     {
-        const auto [error, statusCode] = handler(req, res, *jsonBody);
+        const auto [error, statusCode] = handler(req, res, jsonBody.document());
 
         if (error)
         {
@@ -593,6 +650,206 @@ std::tuple<Error, uint16_t>
     return {SUCCESS, 200};
 }
 
+//RTcoin
+std::tuple<Error, uint16_t> RpcServer::getTransactionLatency(
+    const httplib::Request &req,
+    httplib::Response &res,
+    const rapidjson::Document &body)
+{
+    const auto summary = m_core->getTransactionLatencyTracker().getSummary();
+
+    rapidjson::StringBuffer sb;
+
+    rapidjson::Writer<rapidjson::StringBuffer> writer(sb);
+
+    writer.StartObject();
+    {
+        writer.Key("deadlines");
+        writer.StartArray();
+        {
+            for (size_t i = 0; i < summary.deadlines.size(); i++)
+            {
+                const auto &counts = summary.deadlines[i];
+
+                writer.StartObject();
+                {
+                    writer.Key("expired");
+                    writer.Uint64(counts.expired);
+
+                    writer.Key("met");
+                    writer.Uint64(counts.met);
+
+                    writer.Key("missed");
+                    writer.Uint64(counts.missed);
+
+                    writer.Key("rejected");
+                    writer.Uint64(counts.rejected);
+
+                    writer.Key("sizeClass");
+                    writer.String(CryptoNote::TransactionLatencyTracker::sizeClassName(i));
+                }
+                writer.EndObject();
+            }
+        }
+        writer.EndArray();
+
+        /* All delays are in microseconds */
+        writer.Key("delays");
+        writer.StartArray();
+        {
+            for (const auto &delay : summary.delays)
+            {
+                writer.StartObject();
+                {
+                    writer.Key("count");
+                    writer.Uint64(delay.count);
+
+                    writer.Key("max");
+                    writer.Uint64(delay.max);
+
+                    writer.Key("mean");
+                    writer.Double(delay.mean);
+
+                    writer.Key("name");
+                    writer.String(delay.name);
+
+                    writer.Key("p50");
+                    writer.Uint64(delay.p50);
+
+                    writer.Key("p90");
+                    writer.Uint64(delay.p90);
+
+                    writer.Key("p99");
+                    writer.Uint64(delay.p99);
+
+                    writer.Key("p999");
+                    writer.Uint64(delay.p999);
+                }
+                writer.EndObject();
+            }
+        }
+        writer.EndArray();
+
+        writer.Key("dropped");
+        writer.Uint64(summary.dropped);
+
+        writer.Key("tracked");
+        writer.Uint64(summary.tracked);
+    }
+    writer.EndObject();
+
+    res.body = sb.GetString();
+
+    return {SUCCESS, 200};
+}
+
+//RTcoin
+std::tuple<Error, uint16_t>
+    RpcServer::getMemory(const httplib::Request &req, httplib::Response &res, const rapidjson::Document &body)
+{
+    const auto &budget = MemoryBudget::budget();
+
+    rapidjson::StringBuffer sb;
+
+    rapidjson::Writer<rapidjson::StringBuffer> writer(sb);
+
+    writer.StartObject();
+    {
+        writer.Key("overBudget");
+        writer.Bool(budget.isOverBudget());
+
+        writer.Key("subsystems");
+        writer.StartArray();
+        {
+            for (const auto subsystem : MemoryBudget::SUBSYSTEMS)
+            {
+                const uint64_t allowance = budget.allowance(subsystem);
+
+                writer.StartObject();
+                {
+                    /* 0 when there's no limit, same as the target */
+                    writer.Key("allowance");
+                    writer.Uint64(allowance == std::numeric_limits<uint64_t>::max() ? 0 : allowance);
+
+                    writer.Key("name");
+                    writer.String(MemoryBudget::subsystemName(subsystem));
+
+                    writer.Key("usage");
+                    writer.Uint64(budget.usage(subsystem));
+                }
+                writer.EndObject();
+            }
+        }
+        writer.EndArray();
+
+        writer.Key("target");
+        writer.Uint64(budget.target());
+
+        writer.Key("total");
+        writer.Uint64(budget.total());
+    }
+    writer.EndObject();
+
+    res.body = sb.GetString();
+
+    return {SUCCESS, 200};
+}
+
+std::tuple<Error, uint16_t>
+    RpcServer::getMetrics(const httplib::Request &req, httplib::Response &res, const rapidjson::Document &body)
+{
+    const uint64_t height = m_core->getTopBlockIndex() + 1;
+
+    const uint64_t difficulty = m_core->getDifficultyForNextBlock();
+
+    const uint64_t totalConnections = m_p2p->get_connections_count();
+
+    const uint64_t outgoingConnections = m_p2p->get_outgoing_connections_count();
+
+    const auto &budget = MemoryBudget::budget();
+
+    std::stringstream stream;
+
+    /* Read from the node when scraped, rather than kept up to date */
+    const auto writeGauge = [&stream](const std::string &name, const std::string &help, const uint64_t value) {
+        stream << "# HELP " << name << " " << help << "\n"
+               << "# TYPE " << name << " gauge\n"
+               << name << " " << value << "\n";
+    };
+
+    writeGauge("node_height", "Blocks in the local chain", height);
+    writeGauge(
+        "node_network_height",
+        "Blocks in the chain, as reported by peers",
+        std::max(1u, m_syncManager->getBlockchainHeight()));
+    writeGauge("node_difficulty", "Difficulty of the next block", difficulty);
+    writeGauge(
+        "node_hashrate", "Estimated network hashrate", round(difficulty / CryptoNote::parameters::DIFFICULTY_TARGET));
+    writeGauge("node_pool_transactions", "Transactions in the pool", m_core->getPoolTransactionCount());
+    writeGauge("p2p_incoming_connections", "Connections opened by peers", totalConnections - outgoingConnections);
+    writeGauge("p2p_outgoing_connections", "Connections opened to peers", outgoingConnections);
+    writeGauge("memory_budget_bytes", "Memory target for the tracked subsystems, 0 for no limit", budget.target());
+
+    stream << "# HELP memory_usage_bytes Estimated memory held by each tracked subsystem\n"
+           << "# TYPE memory_usage_bytes gauge\n";
+
+    for (const auto subsystem : MemoryBudget::SUBSYSTEMS)
+    {
+        stream << "memory_usage_bytes{subsystem=\"" << MemoryBudget::subsystemName(subsystem) << "\"} "
+               << budget.usage(subsystem) << "\n";
+    }
+
+    stream << Metrics::registry().render();
+
+    /* Middleware has already set this to JSON */
+    res.headers.erase("Content-Type");
+    res.set_header("Content-Type", "text/plain; version=0.0.4");
+
+    res.body = stream.str();
+
+    return {SUCCESS, 200};
+}
+
 //RTcoin
 std::tuple<Error, uint16_t>
     RpcServer::sendTransaction(const httplib::Request &req, httplib::Response &res, const rapidjson::Document &body)
@@ -610,9 +867,10 @@ std::tuple<Error, uint16_t>
         return {Error(API_INVALID_ARGUMENT, "Failed to parse transaction from hex buffer"), 400};
     }
 
-    const CryptoNote::CachedTransaction cachedTransaction(transaction);
+    /* Only the hash is needed here, the pool deserializes it if it's new */
+    const CryptoNote::TransactionView view(transaction);
 
-    const auto hash = cachedTransaction.getTransactionHash();
+    const auto hash = view.getTransactionHash();
 
     std::stringstream stream;
 
@@ -620,7 +878,20 @@ std::tuple<Error, uint16_t>
 
     Logger::logger.log(stream.str(), Logger::DEBUG, {Logger::DAEMON_RPC});
 
-    const auto [success, error] = m_core->addTransactionToPool(transaction);
+    const auto [success, error, rejection] = m_core->addTransactionToPool(view);
+
+    /* Not wrong, just more than the blocks to come can fit in time - worth
+       trying again once the next block has made some room */
+    if (rejection == CryptoNote::PoolRejection::Unschedulable)
+    {
+        const auto forecast = m_core->getCapacityForecast();
+
+        const uint64_t retryAfter = (forecast.nextBlock - std::min(forecast.nextBlock, forecast.now) + 999) / 1000;
+
+        res.set_header("Retry-After", std::to_string(std::max<uint64_t>(retryAfter, 1)));
+
+        return {Error(API_TRANSACTION_UNSCHEDULABLE, error), 429};
+    }
 
     if (!success)
     {
@@ -1076,6 +1347,108 @@ std::tuple<Error, uint16_t>
     return {SUCCESS, 201};
 }
 
+//RTcoin
+/* Long poll, so a block producer can react to new blocks and transactions as
+   soon as they arrive, rather than polling for templates. Returns as soon as
+   the chain or pool has changed since the version the caller last saw, or
+   once the timeout (milliseconds) expires. */
+std::tuple<Error, uint16_t>
+    RpcServer::waitForChainChange(const httplib::Request &req, httplib::Response &res, const rapidjson::Document &body)
+{
+    /* Don't tie up a server thread for too long */
+    const uint64_t maxTimeout = 30000;
+
+    const uint64_t knownVersion = hasMember(body, "version") ? getUint64FromJSON(body, "version") : 0;
+
+    const uint64_t timeout =
+        std::min(maxTimeout, hasMember(body, "timeout") ? getUint64FromJSON(body, "timeout") : 0);
+
+    const uint64_t version = m_core->waitForChange(knownVersion, std::chrono::milliseconds(timeout));
+
+    rapidjson::StringBuffer sb;
+
+    rapidjson::Writer<rapidjson::StringBuffer> writer(sb);
+
+    writer.StartObject();
+    {
+        writer.Key("earliestDeadline");
+        writer.Uint64(m_core->getPoolEarliestDeadline());
+
+        writer.Key("hash");
+        m_core->getTopBlockHash().toJSON(writer);
+
+        writer.Key("height");
+        writer.Uint64(m_core->getTopBlockIndex() + 1);
+
+        /* 0 if nothing is hurrying the next block along */
+        const uint64_t sealAt = m_core->getBlockCadence().sealAt;
+
+        writer.Key("sealAt");
+        writer.Uint64(sealAt == CryptoNote::BlockCadencePlan::NO_SEAL_TIME ? 0 : sealAt);
+
+        writer.Key("transactionsPoolSize");
+        writer.Uint64(m_core->getPoolTransactionCount());
+
+        writer.Key("version");
+        writer.Uint64(version);
+    }
+    writer.EndObject();
+
+    res.body = sb.GetString();
+
+    return {SUCCESS, 200};
+}
+
+//RTcoin
+std::tuple<Error, uint16_t>
+    RpcServer::getBlockCadence(const httplib::Request &req, httplib::Response &res, const rapidjson::Document &body)
+{
+    const auto plan = m_core->getBlockCadence();
+
+    rapidjson::StringBuffer sb;
+
+    rapidjson::Writer<rapidjson::StringBuffer> writer(sb);
+
+    writer.StartObject();
+    {
+        writer.Key("arrivalRate");
+        writer.Uint64(plan.arrivalRate);
+
+        writer.Key("blockSize");
+        writer.Uint64(plan.blockSize);
+
+        writer.Key("interval");
+        writer.Uint64(plan.interval);
+
+        writer.Key("maxBlockSize");
+        writer.Uint64(plan.maxBlockSize);
+
+        writer.Key("policy");
+        writer.String(CryptoNote::BlockCadenceController::policyName(plan.policy));
+
+        writer.Key("poolBytes");
+        writer.Uint64(plan.poolBytes);
+
+        writer.Key("requiredBlockSize");
+        writer.Uint64(plan.requiredBlockSize);
+
+        /* 0 if nothing is hurrying the next block along */
+        writer.Key("sealAt");
+        writer.Uint64(plan.sealAt == CryptoNote::BlockCadencePlan::NO_SEAL_TIME ? 0 : plan.sealAt);
+
+        writer.Key("staticBlockSize");
+        writer.Uint64(plan.staticBlockSize);
+
+        writer.Key("timestamp");
+        writer.Uint64(plan.now);
+    }
+    writer.EndObject();
+
+    res.body = sb.GetString();
+
+    return {SUCCESS, 200};
+}
+
 std::tuple<Error, uint16_t>
     RpcServer::submitBlock(const httplib::Request &req, httplib::Response &res, const rapidjson::Document &body)
 {
@@ -1774,7 +2147,7 @@ std::tuple<Error, uint16_t> RpcServer::getTransactionsStatus(
     {
         Crypto::Hash hash;
 
-        if (!Common::podFromHex(getStringFromJSON(hashStr), hash))
+        if (!Common::podFromHex(getStringViewFromJSON(hashStr), hash))
         {
             return {Error(API_INVALID_ARGUMENT), 400};
         }
@@ -1844,7 +2217,7 @@ std::tuple<Error, uint16_t>
 
     Crypto::Hash lastBlockHash;
 
-    if (!Common::podFromHex(getStringFromJSON(body, "lastKnownBlock"), lastBlockHash))
+    if (!Common::podFromHex(getStringViewFromJSON(body, "lastKnownBlock"), lastBlockHash))
     {
         return {Error(API_INVALID_ARGUMENT), 400};
     }
@@ -1855,7 +2228,7 @@ std::tuple<Error, uint16_t>
     {
         Crypto::Hash hash;
 
-        if (!Common::podFromHex(getStringFromJSON(hashStr), hash))
+        if (!Common::podFromHex(getStringViewFromJSON(hashStr), hash))
         {
             return {Error(API_INVALID_ARGUMENT), 400};
         }
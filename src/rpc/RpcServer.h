@@ -9,6 +9,7 @@
 #include "rapidjson/stringbuffer.h"
 #include "rapidjson/writer.h"
 
+#include <common/JsonRequestBody.h>
 #include <cryptonotecore/Core.h>
 #include <cryptonoteprotocol/CryptoNoteProtocolHandlerCommon.h>
 #include <errors/Errors.h>
@@ -65,8 +66,14 @@ class RpcServer
     /* Starts listening for requests on the server */
     void listen();
 
-    std::optional<rapidjson::Document>
-        getJsonBody(const httplib::Request &req, httplib::Response &res, const bool bodyRequired);
+    //RTcoin
+    /* Parses the request body into jsonBody, returning false, with the
+       response filled in, if it isn't JSON */
+    bool getJsonBody(
+        const httplib::Request &req,
+        httplib::Response &res,
+        const bool bodyRequired,
+        Common::JsonRequestBody &jsonBody);
 
     /* Handles stuff like parsing json and then forwards onto the handler */
     void middleware(
@@ -115,6 +122,16 @@ class RpcServer
     std::tuple<Error, uint16_t>
         peers(const httplib::Request &req, httplib::Response &res, const rapidjson::Document &body);
 
+    std::tuple<Error, uint16_t>
+        getTransactionLatency(const httplib::Request &req, httplib::Response &res, const rapidjson::Document &body);
+
+    //RTcoin
+    std::tuple<Error, uint16_t>
+        getMemory(const httplib::Request &req, httplib::Response &res, const rapidjson::Document &body);
+
+    std::tuple<Error, uint16_t>
+        getMetrics(const httplib::Request &req, httplib::Response &res, const rapidjson::Document &body);
+
     std::tuple<Error, uint16_t>
         getBlockCount(const httplib::Request &req, httplib::Response &res, const rapidjson::Document &body);
 
@@ -184,6 +201,12 @@ class RpcServer
     std::tuple<Error, uint16_t>
         submitBlock(const httplib::Request &req, httplib::Response &res, const rapidjson::Document &body);
 
+    std::tuple<Error, uint16_t>
+        waitForChainChange(const httplib::Request &req, httplib::Response &res, const rapidjson::Document &body);
+
+    std::tuple<Error, uint16_t>
+        getBlockCadence(const httplib::Request &req, httplib::Response &res, const rapidjson::Document &body);
+
     //////////////////////////////
     /* Private member variables */
     //////////////////////////////
@@ -0,0 +1,627 @@
+// Copyright (c) 2018-2020, The TurtleCoin Developers
+//
+// Please see the included LICENSE file for more information.
+
+////////////////////////////////////////
+#include <serialization/BinaryCodec.h>
+////////////////////////////////////////
+
+#include <common/TransactionExtra.h>
+#include <config/CryptoNoteConfig.h>
+#include <crypto/crypto.h>
+#include <cstring>
+#include <serialization/BufferReader.h>
+#include <stdexcept>
+
+namespace CryptoNote
+{
+    namespace
+    {
+        /* Variant tags, as in CryptoNoteSerialization.cpp */
+        const uint8_t BASE_INPUT_TAG = 0xff;
+
+        const uint8_t KEY_TAG = 0x2;
+
+        /* Counts the bytes an object encodes to */
+        class SizeCounter
+        {
+          public:
+            void varint(uint64_t value)
+            {
+                m_size++;
+
+                while (value >= 0x80)
+                {
+                    value >>= 7;
+                    m_size++;
+                }
+            }
+
+            void bytes(const void *data, size_t size)
+            {
+                m_size += size;
+            }
+
+            size_t size() const
+            {
+                return m_size;
+            }
+
+          private:
+            size_t m_size = 0;
+        };
+
+        /* Writes into a buffer already sized by SizeCounter */
+        class BufferWriter
+        {
+          public:
+            BufferWriter(uint8_t *output): m_pos(output) {}
+
+            void varint(uint64_t value)
+            {
+                while (value >= 0x80)
+                {
+                    *m_pos++ = static_cast<uint8_t>(value & 0x7f) | 0x80;
+                    value >>= 7;
+                }
+
+                *m_pos++ = static_cast<uint8_t>(value);
+            }
+
+            void bytes(const void *data, size_t size)
+            {
+                std::memcpy(m_pos, data, size);
+                m_pos += size;
+            }
+
+          private:
+            uint8_t *m_pos;
+        };
+
+        template<typename Output> void writeInput(const TransactionInput &input, Output &out)
+        {
+            if (input.type() == typeid(BaseInput))
+            {
+                out.bytes(&BASE_INPUT_TAG, 1);
+                out.varint(boost::get<BaseInput>(input).blockIndex);
+            }
+            else
+            {
+                const auto &keyInput = boost::get<KeyInput>(input);
+
+                out.bytes(&KEY_TAG, 1);
+                out.varint(keyInput.amount);
+                out.varint(keyInput.outputIndexes.size());
+
+                for (const uint32_t index : keyInput.outputIndexes)
+                {
+                    out.varint(index);
+                }
+
+                out.bytes(&keyInput.keyImage, sizeof(keyInput.keyImage));
+            }
+        }
+
+        void readInput(TransactionInput &input, BufferReader &in)
+        {
+            const uint8_t tag = in.byte();
+
+            if (tag == BASE_INPUT_TAG)
+            {
+                if (input.type() != typeid(BaseInput))
+                {
+                    input = BaseInput();
+                }
+
+                boost::get<BaseInput>(input).blockIndex = in.varint<uint32_t>();
+            }
+            else if (tag == KEY_TAG)
+            {
+                if (input.type() != typeid(KeyInput))
+                {
+                    input = KeyInput();
+                }
+
+                auto &keyInput = boost::get<KeyInput>(input);
+
+                keyInput.amount = in.varint<uint64_t>();
+                keyInput.outputIndexes.resize(in.count(1));
+
+                for (uint32_t &index : keyInput.outputIndexes)
+                {
+                    index = in.varint<uint32_t>();
+                }
+
+                in.bytes(&keyInput.keyImage, sizeof(keyInput.keyImage));
+            }
+            else
+            {
+                throw std::runtime_error("Unknown variant tag");
+            }
+        }
+
+        /* Fields shared by TransactionPrefix and BaseTransaction. The version
+           and unlock time come first, and differ between the two */
+        template<typename Output> void writeBody(const TransactionPrefix &prefix, Output &out)
+        {
+            out.varint(prefix.inputs.size());
+
+            for (const auto &input : prefix.inputs)
+            {
+                writeInput(input, out);
+            }
+
+            out.varint(prefix.outputs.size());
+
+            for (const auto &output : prefix.outputs)
+            {
+                out.varint(output.amount);
+                out.bytes(&KEY_TAG, 1);
+                out.bytes(&boost::get<KeyOutput>(output.target).key, sizeof(Crypto::PublicKey));
+            }
+
+            out.varint(prefix.extra.size());
+            out.bytes(prefix.extra.data(), prefix.extra.size());
+        }
+
+        void readBody(TransactionPrefix &prefix, BufferReader &in)
+        {
+            /* Smallest input is a tag and a one byte varint */
+            prefix.inputs.resize(in.count(2));
+
+            for (auto &input : prefix.inputs)
+            {
+                readInput(input, in);
+            }
+
+            /* Amount, tag and key */
+            prefix.outputs.resize(in.count(2 + sizeof(Crypto::PublicKey)));
+
+            for (auto &output : prefix.outputs)
+            {
+                output.amount = in.varint<uint64_t>();
+
+                if (in.byte() != KEY_TAG)
+                {
+                    throw std::runtime_error("Unknown variant tag");
+                }
+
+                if (output.target.type() != typeid(KeyOutput))
+                {
+                    output.target = KeyOutput();
+                }
+
+                in.bytes(&boost::get<KeyOutput>(output.target).key, sizeof(Crypto::PublicKey));
+            }
+
+            const uint64_t extraSize = in.count(1);
+            const uint8_t *extra = in.take(extraSize);
+
+            prefix.extra.assign(extra, extra + extraSize);
+        }
+
+        template<typename Output> void writePrefix(const TransactionPrefix &prefix, Output &out)
+        {
+            out.varint(prefix.version);
+            out.varint(prefix.unlockTime);
+
+            if (prefix.version == HACK_TRANSACTION_VERSION)
+            {
+                out.varint(prefix.deadline);
+                out.varint(prefix.size);
+            }
+
+            writeBody(prefix, out);
+        }
+
+        void readPrefix(TransactionPrefix &prefix, BufferReader &in)
+        {
+            prefix.version = in.varint<uint8_t>();
+
+            if (CURRENT_TRANSACTION_VERSION < prefix.version && prefix.version != HACK_TRANSACTION_VERSION)
+            {
+                throw std::runtime_error("Wrong transaction version");
+            }
+
+            prefix.unlockTime = in.varint<uint64_t>();
+
+            if (prefix.version == HACK_TRANSACTION_VERSION)
+            {
+                prefix.deadline = in.varint<uint64_t>();
+                prefix.size = in.varint<uint64_t>();
+            }
+            else
+            {
+                prefix.deadline = 0;
+                prefix.size = 0;
+            }
+
+            readBody(prefix, in);
+        }
+
+        /* The signatures for each input have no count - it's the input's ring
+           size, or none for coinbase inputs */
+        uint64_t getSignatureCount(const TransactionInput &input)
+        {
+            if (input.type() == typeid(KeyInput))
+            {
+                return boost::get<KeyInput>(input).outputIndexes.size();
+            }
+
+            return 0;
+        }
+
+        template<typename Output> void writeTransaction(const Transaction &transaction, Output &out)
+        {
+            writePrefix(transaction, out);
+
+            const bool signaturesNotExpected = transaction.signatures.empty();
+
+            if (!signaturesNotExpected && transaction.inputs.size() != transaction.signatures.size())
+            {
+                throw std::runtime_error("Serialization error: unexpected signatures size");
+            }
+
+            for (size_t i = 0; i < transaction.inputs.size(); i++)
+            {
+                const uint64_t signatureCount = getSignatureCount(transaction.inputs[i]);
+
+                if (signaturesNotExpected)
+                {
+                    if (signatureCount != 0)
+                    {
+                        throw std::runtime_error("Serialization error: signatures are not expected");
+                    }
+
+                    continue;
+                }
+
+                if (signatureCount != transaction.signatures[i].size())
+                {
+                    throw std::runtime_error("Serialization error: unexpected signatures size");
+                }
+
+                out.bytes(transaction.signatures[i].data(), signatureCount * sizeof(Crypto::Signature));
+            }
+        }
+
+        void readTransaction(Transaction &transaction, BufferReader &in)
+        {
+            const size_t start = in.consumed();
+
+            readPrefix(transaction, in);
+
+            const bool isCoinbase =
+                transaction.inputs.size() == 1 && transaction.inputs[0].type() == typeid(BaseInput);
+
+            if (isCoinbase)
+            {
+                transaction.signatures.clear();
+            }
+            else
+            {
+                transaction.signatures.resize(transaction.inputs.size());
+            }
+
+            const bool signaturesNotExpected = transaction.signatures.empty();
+
+            for (size_t i = 0; i < transaction.inputs.size(); i++)
+            {
+                const uint64_t signatureCount = getSignatureCount(transaction.inputs[i]);
+
+                if (signaturesNotExpected)
+                {
+                    if (signatureCount != 0)
+                    {
+                        throw std::runtime_error("Serialization error: signatures are not expected");
+                    }
+
+                    continue;
+                }
+
+                auto &signatures = transaction.signatures[i];
+
+                signatures.resize(signatureCount);
+
+                in.bytes(signatures.data(), signatureCount * sizeof(Crypto::Signature));
+            }
+
+            //RTcoin
+            /* A synthetic transaction's size field has to be its real size,
+               not whatever the sender chose to write */
+            if (transaction.version == HACK_TRANSACTION_VERSION && in.consumed() - start != transaction.size)
+            {
+                throw std::runtime_error("Serialization error: synthetic transaction size does not match its size field");
+            }
+        }
+
+        /* The parent block's coinbase. Unlike a TransactionPrefix, there's no
+           version check, and a trailing zero from version 2 on */
+        template<typename Output> void writeBaseTransaction(const BaseTransaction &transaction, Output &out)
+        {
+            out.varint(transaction.version);
+            out.varint(transaction.unlockTime);
+
+            writeBody(transaction, out);
+
+            if (transaction.version >= TRANSACTION_VERSION_2)
+            {
+                out.varint(0);
+            }
+        }
+
+        void readBaseTransaction(BaseTransaction &transaction, BufferReader &in)
+        {
+            transaction.version = in.varint<uint8_t>();
+            transaction.unlockTime = in.varint<uint64_t>();
+            transaction.deadline = 0;
+            transaction.size = 0;
+
+            readBody(transaction, in);
+
+            if (transaction.version >= TRANSACTION_VERSION_2)
+            {
+                in.varint<uint64_t>();
+            }
+        }
+
+        uint64_t getMergeMiningDepth(const BaseTransaction &transaction)
+        {
+            TransactionExtraMergeMiningTag mmTag;
+
+            if (!getMergeMiningTagFromExtra(transaction.extra, mmTag))
+            {
+                throw std::runtime_error("Can't get extra merge mining tag");
+            }
+
+            if (mmTag.depth > 8 * sizeof(Crypto::Hash))
+            {
+                throw std::runtime_error("Wrong merge mining tag depth");
+            }
+
+            return mmTag.depth;
+        }
+
+        template<typename Output> void writeBlock(const BlockTemplate &block, Output &out)
+        {
+            if (block.majorVersion > BLOCK_MAJOR_VERSION_7 || block.majorVersion < BLOCK_MAJOR_VERSION_1)
+            {
+                throw std::runtime_error("Wrong major version");
+            }
+
+            out.varint(block.majorVersion);
+            out.varint(block.minorVersion);
+
+            if (block.majorVersion == BLOCK_MAJOR_VERSION_1)
+            {
+                out.varint(block.timestamp);
+                out.bytes(&block.previousBlockHash, sizeof(Crypto::Hash));
+                out.bytes(&block.nonce, sizeof(block.nonce));
+            }
+            else
+            {
+                out.bytes(&block.previousBlockHash, sizeof(Crypto::Hash));
+
+                const ParentBlock &parent = block.parentBlock;
+
+                out.varint(parent.majorVersion);
+                out.varint(parent.minorVersion);
+                out.varint(block.timestamp);
+                out.bytes(&parent.previousBlockHash, sizeof(Crypto::Hash));
+                out.bytes(&block.nonce, sizeof(block.nonce));
+                out.varint(parent.transactionCount);
+
+                if (parent.transactionCount < 1)
+                {
+                    throw std::runtime_error("Wrong transactions number");
+                }
+
+                if (parent.baseTransactionBranch.size() != Crypto::tree_depth(parent.transactionCount))
+                {
+                    throw std::runtime_error("Wrong miner transaction branch size");
+                }
+
+                out.bytes(parent.baseTransactionBranch.data(), parent.baseTransactionBranch.size() * sizeof(Crypto::Hash));
+
+                writeBaseTransaction(parent.baseTransaction, out);
+
+                if (getMergeMiningDepth(parent.baseTransaction) != parent.blockchainBranch.size())
+                {
+                    throw std::runtime_error("Blockchain branch size must be equal to merge mining tag depth");
+                }
+
+                out.bytes(parent.blockchainBranch.data(), parent.blockchainBranch.size() * sizeof(Crypto::Hash));
+            }
+
+            writeTransaction(block.baseTransaction, out);
+
+            out.varint(block.transactionHashes.size());
+            out.bytes(block.transactionHashes.data(), block.transactionHashes.size() * sizeof(Crypto::Hash));
+        }
+
+        void readBlock(BlockTemplate &block, BufferReader &in)
+        {
+            block.majorVersion = in.varint<uint8_t>();
+
+            if (block.majorVersion > BLOCK_MAJOR_VERSION_7 || block.majorVersion < BLOCK_MAJOR_VERSION_1)
+            {
+                throw std::runtime_error("Wrong major version");
+            }
+
+            block.minorVersion = in.varint<uint8_t>();
+
+            if (block.majorVersion == BLOCK_MAJOR_VERSION_1)
+            {
+                block.timestamp = in.varint<uint64_t>();
+                in.bytes(&block.previousBlockHash, sizeof(Crypto::Hash));
+                in.bytes(&block.nonce, sizeof(block.nonce));
+
+                block.parentBlock = ParentBlock();
+            }
+            else
+            {
+                in.bytes(&block.previousBlockHash, sizeof(Crypto::Hash));
+
+                ParentBlock &parent = block.parentBlock;
+
+                parent.majorVersion = in.varint<uint8_t>();
+                parent.minorVersion = in.varint<uint8_t>();
+                block.timestamp = in.varint<uint64_t>();
+                in.bytes(&parent.previousBlockHash, sizeof(Crypto::Hash));
+                in.bytes(&block.nonce, sizeof(block.nonce));
+
+                /* Truncated, as ParentBlockSerializer does */
+                parent.transactionCount = static_cast<uint16_t>(in.varint<uint64_t>());
+
+                if (parent.transactionCount < 1)
+                {
+                    throw std::runtime_error("Wrong transactions number");
+                }
+
+                parent.baseTransactionBranch.resize(Crypto::tree_depth(parent.transactionCount));
+
+                in.bytes(parent.baseTransactionBranch.data(), parent.baseTransactionBranch.size() * sizeof(Crypto::Hash));
+
+                readBaseTransaction(parent.baseTransaction, in);
+
+                parent.blockchainBranch.resize(getMergeMiningDepth(parent.baseTransaction));
+
+                in.bytes(parent.blockchainBranch.data(), parent.blockchainBranch.size() * sizeof(Crypto::Hash));
+            }
+
+            readTransaction(block.baseTransaction, in);
+
+            block.transactionHashes.resize(in.count(sizeof(Crypto::Hash)));
+
+            in.bytes(block.transactionHashes.data(), block.transactionHashes.size() * sizeof(Crypto::Hash));
+        }
+
+        template<typename Output> void writeRawBlock(const RawBlock &rawBlock, Output &out)
+        {
+            out.varint(rawBlock.block.size());
+            out.bytes(rawBlock.block.data(), rawBlock.block.size());
+
+            /* The count is written twice - once as tx_count, and again as
+               the size of the transactions array */
+            out.varint(rawBlock.transactions.size());
+            out.varint(rawBlock.transactions.size());
+
+            for (const auto &transaction : rawBlock.transactions)
+            {
+                out.varint(transaction.size());
+                out.bytes(transaction.data(), transaction.size());
+            }
+        }
+
+        void readRawBlock(RawBlock &rawBlock, BufferReader &in)
+        {
+            const uint64_t blockSize = in.count(1);
+            const uint8_t *block = in.take(blockSize);
+
+            rawBlock.block.assign(block, block + blockSize);
+
+            rawBlock.transactions.resize(in.count(1));
+
+            /* Array size, unused. The first count is the one that counts */
+            in.varint<uint64_t>();
+
+            for (auto &transaction : rawBlock.transactions)
+            {
+                const uint64_t transactionSize = in.count(1);
+                const uint8_t *data = in.take(transactionSize);
+
+                transaction.assign(data, data + transactionSize);
+            }
+        }
+
+        /* Size the object, then write it in one pass with no reallocation.
+           Sizing runs every check, so a failure leaves output untouched */
+        template<typename T, typename Writer>
+        void encodeWith(const T &object, std::vector<uint8_t> &output, Writer write)
+        {
+            SizeCounter counter;
+            write(object, counter);
+
+            output.resize(counter.size());
+
+            BufferWriter writer(output.data());
+            write(object, writer);
+        }
+
+        template<typename T, typename Writer> size_t sizeWith(const T &object, Writer write)
+        {
+            SizeCounter counter;
+            write(object, counter);
+            return counter.size();
+        }
+    } // namespace
+
+    size_t BinaryCodec<TransactionPrefix>::size(const TransactionPrefix &prefix)
+    {
+        return sizeWith(prefix, [](const auto &object, auto &out) { writePrefix(object, out); });
+    }
+
+    void BinaryCodec<TransactionPrefix>::encode(const TransactionPrefix &prefix, std::vector<uint8_t> &output)
+    {
+        encodeWith(prefix, output, [](const auto &object, auto &out) { writePrefix(object, out); });
+    }
+
+    size_t BinaryCodec<TransactionPrefix>::decode(TransactionPrefix &prefix, const uint8_t *data, size_t size)
+    {
+        BufferReader in(data, size);
+        readPrefix(prefix, in);
+        return in.consumed();
+    }
+
+    size_t BinaryCodec<Transaction>::size(const Transaction &transaction)
+    {
+        return sizeWith(transaction, [](const auto &object, auto &out) { writeTransaction(object, out); });
+    }
+
+    void BinaryCodec<Transaction>::encode(const Transaction &transaction, std::vector<uint8_t> &output)
+    {
+        encodeWith(transaction, output, [](const auto &object, auto &out) { writeTransaction(object, out); });
+    }
+
+    size_t BinaryCodec<Transaction>::decode(Transaction &transaction, const uint8_t *data, size_t size)
+    {
+        BufferReader in(data, size);
+        readTransaction(transaction, in);
+        return in.consumed();
+    }
+
+    size_t BinaryCodec<BlockTemplate>::size(const BlockTemplate &block)
+    {
+        return sizeWith(block, [](const auto &object, auto &out) { writeBlock(object, out); });
+    }
+
+    void BinaryCodec<BlockTemplate>::encode(const BlockTemplate &block, std::vector<uint8_t> &output)
+    {
+        encodeWith(block, output, [](const auto &object, auto &out) { writeBlock(object, out); });
+    }
+
+    size_t BinaryCodec<BlockTemplate>::decode(BlockTemplate &block, const uint8_t *data, size_t size)
+    {
+        BufferReader in(data, size);
+        readBlock(block, in);
+        return in.consumed();
+    }
+
+    size_t BinaryCodec<RawBlock>::size(const RawBlock &rawBlock)
+    {
+        return sizeWith(rawBlock, [](const auto &object, auto &out) { writeRawBlock(object, out); });
+    }
+
+    void BinaryCodec<RawBlock>::encode(const RawBlock &rawBlock, std::vector<uint8_t> &output)
+    {
+        encodeWith(rawBlock, output, [](const auto &object, auto &out) { writeRawBlock(object, out); });
+    }
+
+    size_t BinaryCodec<RawBlock>::decode(RawBlock &rawBlock, const uint8_t *data, size_t size)
+    {
+        BufferReader in(data, size);
+        readRawBlock(rawBlock, in);
+        return in.consumed();
+    }
+
+} // namespace CryptoNote
@@ -0,0 +1,78 @@
+// Copyright (c) 2018-2020, The TurtleCoin Developers
+//
+// Please see the included LICENSE file for more information.
+
+#pragma once
+
+#include <CryptoNote.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace CryptoNote
+{
+    /* Binary encoding for the types we (de)serialize the most, written
+       directly against the byte layout rather than through ISerializer.
+       There are no virtual calls or field names, sizes are computed without
+       building a buffer, and decoding reuses the storage the object already
+       holds - decode into the same object repeatedly, and once its vectors
+       have grown, it doesn't allocate.
+
+       The bytes produced and accepted are exactly those of the ISerializer
+       path. toBinaryArray(), fromBinaryArray() and getObjectBinarySize() use
+       this for any type with a specialisation, and ISerializer otherwise. */
+    template<typename T> struct BinaryCodec
+    {
+        static constexpr bool specialised = false;
+    };
+
+    template<> struct BinaryCodec<TransactionPrefix>
+    {
+        static constexpr bool specialised = true;
+
+        /* Encoded size of the object. Throws if it can't be encoded */
+        static size_t size(const TransactionPrefix &prefix);
+
+        /* Replaces the contents of output with the encoded object. Output is
+           untouched if it can't be encoded */
+        static void encode(const TransactionPrefix &prefix, std::vector<uint8_t> &output);
+
+        /* Returns the number of bytes read. Throws if the data is malformed,
+           leaving the object in an unspecified state */
+        static size_t decode(TransactionPrefix &prefix, const uint8_t *data, size_t size);
+    };
+
+    template<> struct BinaryCodec<Transaction>
+    {
+        static constexpr bool specialised = true;
+
+        static size_t size(const Transaction &transaction);
+
+        static void encode(const Transaction &transaction, std::vector<uint8_t> &output);
+
+        static size_t decode(Transaction &transaction, const uint8_t *data, size_t size);
+    };
+
+    template<> struct BinaryCodec<BlockTemplate>
+    {
+        static constexpr bool specialised = true;
+
+        static size_t size(const BlockTemplate &block);
+
+        static void encode(const BlockTemplate &block, std::vector<uint8_t> &output);
+
+        static size_t decode(BlockTemplate &block, const uint8_t *data, size_t size);
+    };
+
+    template<> struct BinaryCodec<RawBlock>
+    {
+        static constexpr bool specialised = true;
+
+        static size_t size(const RawBlock &rawBlock);
+
+        static void encode(const RawBlock &rawBlock, std::vector<uint8_t> &output);
+
+        static size_t decode(RawBlock &rawBlock, const uint8_t *data, size_t size);
+    };
+
+} // namespace CryptoNote
@@ -0,0 +1,123 @@
+// Copyright (c) 2018-2020, The TurtleCoin Developers
+//
+// Please see the included LICENSE file for more information.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
+namespace CryptoNote
+{
+    /* Bounds checked reads from a binary serialized buffer. Varints follow
+       the same rules as Common::readVarint, so anything accepted here is
+       accepted by BinaryInputStreamSerializer too. Throws on malformed data */
+    class BufferReader
+    {
+      public:
+        BufferReader(const uint8_t *data, size_t size): m_begin(data), m_pos(data), m_end(data + size) {}
+
+        /* Same rules as Common::readVarint - no overflowing T, and no
+           redundant trailing zero bytes */
+        template<typename T> T varint()
+        {
+            constexpr int bits = sizeof(T) * 8;
+
+            T value = 0;
+
+            for (int shift = 0;; shift += 7)
+            {
+                if (m_pos == m_end)
+                {
+                    throw std::runtime_error("Unexpected end of data");
+                }
+
+                const uint8_t piece = *m_pos++;
+
+                if (shift >= bits - 7 && piece >= 1 << (bits - shift))
+                {
+                    throw std::runtime_error("readVarint, value overflow");
+                }
+
+                value |= static_cast<T>(static_cast<uint64_t>(piece & 0x7f) << shift);
+
+                if ((piece & 0x80) == 0)
+                {
+                    if (piece == 0 && shift != 0)
+                    {
+                        throw std::runtime_error("readVarint, invalid value representation");
+                    }
+
+                    return value;
+                }
+            }
+        }
+
+        uint8_t byte()
+        {
+            if (m_pos == m_end)
+            {
+                throw std::runtime_error("Unexpected end of data");
+            }
+
+            return *m_pos++;
+        }
+
+        void bytes(void *output, size_t size)
+        {
+            checkRemaining(size);
+            std::memcpy(output, m_pos, size);
+            m_pos += size;
+        }
+
+        const uint8_t *take(size_t size)
+        {
+            checkRemaining(size);
+            const uint8_t *start = m_pos;
+            m_pos += size;
+            return start;
+        }
+
+        /* Reads an element count, and makes sure there's enough data left
+           for that many elements, before anything is allocated for them */
+        uint64_t count(size_t minElementSize)
+        {
+            const uint64_t count = varint<uint64_t>();
+
+            if (count > remaining() / minElementSize)
+            {
+                throw std::runtime_error("Array size exceeds remaining data");
+            }
+
+            return count;
+        }
+
+        size_t consumed() const
+        {
+            return m_pos - m_begin;
+        }
+
+      private:
+        size_t remaining() const
+        {
+            return m_end - m_pos;
+        }
+
+        void checkRemaining(size_t size) const
+        {
+            if (size > remaining())
+            {
+                throw std::runtime_error("Unexpected end of data");
+            }
+        }
+
+        const uint8_t *m_begin;
+
+        const uint8_t *m_pos;
+
+        const uint8_t *m_end;
+    };
+
+} // namespace CryptoNote
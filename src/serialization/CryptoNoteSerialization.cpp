@@ -208,12 +208,22 @@ namespace CryptoNote
     {
         serializer(txP.version, "version");
 
-        if (CURRENT_TRANSACTION_VERSION < txP.version && serializer.type() == ISerializer::INPUT)
+        if (CURRENT_TRANSACTION_VERSION < txP.version && txP.version != HACK_TRANSACTION_VERSION
+            && serializer.type() == ISerializer::INPUT)
         {
             throw std::runtime_error("Wrong transaction version");
         }
 
         serializer(txP.unlockTime, "unlock_time");
+
+        //RTcoin
+        /* Synthetic real-time transactions carry their deadline and target
+           size on the wire, so the daemon can schedule them */
+        if (txP.version == HACK_TRANSACTION_VERSION)
+        {
+            serializer(txP.deadline, "deadline");
+            serializer(txP.size, "size");
+        }
         serializer(txP.inputs, "vin");
         serializer(txP.outputs, "vout");
         serializeAsBinary(txP.extra, "extra", serializer);
@@ -293,6 +303,15 @@ namespace CryptoNote
             }
         }
         //  serializer.endArray();
+
+        //RTcoin
+        /* A synthetic transaction's size field has to be its real size, not
+           whatever the sender chose to write */
+        if (serializer.type() == ISerializer::INPUT && tx.version == HACK_TRANSACTION_VERSION
+            && getObjectBinarySize(tx) != tx.size)
+        {
+            throw std::runtime_error("Serialization error: synthetic transaction size does not match its size field");
+        }
     }
 
     void serialize(TransactionInput &in, ISerializer &serializer)
@@ -15,6 +15,7 @@
 #include <common/StringOutputStream.h>
 #include <common/VectorOutputStream.h>
 #include <list>
+#include <serialization/BinaryCodec.h>
 #include <serialization/BinaryInputStreamSerializer.h>
 #include <serialization/BinaryOutputStreamSerializer.h>
 #include <serialization/CryptoNoteSerialization.h>
@@ -169,6 +170,13 @@ namespace CryptoNote
     template<class T> std::vector<uint8_t> toBinaryArray(const T &object)
     {
         std::vector<uint8_t> ba;
+
+        if constexpr (BinaryCodec<T>::specialised)
+        {
+            BinaryCodec<T>::encode(object, ba);
+            return ba;
+        }
+
         Common::VectorOutputStream stream(ba);
         BinaryOutputStreamSerializer serializer(stream);
         serialize(const_cast<T &>(object), serializer);
@@ -180,6 +188,13 @@ namespace CryptoNote
     {
         try
         {
+            /* Write straight into the callers buffer, reusing its capacity */
+            if constexpr (BinaryCodec<T>::specialised)
+            {
+                BinaryCodec<T>::encode(object, binaryArray);
+                return true;
+            }
+
             binaryArray = toBinaryArray(object);
         }
         catch (std::exception &)
@@ -210,6 +225,17 @@ namespace CryptoNote
     template<class T> T fromBinaryArray(const std::vector<uint8_t> &binaryArray)
     {
         T object;
+
+        if constexpr (BinaryCodec<T>::specialised)
+        {
+            if (BinaryCodec<T>::decode(object, binaryArray.data(), binaryArray.size()) != binaryArray.size())
+            {
+                throw std::runtime_error("failed to unpack type");
+            }
+
+            return object;
+        }
+
         Common::MemoryInputStream stream(binaryArray.data(), binaryArray.size());
         BinaryInputStreamSerializer serializer(stream);
         serialize(object, serializer);
@@ -0,0 +1,356 @@
+// Copyright (c) 2018-2020, The TurtleCoin Developers
+//
+// Please see the included LICENSE file for more information.
+
+////////////////////////////////
+#include "SimulatedNode.h"
+////////////////////////////////
+
+#include <config/CryptoNoteConfig.h>
+#include <cryptonotecore/BlockchainCache.h>
+#include <cryptonotecore/Checkpoints.h>
+#include <cryptonotecore/MainChainStorage.h>
+#include <cryptonotecore/MemoryBlockchainCacheFactory.h>
+#include <cstring>
+#include <filesystem>
+
+namespace fs = std::filesystem;
+
+namespace Simulator
+{
+    namespace
+    {
+        /* The levin header in front of every message */
+        const uint64_t LEVIN_HEADER_SIZE = 33;
+
+        /* Unique for every connection, and the same from run to run */
+        boost::uuids::uuid connectionId(const size_t from, const size_t to)
+        {
+            boost::uuids::uuid id {};
+
+            const uint64_t fromValue = from;
+            const uint64_t toValue = to;
+
+            std::memcpy(id.data, &fromValue, sizeof(fromValue));
+            std::memcpy(id.data + sizeof(fromValue), &toValue, sizeof(toValue));
+
+            return id;
+        }
+    } // namespace
+
+    SimulatedNode::SimulatedNode(
+        const size_t index,
+        const CryptoNote::Currency &currency,
+        std::shared_ptr<Logging::ILogger> logger,
+        System::Dispatcher &dispatcher,
+        VirtualClock &clock,
+        const std::string &dataDirectory):
+        m_index(index),
+        m_clock(clock),
+        m_dataDirectory(dataDirectory)
+    {
+        fs::create_directories(m_dataDirectory);
+
+        const auto cacheFile = (fs::path(m_dataDirectory) / "blockchaincache.bin").string();
+
+        /* The root cache is loaded from this file when Core starts, so seed
+           it with a cache holding just the genesis block */
+        CryptoNote::BlockchainCache(cacheFile, currency, logger, nullptr, 0).save();
+
+        m_core = std::make_shared<CryptoNote::Core>(
+            currency,
+            logger,
+            CryptoNote::Checkpoints(logger),
+            dispatcher,
+            std::make_unique<CryptoNote::MemoryBlockchainCacheFactory>(cacheFile, logger),
+            CryptoNote::createSwappedMainChainStorage(m_dataDirectory, currency),
+            1);
+
+        m_core->load();
+
+        m_protocol =
+            std::make_unique<CryptoNote::CryptoNoteProtocolHandler>(currency, dispatcher, *m_core, this, logger);
+    }
+
+    SimulatedNode::~SimulatedNode()
+    {
+        m_protocol.reset();
+        m_core.reset();
+
+        std::error_code ec;
+        fs::remove_all(m_dataDirectory, ec);
+    }
+
+    void SimulatedNode::connect(SimulatedNode &a, SimulatedNode &b, const uint64_t latency, const uint64_t bandwidth)
+    {
+        const uint64_t now = a.m_clock.nowMicroseconds();
+
+        auto &outgoing = a.m_connections.emplace_back();
+        auto &incoming = b.m_connections.emplace_back();
+
+        outgoing.peer = &b;
+        outgoing.peerConnection = b.m_connections.size() - 1;
+        incoming.peer = &a;
+        incoming.peerConnection = a.m_connections.size() - 1;
+
+        const auto setUp = [&](Connection &connection, const size_t from, const size_t to, const bool isIncoming)
+        {
+            connection.latency = latency;
+            connection.bandwidth = bandwidth;
+            connection.context.version = CryptoNote::P2P_CURRENT_VERSION;
+            connection.context.m_connection_id = connectionId(from, to);
+            connection.context.m_is_income = isIncoming;
+            connection.context.m_started = static_cast<time_t>(now / 1000000);
+        };
+
+        setUp(outgoing, a.m_index, b.m_index, false);
+        setUp(incoming, b.m_index, a.m_index, true);
+
+        /* Each side takes the other's top block from the handshake */
+        CryptoNote::CORE_SYNC_DATA aSyncData;
+        CryptoNote::CORE_SYNC_DATA bSyncData;
+
+        a.m_protocol->get_payload_sync_data(aSyncData);
+        b.m_protocol->get_payload_sync_data(bSyncData);
+
+        b.m_protocol->process_payload_sync_data(aSyncData, incoming.context, true);
+        a.m_protocol->process_payload_sync_data(bSyncData, outgoing.context, true);
+
+        a.m_protocol->onConnectionOpened(outgoing.context);
+        b.m_protocol->onConnectionOpened(incoming.context);
+
+        a.advanceState(outgoing);
+        b.advanceState(incoming);
+    }
+
+    size_t SimulatedNode::getIndex() const
+    {
+        return m_index;
+    }
+
+    bool SimulatedNode::isConnectedTo(const SimulatedNode &other) const
+    {
+        return std::any_of(
+            m_connections.begin(),
+            m_connections.end(),
+            [&other](const Connection &connection) { return connection.open && connection.peer == &other; });
+    }
+
+    const std::shared_ptr<CryptoNote::Core> &SimulatedNode::getCore() const
+    {
+        return m_core;
+    }
+
+    CryptoNote::ICryptoNoteProtocolHandler &SimulatedNode::getProtocol()
+    {
+        return *m_protocol;
+    }
+
+    void SimulatedNode::setDeadlineAwareRelay(const bool enabled)
+    {
+        m_protocol->setDeadlineAwareRelay(enabled);
+    }
+
+    void SimulatedNode::setReceiveCallback(
+        std::function<void(SimulatedNode &, int, const CryptoNote::BinaryArray &)> callback)
+    {
+        m_receiveCallback = std::move(callback);
+    }
+
+    const std::map<int, Traffic> &SimulatedNode::getTraffic() const
+    {
+        return m_traffic;
+    }
+
+    void SimulatedNode::relay_notify_to_all(
+        int command,
+        const CryptoNote::BinaryArray &data_buff,
+        const boost::uuids::uuid *excludeConnection)
+    {
+        /* Shared between every peer it goes to, rather than copied */
+        const auto data = std::make_shared<const CryptoNote::BinaryArray>(data_buff);
+
+        for (auto &connection : m_connections)
+        {
+            if (connection.open
+                && (excludeConnection == nullptr || connection.context.m_connection_id != *excludeConnection))
+            {
+                send(connection, command, data);
+            }
+        }
+    }
+
+    bool SimulatedNode::invoke_notify_to_peer(
+        int command,
+        const CryptoNote::BinaryArray &req_buff,
+        const CryptoNote::CryptoNoteConnectionContext &context)
+    {
+        Connection *connection = findConnection(context.m_connection_id);
+
+        if (connection == nullptr)
+        {
+            return false;
+        }
+
+        send(*connection, command, std::make_shared<const CryptoNote::BinaryArray>(req_buff));
+
+        return true;
+    }
+
+    uint64_t SimulatedNode::get_connections_count()
+    {
+        return std::count_if(
+            m_connections.begin(), m_connections.end(), [](const Connection &connection) { return connection.open; });
+    }
+
+    void SimulatedNode::for_each_connection(
+        std::function<void(CryptoNote::CryptoNoteConnectionContext &, uint64_t)> f)
+    {
+        for (auto &connection : m_connections)
+        {
+            if (connection.open)
+            {
+                f(connection.context, connection.peer->m_index);
+            }
+        }
+    }
+
+    void SimulatedNode::externalRelayNotifyToAll(
+        int command,
+        const CryptoNote::BinaryArray &data_buff,
+        const boost::uuids::uuid *excludeConnection)
+    {
+        /* Everything runs on the simulator's thread, so there's nothing to
+           hand over to */
+        relay_notify_to_all(command, data_buff, excludeConnection);
+    }
+
+    void SimulatedNode::externalRelayNotifyToList(
+        int command,
+        const CryptoNote::BinaryArray &data_buff,
+        const std::list<boost::uuids::uuid> relayList)
+    {
+        const auto data = std::make_shared<const CryptoNote::BinaryArray>(data_buff);
+
+        for (const auto &id : relayList)
+        {
+            if (Connection *connection = findConnection(id))
+            {
+                send(*connection, command, data);
+            }
+        }
+    }
+
+    void SimulatedNode::send(
+        Connection &connection,
+        int command,
+        const std::shared_ptr<const CryptoNote::BinaryArray> &data)
+    {
+        const uint64_t bytes = data->size() + LEVIN_HEADER_SIZE;
+
+        auto &traffic = m_traffic[command];
+
+        traffic.messages++;
+        traffic.bytes += bytes;
+
+        /* Messages queue up behind each other on the link, as on a socket */
+        const uint64_t start = std::max(m_clock.nowMicroseconds(), connection.busyUntil);
+
+        const uint64_t sendTime =
+            connection.bandwidth == 0 ? 0 : (bytes * 8 + connection.bandwidth - 1) / connection.bandwidth;
+
+        connection.busyUntil = start + sendTime;
+
+        SimulatedNode *peer = connection.peer;
+
+        const size_t peerConnection = connection.peerConnection;
+
+        m_clock.schedule(
+            connection.busyUntil + connection.latency,
+            [peer, peerConnection, command, data]() { peer->receive(peerConnection, command, *data); });
+    }
+
+    void SimulatedNode::receive(size_t connectionIndex, int command, const CryptoNote::BinaryArray &data)
+    {
+        Connection &connection = m_connections[connectionIndex];
+
+        /* Dropped while the message was on its way */
+        if (!connection.open)
+        {
+            return;
+        }
+
+        CryptoNote::BinaryArray response;
+
+        bool handled = false;
+
+        try
+        {
+            m_protocol->handleCommand(true, command, data, response, connection.context, handled);
+        }
+        catch (const std::exception &)
+        {
+            /* NodeServer drops the connection */
+            connection.context.m_state = CryptoNote::CryptoNoteConnectionContext::state_shutdown;
+        }
+
+        if (connection.context.m_state == CryptoNote::CryptoNoteConnectionContext::state_shutdown)
+        {
+            close(connection);
+        }
+        else
+        {
+            advanceState(connection);
+        }
+
+        if (m_receiveCallback)
+        {
+            m_receiveCallback(*this, command, data);
+        }
+    }
+
+    void SimulatedNode::advanceState(Connection &connection)
+    {
+        auto &context = connection.context;
+
+        if (context.m_state == CryptoNote::CryptoNoteConnectionContext::state_sync_required)
+        {
+            context.m_state = CryptoNote::CryptoNoteConnectionContext::state_synchronizing;
+            m_protocol->start_sync(context);
+        }
+        else if (context.m_state == CryptoNote::CryptoNoteConnectionContext::state_pool_sync_required)
+        {
+            context.m_state = CryptoNote::CryptoNoteConnectionContext::state_normal;
+            m_protocol->requestMissingPoolTransactions(context);
+        }
+    }
+
+    void SimulatedNode::close(Connection &connection)
+    {
+        if (!connection.open)
+        {
+            return;
+        }
+
+        connection.open = false;
+
+        m_protocol->onConnectionClosed(connection.context);
+
+        /* The peer sees the socket close */
+        connection.peer->close(connection.peer->m_connections[connection.peerConnection]);
+    }
+
+    SimulatedNode::Connection *SimulatedNode::findConnection(const boost::uuids::uuid &id)
+    {
+        for (auto &connection : m_connections)
+        {
+            if (connection.open && connection.context.m_connection_id == id)
+            {
+                return &connection;
+            }
+        }
+
+        return nullptr;
+    }
+
+} // namespace Simulator
@@ -0,0 +1,153 @@
+// Copyright (c) 2018-2020, The TurtleCoin Developers
+//
+// Please see the included LICENSE file for more information.
+
+#pragma once
+
+#include "VirtualClock.h"
+
+#include <cryptonotecore/Core.h>
+#include <cryptonotecore/Currency.h>
+#include <cryptonoteprotocol/CryptoNoteProtocolHandler.h>
+#include <deque>
+#include <functional>
+#include <logging/ILogger.h>
+#include <map>
+#include <memory>
+#include <p2p/NetNodeCommon.h>
+#include <system/Dispatcher.h>
+
+namespace Simulator
+{
+    /* Messages and bytes sent for one command */
+    struct Traffic
+    {
+        uint64_t messages = 0;
+
+        uint64_t bytes = 0;
+    };
+
+    /* A Core and CryptoNoteProtocolHandler, as the daemon runs them, with
+       this standing in for the NodeServer beneath them.
+
+       NodeServer is built on TCP sockets and real time timers, so rather
+       than that, peers are connected by in-memory links, and messages are
+       scheduled on the virtual clock to arrive after the link's delay, and
+       the time it takes to send them at the link's bandwidth. Everything
+       above the NodeServer - handshakes, relaying, lite blocks, syncing -
+       is the daemon's own code. */
+    class SimulatedNode : public CryptoNote::IP2pEndpoint
+    {
+      public:
+        SimulatedNode(
+            const size_t index,
+            const CryptoNote::Currency &currency,
+            std::shared_ptr<Logging::ILogger> logger,
+            System::Dispatcher &dispatcher,
+            VirtualClock &clock,
+            const std::string &dataDirectory);
+
+        virtual ~SimulatedNode() override;
+
+        /* Connects two nodes, and has them handshake as NodeServer would.
+           latency is in microseconds, bandwidth in megabits per second each
+           way, 0 for no limit. */
+        static void connect(SimulatedNode &a, SimulatedNode &b, const uint64_t latency, const uint64_t bandwidth);
+
+        size_t getIndex() const;
+
+        bool isConnectedTo(const SimulatedNode &other) const;
+
+        const std::shared_ptr<CryptoNote::Core> &getCore() const;
+
+        CryptoNote::ICryptoNoteProtocolHandler &getProtocol();
+
+        /* As CryptoNoteProtocolHandler::setDeadlineAwareRelay() */
+        void setDeadlineAwareRelay(const bool enabled);
+
+        /* Called with each command after the node has handled it */
+        void setReceiveCallback(std::function<void(SimulatedNode &, int, const CryptoNote::BinaryArray &)> callback);
+
+        /* By command */
+        const std::map<int, Traffic> &getTraffic() const;
+
+        /* IP2pEndpoint */
+        virtual void relay_notify_to_all(
+            int command,
+            const CryptoNote::BinaryArray &data_buff,
+            const boost::uuids::uuid *excludeConnection) override;
+
+        virtual bool invoke_notify_to_peer(
+            int command,
+            const CryptoNote::BinaryArray &req_buff,
+            const CryptoNote::CryptoNoteConnectionContext &context) override;
+
+        virtual uint64_t get_connections_count() override;
+
+        virtual void for_each_connection(
+            std::function<void(CryptoNote::CryptoNoteConnectionContext &, uint64_t)> f) override;
+
+        virtual void externalRelayNotifyToAll(
+            int command,
+            const CryptoNote::BinaryArray &data_buff,
+            const boost::uuids::uuid *excludeConnection) override;
+
+        virtual void externalRelayNotifyToList(
+            int command,
+            const CryptoNote::BinaryArray &data_buff,
+            const std::list<boost::uuids::uuid> relayList) override;
+
+      private:
+        struct Connection
+        {
+            CryptoNote::CryptoNoteConnectionContext context;
+
+            SimulatedNode *peer;
+
+            /* Index of the other end in the peer's connections */
+            size_t peerConnection;
+
+            /* Microseconds */
+            uint64_t latency;
+
+            /* Megabits per second, or bits per microsecond */
+            uint64_t bandwidth;
+
+            /* When the link will have finished sending what it has been
+               given so far, unix microseconds */
+            uint64_t busyUntil = 0;
+
+            bool open = true;
+        };
+
+        void send(Connection &connection, int command, const std::shared_ptr<const CryptoNote::BinaryArray> &data);
+
+        void receive(size_t connectionIndex, int command, const CryptoNote::BinaryArray &data);
+
+        /* As NodeServer's connection handler does between commands */
+        void advanceState(Connection &connection);
+
+        void close(Connection &connection);
+
+        Connection *findConnection(const boost::uuids::uuid &id);
+
+        const size_t m_index;
+
+        VirtualClock &m_clock;
+
+        const std::string m_dataDirectory;
+
+        std::shared_ptr<CryptoNote::Core> m_core;
+
+        /* After the core, so it is destroyed first */
+        std::unique_ptr<CryptoNote::CryptoNoteProtocolHandler> m_protocol;
+
+        /* A deque, so the contexts handed to the protocol handler never move */
+        std::deque<Connection> m_connections;
+
+        std::map<int, Traffic> m_traffic;
+
+        std::function<void(SimulatedNode &, int, const CryptoNote::BinaryArray &)> m_receiveCallback;
+    };
+
+} // namespace Simulator
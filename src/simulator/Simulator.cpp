@@ -0,0 +1,632 @@
+// Copyright (c) 2018-2020, The TurtleCoin Developers
+//
+// Please see the included LICENSE file for more information.
+
+////////////////////////////////
+#include "Simulator.h"
+////////////////////////////////
+
+#include <common/CryptoNoteTools.h>
+#include <common/TransactionExtra.h>
+#include <crypto/crypto.h>
+#include <cryptonotecore/CachedBlock.h>
+#include <cryptonotecore/TransactionUtils.h>
+#include <cryptonotecore/TransactionView.h>
+#include <cryptonoteprotocol/CryptoNoteProtocolDefinitions.h>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <logging/DummyLogger.h>
+#include <p2p/LevinProtocol.h>
+#include <serialization/ISerializer.h>
+#include <utilities/ColouredMsg.h>
+#include <utilities/Metrics.h>
+
+namespace fs = std::filesystem;
+
+namespace Simulator
+{
+    namespace
+    {
+        /* Longest the producer waits before checking again whether a block
+           is due, as BlockProducer does. Milliseconds. */
+        const uint64_t PRODUCER_MAX_WAIT = 1000;
+
+        /* The transactions from a NOTIFY_NEW_TRANSACTIONS, which are all we
+           need to know who has what */
+        struct NewTransactions
+        {
+            std::vector<std::string> txs;
+        };
+
+        void serialize(NewTransactions &request, CryptoNote::ISerializer &s)
+        {
+            s(request.txs, "txs");
+        }
+
+        double toMilliseconds(const uint64_t microseconds)
+        {
+            return microseconds / 1000.0;
+        }
+
+        void printLatency(const std::string &name, const LatencyHistogram &histogram)
+        {
+            std::cout << std::left << std::setw(30) << name << std::right << std::setw(10) << histogram.count()
+                      << std::fixed << std::setprecision(1) << std::setw(10)
+                      << toMilliseconds(histogram.valueAtPercentile(50)) << std::setw(10)
+                      << toMilliseconds(histogram.valueAtPercentile(90)) << std::setw(10)
+                      << toMilliseconds(histogram.valueAtPercentile(99)) << std::setw(10)
+                      << toMilliseconds(histogram.max()) << "\n";
+        }
+
+        std::string commandName(const int command)
+        {
+            switch (command)
+            {
+                case CryptoNote::NOTIFY_NEW_BLOCK::ID:
+                {
+                    return "NOTIFY_NEW_BLOCK";
+                }
+                case CryptoNote::NOTIFY_NEW_TRANSACTIONS::ID:
+                {
+                    return "NOTIFY_NEW_TRANSACTIONS";
+                }
+                case CryptoNote::NOTIFY_REQUEST_GET_OBJECTS::ID:
+                {
+                    return "NOTIFY_REQUEST_GET_OBJECTS";
+                }
+                case CryptoNote::NOTIFY_RESPONSE_GET_OBJECTS::ID:
+                {
+                    return "NOTIFY_RESPONSE_GET_OBJECTS";
+                }
+                case CryptoNote::NOTIFY_REQUEST_CHAIN::ID:
+                {
+                    return "NOTIFY_REQUEST_CHAIN";
+                }
+                case CryptoNote::NOTIFY_RESPONSE_CHAIN_ENTRY::ID:
+                {
+                    return "NOTIFY_RESPONSE_CHAIN_ENTRY";
+                }
+                case CryptoNote::NOTIFY_REQUEST_TX_POOL::ID:
+                {
+                    return "NOTIFY_REQUEST_TX_POOL";
+                }
+                case CryptoNote::NOTIFY_NEW_LITE_BLOCK::ID:
+                {
+                    return "NOTIFY_NEW_LITE_BLOCK";
+                }
+                case CryptoNote::NOTIFY_MISSING_TXS::ID:
+                {
+                    return "NOTIFY_MISSING_TXS";
+                }
+                default:
+                {
+                    return std::to_string(command);
+                }
+            }
+        }
+    } // namespace
+
+    Simulator::Simulator(const SimulatorConfig &config):
+        m_config(config),
+        /* A hundred nodes logging every block would drown out the results */
+        m_logger(std::make_shared<Logging::DummyLogger>()),
+        m_currency(CryptoNote::CurrencyBuilder(m_logger).currency()),
+        m_random(config.seed),
+        /* Whole seconds, so block timestamps fall the same way every run */
+        m_clock(CryptoNote::RealTimeProvider().now() * 1000000ull),
+        m_startTime(m_clock.nowMicroseconds())
+    {
+        Crypto::SecretKey secretKey;
+
+        Crypto::generate_keys(m_publicSpendKey, secretKey);
+        Crypto::generate_keys(m_publicViewKey, secretKey);
+    }
+
+    Simulator::~Simulator()
+    {
+        m_nodes.clear();
+
+        CryptoNote::setTimeProvider(nullptr);
+
+        if (!m_dataDirectory.empty())
+        {
+            std::error_code ec;
+            fs::remove_all(m_dataDirectory, ec);
+        }
+    }
+
+    void Simulator::run()
+    {
+        m_dataDirectory =
+            (fs::temp_directory_path() / ("simulator-" + std::to_string(std::random_device()()))).string();
+
+        /* Everything from here on runs on simulated time */
+        CryptoNote::setTimeProvider(&m_clock);
+
+        std::cout << InformationMsg("Starting ") << SuccessMsg(m_config.nodes) << InformationMsg(" nodes in ")
+                  << SuccessMsg(m_dataDirectory) << std::endl;
+
+        createNodes();
+
+        connectNodes();
+
+        std::cout << InformationMsg("Connected them with ") << SuccessMsg(m_links) << InformationMsg(" links")
+                  << "\n\n";
+
+        scheduleNextTransaction();
+
+        const auto realStart = std::chrono::steady_clock::now();
+
+        m_clock.runUntil(m_startTime + m_config.duration * 1000000);
+
+        printSummary(std::chrono::steady_clock::now() - realStart);
+    }
+
+    void Simulator::createNodes()
+    {
+        for (size_t i = 0; i < m_config.nodes; i++)
+        {
+            auto node = std::make_unique<SimulatedNode>(
+                i,
+                m_currency,
+                m_logger,
+                m_dispatcher,
+                m_clock,
+                (fs::path(m_dataDirectory) / ("node-" + std::to_string(i))).string());
+
+            node->getCore()->setBlockCadence(m_config.blockPolicy, m_config.deadlineSlack);
+
+            node->setDeadlineAwareRelay(m_config.deadlineRelay);
+
+            node->setReceiveCallback([this](SimulatedNode &receiver, int command, const CryptoNote::BinaryArray &data) {
+                onReceive(receiver, command, data);
+            });
+
+            m_nodes.push_back(std::move(node));
+        }
+
+        /* As the daemon does when it produces blocks itself */
+        if (m_config.maxInterval != 0)
+        {
+            m_nodes[0]->getCore()->setBlockInterval(m_config.maxInterval);
+        }
+
+        m_seenHeights.assign(m_nodes.size(), 0);
+
+        /* The genesis block */
+        m_blocks.resize(1);
+    }
+
+    void Simulator::connectNodes()
+    {
+        const size_t nodeCount = m_nodes.size();
+
+        const uint64_t degree = std::min<uint64_t>(m_config.degree, nodeCount - 1);
+
+        /* A random tree first, so every node can reach every other */
+        for (size_t i = 1; i < nodeCount; i++)
+        {
+            std::uniform_int_distribution<size_t> distribution(0, i - 1);
+
+            SimulatedNode::connect(*m_nodes[i], *m_nodes[distribution(m_random)], linkLatency(), m_config.bandwidth);
+
+            m_links++;
+        }
+
+        /* Then random links until everyone has enough peers */
+        std::uniform_int_distribution<size_t> distribution(0, nodeCount - 1);
+
+        for (size_t i = 0; i < nodeCount; i++)
+        {
+            auto &node = *m_nodes[i];
+
+            while (node.get_connections_count() < degree)
+            {
+                auto &peer = *m_nodes[distribution(m_random)];
+
+                if (&peer == &node || node.isConnectedTo(peer))
+                {
+                    continue;
+                }
+
+                SimulatedNode::connect(node, peer, linkLatency(), m_config.bandwidth);
+
+                m_links++;
+            }
+        }
+    }
+
+    uint64_t Simulator::linkLatency()
+    {
+        std::uniform_int_distribution<uint64_t> distribution(m_config.minLatency * 1000, m_config.maxLatency * 1000);
+
+        return distribution(m_random);
+    }
+
+    void Simulator::scheduleNextTransaction()
+    {
+        if (m_config.transactionRate == 0)
+        {
+            return;
+        }
+
+        std::exponential_distribution<double> gap(m_config.transactionRate);
+
+        m_clock.scheduleAfter(static_cast<uint64_t>(gap(m_random) * 1000000), [this]() {
+            sendTransaction();
+            scheduleNextTransaction();
+        });
+    }
+
+    void Simulator::sendTransaction()
+    {
+        std::uniform_int_distribution<size_t> nodeDistribution(0, m_nodes.size() - 1);
+
+        std::uniform_int_distribution<uint64_t> deadlineDistribution(m_config.deadlineMin, m_config.deadlineMax);
+
+        auto &node = *m_nodes[nodeDistribution(m_random)];
+
+        const uint64_t now = m_clock.nowMicroseconds();
+
+        const uint64_t deadline = now / 1000 + deadlineDistribution(m_random);
+
+        /* The sequence number as the nonce, so runs stay reproducible */
+        const CryptoNote::Transaction transaction =
+            CryptoNote::createHackTransaction(m_config.transactionSize, deadline, m_transactions.size());
+
+        const auto blob = CryptoNote::toBinaryArray(transaction);
+
+        const CryptoNote::TransactionView view(blob);
+
+        const auto [success, error, rejection] = node.getCore()->addTransactionToPool(view);
+
+        if (!success)
+        {
+            m_rejected++;
+            return;
+        }
+
+        TransactionRecord record;
+
+        record.sent = now;
+        record.deadline = deadline;
+        record.seenBy.assign(m_nodes.size(), false);
+
+        m_transactionIndexes[view.getTransactionHash()] = m_transactions.size();
+        m_transactions.push_back(std::move(record));
+
+        recordTransactionSeen(node, view.getTransactionHash());
+
+        node.getProtocol().relayTransactions({blob});
+
+        if (node.getIndex() == 0)
+        {
+            scheduleProducerCheck(now);
+        }
+    }
+
+    void Simulator::onReceive(SimulatedNode &node, int command, const CryptoNote::BinaryArray &data)
+    {
+        if (command == CryptoNote::NOTIFY_NEW_TRANSACTIONS::ID)
+        {
+            NewTransactions request;
+
+            if (CryptoNote::LevinProtocol::decode(data, request))
+            {
+                for (const auto &transaction : request.txs)
+                {
+                    recordTransactionSeen(node, Crypto::cn_fast_hash(transaction.data(), transaction.size()));
+                }
+            }
+
+            /* Like BlockProducer, wake up when something new arrives */
+            if (node.getIndex() == 0)
+            {
+                scheduleProducerCheck(m_clock.nowMicroseconds());
+            }
+        }
+
+        recordBlocksSeen(node);
+    }
+
+    void Simulator::recordTransactionSeen(SimulatedNode &node, const Crypto::Hash &hash)
+    {
+        const auto it = m_transactionIndexes.find(hash);
+
+        if (it == m_transactionIndexes.end())
+        {
+            return;
+        }
+
+        auto &record = m_transactions[it->second];
+
+        if (record.seenBy[node.getIndex()] || !node.getCore()->hasTransaction(hash))
+        {
+            return;
+        }
+
+        record.seenBy[node.getIndex()] = true;
+        record.seenCount++;
+
+        const uint64_t elapsed = m_clock.nowMicroseconds() - record.sent;
+
+        m_transactionToNode.record(elapsed);
+
+        if (record.seenCount == m_nodes.size())
+        {
+            m_transactionToAll.record(elapsed);
+        }
+    }
+
+    void Simulator::recordBlocksSeen(SimulatedNode &node)
+    {
+        const uint32_t topIndex = node.getCore()->getTopBlockIndex();
+
+        auto &seenHeight = m_seenHeights[node.getIndex()];
+
+        while (seenHeight < topIndex && seenHeight + 1 < m_blocks.size())
+        {
+            seenHeight++;
+
+            auto &block = m_blocks[seenHeight];
+
+            block.seenCount++;
+
+            const uint64_t elapsed = m_clock.nowMicroseconds() - block.produced;
+
+            m_blockToNode.record(elapsed);
+
+            if (block.seenCount == m_nodes.size())
+            {
+                m_blockToAll.record(elapsed);
+            }
+        }
+    }
+
+    void Simulator::scheduleProducerCheck(const uint64_t time)
+    {
+        if (time >= m_nextProducerCheck)
+        {
+            return;
+        }
+
+        m_nextProducerCheck = time;
+
+        const uint64_t generation = ++m_producerCheckGeneration;
+
+        m_clock.schedule(time, [this, generation]() {
+            if (generation != m_producerCheckGeneration)
+            {
+                return;
+            }
+
+            m_nextProducerCheck = std::numeric_limits<uint64_t>::max();
+
+            checkProducer();
+        });
+    }
+
+    void Simulator::checkProducer()
+    {
+        const auto &core = m_nodes[0]->getCore();
+
+        /* Woken up again by the next transaction to arrive */
+        if (core->getPoolTransactionCount() == 0)
+        {
+            return;
+        }
+
+        const uint64_t now = m_clock.nowMicroseconds() / 1000;
+
+        /* The same decision as BlockProducer::timeUntilDue() */
+        uint64_t due = core->getBlockCadence().sealAt;
+
+        if (due == CryptoNote::BlockCadencePlan::NO_SEAL_TIME && m_config.maxInterval == 0)
+        {
+            due = now;
+        }
+
+        if (m_config.maxInterval != 0)
+        {
+            due = std::min(due, m_lastBlockTime + m_config.maxInterval);
+        }
+
+        if (due > now)
+        {
+            scheduleProducerCheck(std::min(due, now + PRODUCER_MAX_WAIT) * 1000);
+            return;
+        }
+
+        if (produceBlock())
+        {
+            m_lastBlockTime = now;
+            scheduleProducerCheck(now * 1000);
+        }
+        else
+        {
+            scheduleProducerCheck((now + PRODUCER_MAX_WAIT) * 1000);
+        }
+    }
+
+    bool Simulator::produceBlock()
+    {
+        auto &producer = *m_nodes[0];
+
+        const auto &core = producer.getCore();
+
+        CryptoNote::BlockTemplate blockTemplate;
+
+        uint64_t difficulty;
+
+        bool isEmpty;
+
+        uint32_t height;
+
+        const auto [success, error] = core->getBlockTemplate(
+            blockTemplate, m_publicViewKey, m_publicSpendKey, {}, difficulty, isEmpty, height);
+
+        if (!success || isEmpty)
+        {
+            return false;
+        }
+
+        /* As BlockProducer does */
+        if (blockTemplate.majorVersion >= CryptoNote::BLOCK_MAJOR_VERSION_2)
+        {
+            CryptoNote::TransactionExtraMergeMiningTag mmTag;
+            mmTag.depth = 0;
+            mmTag.merkleRoot = CryptoNote::CachedBlock(blockTemplate).getAuxiliaryBlockHeaderHash();
+
+            blockTemplate.parentBlock.baseTransaction.extra.clear();
+
+            if (!CryptoNote::appendMergeMiningTagToExtra(blockTemplate.parentBlock.baseTransaction.extra, mmTag))
+            {
+                return false;
+            }
+        }
+
+        const std::vector<uint8_t> rawBlock = CryptoNote::toBinaryArray(blockTemplate);
+
+        const auto submitResult = core->submitBlock(rawBlock);
+
+        if (submitResult != CryptoNote::error::AddBlockErrorCode::ADDED_TO_MAIN)
+        {
+            return false;
+        }
+
+        const uint64_t now = m_clock.nowMicroseconds();
+
+        m_blocks.resize(std::max<size_t>(m_blocks.size(), core->getTopBlockIndex() + 1));
+
+        m_blocks[core->getTopBlockIndex()].produced = now;
+
+        recordBlocksSeen(producer);
+
+        for (const auto &hash : blockTemplate.transactionHashes)
+        {
+            const auto it = m_transactionIndexes.find(hash);
+
+            if (it == m_transactionIndexes.end() || m_transactions[it->second].included)
+            {
+                continue;
+            }
+
+            auto &record = m_transactions[it->second];
+
+            record.included = true;
+
+            if (now / 1000 <= record.deadline)
+            {
+                m_met++;
+            }
+            else
+            {
+                m_missed++;
+            }
+        }
+
+        m_blockTransactions += blockTemplate.transactionHashes.size();
+
+        CryptoNote::NOTIFY_NEW_BLOCK::request newBlockMessage;
+
+        newBlockMessage.block = CryptoNote::RawBlockLegacy(rawBlock, blockTemplate, core);
+
+        newBlockMessage.hop = 0;
+
+        newBlockMessage.current_blockchain_height = core->getTopBlockIndex() + 1;
+
+        producer.getProtocol().relayBlock(newBlockMessage);
+
+        return true;
+    }
+
+    void Simulator::printSummary(const std::chrono::nanoseconds realTime) const
+    {
+        const double realSeconds = std::chrono::duration<double>(realTime).count();
+
+        const uint64_t blocks = m_blocks.size() - 1;
+
+        uint64_t pending = 0;
+
+        uint64_t fullyPropagated = 0;
+
+        /* Every node's skips, as they all share the process's metrics */
+        const auto &relaySkipped = Metrics::registry().counter(
+            "p2p_relay_skipped_transactions_total", "Transactions not relayed as they can't make their deadline");
+
+        const auto &relaySkippedBytes = Metrics::registry().counter(
+            "p2p_relay_skipped_bytes_total", "Bytes of transactions not relayed as they can't make their deadline");
+
+        const uint64_t endTime = m_startTime + m_config.duration * 1000000;
+
+        /* In a block, or out of time - the rest could still make it */
+        uint64_t settled = 0;
+
+        for (const auto &record : m_transactions)
+        {
+            pending += record.included ? 0 : 1;
+            fullyPropagated += record.seenCount == m_nodes.size() ? 1 : 0;
+            settled += record.included || record.deadline * 1000 < endTime ? 1 : 0;
+        }
+
+        std::cout << InformationMsg("Simulated ") << SuccessMsg(m_config.duration) << InformationMsg(" seconds in ")
+                  << std::fixed << std::setprecision(2) << SuccessMsg(realSeconds) << InformationMsg(" seconds (")
+                  << SuccessMsg(m_clock.getEventsRun()) << InformationMsg(" events)") << "\n\n";
+
+        std::cout << InformationMsg("Transactions sent:          ") << SuccessMsg(m_transactions.size() + m_rejected)
+                  << "\n"
+                  << InformationMsg("Rejected by the first node: ") << SuccessMsg(m_rejected) << "\n"
+                  << InformationMsg("Reached every node:         ") << SuccessMsg(fullyPropagated) << "\n"
+                  << InformationMsg("Deadline met:               ") << SuccessMsg(m_met) << "\n"
+                  << InformationMsg("Deadline missed:            ") << SuccessMsg(m_missed) << "\n"
+                  << InformationMsg("Not yet in a block:         ") << SuccessMsg(pending) << "\n"
+                  << InformationMsg("Deadline met ratio:         ") << std::setprecision(4)
+                  << SuccessMsg(settled == 0 ? 0.0 : static_cast<double>(m_met) / settled)
+                  << "\n"
+                  << InformationMsg("Relays skipped:             ") << SuccessMsg(relaySkipped.value()) << "\n"
+                  << InformationMsg("Relay bytes skipped:        ") << SuccessMsg(relaySkippedBytes.value()) << "\n"
+                  << InformationMsg("Blocks produced:            ") << SuccessMsg(blocks) << "\n"
+                  << InformationMsg("Transactions per block:     ") << std::setprecision(1)
+                  << SuccessMsg(blocks == 0 ? 0.0 : static_cast<double>(m_blockTransactions) / blocks) << "\n\n";
+
+        std::cout << std::left << std::setw(30) << "Propagation (ms)" << std::right << std::setw(10) << "Count"
+                  << std::setw(10) << "p50" << std::setw(10) << "p90" << std::setw(10) << "p99" << std::setw(10)
+                  << "Max" << "\n";
+
+        printLatency("Transaction to each node", m_transactionToNode);
+        printLatency("Transaction to every node", m_transactionToAll);
+        printLatency("Block to each node", m_blockToNode);
+        printLatency("Block to every node", m_blockToAll);
+
+        std::map<int, Traffic> traffic;
+
+        for (const auto &node : m_nodes)
+        {
+            for (const auto &[command, counts] : node->getTraffic())
+            {
+                traffic[command].messages += counts.messages;
+                traffic[command].bytes += counts.bytes;
+            }
+        }
+
+        Traffic total;
+
+        std::cout << "\n"
+                  << std::left << std::setw(30) << "Traffic" << std::right << std::setw(12) << "Messages"
+                  << std::setw(16) << "Bytes" << "\n";
+
+        for (const auto &[command, counts] : traffic)
+        {
+            std::cout << std::left << std::setw(30) << commandName(command) << std::right << std::setw(12)
+                      << counts.messages << std::setw(16) << counts.bytes << "\n";
+
+            total.messages += counts.messages;
+            total.bytes += counts.bytes;
+        }
+
+        std::cout << std::left << std::setw(30) << "Total" << std::right << std::setw(12) << total.messages
+                  << std::setw(16) << total.bytes << std::endl;
+    }
+
+} // namespace Simulator
@@ -0,0 +1,166 @@
+// Copyright (c) 2018-2020, The TurtleCoin Developers
+//
+// Please see the included LICENSE file for more information.
+
+#pragma once
+
+#include "SimulatedNode.h"
+#include "SimulatorConfig.h"
+#include "VirtualClock.h"
+
+#include <CryptoTypes.h>
+#include <cryptonotecore/Currency.h>
+#include <limits>
+#include <logging/ILogger.h>
+#include <memory>
+#include <random>
+#include <system/Dispatcher.h>
+#include <unordered_map>
+#include <utilities/LatencyHistogram.h>
+#include <vector>
+
+namespace Simulator
+{
+    /* A transaction sent into the network */
+    struct TransactionRecord
+    {
+        /* Unix microseconds */
+        uint64_t sent;
+
+        /* Unix milliseconds */
+        uint64_t deadline;
+
+        /* Nodes with it in their pool */
+        std::vector<bool> seenBy;
+
+        uint64_t seenCount = 0;
+
+        bool included = false;
+    };
+
+    /* A block made by the producing node */
+    struct BlockRecord
+    {
+        /* Unix microseconds */
+        uint64_t produced = 0;
+
+        /* Nodes that have added it */
+        uint64_t seenCount = 0;
+    };
+
+    /* Runs a network of nodes in one process, on a virtual clock.
+
+       Node 0 produces blocks as the daemon's BlockProducer would, and
+       transactions are sent to random nodes as a Poisson process. The
+       latency histograms are all in microseconds of simulated time. */
+    class Simulator
+    {
+      public:
+        Simulator(const SimulatorConfig &config);
+
+        ~Simulator();
+
+        void run();
+
+      private:
+        void createNodes();
+
+        void connectNodes();
+
+        /* Random one way delay for a new link, microseconds */
+        uint64_t linkLatency();
+
+        void scheduleNextTransaction();
+
+        void sendTransaction();
+
+        void onReceive(SimulatedNode &node, int command, const CryptoNote::BinaryArray &data);
+
+        /* Records the node having the transaction, if it does */
+        void recordTransactionSeen(SimulatedNode &node, const Crypto::Hash &hash);
+
+        /* Records any blocks the node has added since we last looked */
+        void recordBlocksSeen(SimulatedNode &node);
+
+        /* Has the producer check whether a block is due at time, unless it
+           already will by then */
+        void scheduleProducerCheck(const uint64_t time);
+
+        void checkProducer();
+
+        /* Returns false if there was nothing to put in the block, or the
+           core rejected it */
+        bool produceBlock();
+
+        void printSummary(const std::chrono::nanoseconds realTime) const;
+
+        const SimulatorConfig m_config;
+
+        std::shared_ptr<Logging::ILogger> m_logger;
+
+        const CryptoNote::Currency m_currency;
+
+        /* Holds every node's data directory */
+        std::string m_dataDirectory;
+
+        std::mt19937_64 m_random;
+
+        VirtualClock m_clock;
+
+        /* Unix microseconds */
+        const uint64_t m_startTime;
+
+        /* Shared by every node's Core and protocol handler. Outlives them. */
+        System::Dispatcher m_dispatcher;
+
+        std::vector<std::unique_ptr<SimulatedNode>> m_nodes;
+
+        uint64_t m_links = 0;
+
+        std::vector<TransactionRecord> m_transactions;
+
+        std::unordered_map<Crypto::Hash, size_t> m_transactionIndexes;
+
+        /* By height */
+        std::vector<BlockRecord> m_blocks;
+
+        /* Per node, the highest block we have recorded it adding */
+        std::vector<uint32_t> m_seenHeights;
+
+        /* Producer */
+        Crypto::PublicKey m_publicSpendKey;
+
+        Crypto::PublicKey m_publicViewKey;
+
+        /* Unix milliseconds */
+        uint64_t m_lastBlockTime = 0;
+
+        /* When the producer is next due to check, and the check that will
+           do it - any other is stale */
+        uint64_t m_nextProducerCheck = std::numeric_limits<uint64_t>::max();
+
+        uint64_t m_producerCheckGeneration = 0;
+
+        /* Results */
+        uint64_t m_rejected = 0;
+
+        uint64_t m_met = 0;
+
+        uint64_t m_missed = 0;
+
+        uint64_t m_blockTransactions = 0;
+
+        /* From being sent, to each node having it */
+        LatencyHistogram m_transactionToNode;
+
+        /* From being sent, to every node having it */
+        LatencyHistogram m_transactionToAll;
+
+        /* From being produced, to each node adding it */
+        LatencyHistogram m_blockToNode;
+
+        /* From being produced, to every node adding it */
+        LatencyHistogram m_blockToAll;
+    };
+
+} // namespace Simulator
@@ -0,0 +1,161 @@
+// Copyright (c) 2018-2020, The TurtleCoin Developers
+//
+// Please see the included LICENSE file for more information.
+
+////////////////////////////////
+#include "SimulatorConfig.h"
+////////////////////////////////
+
+#include <config/CliHeader.h>
+#include <cxxopts.hpp>
+#include <iostream>
+#include <utilities/ColouredMsg.h>
+
+namespace Simulator
+{
+    namespace
+    {
+        CryptoNote::BlockPolicy parseBlockPolicy(const std::string &str)
+        {
+            if (str == "static")
+            {
+                return CryptoNote::BlockPolicy::Static;
+            }
+            else if (str == "adaptive")
+            {
+                return CryptoNote::BlockPolicy::Adaptive;
+            }
+
+            throw std::runtime_error("--block-policy must be one of static, adaptive");
+        }
+    } // namespace
+
+    SimulatorConfig::SimulatorConfig(): help(false), version(false) {}
+
+    void SimulatorConfig::parse(int argc, char **argv)
+    {
+        cxxopts::Options options(argv[0], CryptoNote::getProjectCLIHeader());
+
+        std::string blockPolicyStr;
+
+        options.add_options("Core")(
+            "help", "Display this help message", cxxopts::value<bool>(help)->implicit_value("true"))(
+            "version",
+            "Output software version information",
+            cxxopts::value<bool>(version)->default_value("false")->implicit_value("true"));
+
+        options.add_options("Network")(
+            "nodes", "Number of nodes to simulate", cxxopts::value<uint64_t>(nodes)->default_value("20"), "#")(
+            "degree",
+            "Connect every node to at least this many peers",
+            cxxopts::value<uint64_t>(degree)->default_value("8"),
+            "#")(
+            "min-latency",
+            "Shortest one way delay of a link, in milliseconds",
+            cxxopts::value<uint64_t>(minLatency)->default_value("10"),
+            "#")(
+            "max-latency",
+            "Longest one way delay of a link, in milliseconds",
+            cxxopts::value<uint64_t>(maxLatency)->default_value("200"),
+            "#")(
+            "bandwidth",
+            "Bandwidth of each link, each way, in megabits per second. 0 means no limit",
+            cxxopts::value<uint64_t>(bandwidth)->default_value("100"),
+            "#")(
+            "deadline-relay",
+            "Skip relaying transactions that can no longer make their deadline, and relay the most urgent first",
+            cxxopts::value<bool>(deadlineRelay)->default_value("true"),
+            "<bool>");
+
+        options.add_options("Load")(
+            "duration",
+            "Simulated seconds to run for",
+            cxxopts::value<uint64_t>(duration)->default_value("60"),
+            "#")(
+            "rate",
+            "Transactions per second, sent to random nodes",
+            cxxopts::value<double>(transactionRate)->default_value("50"),
+            "#")(
+            "transaction-size",
+            "Size of each transaction in bytes",
+            cxxopts::value<uint64_t>(transactionSize)->default_value("512"),
+            "#")(
+            "deadline-min",
+            "Shortest deadline, in milliseconds after the transaction is sent",
+            cxxopts::value<uint64_t>(deadlineMin)->default_value("5000"),
+            "#")(
+            "deadline-max",
+            "Longest deadline, in milliseconds after the transaction is sent",
+            cxxopts::value<uint64_t>(deadlineMax)->default_value("30000"),
+            "#")(
+            "seed",
+            "Seed for the network layout and the transactions sent",
+            cxxopts::value<uint64_t>(seed)->default_value("1"),
+            "#");
+
+        options.add_options("Blocks")(
+            "block-policy",
+            "How the producing node sizes and seals blocks: static or adaptive",
+            cxxopts::value<std::string>(blockPolicyStr)->default_value("static"),
+            "<policy>")(
+            "deadline-slack",
+            "Seal a block this many milliseconds before the earliest deadline in the pool",
+            cxxopts::value<uint64_t>(deadlineSlack)->default_value("500"),
+            "#")(
+            "max-interval",
+            "Seal a block at least this often, in milliseconds, while the pool is not empty. 0 means no limit",
+            cxxopts::value<uint64_t>(maxInterval)->default_value("0"),
+            "#");
+
+        try
+        {
+            options.parse(argc, argv);
+        }
+        catch (const cxxopts::OptionException &e)
+        {
+            std::cout << WarningMsg("Error: Unable to parse command line argument options: ") << WarningMsg(e.what())
+                      << "\n\n";
+            std::cout << options.help({}) << std::endl;
+            exit(1);
+        }
+
+        if (help) // Do we want to display the help message?
+        {
+            std::cout << options.help({}) << std::endl;
+            exit(0);
+        }
+        else if (version) // Do we want to display the software version?
+        {
+            std::cout << InformationMsg(CryptoNote::getProjectCLIHeader()) << std::endl;
+            exit(0);
+        }
+
+        blockPolicy = parseBlockPolicy(blockPolicyStr);
+
+        if (nodes < 2)
+        {
+            throw std::runtime_error("--nodes must be at least 2");
+        }
+
+        if (degree == 0)
+        {
+            throw std::runtime_error("--degree must not be zero");
+        }
+
+        if (minLatency > maxLatency)
+        {
+            throw std::runtime_error("--min-latency must not be more than --max-latency");
+        }
+
+        if (deadlineMin == 0 || deadlineMin > deadlineMax)
+        {
+            throw std::runtime_error("--deadline-min must be above zero, and not more than --deadline-max");
+        }
+
+        if (transactionRate < 0)
+        {
+            throw std::runtime_error("--rate must not be negative");
+        }
+    }
+
+} // namespace Simulator
@@ -0,0 +1,69 @@
+// Copyright (c) 2018-2020, The TurtleCoin Developers
+//
+// Please see the included LICENSE file for more information.
+
+#pragma once
+
+#include <cryptonotecore/BlockCadenceController.h>
+#include <cstdint>
+#include <string>
+
+namespace Simulator
+{
+    struct SimulatorConfig
+    {
+        SimulatorConfig();
+
+        void parse(int argc, char **argv);
+
+        uint64_t nodes;
+
+        /* Every node has at least this many peers */
+        uint64_t degree;
+
+        /* One way delay of each link is picked between these, in
+           milliseconds */
+        uint64_t minLatency;
+
+        uint64_t maxLatency;
+
+        /* Megabits per second, each way, of every link. 0 for no limit */
+        uint64_t bandwidth;
+
+        /* Whether nodes skip relaying transactions that can't make their
+           deadline, and send the most urgent first */
+        bool deadlineRelay;
+
+        /* Simulated seconds to run for */
+        uint64_t duration;
+
+        /* Transactions per second, across the whole network */
+        double transactionRate;
+
+        /* Bytes */
+        uint64_t transactionSize;
+
+        /* Each transaction's deadline is picked between these many
+           milliseconds after it is sent */
+        uint64_t deadlineMin;
+
+        uint64_t deadlineMax;
+
+        CryptoNote::BlockPolicy blockPolicy;
+
+        /* As the daemon's --producer-deadline-slack */
+        uint64_t deadlineSlack;
+
+        /* As the daemon's --producer-max-interval */
+        uint64_t maxInterval;
+
+        /* For the network layout, link delays and transactions. The same
+           seed and options give the same run. */
+        uint64_t seed;
+
+        bool help;
+
+        bool version;
+    };
+
+} // namespace Simulator
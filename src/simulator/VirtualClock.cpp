@@ -0,0 +1,59 @@
+// Copyright (c) 2018-2020, The TurtleCoin Developers
+//
+// Please see the included LICENSE file for more information.
+
+////////////////////////////////
+#include "VirtualClock.h"
+////////////////////////////////
+
+#include <algorithm>
+
+namespace Simulator
+{
+    VirtualClock::VirtualClock(const uint64_t start): m_now(start) {}
+
+    time_t VirtualClock::now()
+    {
+        return static_cast<time_t>(nowMicroseconds() / 1000000);
+    }
+
+    uint64_t VirtualClock::nowMicroseconds()
+    {
+        return m_now.load(std::memory_order_relaxed);
+    }
+
+    void VirtualClock::schedule(const uint64_t time, std::function<void()> action)
+    {
+        m_events.push({std::max(time, nowMicroseconds()), m_nextSequence++, std::move(action)});
+    }
+
+    void VirtualClock::scheduleAfter(const uint64_t delay, std::function<void()> action)
+    {
+        schedule(nowMicroseconds() + delay, std::move(action));
+    }
+
+    void VirtualClock::runUntil(const uint64_t end)
+    {
+        while (!m_events.empty() && m_events.top().time <= end)
+        {
+            /* The action may schedule more events, so take it off first */
+            const Event event = m_events.top();
+
+            m_events.pop();
+
+            m_now.store(event.time, std::memory_order_relaxed);
+
+            event.action();
+
+            m_eventsRun++;
+        }
+
+        m_now.store(std::max(end, nowMicroseconds()), std::memory_order_relaxed);
+    }
+
+    uint64_t VirtualClock::getEventsRun() const
+    {
+        return m_eventsRun;
+    }
+
+} // namespace Simulator
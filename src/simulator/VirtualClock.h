@@ -0,0 +1,72 @@
+// Copyright (c) 2018-2020, The TurtleCoin Developers
+//
+// Please see the included LICENSE file for more information.
+
+#pragma once
+
+#include <atomic>
+#include <cryptonotecore/ITimeProvider.h>
+#include <functional>
+#include <queue>
+#include <vector>
+
+namespace Simulator
+{
+    /* Time for the simulation, and the events scheduled in it.
+
+       The clock stands still while an event runs, and jumps straight to the
+       next one when it is done, so a simulated minute only takes as long as
+       its events take to run. Events due at the same time run in the order
+       they were scheduled, so with the same inputs every run is the same. */
+    class VirtualClock : public CryptoNote::ITimeProvider
+    {
+      public:
+        /* Unix microseconds to start from */
+        VirtualClock(const uint64_t start);
+
+        virtual time_t now() override;
+
+        virtual uint64_t nowMicroseconds() override;
+
+        /* Runs action at time, in unix microseconds, or straight after the
+           current event if that has already passed */
+        void schedule(const uint64_t time, std::function<void()> action);
+
+        void scheduleAfter(const uint64_t delay, std::function<void()> action);
+
+        /* Runs events in order until the next is after end, then moves the
+           clock to end */
+        void runUntil(const uint64_t end);
+
+        uint64_t getEventsRun() const;
+
+      private:
+        struct Event
+        {
+            uint64_t time;
+
+            /* Breaks ties between events at the same time */
+            uint64_t sequence;
+
+            std::function<void()> action;
+        };
+
+        struct Later
+        {
+            bool operator()(const Event &a, const Event &b) const
+            {
+                return a.time != b.time ? a.time > b.time : a.sequence > b.sequence;
+            }
+        };
+
+        /* Read by Core's validation threads too */
+        std::atomic<uint64_t> m_now;
+
+        uint64_t m_nextSequence = 0;
+
+        uint64_t m_eventsRun = 0;
+
+        std::priority_queue<Event, std::vector<Event>, Later> m_events;
+    };
+
+} // namespace Simulator
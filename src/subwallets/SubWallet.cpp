@@ -453,7 +453,7 @@ std::vector<WalletTypes::TxInputAndOwner> SubWallet::getSpendableInputs(const ui
 
     for (const auto &input : m_unspentInputs)
     {
-        if (Utilities::isInputUnlocked(input.unlockTime, height))
+        if (Utilities::isInputUnlocked(input.unlockTime, height) && m_reservedInputs.count(input.keyImage) == 0)
         {
             inputs.emplace_back(input, m_publicSpendKey, m_privateSpendKey);
         }
@@ -461,6 +461,26 @@ std::vector<WalletTypes::TxInputAndOwner> SubWallet::getSpendableInputs(const ui
     return inputs;
 }
 
+bool SubWallet::reserveInput(const Crypto::KeyImage keyImage)
+{
+    /* It may have been locked by a transaction that was sent, or spent in a
+       block, since it was picked */
+    const bool isUnspent = std::any_of(
+        m_unspentInputs.begin(), m_unspentInputs.end(), [&keyImage](const auto &x) { return x.keyImage == keyImage; });
+
+    if (!isUnspent)
+    {
+        return false;
+    }
+
+    return m_reservedInputs.insert(keyImage).second;
+}
+
+void SubWallet::releaseInput(const Crypto::KeyImage keyImage)
+{
+    m_reservedInputs.erase(keyImage);
+}
+
 uint64_t SubWallet::syncStartHeight() const
 {
     return m_syncStartHeight;
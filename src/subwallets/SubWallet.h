@@ -76,6 +76,13 @@ class SubWallet
 
     void markInputAsLocked(const Crypto::KeyImage keyImage);
 
+    /* Reserve an input for a transaction that is being built, so other
+       transactions built at the same time don't use it. Returns false if it
+       is already reserved, or is no longer unspent. */
+    bool reserveInput(const Crypto::KeyImage keyImage);
+
+    void releaseInput(const Crypto::KeyImage keyImage);
+
     std::vector<Crypto::KeyImage> removeForkedInputs(const uint64_t forkHeight, const bool isViewWallet);
 
     void removeCancelledTransactions(const std::unordered_set<Crypto::Hash> cancelledTransactions);
@@ -118,6 +125,11 @@ class SubWallet
        balance correctly */
     std::vector<WalletTypes::UnconfirmedInput> m_unconfirmedIncomingAmounts;
 
+    /* Key images of unspent inputs which a transaction is currently being
+       built with. These are skipped when picking inputs. Not saved, since
+       they only last as long as the transaction construction does. */
+    std::unordered_set<Crypto::KeyImage> m_reservedInputs;
+
     /* This subwallet's public spend key */
     Crypto::PublicKey m_publicSpendKey;
 
@@ -778,6 +778,57 @@ void SubWallets::markInputAsLocked(const Crypto::KeyImage keyImage, const Crypto
     m_subWallets.at(publicKey).markInputAsLocked(keyImage);
 }
 
+bool SubWallets::reserveInput(const Crypto::KeyImage keyImage, const Crypto::PublicKey publicKey)
+{
+    throwIfViewWallet();
+
+    std::scoped_lock lock(m_mutex);
+
+    const auto it = m_subWallets.find(publicKey);
+
+    /* Subwallet has been deleted since the input was picked */
+    if (it == m_subWallets.end())
+    {
+        return false;
+    }
+
+    return it->second.reserveInput(keyImage);
+}
+
+void SubWallets::releaseInput(const Crypto::KeyImage keyImage, const Crypto::PublicKey publicKey)
+{
+    std::scoped_lock lock(m_mutex);
+
+    const auto it = m_subWallets.find(publicKey);
+
+    if (it != m_subWallets.end())
+    {
+        it->second.releaseInput(keyImage);
+    }
+}
+
+InputReservation::InputReservation(const std::shared_ptr<SubWallets> subWallets): m_subWallets(subWallets) {}
+
+InputReservation::~InputReservation()
+{
+    for (const auto &input : m_reserved)
+    {
+        m_subWallets->releaseInput(input.input.keyImage, input.publicSpendKey);
+    }
+}
+
+bool InputReservation::reserve(const WalletTypes::TxInputAndOwner &input)
+{
+    if (!m_subWallets->reserveInput(input.input.keyImage, input.publicSpendKey))
+    {
+        return false;
+    }
+
+    m_reserved.push_back(input);
+
+    return true;
+}
+
 /* Remove transactions and key images that occured on a forked chain */
 void SubWallets::removeForkedTransactions(const uint64_t forkHeight)
 {
@@ -5,6 +5,7 @@
 #pragma once
 
 #include <crypto/crypto.h>
+#include <memory>
 #include <subwallets/SubWallet.h>
 
 class SubWallets
@@ -137,6 +138,14 @@ class SubWallets
 
     void markInputAsLocked(const Crypto::KeyImage keyImage, const Crypto::PublicKey publicKey);
 
+    /* Reserve an input while a transaction is built with it. Returns false
+       if another transaction has already reserved it, or it has been locked
+       or spent since it was picked. Use InputReservation rather than calling
+       these directly. */
+    bool reserveInput(const Crypto::KeyImage keyImage, const Crypto::PublicKey publicKey);
+
+    void releaseInput(const Crypto::KeyImage keyImage, const Crypto::PublicKey publicKey);
+
     std::unordered_set<Crypto::Hash> getLockedTransactionsHashes() const;
 
     void removeCancelledTransactions(const std::unordered_set<Crypto::Hash> cancelledTransactions);
@@ -221,3 +230,28 @@ class SubWallets
        transactions, etc as these are modified on multiple threads */
     mutable std::mutex m_mutex;
 };
+
+/* Holds the inputs a transaction is being built with, so transactions can be
+   built in parallel without picking the same inputs. The inputs are released
+   when this goes out of scope - if the transaction was sent, they have been
+   marked as locked by then. */
+class InputReservation
+{
+  public:
+    InputReservation(const std::shared_ptr<SubWallets> subWallets);
+
+    ~InputReservation();
+
+    InputReservation(const InputReservation &) = delete;
+
+    InputReservation &operator=(const InputReservation &) = delete;
+
+    /* Returns false if another transaction has already reserved this input,
+       or it is no longer unspent */
+    bool reserve(const WalletTypes::TxInputAndOwner &input);
+
+  private:
+    std::shared_ptr<SubWallets> m_subWallets;
+
+    std::vector<WalletTypes::TxInputAndOwner> m_reserved;
+};
@@ -0,0 +1,159 @@
+// Copyright (c) 2018-2020, The TurtleCoin Developers
+//
+// Please see the included LICENSE file for more information.
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+/* A fixed size, log-linear histogram in the style of HdrHistogram. Every
+   power of two range is split into SUB_BUCKET_COUNT linear buckets, so any
+   recorded value is reported with a relative error of at most
+   1 / SUB_BUCKET_COUNT (~3%), whatever its magnitude, without storing the
+   samples themselves.
+
+   Recording is lock free, so it can be done from any thread.
+   Reads are not synchronized with writes, so a percentile read while
+   values are being recorded may be very slightly out of date. */
+class LatencyHistogram
+{
+  public:
+    static constexpr uint64_t SUB_BUCKET_BITS = 5;
+
+    static constexpr uint64_t SUB_BUCKET_COUNT = 1 << SUB_BUCKET_BITS;
+
+    static constexpr uint64_t BUCKET_COUNT = (64 - SUB_BUCKET_BITS + 1) * SUB_BUCKET_COUNT;
+
+    void record(const uint64_t value)
+    {
+        m_buckets[bucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+        m_count.fetch_add(1, std::memory_order_relaxed);
+        m_sum.fetch_add(value, std::memory_order_relaxed);
+
+        uint64_t max = m_max.load(std::memory_order_relaxed);
+
+        while (value > max && !m_max.compare_exchange_weak(max, value, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    uint64_t count() const
+    {
+        return m_count.load(std::memory_order_relaxed);
+    }
+
+    uint64_t max() const
+    {
+        return m_max.load(std::memory_order_relaxed);
+    }
+
+    uint64_t sum() const
+    {
+        return m_sum.load(std::memory_order_relaxed);
+    }
+
+    double mean() const
+    {
+        const uint64_t count = this->count();
+
+        return count == 0 ? 0 : static_cast<double>(m_sum.load(std::memory_order_relaxed)) / count;
+    }
+
+    /* Percentile is in the range 0..100. Returns the highest value that is
+       equivalent to the bucket the percentile falls in, capped at the
+       largest value we have seen. */
+    uint64_t valueAtPercentile(const double percentile) const
+    {
+        const uint64_t count = this->count();
+
+        if (count == 0)
+        {
+            return 0;
+        }
+
+        const double clamped = std::clamp(percentile, 0.0, 100.0);
+
+        const uint64_t target = std::max<uint64_t>(1, static_cast<uint64_t>((clamped / 100.0) * count + 0.5));
+
+        uint64_t seen = 0;
+
+        for (uint64_t i = 0; i < BUCKET_COUNT; i++)
+        {
+            seen += m_buckets[i].load(std::memory_order_relaxed);
+
+            if (seen >= target)
+            {
+                return std::min(highestEquivalentValue(i), max());
+            }
+        }
+
+        return max();
+    }
+
+    void reset()
+    {
+        for (auto &bucket : m_buckets)
+        {
+            bucket.store(0, std::memory_order_relaxed);
+        }
+
+        m_count.store(0, std::memory_order_relaxed);
+        m_sum.store(0, std::memory_order_relaxed);
+        m_max.store(0, std::memory_order_relaxed);
+    }
+
+  private:
+    static uint64_t bucketIndex(const uint64_t value)
+    {
+        if (value < SUB_BUCKET_COUNT)
+        {
+            return value;
+        }
+
+        /* Position of the highest set bit */
+#ifdef _MSC_VER
+        unsigned long highestBit;
+        _BitScanReverse64(&highestBit, value);
+        const uint64_t exponent = highestBit;
+#else
+        const uint64_t exponent = 63 - __builtin_clzll(value);
+#endif
+
+        const uint64_t shift = exponent - SUB_BUCKET_BITS;
+
+        const uint64_t subBucket = (value >> shift) & (SUB_BUCKET_COUNT - 1);
+
+        return (shift + 1) * SUB_BUCKET_COUNT + subBucket;
+    }
+
+    static uint64_t highestEquivalentValue(const uint64_t index)
+    {
+        if (index < SUB_BUCKET_COUNT)
+        {
+            return index;
+        }
+
+        const uint64_t shift = index / SUB_BUCKET_COUNT - 1;
+
+        const uint64_t subBucket = index % SUB_BUCKET_COUNT;
+
+        const uint64_t lowest = (SUB_BUCKET_COUNT + subBucket) << shift;
+
+        return lowest + ((uint64_t(1) << shift) - 1);
+    }
+
+    std::array<std::atomic<uint64_t>, BUCKET_COUNT> m_buckets {};
+
+    std::atomic<uint64_t> m_count {0};
+
+    std::atomic<uint64_t> m_sum {0};
+
+    std::atomic<uint64_t> m_max {0};
+};
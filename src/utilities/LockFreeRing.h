@@ -0,0 +1,158 @@
+// Copyright (c) 2018-2020, The TurtleCoin Developers
+//
+// Please see the included LICENSE file for more information.
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+
+/* A bounded, lock free, multiple producer / single consumer ring buffer.
+   Producers never block - if the ring is full, the push fails and the item
+   is dropped, which is what we want for instrumentation on hot paths.
+
+   Each slot carries a sequence number, which tells producers and the
+   consumer whose turn it is to use the slot (see Dmitry Vyukov's bounded
+   MPMC queue). */
+template<typename T> class LockFreeRing
+{
+  public:
+    /* Capacity must be a power of two */
+    explicit LockFreeRing(const size_t capacity):
+        m_capacity(capacity), m_mask(capacity - 1), m_slots(new Slot[capacity])
+    {
+        if (capacity < 2 || (capacity & m_mask) != 0)
+        {
+            throw std::invalid_argument("LockFreeRing capacity must be a power of two");
+        }
+
+        for (size_t i = 0; i < capacity; i++)
+        {
+            m_slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    LockFreeRing(const LockFreeRing &) = delete;
+
+    LockFreeRing &operator=(const LockFreeRing &) = delete;
+
+    /* Safe to call from any thread. Returns false if the ring is full. */
+    bool tryPush(const T &item)
+    {
+        size_t position = m_head.load(std::memory_order_relaxed);
+
+        Slot *slot;
+
+        while (true)
+        {
+            slot = &m_slots[position & m_mask];
+
+            const size_t sequence = slot->sequence.load(std::memory_order_acquire);
+
+            const auto difference = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position);
+
+            if (difference == 0)
+            {
+                /* Slot is free, try and claim it */
+                if (m_head.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            else if (difference < 0)
+            {
+                /* The consumer hasn't got this far yet - we're full */
+                m_dropped.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            else
+            {
+                /* Another producer beat us to it */
+                position = m_head.load(std::memory_order_relaxed);
+            }
+        }
+
+        slot->item = item;
+
+        /* Publish the item to the consumer */
+        slot->sequence.store(position + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    /* Must only be called from one thread at a time. Returns false if the
+       ring is empty. */
+    bool tryPop(T &item)
+    {
+        Slot &slot = m_slots[m_tail & m_mask];
+
+        const size_t sequence = slot.sequence.load(std::memory_order_acquire);
+
+        if (sequence != m_tail + 1)
+        {
+            return false;
+        }
+
+        item = std::move(slot.item);
+
+        /* Hand the slot back to the producers, for the next lap */
+        slot.sequence.store(m_tail + m_capacity, std::memory_order_release);
+
+        m_tail++;
+
+        return true;
+    }
+
+    /* Pops everything currently in the ring, calling func on each item.
+       Single consumer only. Returns how many items were consumed. */
+    template<typename Func> size_t drain(Func func)
+    {
+        size_t count = 0;
+
+        T item;
+
+        while (tryPop(item))
+        {
+            func(item);
+            count++;
+        }
+
+        return count;
+    }
+
+    /* How many pushes have failed because the ring was full */
+    uint64_t dropped() const
+    {
+        return m_dropped.load(std::memory_order_relaxed);
+    }
+
+    size_t capacity() const
+    {
+        return m_capacity;
+    }
+
+  private:
+    struct Slot
+    {
+        std::atomic<size_t> sequence;
+
+        T item;
+    };
+
+    const size_t m_capacity;
+
+    const size_t m_mask;
+
+    std::unique_ptr<Slot[]> m_slots;
+
+    /* Keep the producer and consumer positions on separate cache lines, so
+       they don't bounce between cores */
+    alignas(64) std::atomic<size_t> m_head {0};
+
+    alignas(64) size_t m_tail = 0;
+
+    alignas(64) std::atomic<uint64_t> m_dropped {0};
+};
@@ -0,0 +1,229 @@
+// Copyright (c) 2018-2020, The TurtleCoin Developers
+//
+// Please see the included LICENSE file for more information.
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+/* Tracks how many bytes the daemon's larger in-memory structures hold, and
+   hands each of them an allowance out of a configured total.
+
+   Each subsystem reports its own usage - with set() if it can measure it,
+   or add() as it grows and shrinks - and asks for its allowance before it
+   grows. Caches size themselves to fit their allowance, the pool evicts or
+   refuses transactions, and syncing requests fewer blocks at once.
+
+   The target only covers the subsystems below, not the whole process, so
+   it should be set somewhat under the memory actually available. A target
+   of 0, the default, means no limit, and everything behaves as it would
+   without a budget. */
+namespace MemoryBudget
+{
+    enum class Subsystem
+    {
+        TransactionPool,
+        AlternativeChains,
+        BlockInfoCache,
+        BlockStorageCache,
+        Database,
+        P2PWriteQueues
+    };
+
+    constexpr size_t SUBSYSTEM_COUNT = 6;
+
+    constexpr std::array<Subsystem, SUBSYSTEM_COUNT> SUBSYSTEMS = {Subsystem::TransactionPool,
+                                                                   Subsystem::AlternativeChains,
+                                                                   Subsystem::BlockInfoCache,
+                                                                   Subsystem::BlockStorageCache,
+                                                                   Subsystem::Database,
+                                                                   Subsystem::P2PWriteQueues};
+
+    inline const char *subsystemName(const Subsystem subsystem)
+    {
+        switch (subsystem)
+        {
+            case Subsystem::TransactionPool:
+                return "transaction_pool";
+            case Subsystem::AlternativeChains:
+                return "alternative_chains";
+            case Subsystem::BlockInfoCache:
+                return "block_info_cache";
+            case Subsystem::BlockStorageCache:
+                return "block_storage_cache";
+            case Subsystem::Database:
+                return "database";
+            default:
+                return "p2p_write_queues";
+        }
+    }
+
+    /* Percentage of the target each subsystem is allowed. The pool is what
+       floods, and the database cache is what keeps lookups fast, so they
+       get the most */
+    inline uint64_t subsystemShare(const Subsystem subsystem)
+    {
+        switch (subsystem)
+        {
+            case Subsystem::TransactionPool:
+                return 40;
+            case Subsystem::AlternativeChains:
+                return 5;
+            case Subsystem::BlockInfoCache:
+                return 1;
+            case Subsystem::BlockStorageCache:
+                return 9;
+            case Subsystem::Database:
+                return 35;
+            default:
+                return 10;
+        }
+    }
+
+    /* Caches can give memory back straight away, without losing anything
+       that can't be read again */
+    inline bool isCache(const Subsystem subsystem)
+    {
+        return subsystem == Subsystem::BlockInfoCache || subsystem == Subsystem::BlockStorageCache
+               || subsystem == Subsystem::Database;
+    }
+
+    class Budget
+    {
+      public:
+        /* In bytes, 0 for no limit */
+        void setTarget(const uint64_t bytes)
+        {
+            m_target.store(bytes, std::memory_order_relaxed);
+        }
+
+        uint64_t target() const
+        {
+            return m_target.load(std::memory_order_relaxed);
+        }
+
+        void set(const Subsystem subsystem, const uint64_t bytes)
+        {
+            m_usage[index(subsystem)].store(static_cast<int64_t>(bytes), std::memory_order_relaxed);
+        }
+
+        void add(const Subsystem subsystem, const int64_t bytes)
+        {
+            m_usage[index(subsystem)].fetch_add(bytes, std::memory_order_relaxed);
+        }
+
+        uint64_t usage(const Subsystem subsystem) const
+        {
+            const int64_t bytes = m_usage[index(subsystem)].load(std::memory_order_relaxed);
+
+            return static_cast<uint64_t>(std::max<int64_t>(0, bytes));
+        }
+
+        uint64_t total() const
+        {
+            uint64_t total = 0;
+
+            for (const auto subsystem : SUBSYSTEMS)
+            {
+                total += usage(subsystem);
+            }
+
+            return total;
+        }
+
+        bool isOverBudget() const
+        {
+            const uint64_t targetBytes = target();
+
+            return targetBytes != 0 && total() > targetBytes;
+        }
+
+        /* How many bytes the subsystem may hold right now. That's its share
+           of the target - unless the total is over the target, in which case
+           the caches shrink to make up the difference, each in proportion to
+           how much it holds. The rest keep their share, so the pool doesn't
+           start refusing everything because, say, the memtables are large */
+        uint64_t allowance(const Subsystem subsystem) const
+        {
+            const uint64_t targetBytes = target();
+
+            if (targetBytes == 0)
+            {
+                return std::numeric_limits<uint64_t>::max();
+            }
+
+            const uint64_t share = targetBytes / 100 * subsystemShare(subsystem);
+
+            const uint64_t totalBytes = total();
+
+            if (!isCache(subsystem) || totalBytes <= targetBytes)
+            {
+                return share;
+            }
+
+            uint64_t cacheBytes = 0;
+
+            for (const auto cache : SUBSYSTEMS)
+            {
+                if (isCache(cache))
+                {
+                    cacheBytes += usage(cache);
+                }
+            }
+
+            const uint64_t used = usage(subsystem);
+
+            if (cacheBytes == 0)
+            {
+                return std::min(share, used);
+            }
+
+            const uint64_t excess = std::min(totalBytes - targetBytes, cacheBytes);
+
+            const auto giveBack = static_cast<uint64_t>(static_cast<double>(excess) * used / cacheBytes);
+
+            return std::min(share, used - std::min(used, giveBack));
+        }
+
+        /* How many items of itemBytes each a cache may hold, between minimum
+           and maximum. Without a target, that's always maximum */
+        size_t capacity(const Subsystem subsystem, const uint64_t itemBytes, const size_t minimum, const size_t maximum)
+            const
+        {
+            const uint64_t bytes = allowance(subsystem);
+
+            if (bytes == std::numeric_limits<uint64_t>::max())
+            {
+                return maximum;
+            }
+
+            const uint64_t items = bytes / std::max<uint64_t>(itemBytes, 1);
+
+            return static_cast<size_t>(std::clamp<uint64_t>(items, minimum, maximum));
+        }
+
+      private:
+        static size_t index(const Subsystem subsystem)
+        {
+            return static_cast<size_t>(subsystem);
+        }
+
+        std::atomic<uint64_t> m_target {0};
+
+        /* Signed, so a subsystem which adds and removes out of order can
+           briefly go below zero without wrapping */
+        std::array<std::atomic<int64_t>, SUBSYSTEM_COUNT> m_usage {};
+    };
+
+    inline Budget &budget()
+    {
+        static Budget budget;
+
+        return budget;
+    }
+} // namespace MemoryBudget
@@ -0,0 +1,331 @@
+// Copyright (c) 2018-2020, The TurtleCoin Developers
+//
+// Please see the included LICENSE file for more information.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utilities/LatencyHistogram.h>
+#include <utility>
+#include <vector>
+
+/* Process wide runtime metrics, exposed in the Prometheus text format.
+
+   Metrics are created through registry(), which takes a lock, so on hot
+   paths look a metric up once and keep the reference - they live for the
+   rest of the process. Updating a metric never takes a lock.
+
+   Everything is in this header, so any library can record metrics without
+   having to link against anything. */
+namespace Metrics
+{
+    typedef std::vector<std::pair<std::string, std::string>> Labels;
+
+    /* Counters are split into this many shards, each on its own cache line,
+       so threads counting the same thing don't fight over one */
+    constexpr size_t SHARD_COUNT = 16;
+
+    /* Threads are handed shards round robin, the first time they count */
+    inline size_t threadShard()
+    {
+        static std::atomic<size_t> nextShard {0};
+
+        thread_local const size_t shard = nextShard.fetch_add(1, std::memory_order_relaxed) % SHARD_COUNT;
+
+        return shard;
+    }
+
+    /* Only goes up */
+    class Counter
+    {
+      public:
+        void add(const uint64_t amount = 1)
+        {
+            m_shards[threadShard()].value.fetch_add(amount, std::memory_order_relaxed);
+        }
+
+        uint64_t value() const
+        {
+            uint64_t total = 0;
+
+            for (const auto &shard : m_shards)
+            {
+                total += shard.value.load(std::memory_order_relaxed);
+            }
+
+            return total;
+        }
+
+      private:
+        struct alignas(64) Shard
+        {
+            std::atomic<uint64_t> value {0};
+        };
+
+        std::array<Shard, SHARD_COUNT> m_shards;
+    };
+
+    /* A value that goes up and down, such as a queue depth */
+    class Gauge
+    {
+      public:
+        void set(const int64_t value)
+        {
+            m_value.store(value, std::memory_order_relaxed);
+        }
+
+        void add(const int64_t amount)
+        {
+            m_value.fetch_add(amount, std::memory_order_relaxed);
+        }
+
+        int64_t value() const
+        {
+            return m_value.load(std::memory_order_relaxed);
+        }
+
+      private:
+        std::atomic<int64_t> m_value {0};
+    };
+
+    inline uint64_t microsecondsSince(const std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start)
+            .count();
+    }
+
+    /* Records how long the scope it lives in took, in microseconds */
+    class ScopedTimer
+    {
+      public:
+        explicit ScopedTimer(LatencyHistogram &histogram):
+            m_histogram(histogram),
+            m_start(std::chrono::steady_clock::now())
+        {
+        }
+
+        ScopedTimer(const ScopedTimer &) = delete;
+
+        ScopedTimer &operator=(const ScopedTimer &) = delete;
+
+        ~ScopedTimer()
+        {
+            m_histogram.record(microsecondsSince(m_start));
+        }
+
+      private:
+        LatencyHistogram &m_histogram;
+
+        const std::chrono::steady_clock::time_point m_start;
+    };
+
+    class Registry
+    {
+      public:
+        Counter &counter(const std::string &name, const std::string &help, const Labels &labels = {})
+        {
+            return *get(name, help, labels, Type::Counter).counter;
+        }
+
+        Gauge &gauge(const std::string &name, const std::string &help, const Labels &labels = {})
+        {
+            return *get(name, help, labels, Type::Gauge).gauge;
+        }
+
+        /* Values are recorded in microseconds, and exposed as a summary with
+           the 50th, 90th, 99th and 99.9th percentiles */
+        LatencyHistogram &histogram(const std::string &name, const std::string &help, const Labels &labels = {})
+        {
+            return *get(name, help, labels, Type::Summary).histogram;
+        }
+
+        /* Every metric, in the Prometheus text exposition format (0.0.4) */
+        std::string render() const
+        {
+            std::scoped_lock lock(m_mutex);
+
+            std::stringstream stream;
+
+            for (const auto &[name, family] : m_families)
+            {
+                stream << "# HELP " << name << " " << family.help << "\n"
+                       << "# TYPE " << name << " " << typeName(family.type) << "\n";
+
+                for (const auto &[labels, metric] : family.metrics)
+                {
+                    if (family.type == Type::Counter)
+                    {
+                        stream << name << wrapLabels(labels) << " " << metric->counter->value() << "\n";
+                    }
+                    else if (family.type == Type::Gauge)
+                    {
+                        stream << name << wrapLabels(labels) << " " << metric->gauge->value() << "\n";
+                    }
+                    else
+                    {
+                        const auto &histogram = *metric->histogram;
+
+                        for (const auto &[quantile, percentile] : QUANTILES)
+                        {
+                            const std::string quantileLabel = std::string("quantile=\"") + quantile + "\"";
+
+                            stream << name << wrapLabels(labels.empty() ? quantileLabel : labels + "," + quantileLabel)
+                                   << " " << histogram.valueAtPercentile(percentile) << "\n";
+                        }
+
+                        stream << name << "_sum" << wrapLabels(labels) << " " << histogram.sum() << "\n"
+                               << name << "_count" << wrapLabels(labels) << " " << histogram.count() << "\n";
+                    }
+                }
+            }
+
+            return stream.str();
+        }
+
+      private:
+        enum class Type
+        {
+            Counter,
+            Gauge,
+            Summary
+        };
+
+        /* Summary quantiles, and the percentiles they're read at */
+        static constexpr std::array<std::pair<const char *, double>, 4> QUANTILES = {
+            {{"0.5", 50}, {"0.9", 90}, {"0.99", 99}, {"0.999", 99.9}}};
+
+        /* Only the one matching the family type is set. Histograms are large,
+           so they aren't made for every metric */
+        struct Metric
+        {
+            std::unique_ptr<Counter> counter;
+
+            std::unique_ptr<Gauge> gauge;
+
+            std::unique_ptr<LatencyHistogram> histogram;
+        };
+
+        struct Family
+        {
+            std::string help;
+
+            Type type;
+
+            /* Keyed by the rendered labels */
+            std::map<std::string, std::unique_ptr<Metric>> metrics;
+        };
+
+        static const char *typeName(const Type type)
+        {
+            switch (type)
+            {
+                case Type::Counter:
+                    return "counter";
+                case Type::Gauge:
+                    return "gauge";
+                default:
+                    return "summary";
+            }
+        }
+
+        static std::string wrapLabels(const std::string &labels)
+        {
+            return labels.empty() ? "" : "{" + labels + "}";
+        }
+
+        static std::string renderLabels(const Labels &labels)
+        {
+            std::string result;
+
+            for (const auto &[key, value] : labels)
+            {
+                if (!result.empty())
+                {
+                    result += ",";
+                }
+
+                result += key + "=\"";
+
+                for (const char c : value)
+                {
+                    if (c == '\\' || c == '"')
+                    {
+                        result += '\\';
+                        result += c;
+                    }
+                    else if (c == '\n')
+                    {
+                        result += "\\n";
+                    }
+                    else
+                    {
+                        result += c;
+                    }
+                }
+
+                result += "\"";
+            }
+
+            return result;
+        }
+
+        Metric &get(const std::string &name, const std::string &help, const Labels &labels, const Type type)
+        {
+            std::scoped_lock lock(m_mutex);
+
+            auto &family = m_families[name];
+
+            if (family.metrics.empty())
+            {
+                family.help = help;
+                family.type = type;
+            }
+            else if (family.type != type)
+            {
+                throw std::invalid_argument("Metric " + name + " is already registered with a different type");
+            }
+
+            auto &metric = family.metrics[renderLabels(labels)];
+
+            if (!metric)
+            {
+                metric = std::make_unique<Metric>();
+
+                if (type == Type::Counter)
+                {
+                    metric->counter = std::make_unique<Counter>();
+                }
+                else if (type == Type::Gauge)
+                {
+                    metric->gauge = std::make_unique<Gauge>();
+                }
+                else
+                {
+                    metric->histogram = std::make_unique<LatencyHistogram>();
+                }
+            }
+
+            return *metric;
+        }
+
+        mutable std::mutex m_mutex;
+
+        std::map<std::string, Family> m_families;
+    };
+
+    inline Registry &registry()
+    {
+        static Registry registry;
+
+        return registry;
+    }
+} // namespace Metrics
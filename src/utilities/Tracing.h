@@ -0,0 +1,347 @@
+// Copyright (c) 2018-2020, The TurtleCoin Developers
+//
+// Please see the included LICENSE file for more information.
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
+#include <string>
+#include <vector>
+
+/* Scoped tracing spans, dumped in the Chrome trace event format, which
+   chrome://tracing and https://ui.perfetto.dev both open.
+
+       TRACE_SPAN("core", "addBlock");
+
+   records how long the rest of the scope takes, when tracing is switched on
+   with setEnabled(). When it's off, a span costs one relaxed load. Building
+   without ENABLE_TRACING removes the spans entirely.
+
+   Each thread records into its own ring buffer, so recording never takes a
+   lock. Once a ring is full, the oldest spans are overwritten - dump() only
+   ever sees the last RING_SIZE spans of each thread. When a thread exits,
+   its ring is handed to the next new thread, spans and all, so threads
+   made per connection don't each leave a ring behind.
+
+   Span names and categories must be string literals, or otherwise live for
+   the rest of the process, as only the pointer is stored. */
+namespace Tracing
+{
+#ifdef ENABLE_TRACING
+    constexpr bool SPANS_COMPILED = true;
+#else
+    constexpr bool SPANS_COMPILED = false;
+#endif
+
+    /* Per thread, 32 bytes a span, so 1MB for each thread which records */
+    constexpr uint64_t RING_SIZE = 1 << 15;
+
+    struct Event
+    {
+        const char *category;
+
+        const char *name;
+
+        /* Microseconds, on the steady clock */
+        uint64_t start;
+
+        uint64_t duration;
+    };
+
+    inline uint64_t now()
+    {
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+    }
+
+    /* Written by one thread, read by whoever dumps. Fields are atomics so a
+       reader racing the writer gets a stale value, rather than undefined
+       behaviour - and it throws away anything the writer may have touched
+       whilst it was reading, like a seqlock. */
+    class ThreadRing
+    {
+      public:
+        explicit ThreadRing(const uint64_t threadId): m_threadId(threadId) {}
+
+        void record(const Event &event)
+        {
+            const uint64_t position = m_published.load(std::memory_order_relaxed);
+
+            /* Let readers know this slot is about to change, before it does */
+            m_claimed.store(position + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+
+            Slot &slot = m_slots[position % RING_SIZE];
+
+            slot.category.store(event.category, std::memory_order_relaxed);
+            slot.name.store(event.name, std::memory_order_relaxed);
+            slot.start.store(event.start, std::memory_order_relaxed);
+            slot.duration.store(event.duration, std::memory_order_relaxed);
+
+            m_published.store(position + 1, std::memory_order_release);
+        }
+
+        /* Appends every intact span which started at or after since */
+        void read(const uint64_t since, std::vector<Event> &events) const
+        {
+            const uint64_t end = m_published.load(std::memory_order_acquire);
+
+            const uint64_t begin = end > RING_SIZE ? end - RING_SIZE : 0;
+
+            std::vector<Event> copied;
+
+            copied.reserve(end - begin);
+
+            for (uint64_t i = begin; i < end; i++)
+            {
+                const Slot &slot = m_slots[i % RING_SIZE];
+
+                copied.push_back(
+                    {slot.category.load(std::memory_order_relaxed),
+                     slot.name.load(std::memory_order_relaxed),
+                     slot.start.load(std::memory_order_relaxed),
+                     slot.duration.load(std::memory_order_relaxed)});
+            }
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+
+            /* Anything the writer started on since we began could be torn */
+            const uint64_t claimed = m_claimed.load(std::memory_order_relaxed);
+
+            const uint64_t firstIntact = claimed > RING_SIZE ? claimed - RING_SIZE : 0;
+
+            for (uint64_t i = std::max(begin, firstIntact); i < end; i++)
+            {
+                const Event &event = copied[i - begin];
+
+                if (event.start >= since)
+                {
+                    events.push_back(event);
+                }
+            }
+        }
+
+        uint64_t threadId() const
+        {
+            return m_threadId;
+        }
+
+      private:
+        struct Slot
+        {
+            std::atomic<const char *> category {nullptr};
+
+            std::atomic<const char *> name {nullptr};
+
+            std::atomic<uint64_t> start {0};
+
+            std::atomic<uint64_t> duration {0};
+        };
+
+        const uint64_t m_threadId;
+
+        /* Spans written */
+        std::atomic<uint64_t> m_published {0};
+
+        /* Spans written, or being written */
+        std::atomic<uint64_t> m_claimed {0};
+
+        std::array<Slot, RING_SIZE> m_slots;
+    };
+
+    class Tracer
+    {
+      public:
+        void setEnabled(const bool enabled)
+        {
+            m_enabled.store(enabled, std::memory_order_relaxed);
+        }
+
+        bool isEnabled() const
+        {
+            return m_enabled.load(std::memory_order_relaxed);
+        }
+
+        void record(const Event &event)
+        {
+            thread_local RingLease lease(*this);
+
+            lease.ring->record(event);
+        }
+
+        /* Every span which started in the last `seconds` seconds, as Chrome
+           trace event JSON */
+        std::string dump(const uint64_t seconds)
+        {
+            const uint64_t currentTime = now();
+
+            const uint64_t since = seconds < currentTime / 1000000 ? currentTime - seconds * 1000000 : 0;
+
+            rapidjson::StringBuffer sb;
+
+            rapidjson::Writer<rapidjson::StringBuffer> writer(sb);
+
+            writer.StartObject();
+
+            writer.Key("displayTimeUnit");
+            writer.String("ms");
+
+            writer.Key("traceEvents");
+            writer.StartArray();
+            {
+                std::scoped_lock lock(m_mutex);
+
+                std::vector<Event> events;
+
+                for (const auto &ring : m_rings)
+                {
+                    events.clear();
+
+                    ring->read(since, events);
+
+                    for (const auto &event : events)
+                    {
+                        writer.StartObject();
+                        {
+                            writer.Key("cat");
+                            writer.String(event.category);
+
+                            writer.Key("dur");
+                            writer.Uint64(event.duration);
+
+                            writer.Key("name");
+                            writer.String(event.name);
+
+                            writer.Key("ph");
+                            writer.String("X");
+
+                            writer.Key("pid");
+                            writer.Uint64(1);
+
+                            writer.Key("tid");
+                            writer.Uint64(ring->threadId());
+
+                            writer.Key("ts");
+                            writer.Uint64(event.start);
+                        }
+                        writer.EndObject();
+                    }
+                }
+
+            }
+            writer.EndArray();
+
+            writer.EndObject();
+
+            return sb.GetString();
+        }
+
+      private:
+        /* The ring a thread records into, for as long as the thread lives */
+        struct RingLease
+        {
+            explicit RingLease(Tracer &tracer): tracer(tracer), ring(tracer.acquireRing()) {}
+
+            ~RingLease()
+            {
+                tracer.releaseRing(ring);
+            }
+
+            Tracer &tracer;
+
+            ThreadRing *ring;
+        };
+
+        ThreadRing *acquireRing()
+        {
+            std::scoped_lock lock(m_mutex);
+
+            if (!m_freeRings.empty())
+            {
+                ThreadRing *ring = m_freeRings.back();
+
+                m_freeRings.pop_back();
+
+                return ring;
+            }
+
+            m_rings.push_back(std::make_unique<ThreadRing>(m_rings.size() + 1));
+
+            return m_rings.back().get();
+        }
+
+        void releaseRing(ThreadRing *ring)
+        {
+            std::scoped_lock lock(m_mutex);
+
+            m_freeRings.push_back(ring);
+        }
+
+        std::atomic<bool> m_enabled {false};
+
+        std::mutex m_mutex;
+
+        /* One for each thread recording at once, at most. Never freed, as
+           they're reused */
+        std::vector<std::unique_ptr<ThreadRing>> m_rings;
+
+        std::vector<ThreadRing *> m_freeRings;
+    };
+
+    inline Tracer &tracer()
+    {
+        static Tracer tracer;
+
+        return tracer;
+    }
+
+    /* Records the time from construction to destruction, if tracing was on
+       when it was constructed */
+    class Span
+    {
+      public:
+        Span(const char *category, const char *name):
+            m_category(category),
+            m_name(name),
+            m_start(tracer().isEnabled() ? now() : 0)
+        {
+        }
+
+        Span(const Span &) = delete;
+
+        Span &operator=(const Span &) = delete;
+
+        ~Span()
+        {
+            if (m_start != 0)
+            {
+                tracer().record({m_category, m_name, m_start, now() - m_start});
+            }
+        }
+
+      private:
+        const char *m_category;
+
+        const char *m_name;
+
+        const uint64_t m_start;
+    };
+} // namespace Tracing
+
+#define TRACING_CONCAT_INNER(a, b) a##b
+#define TRACING_CONCAT(a, b) TRACING_CONCAT_INNER(a, b)
+
+#ifdef ENABLE_TRACING
+#define TRACE_SPAN(category, name) Tracing::Span TRACING_CONCAT(traceSpan, __LINE__)(category, name)
+#else
+#define TRACE_SPAN(category, name)
+#endif
@@ -10,6 +10,8 @@
 #include <config/CryptoNoteConfig.h>
 #include <crypto/random.h>
 #include <cryptonotecore/Mixins.h>
+#include <cryptopp/hmac.h>
+#include <cryptopp/misc.h>
 #include <cryptopp/modes.h>
 #include <cryptopp/pwdbased.h>
 #include <cryptopp/sha.h>
@@ -41,6 +43,8 @@ ApiDispatcher::ApiDispatcher(
     /* Make sure to do this after initializing the salt above! */
     m_hashedPassword = hashPassword(rpcPassword);
 
+    Random::randomBytes(sizeof(m_sessionKey), m_sessionKey);
+
     using namespace std::placeholders;
 
     /* Route the request through our middleware function, before forwarding
@@ -49,7 +53,8 @@ ApiDispatcher::ApiDispatcher(
                             const auto function,
                             const WalletState walletState,
                             const bool viewWalletPermitted,
-                            const bool isBodyRequired)
+                            const bool isBodyRequired,
+                            const bool isWalletLifecycle = false)
     {
         return [=](const httplib::Request &req, httplib::Response &res)
         {
@@ -61,6 +66,7 @@ ApiDispatcher::ApiDispatcher(
                 walletState,
                 viewWalletPermitted,
                 isBodyRequired,
+                isWalletLifecycle,
                 std::bind(function, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3));
         };
     };
@@ -73,29 +79,49 @@ ApiDispatcher::ApiDispatcher(
 
     const bool viewWalletsBanned = false;
 
+    /* Opening, creating and closing wallets. These run on their own */
+    const bool walletLifecycle = true;
+
     /* POST */
     m_server
-        .Post("/wallet/open", router(&ApiDispatcher::openWallet, WalletMustBeClosed, viewWalletsAllowed, bodyRequired))
+        .Post(
+            "/wallet/open",
+            router(&ApiDispatcher::openWallet, WalletMustBeClosed, viewWalletsAllowed, bodyRequired, walletLifecycle))
 
         /* Import wallet with keys */
         .Post(
             "/wallet/import/key",
-            router(&ApiDispatcher::keyImportWallet, WalletMustBeClosed, viewWalletsAllowed, bodyRequired))
+            router(
+                &ApiDispatcher::keyImportWallet,
+                WalletMustBeClosed,
+                viewWalletsAllowed,
+                bodyRequired,
+                walletLifecycle))
 
         /* Import wallet with seed */
         .Post(
             "/wallet/import/seed",
-            router(&ApiDispatcher::seedImportWallet, WalletMustBeClosed, viewWalletsAllowed, bodyRequired))
+            router(
+                &ApiDispatcher::seedImportWallet,
+                WalletMustBeClosed,
+                viewWalletsAllowed,
+                bodyRequired,
+                walletLifecycle))
 
         /* Import view wallet */
         .Post(
             "/wallet/import/view",
-            router(&ApiDispatcher::importViewWallet, WalletMustBeClosed, viewWalletsAllowed, bodyRequired))
+            router(
+                &ApiDispatcher::importViewWallet,
+                WalletMustBeClosed,
+                viewWalletsAllowed,
+                bodyRequired,
+                walletLifecycle))
 
         /* Create wallet */
         .Post(
             "/wallet/create",
-            router(&ApiDispatcher::createWallet, WalletMustBeClosed, viewWalletsAllowed, bodyRequired))
+            router(&ApiDispatcher::createWallet, WalletMustBeClosed, viewWalletsAllowed, bodyRequired, walletLifecycle))
 
         /* Create a random address */
         .Post(
@@ -159,10 +185,15 @@ ApiDispatcher::ApiDispatcher(
 
         .Post("/export/json", router(&ApiDispatcher::exportToJSON, WalletMustBeOpen, viewWalletsAllowed, bodyRequired))
 
+        /* Exchange the api key for a session token */
+        .Post("/session", router(&ApiDispatcher::createSession, DoesntMatter, viewWalletsAllowed, bodyNotRequired))
+
         /* DELETE */
 
         /* Close the current wallet */
-        .Delete("/wallet", router(&ApiDispatcher::closeWallet, WalletMustBeOpen, viewWalletsAllowed, bodyNotRequired))
+        .Delete(
+            "/wallet",
+            router(&ApiDispatcher::closeWallet, WalletMustBeOpen, viewWalletsAllowed, bodyNotRequired, walletLifecycle))
 
         /* Delete the given address */
         .Delete(
@@ -174,6 +205,9 @@ ApiDispatcher::ApiDispatcher(
             "/transactions/prepared/" + ApiConstants::hashRegex,
             router(&ApiDispatcher::deletePreparedTransaction, WalletMustBeOpen, viewWalletsBanned, bodyNotRequired))
 
+        /* Revoke a session token */
+        .Delete("/session", router(&ApiDispatcher::deleteSession, DoesntMatter, viewWalletsAllowed, bodyNotRequired))
+
         /* PUT */
 
         /* Save the wallet */
@@ -328,26 +362,22 @@ void ApiDispatcher::stop()
     m_server.stop();
 }
 
-std::optional<rapidjson::Document>
-    ApiDispatcher::getJsonBody(const httplib::Request &req, httplib::Response &res, const bool bodyRequired)
+bool ApiDispatcher::getJsonBody(
+    const httplib::Request &req,
+    httplib::Response &res,
+    const bool bodyRequired,
+    Common::JsonRequestBody &jsonBody)
 {
-    rapidjson::Document jsonBody;
-
     if (req.body == "")
     {
-        /* Some compilers are stupid and can't figure out just `return jsonBody`
-         * and we can't construct a std::optional(jsonBody) since the copy
-         * constructor is deleted, so we need to std::move */
-        return std::optional<rapidjson::Document>(std::move(jsonBody));
+        return true;
     }
 
     /* Some methods, most notably POST(/block) and POST(/transaction) may
      * have plain-text style bodies that will not parse as JSON without
      * being enclosed in quotes. Some libraries properly enclose the values
-     * in quotes while others do not. This permits either forms to work */
-    const auto bodyAsJSONString = "\"" + req.body + "\"";
-
-    if (jsonBody.Parse(req.body.c_str()).HasParseError() && jsonBody.Parse(bodyAsJSONString.c_str()).HasParseError())
+     * in quotes while others do not. The parser permits either form */
+    if (!jsonBody.parse(req.body))
     {
         std::stringstream stream;
 
@@ -367,10 +397,10 @@ std::optional<rapidjson::Document>
 
         res.status = 400;
 
-        return std::nullopt;
+        return false;
     }
 
-    return std::optional<rapidjson::Document>(std::move(jsonBody));
+    return true;
 }
 
 void ApiDispatcher::middleware(
@@ -379,6 +409,7 @@ void ApiDispatcher::middleware(
     const WalletState walletState,
     const bool viewWalletPermitted,
     const bool bodyRequired,
+    const bool walletLifecycle,
     std::function<std::tuple<Error, uint16_t>(
         const httplib::Request &req,
         httplib::Response &res,
@@ -403,6 +434,28 @@ void ApiDispatcher::middleware(
         return;
     }
 
+    /* Wallet lifecycle operations replace m_walletBackend, so they wait for
+       every other request to finish, and hold them off until done. Everything
+       else, including building and sending transactions, runs in parallel -
+       saving, resetting and swapping node are serialized by the wallet
+       synchronizer pausing. Taking m_lifecycleMutex first means a waiting lifecycle
+       operation stops new requests getting in, so it can't be starved. */
+    std::unique_lock lifecycleLock(m_lifecycleMutex);
+
+    std::unique_lock exclusiveLock(m_mutex, std::defer_lock);
+    std::shared_lock sharedLock(m_mutex, std::defer_lock);
+
+    if (walletLifecycle)
+    {
+        exclusiveLock.lock();
+    }
+    else
+    {
+        sharedLock.lock();
+
+        lifecycleLock.unlock();
+    }
+
     /* Wallet must be open for this operation, and it is not */
     if (walletState == WalletMustBeOpen && !assertWalletOpen())
     {
@@ -434,20 +487,23 @@ void ApiDispatcher::middleware(
         return;
     }
 
-    const auto jsonBody = getJsonBody(req, res, bodyRequired);
+    Common::JsonRequestBody jsonBody;
 
-    if (!jsonBody && bodyRequired)
+    if (!getJsonBody(req, res, bodyRequired, jsonBody))
     {
-        failRequest(Error(API_BODY_REQUIRED), res);
+        if (bodyRequired)
+        {
+            failRequest(Error(API_BODY_REQUIRED), res);
 
-        res.status = 400;
+            res.status = 400;
+        }
 
         return;
     }
 
     try
     {
-        const auto [error, statusCode] = handler(req, res, *jsonBody);
+        const auto [error, statusCode] = handler(req, res, jsonBody.document());
 
         if (error)
         {
@@ -506,9 +562,23 @@ void ApiDispatcher::failRequest(const Error error, httplib::Response &res)
 
 bool ApiDispatcher::checkAuthenticated(const httplib::Request &req, httplib::Response &res) const
 {
+    /* The api key takes precedence, so a request carrying both always has
+       its key checked - POST /session relies on this */
     if (!req.has_header("X-API-KEY"))
     {
-        std::cout << "Rejecting unauthorized request: X-API-KEY header is missing.\n";
+        if (!req.has_header("X-SESSION-TOKEN"))
+        {
+            std::cout << "Rejecting unauthorized request: X-API-KEY header is missing.\n";
+
+            return false;
+        }
+
+        if (checkSessionToken(req.get_header_value("X-SESSION-TOKEN")))
+        {
+            return true;
+        }
+
+        std::cout << "Rejecting unauthorized request: X-SESSION-TOKEN is invalid, expired, or revoked.\n";
 
         return false;
     }
@@ -527,6 +597,52 @@ bool ApiDispatcher::checkAuthenticated(const httplib::Request &req, httplib::Res
     return false;
 }
 
+bool ApiDispatcher::checkSessionToken(const std::string &token) const
+{
+    const size_t sessionIdLength = ApiConstants::SESSION_ID_SIZE * 2;
+
+    /* Hex session ID, followed by the hex HMAC of it */
+    if (token.size() != sessionIdLength + sizeof(Crypto::Hash) * 2)
+    {
+        return false;
+    }
+
+    const std::string sessionId = token.substr(0, sessionIdLength);
+
+    Crypto::Hash mac;
+
+    if (!Common::podFromHex(token.substr(sessionIdLength), mac.data))
+    {
+        return false;
+    }
+
+    const Crypto::Hash expectedMac = signSessionId(sessionId);
+
+    /* Compare in constant time, so the HMAC can't be guessed a byte at a
+       time. Forged tokens never reach the session table. */
+    if (!CryptoPP::VerifyBufsEqual(mac.data, expectedMac.data, sizeof(mac.data)))
+    {
+        return false;
+    }
+
+    std::scoped_lock lock(m_sessionMutex);
+
+    const auto session = m_sessions.find(sessionId);
+
+    return session != m_sessions.end() && session->second > std::chrono::steady_clock::now();
+}
+
+Crypto::Hash ApiDispatcher::signSessionId(const std::string &sessionId) const
+{
+    CryptoPP::HMAC<CryptoPP::SHA256> hmac(m_sessionKey, sizeof(m_sessionKey));
+
+    Crypto::Hash mac;
+
+    hmac.CalculateDigest(mac.data, reinterpret_cast<const CryptoPP::byte *>(sessionId.data()), sessionId.size());
+
+    return mac;
+}
+
 ///////////////////
 /* POST REQUESTS */
 ///////////////////
@@ -534,8 +650,6 @@ bool ApiDispatcher::checkAuthenticated(const httplib::Request &req, httplib::Res
 std::tuple<Error, uint16_t>
     ApiDispatcher::openWallet(const httplib::Request &req, httplib::Response &res, const rapidjson::Document &body)
 {
-    std::scoped_lock lock(m_mutex);
-
     const auto [daemonHost, daemonPort, daemonSSL, filename, password] = getDefaultWalletParams(body);
 
     Error error;
@@ -549,8 +663,6 @@ std::tuple<Error, uint16_t>
 std::tuple<Error, uint16_t>
     ApiDispatcher::keyImportWallet(const httplib::Request &req, httplib::Response &res, const rapidjson::Document &body)
 {
-    std::scoped_lock lock(m_mutex);
-
     const auto [daemonHost, daemonPort, daemonSSL, filename, password] = getDefaultWalletParams(body);
 
     Crypto::SecretKey privateViewKey;
@@ -589,8 +701,6 @@ std::tuple<Error, uint16_t> ApiDispatcher::seedImportWallet(
     httplib::Response &res,
     const rapidjson::Document &body)
 {
-    std::scoped_lock lock(m_mutex);
-
     const auto [daemonHost, daemonPort, daemonSSL, filename, password] = getDefaultWalletParams(body);
 
     const std::string mnemonicSeed = getStringFromJSON(body, "mnemonicSeed");
@@ -615,8 +725,6 @@ std::tuple<Error, uint16_t> ApiDispatcher::importViewWallet(
     httplib::Response &res,
     const rapidjson::Document &body)
 {
-    std::scoped_lock lock(m_mutex);
-
     const auto [daemonHost, daemonPort, daemonSSL, filename, password] = getDefaultWalletParams(body);
 
     const std::string address = getStringFromJSON(body, "address");
@@ -651,8 +759,6 @@ std::tuple<Error, uint16_t> ApiDispatcher::importViewWallet(
 std::tuple<Error, uint16_t>
     ApiDispatcher::createWallet(const httplib::Request &req, httplib::Response &res, const rapidjson::Document &body)
 {
-    std::scoped_lock lock(m_mutex);
-
     const auto [daemonHost, daemonPort, daemonSSL, filename, password] = getDefaultWalletParams(body);
 
     Error error;
@@ -991,9 +1097,13 @@ std::tuple<Error, uint16_t> ApiDispatcher::makeAdvancedTransaction(
     const rapidjson::Document &body,
     const bool sendTransaction)
 {
+    const auto destinationsJSON = getArrayFromJSON(body, "destinations");
+
     std::vector<std::pair<std::string, uint64_t>> destinations;
 
-    for (const auto &destination : getArrayFromJSON(body, "destinations"))
+    destinations.reserve(destinationsJSON.Size());
+
+    for (const auto &destination : destinationsJSON)
     {
         const std::string address = getStringFromJSON(destination, "address");
 
@@ -1242,6 +1352,70 @@ std::tuple<Error, uint16_t>
     return {SUCCESS, 200};
 }
 
+std::tuple<Error, uint16_t>
+    ApiDispatcher::createSession(const httplib::Request &req, httplib::Response &res, const rapidjson::Document &body)
+{
+    /* Otherwise a session token could be used to extend itself forever */
+    if (!req.has_header("X-API-KEY"))
+    {
+        return {Error(API_INVALID_ARGUMENT, "Sessions can only be created with the X-API-KEY header."), 400};
+    }
+
+    CryptoPP::byte sessionIdBytes[ApiConstants::SESSION_ID_SIZE];
+
+    Random::randomBytes(sizeof(sessionIdBytes), sessionIdBytes);
+
+    const std::string sessionId = Common::podToHex(sessionIdBytes);
+
+    const auto now = std::chrono::steady_clock::now();
+
+    {
+        std::scoped_lock lock(m_sessionMutex);
+
+        for (auto it = m_sessions.begin(); it != m_sessions.end();)
+        {
+            if (it->second <= now)
+            {
+                it = m_sessions.erase(it);
+            }
+            else
+            {
+                it++;
+            }
+        }
+
+        if (m_sessions.size() >= ApiConstants::MAX_SESSION_TOKENS)
+        {
+            const auto soonestExpiry = std::min_element(
+                m_sessions.begin(),
+                m_sessions.end(),
+                [](const auto &a, const auto &b) { return a.second < b.second; });
+
+            m_sessions.erase(soonestExpiry);
+        }
+
+        m_sessions[sessionId] = now + std::chrono::seconds(ApiConstants::SESSION_TOKEN_LIFETIME);
+    }
+
+    rapidjson::StringBuffer sb;
+
+    rapidjson::Writer<rapidjson::StringBuffer> writer(sb);
+
+    writer.StartObject();
+    {
+        writer.Key("expiresIn");
+        writer.Uint64(ApiConstants::SESSION_TOKEN_LIFETIME);
+
+        writer.Key("token");
+        writer.String(sessionId + Common::podToHex(signSessionId(sessionId)));
+    }
+    writer.EndObject();
+
+    res.body = sb.GetString();
+
+    return {SUCCESS, 201};
+}
+
 /////////////////////
 /* DELETE REQUESTS */
 /////////////////////
@@ -1249,8 +1423,6 @@ std::tuple<Error, uint16_t>
 std::tuple<Error, uint16_t>
     ApiDispatcher::closeWallet(const httplib::Request &req, httplib::Response &res, const rapidjson::Document &body)
 {
-    std::scoped_lock lock(m_mutex);
-
     m_walletBackend = nullptr;
 
     return {SUCCESS, 200};
@@ -1301,6 +1473,28 @@ std::tuple<Error, uint16_t> ApiDispatcher::deletePreparedTransaction(
     }
 }
 
+std::tuple<Error, uint16_t>
+    ApiDispatcher::deleteSession(const httplib::Request &req, httplib::Response &res, const rapidjson::Document &body)
+{
+    if (!req.has_header("X-SESSION-TOKEN"))
+    {
+        return {Error(API_INVALID_ARGUMENT, "The X-SESSION-TOKEN header is required to revoke a session."), 400};
+    }
+
+    const std::string token = req.get_header_value("X-SESSION-TOKEN");
+
+    if (!checkSessionToken(token))
+    {
+        return {SUCCESS, 404};
+    }
+
+    std::scoped_lock lock(m_sessionMutex);
+
+    m_sessions.erase(token.substr(0, ApiConstants::SESSION_ID_SIZE * 2));
+
+    return {SUCCESS, 200};
+}
+
 //////////////////
 /* PUT REQUESTS */
 //////////////////
@@ -1310,8 +1504,6 @@ std::tuple<Error, uint16_t> ApiDispatcher::saveWallet(
     httplib::Response &res,
     const rapidjson::Document &body) const
 {
-    std::scoped_lock lock(m_mutex);
-
     m_walletBackend->save();
 
     return {SUCCESS, 200};
@@ -1320,8 +1512,6 @@ std::tuple<Error, uint16_t> ApiDispatcher::saveWallet(
 std::tuple<Error, uint16_t>
     ApiDispatcher::resetWallet(const httplib::Request &req, httplib::Response &res, const rapidjson::Document &body)
 {
-    std::scoped_lock lock(m_mutex);
-
     uint64_t scanHeight = 0;
 
     uint64_t timestamp = 0;
@@ -1339,8 +1529,6 @@ std::tuple<Error, uint16_t>
 std::tuple<Error, uint16_t>
     ApiDispatcher::rewindWallet(const httplib::Request &req, httplib::Response &res, const rapidjson::Document &body)
 {
-    std::scoped_lock lock(m_mutex);
-
     uint64_t scanHeight = 0;
 
     uint64_t timestamp = 0;
@@ -1358,8 +1546,6 @@ std::tuple<Error, uint16_t>
 std::tuple<Error, uint16_t>
     ApiDispatcher::setNodeInfo(const httplib::Request &req, httplib::Response &res, const rapidjson::Document &body)
 {
-    std::scoped_lock lock(m_mutex);
-
     uint16_t daemonPort = CryptoNote::RPC_DEFAULT_PORT;
     bool daemonSSL = false;
 
@@ -2317,7 +2503,9 @@ void ApiDispatcher::handleOptions(const httplib::Request &req, httplib::Response
     if (m_corsHeader != "")
     {
         res.set_header("Access-Control-Allow-Origin", m_corsHeader);
-        res.set_header("Access-Control-Allow-Headers", "Origin, X-Requested-With, Content-Type, Accept, X-API-KEY");
+        res.set_header(
+            "Access-Control-Allow-Headers",
+            "Origin, X-Requested-With, Content-Type, Accept, X-API-KEY, X-SESSION-TOKEN");
     }
 
     res.status = 200;
@@ -6,7 +6,11 @@
 
 #include "httplib.h"
 
+#include <chrono>
+#include <common/JsonRequestBody.h>
 #include <cryptopp/modes.h>
+#include <shared_mutex>
+#include <unordered_map>
 #include <walletbackend/WalletBackend.h>
 
 enum WalletState
@@ -45,8 +49,14 @@ class ApiDispatcher
     /* Private member functions */
     //////////////////////////////
 
-    std::optional<rapidjson::Document>
-        getJsonBody(const httplib::Request &req, httplib::Response &res, const bool bodyRequired);
+    //RTcoin
+    /* Parses the request body into jsonBody, returning false, with the
+       response filled in, if it isn't JSON */
+    bool getJsonBody(
+        const httplib::Request &req,
+        httplib::Response &res,
+        const bool bodyRequired,
+        Common::JsonRequestBody &jsonBody);
 
     /* Check authentication and log, then forward on to the handler if
        applicable */
@@ -56,6 +66,7 @@ class ApiDispatcher
         const WalletState walletState,
         const bool viewWalletsPermitted,
         const bool bodyRequired,
+        const bool walletLifecycle,
         std::function<std::tuple<Error, uint16_t>(
             const httplib::Request &req,
             httplib::Response &res,
@@ -63,10 +74,16 @@ class ApiDispatcher
 
     void failRequest(const Error error, httplib::Response &res);
 
-    /* Verifies that the request has the correct X-API-KEY, and sends a 401
-       if it is not. */
+    /* Verifies that the request has the correct X-API-KEY, or a valid
+       X-SESSION-TOKEN, and sends a 401 if it does not. */
     bool checkAuthenticated(const httplib::Request &req, httplib::Response &res) const;
 
+    /* Checks the token was issued by us, and has not expired or been revoked */
+    bool checkSessionToken(const std::string &token) const;
+
+    /* The HMAC of a session ID, which makes up the second half of the token */
+    Crypto::Hash signSessionId(const std::string &sessionId) const;
+
     ///////////////////
     /* POST REQUESTS */
     ///////////////////
@@ -165,6 +182,11 @@ class ApiDispatcher
     std::tuple<Error, uint16_t>
         exportToJSON(const httplib::Request &req, httplib::Response &res, const rapidjson::Document &body);
 
+    /* Exchanges the X-API-KEY for a session token, which is much cheaper to
+       verify on later requests */
+    std::tuple<Error, uint16_t>
+        createSession(const httplib::Request &req, httplib::Response &res, const rapidjson::Document &body);
+
     /////////////////////
     /* DELETE REQUESTS */
     /////////////////////
@@ -179,6 +201,10 @@ class ApiDispatcher
     std::tuple<Error, uint16_t>
         deletePreparedTransaction(const httplib::Request &req, httplib::Response &res, const rapidjson::Document &body);
 
+    /* Revokes the X-SESSION-TOKEN the request was made with */
+    std::tuple<Error, uint16_t>
+        deleteSession(const httplib::Request &req, httplib::Response &res, const rapidjson::Document &body);
+
     //////////////////
     /* PUT REQUESTS */
     //////////////////
@@ -345,9 +371,24 @@ class ApiDispatcher
     /* The rpc password - only stored to help indicate invalid passwords */
     std::string m_rpcPassword;
 
-    /* Need a mutex for some actions, mainly mutating actions, like opening
-       wallets, sending transfers, etc */
-    mutable std::mutex m_mutex;
+    /* Key used to sign session tokens. Regenerated on every start, so
+       restarting invalidates all tokens */
+    CryptoPP::byte m_sessionKey[32];
+
+    /* Session ID to expiry time of the sessions we have issued */
+    std::unordered_map<std::string, std::chrono::steady_clock::time_point> m_sessions;
+
+    /* Guards m_sessions. Kept separate from m_mutex, so authenticating isn't
+       blocked by slow operations like sending transactions */
+    mutable std::mutex m_sessionMutex;
+
+    /* Held exclusively by wallet lifecycle operations - opening, creating
+       and closing - and shared by every other request */
+    mutable std::shared_mutex m_mutex;
+
+    /* Taken by every request before m_mutex, and held by wallet lifecycle
+       operations until they finish */
+    std::mutex m_lifecycleMutex;
 
     /* The server host */
     std::string m_host;
@@ -12,6 +12,16 @@ namespace ApiConstants
        password. */
     const uint64_t PBKDF2_ITERATIONS = 10000;
 
+    /* Size of the random session ID in a session token, in bytes */
+    const size_t SESSION_ID_SIZE = 16;
+
+    /* How long a session token from POST /session is valid for, in seconds */
+    const uint64_t SESSION_TOKEN_LIFETIME = 60 * 60;
+
+    /* Maximum number of unexpired session tokens at once. Beyond this, the
+       token closest to expiring is revoked to make room */
+    const size_t MAX_SESSION_TOKENS = 1000;
+
     /* The length of the address after removing the prefix */
     const uint16_t addressBodyLength = WalletConfig::standardAddressLength - WalletConfig::addressPrefix.length();
 
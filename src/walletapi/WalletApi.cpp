@@ -6,9 +6,12 @@
 #include <chrono>
 #include <common/SignalHandler.h>
 #include <config/CliHeader.h>
+#include <fstream>
 #include <iostream>
 #include <logger/Logger.h>
+#include <sstream>
 #include <thread>
+#include <utilities/Tracing.h>
 #include <walletapi/ApiDispatcher.h>
 #include <walletapi/ParseArguments.h>
 
@@ -88,9 +91,53 @@ int main(int argc, char **argv)
                     break;
                 }
 
+                //RTcoin
+                std::stringstream command(input);
+
+                std::string name;
+
+                command >> name;
+
                 if (input == "help")
                 {
-                    std::cout << "Type exit to save and shutdown." << std::endl;
+                    std::cout << "Type exit to save and shutdown." << std::endl
+                              << "Type trace <on|off> to start or stop recording tracing spans." << std::endl
+                              << "Type trace_dump <seconds> <file> to write the last <seconds> of spans to <file>."
+                              << std::endl;
+                }
+                else if (name == "trace")
+                {
+                    std::string state;
+
+                    command >> state;
+
+                    if (state != "on" && state != "off")
+                    {
+                        std::cout << "Use: trace <on|off>" << std::endl;
+                        continue;
+                    }
+
+                    Tracing::tracer().setEnabled(state == "on");
+
+                    std::cout << "Tracing " << (state == "on" ? "started" : "stopped") << std::endl;
+                }
+                else if (name == "trace_dump")
+                {
+                    uint64_t seconds = 0;
+
+                    std::string filename;
+
+                    if (!(command >> seconds >> filename))
+                    {
+                        std::cout << "Use: trace_dump <seconds> <file>" << std::endl;
+                        continue;
+                    }
+
+                    std::ofstream file(filename);
+
+                    file << Tracing::tracer().dump(seconds);
+
+                    std::cout << (file ? "Wrote trace to " : "Failed to write trace to ") << filename << std::endl;
                 }
             }
             else /* If not, then a brief sleep helps stop the thread from running away */
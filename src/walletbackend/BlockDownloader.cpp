@@ -10,6 +10,7 @@
 #include <config/WalletConfig.h>
 #include <logger/Logger.h>
 #include <utilities/FormatTools.h>
+#include <utilities/Tracing.h>
 #include <utilities/Utilities.h>
 #include <walletbackend/Constants.h>
 
@@ -226,6 +227,9 @@ std::vector<Crypto::Hash> BlockDownloader::getBlockCheckpoints() const
 
 bool BlockDownloader::downloadBlocks()
 {
+    //RTcoin
+    TRACE_SPAN("wallet", "downloadBlocks");
+
     const uint64_t localDaemonBlockCount = m_daemon->localDaemonBlockCount();
 
     const uint64_t walletBlockCount = m_synchronizationStatus.getHeight();
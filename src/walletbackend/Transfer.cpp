@@ -9,6 +9,8 @@
 #include <common/Varint.h>
 #include <config/Constants.h>
 #include <config/WalletConfig.h>
+#include <crypto/random.h>
+#include <cryptonotecore/TransactionUtils.h>
 #include <errors/ValidateParameters.h>
 #include <logger/Logger.h>
 #include <utilities/Addresses.h>
@@ -65,6 +67,26 @@ namespace SendTransaction
         auto [ourInputs, maxFusionInputs, foundMoney] = subWallets->getFusionTransactionInputs(
             takeFromAllSubWallets, subWalletsToTakeFrom, mixin, daemon->networkBlockCount(), optimizeTarget);
 
+        InputReservation reservation(subWallets);
+
+        std::vector<WalletTypes::TxInputAndOwner> reservedInputs;
+
+        /* Another transaction may have reserved, sent, or had confirmed some
+           of these since they were picked - leave those out */
+        for (const auto &input : ourInputs)
+        {
+            if (reservation.reserve(input))
+            {
+                reservedInputs.push_back(input);
+            }
+            else
+            {
+                foundMoney -= input.input.amount;
+            }
+        }
+
+        ourInputs = reservedInputs;
+
         /* Mixin is too large to get enough outputs whilst remaining in the size
            and ratio constraints */
         if (maxFusionInputs < CryptoNote::parameters::FUSION_TX_MIN_INPUT_COUNT)
@@ -225,33 +247,16 @@ namespace SendTransaction
         uint64_t size,
         uint64_t deadline)
     {
+        /* The deadline is given in seconds from now, but is carried as an
+           absolute unix timestamp in milliseconds */
+        const uint64_t now = std::chrono::duration_cast<std::chrono::milliseconds>(
+                                 std::chrono::system_clock::now().time_since_epoch())
+                                 .count();
 
-        CryptoNote::Transaction transaction;
-
-        //m_daemon
-
-        //validate input
-        //size > MAX
-        //deadline < MIN
-
-        //make tx
-        transaction.version = CryptoNote::HACK_TRANSACTION_VERSION;
-        transaction.deadline = deadline;
-        transaction.size = size;
-
-        //generate garbage tx
-        const uint64_t headerSize = 0; //TODO: need to calculate header size
-        uint64_t garbageSize = size - headerSize;
-        std::vector<uint8_t> garbage(garbageSize, 0x55);
-        transaction.extra.insert(transaction.extra.end(), garbage.begin(), garbage.end());
-
-        //generate tx hash
-        Crypto::Hash txPrefixHash = getTransactionHash(static_cast<CryptoNote::TransactionPrefix>(transaction));
-        Crypto::Signature signature;
-        std::memcpy(signature.data, txPrefixHash.data, 32);
-        std::vector<Crypto::Signature> hash_vector;
-        hash_vector.push_back(signature);
-        transaction.signatures.push_back(hash_vector);
+        /* Random, so repeated sends of the same size and deadline aren't
+           rejected as duplicates */
+        const CryptoNote::Transaction transaction =
+            CryptoNote::createHackTransaction(size, now + deadline * 1000, Random::randomValue<uint64_t>());
 
         //send tx
         const auto [sendError, txHash] = relayTransaction(transaction, daemon);
@@ -398,8 +403,17 @@ namespace SendTransaction
         uint64_t requiredAmount = totalAmount;
         WalletTypes::PreparedTransactionInfo txInfo;
 
+        InputReservation reservation(subWallets);
+
         for (const auto &input : availableInputs)
         {
+            /* Being used by a transaction that is being built right now, or
+               no longer unspent */
+            if (!reservation.reserve(input))
+            {
+                continue;
+            }
+
             ourInputs.push_back(input);
             sumOfInputs += input.input.amount;
 
@@ -581,8 +595,21 @@ namespace SendTransaction
         const std::shared_ptr<Nigel> daemon,
         const std::shared_ptr<SubWallets> subWallets)
     {
+        InputReservation reservation(subWallets);
+
         for (const auto &input : txInfo.inputs)
         {
+            if (!reservation.reserve(input))
+            {
+                /* Spent since the transaction was prepared */
+                if (!subWallets->haveSpendableInput(input.input, daemon->networkBlockCount()))
+                {
+                    return {PREPARED_TRANSACTION_EXPIRED, Crypto::Hash()};
+                }
+
+                return {PREPARED_TRANSACTION_INPUTS_IN_USE, Crypto::Hash()};
+            }
+
             if (!subWallets->haveSpendableInput(input.input, daemon->networkBlockCount()))
             {
                 return {PREPARED_TRANSACTION_EXPIRED, Crypto::Hash()};
@@ -1133,8 +1160,9 @@ namespace SendTransaction
         return {SUCCESS, inputs, tmpSecretKeys};
     }
 
-    std::tuple<std::vector<WalletTypes::KeyOutput>, CryptoNote::KeyPair>
-        setupOutputs(std::vector<WalletTypes::TransactionDestination> destinations)
+    std::tuple<std::vector<WalletTypes::KeyOutput>, CryptoNote::KeyPair> setupOutputs(
+        std::vector<WalletTypes::TransactionDestination> destinations,
+        const Crypto::PublicKey ourPublicViewKey)
     {
         /* Sort the destinations by amount. Helps obscure which output belongs to
            which transaction */
@@ -1153,12 +1181,39 @@ namespace SendTransaction
 
         std::vector<WalletTypes::KeyOutput> outputs;
 
+        /* Each address is split into several outputs, one per denomination,
+           which all share the same derivation */
+        std::unordered_map<Crypto::PublicKey, Crypto::KeyDerivation> derivations;
+
         for (const auto &destination : destinations)
         {
-            Crypto::KeyDerivation derivation;
+            auto it = derivations.find(destination.receiverPublicViewKey);
 
-            /* Generate derivation from receiver public view key and random tx key */
-            Crypto::generate_key_derivation(destination.receiverPublicViewKey, randomTxKey.secretKey, derivation);
+            if (it == derivations.end())
+            {
+                Crypto::KeyDerivation derivation;
+
+                /* Generate derivation from receiver public view key and random tx key */
+                if (destination.receiverPublicViewKey == ourPublicViewKey)
+                {
+                    /* Change, or a send to one of our subwallets - we derive
+                       against our own view key in most transactions, so keep
+                       its table around */
+                    Crypto::crypto_ops::generateKeyDerivationPrecomputed(
+                        destination.receiverPublicViewKey, randomTxKey.secretKey, derivation);
+                }
+                else
+                {
+                    /* Building a table for a key we may never see again would
+                       cost more than it saves, and push out the ones we will */
+                    Crypto::generate_key_derivation(
+                        destination.receiverPublicViewKey, randomTxKey.secretKey, derivation);
+                }
+
+                it = derivations.emplace(destination.receiverPublicViewKey, derivation).first;
+            }
+
+            const Crypto::KeyDerivation &derivation = it->second;
 
             Crypto::PublicKey tmpPubKey;
 
@@ -1359,8 +1414,12 @@ namespace SendTransaction
             return result;
         }
 
+        Crypto::PublicKey publicViewKey;
+
+        Crypto::secret_key_to_public_key(subWallets->getPrivateViewKey(), publicViewKey);
+
         /* Setup the transaction outputs */
-        std::tie(result.outputs, result.txKeyPair) = setupOutputs(destinations);
+        std::tie(result.outputs, result.txKeyPair) = setupOutputs(destinations, publicViewKey);
 
         std::vector<uint8_t> extraNonce;
 
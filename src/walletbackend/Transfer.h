@@ -75,8 +75,9 @@ namespace SendTransaction
         const std::vector<WalletTypes::ObscuredInput> inputsAndFakes,
         const Crypto::SecretKey privateViewKey);
 
-    std::tuple<std::vector<WalletTypes::KeyOutput>, CryptoNote::KeyPair>
-        setupOutputs(std::vector<WalletTypes::TransactionDestination> destinations);
+    std::tuple<std::vector<WalletTypes::KeyOutput>, CryptoNote::KeyPair> setupOutputs(
+        std::vector<WalletTypes::TransactionDestination> destinations,
+        const Crypto::PublicKey ourPublicViewKey);
 
     std::tuple<Error, CryptoNote::Transaction> generateRingSignatures(
         CryptoNote::Transaction tx,
@@ -677,8 +677,12 @@ uint64_t WalletBackend::getTotalUnlockedBalance() const
 
 bool WalletBackend::removePreparedTransaction(const Crypto::Hash &transactionHash)
 {
+    std::unique_lock lock(m_preparedTransactionsMutex);
+
     const bool removed = m_preparedTransactions.erase(transactionHash) == 1;
 
+    lock.unlock();
+
     std::stringstream stream;
 
     if (removed)
@@ -699,7 +703,7 @@ bool WalletBackend::removePreparedTransaction(const Crypto::Hash &transactionHas
 
 std::tuple<Error, Crypto::Hash> WalletBackend::sendPreparedTransaction(const Crypto::Hash transactionHash)
 {
-    std::scoped_lock lock(m_transactionMutex);
+    std::unique_lock lock(m_preparedTransactionsMutex);
 
     auto it = m_preparedTransactions.find(transactionHash);
 
@@ -710,6 +714,8 @@ std::tuple<Error, Crypto::Hash> WalletBackend::sendPreparedTransaction(const Cry
 
     const auto preparedTransaction = it->second;
 
+    lock.unlock();
+
     const auto [error, hash] = SendTransaction::sendPreparedTransaction(preparedTransaction, m_daemon, m_subWallets);
 
     /* Remove the prepared transaction if we just sent it or it's no longer
@@ -740,13 +746,13 @@ std::tuple<Error, Crypto::Hash, WalletTypes::PreparedTransactionInfo> WalletBack
     const bool sendTransaction,
     const uint64_t deadline)                        //deadline add
 {
-    std::scoped_lock lock(m_transactionMutex);
-
     const auto [error, hash, preparedTransaction] = SendTransaction::sendTransactionBasic(
         destination, amount, paymentID, m_daemon, m_subWallets, sendAll, sendTransaction, deadline);
 
     if (!sendTransaction && !error)
     {
+        std::scoped_lock lock(m_preparedTransactionsMutex);
+
         m_preparedTransactions[hash] = preparedTransaction;
     }
 
@@ -766,8 +772,6 @@ std::tuple<Error, Crypto::Hash, WalletTypes::PreparedTransactionInfo> WalletBack
     const bool sendTransaction,
     const uint64_t deadline)                                //deadline add
 {
-    std::scoped_lock lock(m_transactionMutex);
-
     const auto [error, hash, preparedTransaction] = SendTransaction::sendTransactionAdvanced(
         destinations,
         mixin,
@@ -785,6 +789,8 @@ std::tuple<Error, Crypto::Hash, WalletTypes::PreparedTransactionInfo> WalletBack
 
     if (!sendTransaction && !error)
     {
+        std::scoped_lock lock(m_preparedTransactionsMutex);
+
         m_preparedTransactions[hash] = preparedTransaction;
     }
 
@@ -793,8 +799,6 @@ std::tuple<Error, Crypto::Hash, WalletTypes::PreparedTransactionInfo> WalletBack
 
 std::tuple<Error, Crypto::Hash> WalletBackend::sendFusionTransactionBasic()
 {
-    std::scoped_lock lock(m_transactionMutex);
-
     return SendTransaction::sendFusionTransactionBasic(m_daemon, m_subWallets);
 }
 
@@ -805,8 +809,6 @@ std::tuple<Error, Crypto::Hash> WalletBackend::sendFusionTransactionAdvanced(
     const std::vector<uint8_t> extraData,
     const std::optional<uint64_t> optimizeTarget)
 {
-    std::scoped_lock lock(m_transactionMutex);
-
     return SendTransaction::sendFusionTransactionAdvanced(
         mixin, subWalletsToTakeFrom, destination, m_daemon, m_subWallets, extraData, optimizeTarget);
 }
@@ -350,6 +350,7 @@ class WalletBackend
     /* Prepared, unsent transactions. */
     std::unordered_map<Crypto::Hash, WalletTypes::PreparedTransactionInfo> m_preparedTransactions;
 
-    /* Ensure we only send one transaction in parallel, otherwise txs will likely fail. */
-    std::mutex m_transactionMutex;
+    /* Guards m_preparedTransactions. Transactions themselves are built in
+       parallel, each reserving the inputs it uses - see InputReservation */
+    std::mutex m_preparedTransactionsMutex;
 };
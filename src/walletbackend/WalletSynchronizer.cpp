@@ -15,6 +15,7 @@
 #include <logger/Logger.h>
 #include <utilities/ThreadSafeDeque.h>
 #include <utilities/ThreadSafeQueue.h>
+#include <utilities/Tracing.h>
 #include <utilities/Utilities.h>
 #include <walletbackend/Constants.h>
 
@@ -350,6 +351,9 @@ void WalletSynchronizer::completeBlockProcessing(
     const WalletTypes::WalletBlockInfo &block,
     const std::vector<std::tuple<Crypto::PublicKey, WalletTypes::TransactionInput>> &ourInputs)
 {
+    //RTcoin
+    TRACE_SPAN("wallet", "completeBlockProcessing");
+
     const uint64_t walletHeight = m_blockDownloader.getHeight();
 
     /* Chain forked, invalidate previous transactions */
@@ -426,6 +430,9 @@ BlockScanTmpInfo WalletSynchronizer::processBlockTransactions(
     const WalletTypes::WalletBlockInfo &block,
     const std::vector<std::tuple<Crypto::PublicKey, WalletTypes::TransactionInput>> &inputs) const
 {
+    //RTcoin
+    TRACE_SPAN("wallet", "processBlockTransactions");
+
     BlockScanTmpInfo txData;
 
     if (!Config::config.wallet.skipCoinbaseTransactions)
@@ -567,6 +574,9 @@ std::vector<std::tuple<Crypto::PublicKey, WalletTypes::TransactionInput>> Wallet
     const WalletTypes::RawCoinbaseTransaction &rawTX,
     const uint64_t blockHeight) const
 {
+    //RTcoin
+    TRACE_SPAN("wallet", "processTransactionOutputs");
+
     std::vector<std::tuple<Crypto::PublicKey, WalletTypes::TransactionInput>> inputs;
 
     Crypto::KeyDerivation derivation;
@@ -645,6 +655,9 @@ std::unordered_map<Crypto::Hash, std::vector<uint64_t>>
 
 void WalletSynchronizer::checkLockedTransactions()
 {
+    //RTcoin
+    TRACE_SPAN("wallet", "checkLockedTransactions");
+
     /* Get the hashes of any locked tx's we have */
     const auto lockedTxHashes = m_subWallets->getLockedTransactionsHashes();
 
@@ -14,6 +14,11 @@
 #include <walletbackend/EventHandler.h>
 #include <walletbackend/SynchronizationStatus.h>
 
+namespace Benchmarks
+{
+    class WalletSynchronizerBenchmark;
+}
+
 typedef std::vector<std::tuple<Crypto::PublicKey, WalletTypes::TransactionInput>> BlockInputsAndOwners;
 
 typedef std::tuple<WalletTypes::WalletBlockInfo, BlockInputsAndOwners, uint32_t> SemiProcessedBlock;
@@ -112,6 +117,9 @@ class WalletSynchronizer
     void setSubWallets(const std::shared_ptr<SubWallets> subWallets);
 
   private:
+    /* Times the block processing below without a daemon or sync thread */
+    friend class Benchmarks::WalletSynchronizerBenchmark;
+
     //////////////////////////////
     /* Private member functions */
     //////////////////////////////